@@ -36,6 +36,10 @@ class AssetsMgr {
   int init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
            const std::string& sql);
 
+  // inits with the asset infos loaded by the caller, which are owned by it
+  int init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
+           const AssetInfoGroupSPtr& assetInfoGroup);
+
  private:
   int initAssetInfoGroup(const std::string& sql);
 
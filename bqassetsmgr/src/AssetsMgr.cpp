@@ -36,6 +36,16 @@ int AssetsMgr::init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
   return 0;
 }
 
+int AssetsMgr::init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
+                    const AssetInfoGroupSPtr& assetInfoGroup) {
+  node_ = node;
+  dbEng_ = dbEng;
+
+  assetInfoGroup_ = assetInfoGroup;
+  LOG_I("Init asset info group success. [size = {}]", assetInfoGroup_->size());
+  return 0;
+}
+
 int AssetsMgr::initAssetInfoGroup(const std::string& sql) {
   const auto [ret, tblRecSet] =
       db::TBLRecSetMaker<TBLAssetInfo>::ExecSql(dbEng_, sql);
@@ -10,21 +10,112 @@
 
 #include <benchmark/benchmark.h>
 
+#include "SHMCli.hpp"
+#include "SHMHeader.hpp"
+#include "SHMSrv.hpp"
+#include "iceoryx_posh/iceoryx_posh_config.hpp"
+#include "iceoryx_posh/internal/roudi/roudi.hpp"
+#include "iceoryx_posh/roudi/iceoryx_roudi_components.hpp"
+#include "iceoryx_posh/runtime/posh_runtime_single_process.hpp"
+#include "util/Datetime.hpp"
+
+using namespace bq;
+
+namespace {
+
+struct BenchData {
+  SHMHeader header;
+  std::uint64_t no_{0};
+  char data[128];
+};
+
+/*
+ * RouDi runs in the process of the bench, so the bench needs no iox-roudi and
+ * must not be run while one is running. The server echoes every req back to
+ * the client.
+ */
+class RoundTripEnv {
+ public:
+  RoundTripEnv()
+      : roudiConfig_(iox::RouDiConfig_t().setDefaults()),
+        roudiComponents_(roudiConfig_),
+        roudi_(roudiComponents_.rouDiMemoryManager,
+               roudiComponents_.portManager,
+               iox::roudi::RouDi::RoudiStartupParameters{
+                   iox::roudi::MonitoringMode::OFF, false}),
+        runtime_("bqipc-bench") {
+    shmSrv_ = std::make_shared<SHMSrv>(
+        "bench@bench@bench@Trade",
+        [this](const void* shmBufOfReq, std::size_t shmBufLenOfReq) {
+          const auto header = static_cast<const SHMHeader*>(shmBufOfReq);
+          shmSrv_->sendRspWithZeroCopy(
+              [&](void* shmBufOfRsp) {
+                memcpy(shmBufOfRsp, shmBufOfReq, sizeof(BenchData));
+              },
+              header, sizeof(BenchData));
+        });
+    shmSrv_->start();
+
+    shmCli_ = std::make_shared<SHMCli>(
+        "bench@bench@bench@Trade",
+        [this](const void* shmBufOfRsp, std::size_t shmBufLenOfRsp) {
+          const auto benchData = static_cast<const BenchData*>(shmBufOfRsp);
+          noOfRsp_.store(benchData->no_, std::memory_order_release);
+        });
+    shmCli_->setClientChannel(1);
+    shmCli_->start();
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+  }
+
+  ~RoundTripEnv() {
+    shmCli_->stop();
+    shmSrv_->stop();
+  }
+
+  void roundTrip(std::uint64_t no) {
+    shmCli_->asyncSendReqWithZeroCopy(
+        [no](void* shmBufOfReq) {
+          auto benchData = static_cast<BenchData*>(shmBufOfReq);
+          benchData->header.timestamp_ = GetTotalNSSince1970();
+          benchData->no_ = no;
+        },
+        0, sizeof(BenchData));
+    while (noOfRsp_.load(std::memory_order_acquire) != no) {
+    }
+  }
+
+ private:
+  iox::RouDiConfig_t roudiConfig_;
+  iox::roudi::IceOryxRouDiComponents roudiComponents_;
+  iox::roudi::RouDi roudi_;
+  iox::runtime::PoshRuntimeSingleProcess runtime_;
+
+  SHMSrvSPtr shmSrv_{nullptr};
+  SHMCliSPtr shmCli_{nullptr};
+  std::atomic<std::uint64_t> noOfRsp_{0};
+};
+
+}  // namespace
+
 class FixtureTest : public benchmark::Fixture {
  public:
   void SetUp(const ::benchmark::State& state) {}
   void TearDown(const ::benchmark::State& state) {}
 };
 
-BENCHMARK_DEFINE_F(FixtureTest, test)(benchmark::State& st) {
+/*
+ * A req is serialized into the shm of the client, published to the server and
+ * echoed back, an iteration ends when the rsp arrives at the client.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, roundTrip)(benchmark::State& st) {
+  static RoundTripEnv roundTripEnv;
+  static std::uint64_t no = 0;
   for (auto _ : st) {
-    int times = st.range(0);
-    for (int i = 0; i < times; ++i) {
-    }
+    roundTripEnv.roundTrip(++no);
   }
 }
-BENCHMARK_REGISTER_F(FixtureTest, test)
+BENCHMARK_REGISTER_F(FixtureTest, roundTrip)
     ->Unit(benchmark::kMicrosecond)
-    ->Arg(1000);
+    ->UseRealTime();
 
 BENCHMARK_MAIN();
@@ -42,6 +42,7 @@ constexpr static MsgId MSG_ID_SYNC_ASSETS = 10074;
 constexpr static MsgId MSG_ID_SYNC_ASSETS_SNAPSHOT = 10075;
 constexpr static MsgId MSG_ID_SYNC_UNCLOSED_ORDER_INFO = 10076;
 constexpr static MsgId MSG_ID_SYNC_POS_INFO = 10077;
+constexpr static MsgId MSG_ID_SYNC_ORDER_INFO_GROUP = 10078;
 
 constexpr static MsgId MSG_ID_ON_ORDER = 10101;
 constexpr static MsgId MSG_ID_ON_ORDER_RET = 10102;
@@ -113,6 +114,8 @@ inline std::string GetMsgName(MsgId msgId) {
       return "syncUnclosedOrderInfo";
     case MSG_ID_SYNC_POS_INFO:
       return "syncPosInfo";
+    case MSG_ID_SYNC_ORDER_INFO_GROUP:
+      return "syncOrderInfoGroup";
 
     case MSG_ID_ON_ORDER:
       return "onOrder";
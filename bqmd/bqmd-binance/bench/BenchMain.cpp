@@ -9,22 +9,218 @@
  */
 
 #include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <yyjson.h>
+
+#include "BooksCache.hpp"
+#include "WSFrameDecoderOfBinance.hpp"
+#include "def/BQConst.hpp"
+#include "def/BQMDDef.hpp"
+
+using namespace bq;
+using namespace bq::md;
+using namespace bq::md::svc::binance;
+
+namespace {
+
+/*
+ * Frames are replayed from the file in env BQ_WS_FRAMES_OF_BINANCE, one frame
+ * per line, as captured from the ws stream. Without it the built-in samples
+ * below are replayed.
+ */
+std::vector<std::string> LoadFrames() {
+  std::vector<std::string> ret;
+  if (const auto path = std::getenv("BQ_WS_FRAMES_OF_BINANCE")) {
+    std::ifstream ifs(path);
+    std::string line;
+    while (std::getline(ifs, line)) {
+      if (!line.empty()) ret.emplace_back(std::move(line));
+    }
+    if (!ret.empty()) return ret;
+  }
+
+  ret.emplace_back(
+      R"({"e":"aggTrade","E":1672515782136,"s":"BTCUSDT","a":2150283719,)"
+      R"("p":"16541.77000000","q":"0.00210000","f":2450936121,)"
+      R"("l":2450936121,"T":1672515782136,"m":false,"M":true})");
+  ret.emplace_back(
+      R"({"e":"trade","E":1672515782136,"s":"BTCUSDT","t":2450936122,)"
+      R"("p":"16541.78000000","q":"0.01000000","b":17541011233,)"
+      R"("a":17541011290,"T":1672515782136,"m":true,"M":true})");
+  ret.emplace_back(
+      R"({"e":"24hrMiniTicker","E":1672515782136,"s":"BTCUSDT",)"
+      R"("c":"16541.77000000","o":"16602.96000000","h":"16628.00000000",)"
+      R"("l":"16499.01000000","v":"125349.10745000",)"
+      R"("q":"2077335734.52133370"})");
+  ret.emplace_back(
+      R"({"e":"kline","E":1672515782136,"s":"BTCUSDT","k":{)"
+      R"("t":1672515780000,"T":1672515839999,"s":"BTCUSDT","i":"1m",)"
+      R"("f":2450936000,"L":2450936121,"o":"16540.12000000",)"
+      R"("c":"16541.77000000","h":"16542.00000000","l":"16539.50000000",)"
+      R"("v":"12.34567000","n":122,"x":false,"q":"204196.83412340",)"
+      R"("V":"6.12345000","Q":"101289.11200000","B":"0"}})");
+
+  std::string depthUpdate =
+      R"({"e":"depthUpdate","E":1672515782136,"s":"BTCUSDT",)"
+      R"("U":27911381422,"u":27911381470,"b":[)";
+  for (int i = 0; i < 20; ++i) {
+    if (i != 0) depthUpdate += ",";
+    depthUpdate += fmt::format(R"(["{:.8f}","{:.8f}"])", 16541.77 - i * 0.01,
+                               0.0021 * (i + 1));
+  }
+  depthUpdate += R"(],"a":[)";
+  for (int i = 0; i < 20; ++i) {
+    if (i != 0) depthUpdate += ",";
+    depthUpdate += fmt::format(R"(["{:.8f}","{:.8f}"])", 16541.78 + i * 0.01,
+                               i % 5 == 0 ? 0.0 : 0.0013 * (i + 1));
+  }
+  depthUpdate += "]}";
+  ret.emplace_back(std::move(depthUpdate));
+
+  return ret;
+}
+
+// the same as BooksCache::makeBooksData
+BooksDataSPtr MakeBooksData(const WSFrameOfBinance& frame) {
+  const auto makeDepthData = [](const auto& level) {
+    Decimal price = 0;
+    Decimal size = 0;
+    StrToDecimal(level.price_, price);
+    StrToDecimal(level.size_, size);
+    return std::make_shared<DepthData<Decimal>>(price, size);
+  };
+
+  auto asks = std::make_shared<Asks<Decimal>>();
+  for (const auto& level : frame.asks_) {
+    const auto depthData = makeDepthData(level);
+    const std::uint64_t priceMult = depthData->price_ * DBL_TO_INT_MULTI;
+    asks->emplace(priceMult, depthData);
+  }
+
+  auto bids = std::make_shared<Bids<Decimal>>();
+  for (const auto& level : frame.bids_) {
+    const auto depthData = makeDepthData(level);
+    const std::uint64_t priceMult = depthData->price_ * DBL_TO_INT_MULTI;
+    bids->emplace(priceMult, depthData);
+  }
+
+  return std::make_shared<BooksData>("BTC-USDT", asks, bids,
+                                     frame.firstUpdateId_,
+                                     frame.finalUpdateId_);
+}
+
+}  // namespace
 
 class FixtureTest : public benchmark::Fixture {
  public:
-  void SetUp(const ::benchmark::State& state) {}
+  void SetUp(const ::benchmark::State& state) {
+    if (frames_.empty()) {
+      frames_ = LoadFrames();
+      bytes_ = 0;
+      for (const auto& frame : frames_) bytes_ += frame.size();
+    }
+  }
   void TearDown(const ::benchmark::State& state) {}
+
+ protected:
+  std::vector<std::string> frames_;
+  std::int64_t bytes_{0};
 };
 
-BENCHMARK_DEFINE_F(FixtureTest, test)(benchmark::State& st) {
+/*
+ * The path before the decoder, a dom per frame and a walk over the keys.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, decodeByYYJson)(benchmark::State& st) {
   for (auto _ : st) {
-    int times = st.range(0);
-    for (int i = 0; i < times; ++i) {
+    for (const auto& frame : frames_) {
+      auto doc = yyjson_read(frame.data(), frame.size(), 0);
+      auto root = yyjson_doc_get_root(doc);
+      double sum = 0;
+      yyjson_val *key, *val;
+      yyjson_obj_iter iter;
+      yyjson_obj_iter_init(root, &iter);
+      while ((key = yyjson_obj_iter_next(&iter))) {
+        val = yyjson_obj_iter_get_val(key);
+        if (yyjson_is_str(val)) {
+          sum += std::strtod(yyjson_get_str(val), nullptr);
+        } else if (yyjson_is_arr(val)) {
+          std::size_t idx, max;
+          yyjson_val* level;
+          yyjson_arr_foreach(val, idx, max, level) {
+            sum += std::strtod(yyjson_get_str(yyjson_arr_get(level, 0)),
+                               nullptr);
+            sum += std::strtod(yyjson_get_str(yyjson_arr_get(level, 1)),
+                               nullptr);
+          }
+        }
+      }
+      benchmark::DoNotOptimize(sum);
+      yyjson_doc_free(doc);
     }
   }
+  st.SetItemsProcessed(st.iterations() * frames_.size());
+  st.SetBytesProcessed(st.iterations() * bytes_);
+}
+BENCHMARK_REGISTER_F(FixtureTest, decodeByYYJson)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_DEFINE_F(FixtureTest, decodeByWSFrameDecoder)(benchmark::State& st) {
+  auto& decoded = GetWSFrameOfBinanceOfCurThread();
+  for (auto _ : st) {
+    for (const auto& frame : frames_) {
+      DecodeWSFrameOfBinance(frame, decoded);
+      Decimal sum = 0;
+      Decimal value = 0;
+      for (const auto field : {decoded.price_, decoded.qty_, decoded.open_,
+                               decoded.high_, decoded.low_, decoded.close_,
+                               decoded.vol_, decoded.amt_}) {
+        if (!field.empty() && StrToDecimal(field, value)) sum += value;
+      }
+      for (const auto* levelGroup : {&decoded.asks_, &decoded.bids_}) {
+        for (const auto& level : *levelGroup) {
+          if (StrToDecimal(level.price_, value)) sum += value;
+          if (StrToDecimal(level.size_, value)) sum += value;
+        }
+      }
+      benchmark::DoNotOptimize(sum);
+    }
+  }
+  st.SetItemsProcessed(st.iterations() * frames_.size());
+  st.SetBytesProcessed(st.iterations() * bytes_);
+}
+BENCHMARK_REGISTER_F(FixtureTest, decodeByWSFrameDecoder)
+    ->Unit(benchmark::kMicrosecond);
+
+/*
+ * A depth update is decoded and merged into a snapshot of range(0) levels on
+ * each side, as BooksCache does for every depth update of the ws stream.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, mergeDepthUpdateToSnapshot)
+(benchmark::State& st) {
+  const auto& depthUpdate = frames_.back();
+  auto& decoded = GetWSFrameOfBinanceOfCurThread();
+
+  auto asks = std::make_shared<Asks<Decimal>>();
+  auto bids = std::make_shared<Bids<Decimal>>();
+  for (std::int64_t i = 0; i < st.range(0); ++i) {
+    const Decimal priceOfAsk = 16541.78 + i * 0.01;
+    const Decimal priceOfBid = 16541.77 - i * 0.01;
+    asks->emplace(static_cast<std::uint64_t>(priceOfAsk * DBL_TO_INT_MULTI),
+                  std::make_shared<DepthData<Decimal>>(priceOfAsk, 1));
+    bids->emplace(static_cast<std::uint64_t>(priceOfBid * DBL_TO_INT_MULTI),
+                  std::make_shared<DepthData<Decimal>>(priceOfBid, 1));
+  }
+  const auto snapshot =
+      std::make_shared<BooksData>("BTC-USDT", asks, bids, 0, 0);
+
+  for (auto _ : st) {
+    DecodeWSFrameOfBinance(depthUpdate, decoded);
+    snapshot->merge(MakeBooksData(decoded));
+  }
+  st.SetItemsProcessed(st.iterations());
 }
-BENCHMARK_REGISTER_F(FixtureTest, test)
-    ->Unit(benchmark::kMicrosecond)
+BENCHMARK_REGISTER_F(FixtureTest, mergeDepthUpdateToSnapshot)
+    ->Arg(100)
     ->Arg(1000);
 
 BENCHMARK_MAIN();
@@ -23,6 +23,8 @@ class MDSvc;
 
 namespace bq::md::svc::binance {
 
+struct WSFrameOfBinance;
+
 using Price = std::uint64_t;
 using UpdateId = std::uint64_t;
 
@@ -105,10 +107,11 @@ class BooksCache {
 
   std::tuple<int, BooksDataSPtr> handle(const std::string& symbolCode,
                                         const std::string& exchSymbolCode,
-                                        yyjson_val* root);
+                                        const WSFrameOfBinance& frame);
 
  private:
-  int cacheUpdateData(const std::string& symbolCode, yyjson_val* root);
+  int cacheUpdateData(const std::string& symbolCode,
+                      const WSFrameOfBinance& frame);
 
   void removeSnapshotInOrderToRegenThem(const std::string& symbolCode);
 
@@ -118,13 +121,13 @@ class BooksCache {
   int createSnapshot(const std::string& symbolCode,
                      const std::string& exchSymbolCode);
 
-  std::string getFieldNameOfFirstUpdateId() const;
-
   BooksDataSPtr makeBooksData(const std::string& symbolCode, yyjson_val* root,
                               const char* fieldNameOfAsk,
                               const char* fieldNameOfBid,
                               const char* fieldNameOfFirstUpdateId,
                               const char* fieldNameOfFinalUpdateId);
+  BooksDataSPtr makeBooksData(const std::string& symbolCode,
+                              const WSFrameOfBinance& frame);
 
   void setSnapshot(const std::string& symbolCode,
                    const BooksDataSPtr& booksData);
@@ -17,6 +17,8 @@ namespace bq::md::svc::binance {
 class BooksCache;
 using BooksCacheSPtr = std::shared_ptr<BooksCache>;
 
+struct WSFrameOfBinance;
+
 class WSCliOfExchBinance;
 using WSCliOfExchBinanceSPtr = std::shared_ptr<WSCliOfExchBinance>;
 
@@ -36,6 +38,8 @@ class WSCliOfExchBinance : public WSCliOfExch {
   WSCliAsyncTaskArgSPtr MakeWSCliAsyncTaskArg(
       const web::TaskFromSrvSPtr& task) const final;
 
+  const WSFrameOfBinance* decodeWSFrame(WSCliAsyncTaskSPtr& asyncTask) const;
+
  private:
   std::string handleMDTrades(WSCliAsyncTaskSPtr& asyncTask) final;
   std::string handleMDTickers(WSCliAsyncTaskSPtr& asyncTask) final;
@@ -0,0 +1,100 @@
+/*!
+ * \file WSFrameDecoderOfBinance.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include <memory_resource>
+
+#include "def/BQDefIF.hpp"
+
+namespace bq::md::svc::binance {
+
+enum class WSEventTypeOfBinance : std::uint8_t {
+  Others = 0,
+  Trade = 1,
+  AggTrade = 2,
+  DepthUpdate = 3,
+  MiniTicker = 4,
+  Kline = 5
+};
+
+struct LevelOfBinance {
+  std::string_view price_;
+  std::string_view size_;
+};
+using LevelGroupOfBinance = std::pmr::vector<LevelOfBinance>;
+
+/*
+ * Fields of one ws frame of the fixed binance stream schemas. String fields
+ * are views into the payload, so the payload must outlive them. Levels of
+ * depthUpdate live in the inline arena which is rewound before each decode,
+ * so steady state decoding does not touch the heap.
+ */
+struct WSFrameOfBinance {
+  WSFrameOfBinance(const WSFrameOfBinance&) = delete;
+  WSFrameOfBinance& operator=(const WSFrameOfBinance&) = delete;
+  WSFrameOfBinance(const WSFrameOfBinance&&) = delete;
+  WSFrameOfBinance& operator=(const WSFrameOfBinance&&) = delete;
+
+  WSFrameOfBinance();
+
+  void reset();
+
+ private:
+  static constexpr std::size_t SIZE_OF_ARENA = 64 * 1024;
+  alignas(std::max_align_t) std::byte bufOfArena_[SIZE_OF_ARENA];
+  std::pmr::monotonic_buffer_resource arena_;
+
+ public:
+  WSEventTypeOfBinance eventType_{WSEventTypeOfBinance::Others};
+
+  std::string_view symbol_;        // s
+  std::uint64_t eventTime_{0};     // E
+  std::uint64_t tradeTime_{0};     // T
+  std::uint64_t tradeId_{0};       // t, trade only
+  std::uint64_t aggTradeId_{0};    // a, aggTrade only
+  std::uint64_t firstTradeId_{0};  // f
+  std::uint64_t lastTradeId_{0};   // l
+  std::string_view price_;         // p
+  std::string_view qty_;           // q of trade and aggTrade
+  bool isBuyerMaker_{false};       // m
+
+  std::uint64_t firstUpdateId_{0};      // U
+  std::uint64_t finalUpdateId_{0};      // u
+  std::uint64_t prevFinalUpdateId_{0};  // pu, futures only
+  LevelGroupOfBinance asks_;            // a
+  LevelGroupOfBinance bids_;            // b
+
+  std::string_view open_;   // o, k.o
+  std::string_view high_;   // h, k.h
+  std::string_view low_;    // l, k.l
+  std::string_view close_;  // c, k.c
+  std::string_view vol_;    // v, k.v
+  std::string_view amt_;    // q of miniTicker, k.q
+};
+
+/*
+ * Only scans top level keys up to "e", used to route the frame to the thread
+ * which decodes it. Frames out of the fixed schemas, such as the results of
+ * sub and unsub, return Others.
+ */
+WSEventTypeOfBinance GetEventTypeOfWSFrame(std::string_view payload);
+
+/*
+ * Decodes the frame in one pass over the payload without building a dom,
+ * values of unknown keys are skipped.
+ */
+int DecodeWSFrameOfBinance(std::string_view payload, WSFrameOfBinance& frame);
+
+WSFrameOfBinance& GetWSFrameOfBinanceOfCurThread();
+
+bool StrToDecimal(std::string_view str, Decimal& value);
+
+}  // namespace bq::md::svc::binance
@@ -13,6 +13,7 @@
 #include "Config.hpp"
 #include "MDSvc.hpp"
 #include "MDSvcOfBinanceConst.hpp"
+#include "WSFrameDecoderOfBinance.hpp"
 #include "def/BQConst.hpp"
 #include "def/BQDef.hpp"
 #include "def/StatusCode.hpp"
@@ -26,8 +27,8 @@ namespace bq::md::svc::binance {
 
 std::tuple<int, BooksDataSPtr> BooksCache::handle(
     const std::string& symbolCode, const std::string& exchSymbolCode,
-    yyjson_val* root) {
-  auto retOfCache = cacheUpdateData(symbolCode, root);
+    const WSFrameOfBinance& frame) {
+  auto retOfCache = cacheUpdateData(symbolCode, frame);
   if (retOfCache == SCODE_MD_SVC_UPDATE_DATA_DISCONTINUOUS) {
     removeSnapshotInOrderToRegenThem(symbolCode);
     LOG_W("Handle {} failed.", symbolCode);
@@ -73,14 +74,10 @@ std::tuple<int, BooksDataSPtr> BooksCache::handle(
  *
  */
 int BooksCache::cacheUpdateData(const std::string& symbolCode,
-                                yyjson_val* root) {
+                                const WSFrameOfBinance& frame) {
   UpdateId2BooksDataSPtr updateId2BooksData;
 
-  const auto fieldNameOfFirstUpdateId = getFieldNameOfFirstUpdateId();
-  const auto fieldNameOfFinalUpdateId = "u";
-  const auto booksData =
-      makeBooksData(symbolCode, root, "a", "b",
-                    fieldNameOfFirstUpdateId.c_str(), fieldNameOfFinalUpdateId);
+  const auto booksData = makeBooksData(symbolCode, frame);
 
   const auto iter =
       symbolCode2UpdateId2BooksDataOfUpdateData_->find(symbolCode);
@@ -281,14 +278,6 @@ int BooksCache::createSnapshot(const std::string& symbolCode,
   return 0;
 }
 
-std::string BooksCache::getFieldNameOfFirstUpdateId() const {
-  if (mdSvc_->getSymbolType() == magic_enum::enum_name(SymbolType::Spot)) {
-    return "U";
-  } else {
-    return "pu";
-  }
-};
-
 BooksDataSPtr BooksCache::makeBooksData(const std::string& symbolCode,
                                         yyjson_val* root,
                                         const char* fieldNameOfAsk,
@@ -355,6 +344,43 @@ BooksDataSPtr BooksCache::makeBooksData(const std::string& symbolCode,
   return ret;
 }
 
+BooksDataSPtr BooksCache::makeBooksData(const std::string& symbolCode,
+                                        const WSFrameOfBinance& frame) {
+  const auto makeDepthData = [&](const auto& level) {
+    Decimal price = 0;
+    Decimal size = 0;
+    if (!StrToDecimal(level.price_, price) ||
+        !StrToDecimal(level.size_, size)) {
+      LOG_W("Parse level [{}, {}] of {} failed.", level.price_, level.size_,
+            symbolCode);
+    }
+    return std::make_shared<DepthData<Decimal>>(price, size);
+  };
+
+  auto asks = std::make_shared<Asks<Decimal>>();
+  for (const auto& level : frame.asks_) {
+    const auto depthData = makeDepthData(level);
+    const std::uint64_t priceMult = depthData->price_ * DBL_TO_INT_MULTI;
+    asks->emplace(priceMult, depthData);
+  }
+
+  auto bids = std::make_shared<Bids<Decimal>>();
+  for (const auto& level : frame.bids_) {
+    const auto depthData = makeDepthData(level);
+    const std::uint64_t priceMult = depthData->price_ * DBL_TO_INT_MULTI;
+    bids->emplace(priceMult, depthData);
+  }
+
+  // The first update id of futures is the final update id of prev event.
+  std::uint64_t firstUpdateId = frame.firstUpdateId_;
+  if (mdSvc_->getSymbolType() != magic_enum::enum_name(SymbolType::Spot)) {
+    firstUpdateId = frame.prevFinalUpdateId_ + 1;
+  }
+  const auto ret = std::make_shared<BooksData>(
+      symbolCode, asks, bids, firstUpdateId, frame.finalUpdateId_);
+  return ret;
+}
+
 void BooksCache::setSnapshot(const std::string& symbolCode,
                              const BooksDataSPtr& booksData) {
   (*symbolCode2BooksDataOfSnapshot_)[symbolCode] = booksData;
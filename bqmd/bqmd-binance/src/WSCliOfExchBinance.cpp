@@ -22,12 +22,15 @@
 #include "SHMIPCUtil.hpp"
 #include "SHMSrv.hpp"
 #include "TopicGroupMustSubMaint.hpp"
+#include "WSFrameDecoderOfBinance.hpp"
 #include "WSTask.hpp"
 #include "db/TBLMonitorOfSymbolInfo.hpp"
 #include "def/DataStruOfMD.hpp"
 #include "def/MDWSCliAsyncTaskArg.hpp"
+#include "def/StatusCode.hpp"
 #include "util/BQUtil.hpp"
 #include "util/Json.hpp"
+#include "util/LatencyHist.hpp"
 #include "util/String.hpp"
 #include "util/Util.hpp"
 
@@ -45,23 +48,43 @@ WSCliAsyncTaskArgSPtr WSCliOfExchBinance::MakeWSCliAsyncTaskArg(
     const web::TaskFromSrvSPtr& task) const {
   auto ret = std::make_shared<WSCliAsyncTaskArg>();
 
-  ret->doc_ = yyjson_read(task->msg_->get_payload().data(),
-                          task->msg_->get_payload().size(), 0);
+  // Market data is decoded by the handlers from the payload directly, only
+  // frames out of the fixed schemas are parsed into a dom.
+  const auto& payload = task->msg_->get_payload();
+  switch (GetEventTypeOfWSFrame(payload)) {
+    case WSEventTypeOfBinance::Trade:
+    case WSEventTypeOfBinance::AggTrade:
+      ret->wsMsgType_ = MsgType::Trades;
+      return ret;
+    case WSEventTypeOfBinance::DepthUpdate:
+      ret->wsMsgType_ = MsgType::Books;
+      return ret;
+    case WSEventTypeOfBinance::MiniTicker:
+      ret->wsMsgType_ = MsgType::Tickers;
+      return ret;
+    case WSEventTypeOfBinance::Kline:
+      ret->wsMsgType_ = MsgType::Candle;
+      return ret;
+    default:
+      break;
+  }
+
+  ret->doc_ = yyjson_read(payload.data(), payload.size(), 0);
   ret->root_ = yyjson_doc_get_root(ret->doc_);
+  ret->wsMsgType_ = MsgType::Others;
+  return ret;
+}
 
-  const auto e = yyjson_obj_get(ret->root_, "e");
-  if (yyjson_equals_str(e, EXCH_MD_TYPE_IN_QUOTE_OF_TRADES)) {
-    ret->wsMsgType_ = MsgType::Trades;
-  } else if (yyjson_equals_str(e, EXCH_MD_TYPE_IN_QUOTE_OF_BOOKS)) {
-    ret->wsMsgType_ = MsgType::Books;
-  } else if (yyjson_equals_str(e, EXCH_MD_TYPE_IN_QUOTE_OF_TICKERS)) {
-    ret->wsMsgType_ = MsgType::Tickers;
-  } else if (yyjson_equals_str(e, EXCH_MD_TYPE_IN_QUOTE_OF_CANDLE)) {
-    ret->wsMsgType_ = MsgType::Candle;
-  } else {
-    ret->wsMsgType_ = MsgType::Others;
+const WSFrameOfBinance* WSCliOfExchBinance::decodeWSFrame(
+    WSCliAsyncTaskSPtr& asyncTask) const {
+  auto& frame = GetWSFrameOfBinanceOfCurThread();
+  const auto& payload = asyncTask->task_->msg_->get_payload();
+  const auto ret = DecodeWSFrameOfBinance(payload, frame);
+  if (ret != 0) {
+    LOG_W("Decode ws frame failed. [{}] {}", GetStatusMsg(ret), payload);
+    return nullptr;
   }
-  return ret;
+  return &frame;
 }
 
 /* trades
@@ -86,42 +109,12 @@ std::string WSCliOfExchBinance::handleMDTrades(WSCliAsyncTaskSPtr& asyncTask) {
   const auto& marketCode = mdSvc_->getMarketCode();
   const auto& symbolType = mdSvc_->getSymbolType();
 
-  yyjson_val* vals = nullptr;
-  yyjson_val* valExchTs = nullptr;
-  yyjson_val* vala = nullptr;
-  yyjson_val* valPrice = nullptr;
-  yyjson_val* valSize = nullptr;
-  yyjson_val* valf = nullptr;
-  yyjson_val* vall = nullptr;
-  yyjson_val* valTradeTime = nullptr;
-  yyjson_val* valExchSide = nullptr;
-
-  yyjson_val *valFieldName, *valFieldValue;
-  yyjson_obj_iter iter;
-  yyjson_obj_iter_init(arg->root_, &iter);
-  while ((valFieldName = yyjson_obj_iter_next(&iter))) {
-    if (yyjson_equals_str(valFieldName, "s")) {
-      vals = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "E")) {
-      valExchTs = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "a")) {
-      vala = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "p")) {
-      valPrice = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "q")) {
-      valSize = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "f")) {
-      valf = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "l")) {
-      vall = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "T")) {
-      valTradeTime = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "m")) {
-      valExchSide = yyjson_obj_iter_get_val(valFieldName);
-    }
+  const auto frame = decodeWSFrame(asyncTask);
+  if (frame == nullptr) {
+    return "";
   }
 
-  std::string exchSymbolCode = yyjson_get_str(vals);
+  std::string exchSymbolCode(frame->symbol_);
   boost::to_lower(exchSymbolCode);
   const auto [ret, symbolCode] =
       mdSvc_->getTBLMonitorOfSymbolInfo()->getSymbolCode(marketCode, symbolType,
@@ -135,15 +128,8 @@ std::string WSCliOfExchBinance::handleMDTrades(WSCliAsyncTaskSPtr& asyncTask) {
     return "";
   }
 
-  const auto exchSide = yyjson_get_bool(valExchSide);
-  const auto a = yyjson_get_uint(vala);
-  const auto f = yyjson_get_uint(valf);
-  const auto l = yyjson_get_uint(vall);
-
-  const auto exchTs = yyjson_get_uint(valExchTs) * 1000;
-  const auto tradeTime = yyjson_get_uint(valTradeTime);
-  const auto price = yyjson_get_str(valPrice);
-  const auto size = yyjson_get_str(valSize);
+  const auto exchTs = frame->eventTime_ * 1000;
+  const auto tradeTime = frame->tradeTime_;
 
   const auto [topic, topicHash] =
       MakeTopicInfo(marketCode, symbolType, symbolCode, MDType::Trades);
@@ -160,11 +146,17 @@ std::string WSCliOfExchBinance::handleMDTrades(WSCliAsyncTaskSPtr& asyncTask) {
                 sizeof(trades->mdHeader_.symbolCode_) - 1);
         trades->mdHeader_.mdType_ = MDType::Trades;
         trades->tradeTime_ = tradeTime * 1000;
-        snprintf(trades->tradeNo_, sizeof(trades->tradeNo_) - 1,
-                 "%" PRIu64 "-%" PRIu64 "-%" PRIu64 "", a, f, l);
-        trades->price_ = CONV(Decimal, price);
-        trades->size_ = CONV(Decimal, size);
-        trades->side_ = GetSide(exchSide);
+        if (frame->eventType_ == WSEventTypeOfBinance::AggTrade) {
+          snprintf(trades->tradeNo_, sizeof(trades->tradeNo_) - 1,
+                   "%" PRIu64 "-%" PRIu64 "-%" PRIu64 "", frame->aggTradeId_,
+                   frame->firstTradeId_, frame->lastTradeId_);
+        } else {
+          snprintf(trades->tradeNo_, sizeof(trades->tradeNo_) - 1,
+                   "%" PRIu64 "", frame->tradeId_);
+        }
+        StrToDecimal(frame->price_, trades->price_);
+        StrToDecimal(frame->qty_, trades->size_);
+        trades->side_ = GetSide(frame->isBuyerMaker_);
         if (mdSvc_->saveMarketData()) {
           arg->marketDataOfUnifiedFmt_ = trades->dataOfUnifiedFmt();
           arg->exchTs_ = exchTs;
@@ -173,9 +165,7 @@ std::string WSCliOfExchBinance::handleMDTrades(WSCliAsyncTaskSPtr& asyncTask) {
       },
       PUB_CHANNEL, MSG_ID_ON_MD_TRADES, sizeof(Trades));
 
-#ifdef PERF_TEST
-  EXEC_PERF_TEST("Trades", asyncTask->task_->localTs_, 10000, 100);
-#endif
+  LATENCY_PROBE("MDSvc.PubTrades", asyncTask->task_->localTs_);
   return topic;
 }
 
@@ -197,39 +187,12 @@ std::string WSCliOfExchBinance::handleMDTickers(WSCliAsyncTaskSPtr& asyncTask) {
   const auto& marketCode = mdSvc_->getMarketCode();
   const auto& symbolType = mdSvc_->getSymbolType();
 
-  yyjson_val* vals = nullptr;
-  yyjson_val* valExchTs = nullptr;
-  yyjson_val* valLastPrice = nullptr;
-  yyjson_val* valOpen = nullptr;
-  yyjson_val* valHigh = nullptr;
-  yyjson_val* valLow = nullptr;
-  yyjson_val* valVol = nullptr;
-  yyjson_val* valAmt = nullptr;
-
-  yyjson_val *valFieldName, *valFieldValue;
-  yyjson_obj_iter iter;
-  yyjson_obj_iter_init(arg->root_, &iter);
-  while ((valFieldName = yyjson_obj_iter_next(&iter))) {
-    if (yyjson_equals_str(valFieldName, "s")) {
-      vals = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "E")) {
-      valExchTs = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "c")) {
-      valLastPrice = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "o")) {
-      valOpen = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "h")) {
-      valHigh = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "l")) {
-      valLow = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "v")) {
-      valVol = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "q")) {
-      valAmt = yyjson_obj_iter_get_val(valFieldName);
-    }
+  const auto frame = decodeWSFrame(asyncTask);
+  if (frame == nullptr) {
+    return "";
   }
 
-  std::string exchSymbolCode = yyjson_get_str(vals);
+  std::string exchSymbolCode(frame->symbol_);
   boost::to_lower(exchSymbolCode);
   const auto [ret, symbolCode] =
       mdSvc_->getTBLMonitorOfSymbolInfo()->getSymbolCode(marketCode, symbolType,
@@ -243,13 +206,7 @@ std::string WSCliOfExchBinance::handleMDTickers(WSCliAsyncTaskSPtr& asyncTask) {
     return "";
   }
 
-  const auto exchTs = yyjson_get_uint(valExchTs) * 1000;
-  const auto lastPrice = yyjson_get_str(valLastPrice);
-  const auto open = yyjson_get_str(valOpen);
-  const auto high = yyjson_get_str(valHigh);
-  const auto low = yyjson_get_str(valLow);
-  const auto vol = yyjson_get_str(valVol);
-  const auto amt = yyjson_get_str(valAmt);
+  const auto exchTs = frame->eventTime_ * 1000;
 
   const auto [topic, topicHash] =
       MakeTopicInfo(marketCode, symbolType, symbolCode, MDType::Tickers);
@@ -265,12 +222,12 @@ std::string WSCliOfExchBinance::handleMDTickers(WSCliAsyncTaskSPtr& asyncTask) {
         strncpy(tickers->mdHeader_.symbolCode_, symbolCode.c_str(),
                 sizeof(tickers->mdHeader_.symbolCode_) - 1);
         tickers->mdHeader_.mdType_ = MDType::Tickers;
-        tickers->lastPrice_ = CONV(Decimal, lastPrice);
-        tickers->open_ = CONV(Decimal, open);
-        tickers->high_ = CONV(Decimal, high);
-        tickers->low_ = CONV(Decimal, low);
-        tickers->vol_ = CONV(Decimal, vol);
-        tickers->amt_ = CONV(Decimal, amt);
+        StrToDecimal(frame->close_, tickers->lastPrice_);
+        StrToDecimal(frame->open_, tickers->open_);
+        StrToDecimal(frame->high_, tickers->high_);
+        StrToDecimal(frame->low_, tickers->low_);
+        StrToDecimal(frame->vol_, tickers->vol_);
+        StrToDecimal(frame->amt_, tickers->amt_);
         if (mdSvc_->saveMarketData()) {
           arg->marketDataOfUnifiedFmt_ = tickers->dataOfUnifiedFmt();
           arg->exchTs_ = exchTs;
@@ -279,9 +236,7 @@ std::string WSCliOfExchBinance::handleMDTickers(WSCliAsyncTaskSPtr& asyncTask) {
       },
       PUB_CHANNEL, MSG_ID_ON_MD_TICKERS, sizeof(Tickers));
 
-#ifdef PERF_TEST
-  EXEC_PERF_TEST("Tickers", asyncTask->task_->localTs_, 10000, 100);
-#endif
+  LATENCY_PROBE("MDSvc.PubTickers", asyncTask->task_->localTs_);
   return topic;
 }
 
@@ -320,41 +275,13 @@ std::string WSCliOfExchBinance::handleMDCandle(WSCliAsyncTaskSPtr& asyncTask) {
   const auto& marketCode = mdSvc_->getMarketCode();
   const auto& symbolType = mdSvc_->getSymbolType();
 
-  yyjson_val* valExchTs = yyjson_obj_get(arg->root_, "E");
-  const auto exchTs = yyjson_get_uint(valExchTs) * 1000;
-
-  yyjson_val* vals = nullptr;
-  yyjson_val* valOpen = nullptr;
-  yyjson_val* valClose = nullptr;
-  yyjson_val* valHigh = nullptr;
-  yyjson_val* valLow = nullptr;
-  yyjson_val* valAmt = nullptr;
-  yyjson_val* valVol = nullptr;
-
-  const auto valk = yyjson_obj_get(arg->root_, "k");
-
-  yyjson_val *valFieldName, *valFieldValue;
-  yyjson_obj_iter iter;
-  yyjson_obj_iter_init(valk, &iter);
-  while ((valFieldName = yyjson_obj_iter_next(&iter))) {
-    if (yyjson_equals_str(valFieldName, "s")) {
-      vals = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "o")) {
-      valOpen = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "c")) {
-      valClose = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "h")) {
-      valHigh = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "l")) {
-      valLow = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "q")) {
-      valAmt = yyjson_obj_iter_get_val(valFieldName);
-    } else if (yyjson_equals_str(valFieldName, "v")) {
-      valVol = yyjson_obj_iter_get_val(valFieldName);
-    }
+  const auto frame = decodeWSFrame(asyncTask);
+  if (frame == nullptr) {
+    return "";
   }
+  const auto exchTs = frame->eventTime_ * 1000;
 
-  std::string exchSymbolCode = yyjson_get_str(vals);
+  std::string exchSymbolCode(frame->symbol_);
   boost::to_lower(exchSymbolCode);
   const auto [ret, symbolCode] =
       mdSvc_->getTBLMonitorOfSymbolInfo()->getSymbolCode(marketCode, symbolType,
@@ -383,12 +310,12 @@ std::string WSCliOfExchBinance::handleMDCandle(WSCliAsyncTaskSPtr& asyncTask) {
         strncpy(candle->mdHeader_.symbolCode_, symbolCode.c_str(),
                 sizeof(candle->mdHeader_.symbolCode_) - 1);
         candle->mdHeader_.mdType_ = MDType::Candle;
-        candle->open_ = CONV(Decimal, yyjson_get_str(valOpen));
-        candle->high_ = CONV(Decimal, yyjson_get_str(valHigh));
-        candle->low_ = CONV(Decimal, yyjson_get_str(valLow));
-        candle->close_ = CONV(Decimal, yyjson_get_str(valClose));
-        candle->vol_ = CONV(Decimal, yyjson_get_str(valVol));
-        candle->amt_ = CONV(Decimal, yyjson_get_str(valAmt));
+        StrToDecimal(frame->open_, candle->open_);
+        StrToDecimal(frame->high_, candle->high_);
+        StrToDecimal(frame->low_, candle->low_);
+        StrToDecimal(frame->close_, candle->close_);
+        StrToDecimal(frame->vol_, candle->vol_);
+        StrToDecimal(frame->amt_, candle->amt_);
         if (mdSvc_->saveMarketData()) {
           arg->marketDataOfUnifiedFmt_ = candle->dataOfUnifiedFmt();
           arg->exchTs_ = exchTs;
@@ -397,9 +324,7 @@ std::string WSCliOfExchBinance::handleMDCandle(WSCliAsyncTaskSPtr& asyncTask) {
       },
       PUB_CHANNEL, MSG_ID_ON_MD_CANDLE, sizeof(Candle));
 
-#ifdef PERF_TEST
-  EXEC_PERF_TEST("Candle", asyncTask->task_->localTs_, 10000, 100);
-#endif
+  LATENCY_PROBE("MDSvc.PubCandle", asyncTask->task_->localTs_);
   return topic;
 }
 
@@ -429,8 +354,12 @@ std::string WSCliOfExchBinance::handleMDBooks(WSCliAsyncTaskSPtr& asyncTask) {
   const auto& marketCode = mdSvc_->getMarketCode();
   const auto& symbolType = mdSvc_->getSymbolType();
 
-  const auto s = yyjson_obj_get(arg->root_, "s");
-  std::string exchSymbolCode = yyjson_get_str(s);
+  const auto frame = decodeWSFrame(asyncTask);
+  if (frame == nullptr) {
+    return "";
+  }
+
+  std::string exchSymbolCode(frame->symbol_);
   boost::to_lower(exchSymbolCode);
   const auto [ret, symbolCode] =
       mdSvc_->getTBLMonitorOfSymbolInfo()->getSymbolCode(marketCode, symbolType,
@@ -445,13 +374,12 @@ std::string WSCliOfExchBinance::handleMDBooks(WSCliAsyncTaskSPtr& asyncTask) {
   }
 
   auto [retOfHandle, snapshot] =
-      booksCache_->handle(symbolCode, exchSymbolCode, arg->root_);
+      booksCache_->handle(symbolCode, exchSymbolCode, *frame);
   if (retOfHandle != 0) {
     LOG_D("Handle market data of books snapshot for {} failed.", symbolCode);
     return "";
   }
-  const auto valExchTs = yyjson_obj_get(arg->root_, "E");
-  const auto exchTs = yyjson_get_uint(valExchTs) * 1000;
+  const auto exchTs = frame->eventTime_ * 1000;
 
   const auto [topic, topicHash] =
       MakeTopicInfo(marketCode, symbolType, symbolCode, MDType::Books,
@@ -495,9 +423,7 @@ std::string WSCliOfExchBinance::handleMDBooks(WSCliAsyncTaskSPtr& asyncTask) {
       },
       PUB_CHANNEL, MSG_ID_ON_MD_BOOKS, sizeof(Books));
 
-#ifdef PERF_TEST
-  EXEC_PERF_TEST("Books", asyncTask->task_->localTs_, 10000, 100);
-#endif
+  LATENCY_PROBE("MDSvc.PubBooks", asyncTask->task_->localTs_);
   return topic;
 }
 
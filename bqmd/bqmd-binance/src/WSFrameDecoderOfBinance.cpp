@@ -0,0 +1,467 @@
+/*!
+ * \file WSFrameDecoderOfBinance.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "WSFrameDecoderOfBinance.hpp"
+
+#include <cstring>
+
+#include "def/StatusCode.hpp"
+
+namespace bq::md::svc::binance {
+
+WSFrameOfBinance::WSFrameOfBinance()
+    : arena_(bufOfArena_, sizeof(bufOfArena_)),
+      asks_(&arena_),
+      bids_(&arena_) {}
+
+void WSFrameOfBinance::reset() {
+  // Drop the levels before rewinding the arena they are allocated from.
+  asks_ = LevelGroupOfBinance(&arena_);
+  bids_ = LevelGroupOfBinance(&arena_);
+  arena_.release();
+
+  eventType_ = WSEventTypeOfBinance::Others;
+  symbol_ = {};
+  eventTime_ = 0;
+  tradeTime_ = 0;
+  tradeId_ = 0;
+  aggTradeId_ = 0;
+  firstTradeId_ = 0;
+  lastTradeId_ = 0;
+  price_ = {};
+  qty_ = {};
+  isBuyerMaker_ = false;
+  firstUpdateId_ = 0;
+  finalUpdateId_ = 0;
+  prevFinalUpdateId_ = 0;
+  open_ = {};
+  high_ = {};
+  low_ = {};
+  close_ = {};
+  vol_ = {};
+  amt_ = {};
+}
+
+namespace {
+
+class Scanner {
+ public:
+  explicit Scanner(std::string_view payload)
+      : cur_(payload.data()), end_(payload.data() + payload.size()) {}
+
+  void skipWS() {
+    while (cur_ != end_ &&
+           (*cur_ == ' ' || *cur_ == '\n' || *cur_ == '\r' || *cur_ == '\t')) {
+      ++cur_;
+    }
+  }
+
+  char peek() {
+    skipWS();
+    return cur_ != end_ ? *cur_ : '\0';
+  }
+
+  bool consume(char ch) {
+    if (peek() != ch) return false;
+    ++cur_;
+    return true;
+  }
+
+  // Escapes are kept as they are, binance does not use them in these fields.
+  bool readStr(std::string_view& value) {
+    if (!consume('"')) return false;
+    const auto beg = cur_;
+    while (true) {
+      const auto pos = static_cast<const char*>(
+          std::memchr(cur_, '"', static_cast<std::size_t>(end_ - cur_)));
+      if (pos == nullptr) return false;
+      cur_ = pos + 1;
+      auto numOfBackslash = 0;
+      for (auto p = pos; p != beg && *(p - 1) == '\\'; --p) ++numOfBackslash;
+      if (numOfBackslash % 2 == 0) {
+        value = std::string_view(beg, static_cast<std::size_t>(pos - beg));
+        return true;
+      }
+    }
+  }
+
+  bool readUInt(std::uint64_t& value) {
+    skipWS();
+    const auto [ptr, ec] = std::from_chars(cur_, end_, value);
+    if (ec != std::errc()) return false;
+    cur_ = ptr;
+    return true;
+  }
+
+  bool readBool(bool& value) {
+    const auto ch = peek();
+    if (ch == 't' && end_ - cur_ >= 4 && std::memcmp(cur_, "true", 4) == 0) {
+      value = true;
+      cur_ += 4;
+      return true;
+    }
+    if (ch == 'f' && end_ - cur_ >= 5 && std::memcmp(cur_, "false", 5) == 0) {
+      value = false;
+      cur_ += 5;
+      return true;
+    }
+    return false;
+  }
+
+  bool skipValue() {
+    const auto ch = peek();
+    if (ch == '"') {
+      std::string_view value;
+      return readStr(value);
+    }
+    if (ch == '{' || ch == '[') {
+      std::uint32_t depth = 0;
+      while (cur_ != end_) {
+        const auto c = *cur_;
+        if (c == '"') {
+          std::string_view value;
+          if (!readStr(value)) return false;
+          continue;
+        }
+        ++cur_;
+        if (c == '{' || c == '[') {
+          ++depth;
+        } else if (c == '}' || c == ']') {
+          if (--depth == 0) return true;
+        }
+      }
+      return false;
+    }
+    const auto beg = cur_;
+    while (cur_ != end_ && *cur_ != ',' && *cur_ != '}' && *cur_ != ']' &&
+           *cur_ != ' ' && *cur_ != '\n' && *cur_ != '\r' && *cur_ != '\t') {
+      ++cur_;
+    }
+    return cur_ != beg;
+  }
+
+  // Accepts the separator after a member or an element, returns false at the
+  // closing bracket.
+  bool nextMember(char closing, bool& ok) {
+    const auto ch = peek();
+    if (ch == ',') {
+      ++cur_;
+      return true;
+    }
+    ok = (ch == closing);
+    if (ok) ++cur_;
+    return false;
+  }
+
+ private:
+  const char* cur_;
+  const char* end_;
+};
+
+WSEventTypeOfBinance GetEventType(std::string_view value) {
+  switch (value.size()) {
+    case 5:
+      if (value == "trade") return WSEventTypeOfBinance::Trade;
+      if (value == "kline") return WSEventTypeOfBinance::Kline;
+      break;
+    case 8:
+      if (value == "aggTrade") return WSEventTypeOfBinance::AggTrade;
+      break;
+    case 11:
+      if (value == "depthUpdate") return WSEventTypeOfBinance::DepthUpdate;
+      break;
+    case 14:
+      if (value == "24hrMiniTicker") return WSEventTypeOfBinance::MiniTicker;
+      break;
+    default:
+      break;
+  }
+  return WSEventTypeOfBinance::Others;
+}
+
+/*
+ * [["0.0024","10"],["0.0023","1"]]
+ */
+bool ReadLevelGroup(Scanner& scanner, LevelGroupOfBinance& levelGroup) {
+  if (!scanner.consume('[')) return false;
+  if (scanner.consume(']')) return true;
+  bool ok = false;
+  do {
+    LevelOfBinance level;
+    if (!scanner.consume('[')) return false;
+    if (!scanner.readStr(level.price_)) return false;
+    if (!scanner.consume(',')) return false;
+    if (!scanner.readStr(level.size_)) return false;
+    bool okOfLevel = false;
+    while (scanner.nextMember(']', okOfLevel)) {
+      if (!scanner.skipValue()) return false;
+    }
+    if (!okOfLevel) return false;
+    levelGroup.emplace_back(level);
+  } while (scanner.nextMember(']', ok));
+  return ok;
+}
+
+bool ReadKline(Scanner& scanner, WSFrameOfBinance& frame) {
+  if (!scanner.consume('{')) return false;
+  if (scanner.consume('}')) return true;
+  bool ok = false;
+  do {
+    std::string_view key;
+    if (!scanner.readStr(key) || !scanner.consume(':')) return false;
+    auto succ = true;
+    if (key.size() == 1) {
+      switch (key[0]) {
+        case 's':
+          succ = scanner.readStr(frame.symbol_);
+          break;
+        case 'o':
+          succ = scanner.readStr(frame.open_);
+          break;
+        case 'h':
+          succ = scanner.readStr(frame.high_);
+          break;
+        case 'l':
+          succ = scanner.readStr(frame.low_);
+          break;
+        case 'c':
+          succ = scanner.readStr(frame.close_);
+          break;
+        case 'v':
+          succ = scanner.readStr(frame.vol_);
+          break;
+        case 'q':
+          succ = scanner.readStr(frame.amt_);
+          break;
+        default:
+          succ = scanner.skipValue();
+          break;
+      }
+    } else {
+      succ = scanner.skipValue();
+    }
+    if (!succ) return false;
+  } while (scanner.nextMember('}', ok));
+  return ok;
+}
+
+}  // namespace
+
+WSEventTypeOfBinance GetEventTypeOfWSFrame(std::string_view payload) {
+  Scanner scanner(payload);
+  if (!scanner.consume('{')) return WSEventTypeOfBinance::Others;
+  if (scanner.consume('}')) return WSEventTypeOfBinance::Others;
+  bool ok = false;
+  do {
+    std::string_view key;
+    if (!scanner.readStr(key) || !scanner.consume(':')) break;
+    if (key.size() == 1 && key[0] == 'e') {
+      std::string_view value;
+      if (!scanner.readStr(value)) break;
+      return GetEventType(value);
+    }
+    if (!scanner.skipValue()) break;
+  } while (scanner.nextMember('}', ok));
+  return WSEventTypeOfBinance::Others;
+}
+
+/*
+ * {"e":"aggTrade","E":123456789,"s":"BNBBTC","a":12345,"p":"0.001",
+ *  "q":"100","f":100,"l":105,"T":123456785,"m":true,"M":true}
+ *
+ * Keys shared by several schemas are told apart by the type of their values,
+ * "a" and "b" are arrays in depthUpdate and numbers in trades, "l" is a string
+ * in miniTicker and a number in aggTrade. "q" is always a string, its meaning
+ * is resolved by "e" after the pass.
+ */
+int DecodeWSFrameOfBinance(std::string_view payload, WSFrameOfBinance& frame) {
+  frame.reset();
+
+  Scanner scanner(payload);
+  if (!scanner.consume('{')) return SCODE_MD_SVC_DECODE_WS_FRAME_FAILED;
+
+  std::string_view q;
+  bool ok = scanner.consume('}');
+  if (!ok) {
+    do {
+      std::string_view key;
+      if (!scanner.readStr(key) || !scanner.consume(':')) {
+        return SCODE_MD_SVC_DECODE_WS_FRAME_FAILED;
+      }
+
+      auto succ = true;
+      if (key.size() == 1) {
+        switch (key[0]) {
+          case 'e': {
+            std::string_view value;
+            succ = scanner.readStr(value);
+            frame.eventType_ = GetEventType(value);
+          } break;
+          case 'E':
+            succ = scanner.readUInt(frame.eventTime_);
+            break;
+          case 's':
+            succ = scanner.readStr(frame.symbol_);
+            break;
+          case 'T':
+            succ = scanner.readUInt(frame.tradeTime_);
+            break;
+          case 't':
+            succ = scanner.readUInt(frame.tradeId_);
+            break;
+          case 'a':
+            succ = scanner.peek() == '['
+                       ? ReadLevelGroup(scanner, frame.asks_)
+                       : scanner.readUInt(frame.aggTradeId_);
+            break;
+          case 'b':
+            succ = scanner.peek() == '['
+                       ? ReadLevelGroup(scanner, frame.bids_)
+                       : scanner.skipValue();
+            break;
+          case 'f':
+            succ = scanner.readUInt(frame.firstTradeId_);
+            break;
+          case 'l':
+            succ = scanner.peek() == '"' ? scanner.readStr(frame.low_)
+                                         : scanner.readUInt(frame.lastTradeId_);
+            break;
+          case 'p':
+            succ = scanner.readStr(frame.price_);
+            break;
+          case 'q':
+            succ = scanner.readStr(q);
+            break;
+          case 'm':
+            succ = scanner.readBool(frame.isBuyerMaker_);
+            break;
+          case 'U':
+            succ = scanner.readUInt(frame.firstUpdateId_);
+            break;
+          case 'u':
+            succ = scanner.readUInt(frame.finalUpdateId_);
+            break;
+          case 'o':
+            succ = scanner.readStr(frame.open_);
+            break;
+          case 'h':
+            succ = scanner.readStr(frame.high_);
+            break;
+          case 'c':
+            succ = scanner.readStr(frame.close_);
+            break;
+          case 'v':
+            succ = scanner.readStr(frame.vol_);
+            break;
+          case 'k':
+            succ = ReadKline(scanner, frame);
+            break;
+          default:
+            succ = scanner.skipValue();
+            break;
+        }
+      } else if (key == "pu") {
+        succ = scanner.readUInt(frame.prevFinalUpdateId_);
+      } else {
+        succ = scanner.skipValue();
+      }
+
+      if (!succ) return SCODE_MD_SVC_DECODE_WS_FRAME_FAILED;
+    } while (scanner.nextMember('}', ok));
+  }
+  if (!ok) return SCODE_MD_SVC_DECODE_WS_FRAME_FAILED;
+
+  switch (frame.eventType_) {
+    case WSEventTypeOfBinance::Trade:
+    case WSEventTypeOfBinance::AggTrade:
+      frame.qty_ = q;
+      break;
+    case WSEventTypeOfBinance::MiniTicker:
+      frame.amt_ = q;
+      break;
+    case WSEventTypeOfBinance::Others:
+      return SCODE_MD_SVC_DECODE_WS_FRAME_FAILED;
+    default:
+      break;
+  }
+
+  return 0;
+}
+
+WSFrameOfBinance& GetWSFrameOfBinanceOfCurThread() {
+  thread_local WSFrameOfBinance frame;
+  return frame;
+}
+
+/*
+ * Prices and sizes from binance are plain decimals such as "31603.76000000",
+ * for doubles the mantissa and the power of 10 are both exact in most cases,
+ * so a single division gives the correctly rounded result. Others fall back
+ * to strtod.
+ */
+namespace {
+
+template <typename T>
+bool StrToNum(std::string_view str, T& value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    static constexpr double pow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    static constexpr std::uint64_t maxExactMantissa = 1ULL << 53;
+
+    auto cur = str.data();
+    const auto end = str.data() + str.size();
+    const auto neg = (cur != end && *cur == '-');
+    if (neg) ++cur;
+
+    std::uint64_t mantissa = 0;
+    int numOfDigits = 0;
+    int scale = -1;
+    for (; cur != end; ++cur) {
+      const auto ch = *cur;
+      if (ch >= '0' && ch <= '9') {
+        if (mantissa > maxExactMantissa / 10) break;
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(ch - '0');
+        ++numOfDigits;
+        if (scale >= 0) ++scale;
+      } else if (ch == '.' && scale < 0) {
+        scale = 0;
+      } else {
+        break;
+      }
+    }
+
+    if (cur == end && numOfDigits != 0 && mantissa <= maxExactMantissa &&
+        scale <= 22) {
+      const auto ret = static_cast<double>(mantissa) / pow10[std::max(scale, 0)];
+      value = neg ? -ret : ret;
+      return true;
+    }
+
+    char buf[64];
+    if (str.empty() || str.size() >= sizeof(buf)) return false;
+    std::memcpy(buf, str.data(), str.size());
+    buf[str.size()] = '\0';
+    char* endOfNum = nullptr;
+    value = std::strtod(buf, &endOfNum);
+    return endOfNum == buf + str.size();
+
+  } else {
+    return T::Parse(str, value);
+  }
+}
+
+}  // namespace
+
+bool StrToDecimal(std::string_view str, Decimal& value) {
+  return StrToNum(str, value);
+}
+
+}  // namespace bq::md::svc::binance
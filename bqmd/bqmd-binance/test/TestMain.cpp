@@ -13,6 +13,12 @@
 
 #include <string>
 
+#include "WSFrameDecoderOfBinance.hpp"
+#include "def/StatusCode.hpp"
+
+using namespace bq;
+using namespace bq::md::svc::binance;
+
 class global_event : public testing::Environment {
  public:
   virtual void SetUp() {}
@@ -21,6 +27,80 @@ class global_event : public testing::Environment {
 
 TEST(test, test1) {}
 
+TEST(test, testWSFrameDecoderOfBinance) {
+  auto& frame = GetWSFrameOfBinanceOfCurThread();
+
+  const std::string aggTrade =
+      R"({"e":"aggTrade","E":123456789,"s":"BNBBTC","a":12345,"p":"0.001",)"
+      R"("q":"100","f":100,"l":105,"T":123456785,"m":true,"M":true})";
+  EXPECT_TRUE(GetEventTypeOfWSFrame(aggTrade) ==
+              WSEventTypeOfBinance::AggTrade);
+  EXPECT_TRUE(DecodeWSFrameOfBinance(aggTrade, frame) == 0);
+  EXPECT_TRUE(frame.symbol_ == "BNBBTC");
+  EXPECT_TRUE(frame.eventTime_ == 123456789);
+  EXPECT_TRUE(frame.aggTradeId_ == 12345);
+  EXPECT_TRUE(frame.firstTradeId_ == 100);
+  EXPECT_TRUE(frame.lastTradeId_ == 105);
+  EXPECT_TRUE(frame.tradeTime_ == 123456785);
+  EXPECT_TRUE(frame.price_ == "0.001");
+  EXPECT_TRUE(frame.qty_ == "100");
+  EXPECT_TRUE(frame.isBuyerMaker_);
+
+  const std::string miniTicker = R"({
+    "e": "24hrMiniTicker", "E": 123456789, "s": "BNBBTC", "c": "0.0025",
+    "o": "0.0010", "h": "0.0025", "l": "0.0010", "v": "10000", "q": "18"
+  })";
+  EXPECT_TRUE(DecodeWSFrameOfBinance(miniTicker, frame) == 0);
+  EXPECT_TRUE(frame.eventType_ == WSEventTypeOfBinance::MiniTicker);
+  EXPECT_TRUE(frame.close_ == "0.0025");
+  EXPECT_TRUE(frame.low_ == "0.0010");
+  EXPECT_TRUE(frame.amt_ == "18");
+  EXPECT_TRUE(frame.qty_.empty());
+  EXPECT_TRUE(frame.lastTradeId_ == 0);
+
+  const std::string kline =
+      R"({"e":"kline","E":123456789,"s":"BNBBTC","k":{"t":123400000,)"
+      R"("T":123460000,"s":"BNBBTC","i":"1m","f":100,"L":200,"o":"0.0010",)"
+      R"("c":"0.0020","h":"0.0025","l":"0.0015","v":"1000","n":100,)"
+      R"("x":false,"q":"1.0000","V":"500","Q":"0.500","B":"123456"}})";
+  EXPECT_TRUE(DecodeWSFrameOfBinance(kline, frame) == 0);
+  EXPECT_TRUE(frame.eventType_ == WSEventTypeOfBinance::Kline);
+  EXPECT_TRUE(frame.open_ == "0.0010");
+  EXPECT_TRUE(frame.close_ == "0.0020");
+  EXPECT_TRUE(frame.vol_ == "1000");
+  EXPECT_TRUE(frame.amt_ == "1.0000");
+
+  const std::string depthUpdate =
+      R"({"e":"depthUpdate","E":123456789,"T":123456788,"s":"BTCUSDT",)"
+      R"("U":157,"u":160,"pu":149,"b":[["0.0024","10"],["0.0023","0"]],)"
+      R"("a":[["0.0026","100"]]})";
+  EXPECT_TRUE(DecodeWSFrameOfBinance(depthUpdate, frame) == 0);
+  EXPECT_TRUE(frame.firstUpdateId_ == 157);
+  EXPECT_TRUE(frame.finalUpdateId_ == 160);
+  EXPECT_TRUE(frame.prevFinalUpdateId_ == 149);
+  EXPECT_TRUE(frame.bids_.size() == 2);
+  EXPECT_TRUE(frame.asks_.size() == 1);
+  EXPECT_TRUE(frame.bids_[1].price_ == "0.0023");
+  EXPECT_TRUE(frame.bids_[1].size_ == "0");
+  EXPECT_TRUE(frame.asks_[0].size_ == "100");
+
+  const std::string subRet = R"({"result":null,"id":1})";
+  EXPECT_TRUE(GetEventTypeOfWSFrame(subRet) == WSEventTypeOfBinance::Others);
+  EXPECT_TRUE(DecodeWSFrameOfBinance(subRet, frame) ==
+              SCODE_MD_SVC_DECODE_WS_FRAME_FAILED);
+  EXPECT_TRUE(DecodeWSFrameOfBinance(R"({"e":"aggTrade","p":"0.0)", frame) ==
+              SCODE_MD_SVC_DECODE_WS_FRAME_FAILED);
+
+  Decimal value = 0;
+  EXPECT_TRUE(StrToDecimal("31603.76000000", value));
+  EXPECT_TRUE(value == Decimal(31603.76));
+  EXPECT_TRUE(StrToDecimal("-0.00012", value));
+  EXPECT_TRUE(value == Decimal(-0.00012));
+  EXPECT_TRUE(StrToDecimal("1e-05", value));
+  EXPECT_TRUE(value == Decimal(0.00001));
+  EXPECT_TRUE(!StrToDecimal("0.1x", value));
+}
+
 int main(int argc, char** argv) {
   testing::AddGlobalTestEnvironment(new global_event);
   testing::InitGoogleTest(&argc, argv);
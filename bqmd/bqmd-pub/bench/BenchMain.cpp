@@ -10,21 +10,100 @@
 
 #include <benchmark/benchmark.h>
 
+#include "def/BQConst.hpp"
+#include "util/BQMDHis.hpp"
+
+using namespace bq;
+using namespace bq::md;
+
+namespace {
+
+const std::string ROOT_PATH_OF_HIS_MD = "benchData";
+const std::string TOPIC_OF_HIS_MD = "MD@Binance@Spot@BTC-USDT@Trades";
+
+// 2023-01-20 00:00:00 and 2023-01-20 23:59:59.999999
+constexpr std::uint64_t TS_OF_DATE_OF_HIS_MD = 1674172800000000;
+constexpr std::uint64_t TS_OF_END_OF_DATE_OF_HIS_MD =
+    TS_OF_DATE_OF_HIS_MD + 86400ULL * 1000000ULL - 1;
+
+/*
+ * Writes numOfHisMD trades of one day spread over the day and the index of
+ * them, the same as the files saved by the storage svc of md.
+ */
+void MakeHisMD(std::uint64_t numOfHisMD) {
+  boost::filesystem::path pathPrefix = ROOT_PATH_OF_HIS_MD;
+  std::vector<std::string> topicFieldGroup;
+  boost::split(topicFieldGroup, TOPIC_OF_HIS_MD,
+               boost::is_any_of(SEP_OF_TOPIC));
+  for (const auto& topicField : topicFieldGroup) {
+    pathPrefix /= topicField;
+  }
+  boost::filesystem::remove_all(pathPrefix);
+  boost::filesystem::create_directories(pathPrefix);
+
+  const auto filename =
+      pathPrefix / fmt::format("20230120.{}", HIS_MD_FILE_EXT);
+  std::ofstream out(filename.string());
+  const auto usPerHisMD = 86400ULL * 1000000ULL / numOfHisMD;
+  for (std::uint64_t no = 0; no < numOfHisMD; ++no) {
+    const auto ts = TS_OF_DATE_OF_HIS_MD + no * usPerHisMD;
+    out << fmt::format(
+        R"({{"mdHeader":{{"exchTs":{},"localTs":{},"marketCode":"Binance",)"
+        R"("symbolType":"Spot","symbolCode":"BTC-USDT","mdType":"Trades"}},)"
+        R"("tradeTime":{},"tradeId":"{}","price":16541.77,"size":0.0021,)"
+        R"("side":"Bid"}})",
+        ts, ts + 100, ts, no)
+        << std::endl;
+  }
+  out.close();
+
+  const auto filenameOfIdx = fmt::format("{}.{}", filename.string(),
+                                         HIS_MD_INDEX_BY_ET_EXT);
+  MDHis::CreateIdxFileIfNotExists(filenameOfIdx, IndexType::ByExchTs);
+}
+
+}  // namespace
+
 class FixtureTest : public benchmark::Fixture {
  public:
-  void SetUp(const ::benchmark::State& state) {}
-  void TearDown(const ::benchmark::State& state) {}
+  void SetUp(const ::benchmark::State& state) { MakeHisMD(state.range(0)); }
+  void TearDown(const ::benchmark::State& state) {
+    boost::filesystem::remove_all(ROOT_PATH_OF_HIS_MD);
+  }
 };
 
-BENCHMARK_DEFINE_F(FixtureTest, test)(benchmark::State& st) {
+/*
+ * Loads all his market data of the day through the index, as a query of his
+ * market data from the web svc does.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, loadHisMDBetweenTs)(benchmark::State& st) {
+  for (auto _ : st) {
+    const auto [statusCode, ts2HisMDGroup] = MDHis::LoadHisMDBetweenTs(
+        ROOT_PATH_OF_HIS_MD, TOPIC_OF_HIS_MD, TS_OF_DATE_OF_HIS_MD,
+        TS_OF_END_OF_DATE_OF_HIS_MD, IndexType::ByExchTs, st.range(0));
+    benchmark::DoNotOptimize(ts2HisMDGroup);
+  }
+  st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK_REGISTER_F(FixtureTest, loadHisMDBetweenTs)
+    ->Unit(benchmark::kMillisecond)
+    ->Arg(1000)
+    ->Arg(10000);
+
+/*
+ * Loads the latest 100 his market data before the end of the day.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, loadHisMDBeforeTs)(benchmark::State& st) {
   for (auto _ : st) {
-    int times = st.range(0);
-    for (int i = 0; i < times; ++i) {
-    }
+    const auto [statusCode, ts2HisMDGroup] = MDHis::LoadHisMDBeforeTs(
+        ROOT_PATH_OF_HIS_MD, TOPIC_OF_HIS_MD, TS_OF_END_OF_DATE_OF_HIS_MD, 100,
+        IndexType::ByExchTs, st.range(0));
+    benchmark::DoNotOptimize(ts2HisMDGroup);
   }
 }
-BENCHMARK_REGISTER_F(FixtureTest, test)
-    ->Unit(benchmark::kMicrosecond)
-    ->Arg(1000);
+BENCHMARK_REGISTER_F(FixtureTest, loadHisMDBeforeTs)
+    ->Unit(benchmark::kMillisecond)
+    ->Arg(1000)
+    ->Arg(10000);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,144 @@
+/*!
+ * \file L3Books.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/12/22
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "def/BQConstIF.hpp"
+#include "def/BQDefIF.hpp"
+#include "util/Pch.hpp"
+
+namespace bq {
+struct Books;
+}
+
+namespace bq::md::svc {
+
+using OrderIdOfL3 = std::uint64_t;
+constexpr static OrderIdOfL3 INVALID_ORDER_ID_OF_L3 = UINT64_MAX;
+
+// Prices of cn market have at most 3 decimals, keep them as integers.
+using PriceOfL3 = std::int64_t;
+constexpr static std::int64_t PRICE_MULTI_OF_L3 = 10000;
+
+inline PriceOfL3 ToPriceOfL3(double price) {
+  return std::llround(price * PRICE_MULTI_OF_L3);
+}
+
+inline Decimal ToDecimal(PriceOfL3 price) {
+  return Decimal(price) / PRICE_MULTI_OF_L3;
+}
+
+struct OrderOfL3 {
+  Side side_{Side::Others};
+  PriceOfL3 price_{0};
+  std::int64_t size_{0};
+  bool isMarketOrder_{false};
+  PriceOfL3 lastTradePrice_{0};
+  // neighbours in the queue of the level the order rests at
+  OrderIdOfL3 prevOrderId_{INVALID_ORDER_ID_OF_L3};
+  OrderIdOfL3 nextOrderId_{INVALID_ORDER_ID_OF_L3};
+};
+using OrderId2OrderOfL3 = absl::flat_hash_map<OrderIdOfL3, OrderOfL3>;
+
+/*
+ * The orders of a level are queued in the order they rested at it, linked by
+ * their order ids, so the queue position of an order can be derived.
+ */
+struct LevelOfL3 {
+  std::int64_t size_{0};
+  std::uint32_t orderNum_{0};
+  OrderIdOfL3 headOrderId_{INVALID_ORDER_ID_OF_L3};
+  OrderIdOfL3 tailOrderId_{INVALID_ORDER_ID_OF_L3};
+};
+using AsksOfL3 = boost::container::flat_map<PriceOfL3, LevelOfL3>;
+using BidsOfL3 =
+    boost::container::flat_map<PriceOfL3, LevelOfL3, std::greater<PriceOfL3>>;
+
+/*
+ * Order by order book of one symbol built from tick by tick orders and trades.
+ *
+ * An incoming order which crosses the opposite side is an aggressor, it is
+ * kept out of the levels as the pending order until its trades have been
+ * applied, otherwise the book would be crossed between the order and its
+ * trades. A market order which traded rests its remainder at its last trade
+ * price, the remainder cancelled by the exchange is removed by the cancel
+ * record, a market order which did not trade is dropped. Trades and cancels
+ * of unknown orders are ignored, such as the aggressors of sse which are only
+ * published with their resting remainder.
+ */
+class L3Books {
+ public:
+  L3Books(const L3Books&) = delete;
+  L3Books& operator=(const L3Books&) = delete;
+  L3Books(const L3Books&&) = delete;
+  L3Books& operator=(const L3Books&&) = delete;
+
+  L3Books() = default;
+
+ public:
+  void addOrder(OrderIdOfL3 orderId, Side side, PriceOfL3 price,
+                std::int64_t size);
+  void addMarketOrder(OrderIdOfL3 orderId, Side side, std::int64_t size);
+
+  void onTrade(OrderIdOfL3 bidOrderId, OrderIdOfL3 askOrderId, PriceOfL3 price,
+               std::int64_t size);
+  void onCancel(OrderIdOfL3 orderId, std::int64_t size);
+
+  /*
+   * Rests the pending order once it no longer crosses the opposite side,
+   * called before the book is published.
+   */
+  void settle();
+
+  std::tuple<bool, PriceOfL3> getBestPrice(Side side) const;
+
+  void fillBooks(Books* books,
+                 std::uint32_t maxLevel = MAX_DEPTH_LEVEL) const;
+
+  const AsksOfL3& getAsks() const { return asks_; }
+  const BidsOfL3& getBids() const { return bids_; }
+  std::size_t getOrderNum() const { return orderId2Order_.size(); }
+
+  /*
+   * Returns the size and the num of the orders queued before the order at its
+   * level, false if the order does not rest in the book.
+   */
+  std::tuple<bool, std::int64_t, std::uint32_t> getQueuePos(
+      OrderIdOfL3 orderId) const;
+
+  // the ids of the orders of the level from the head of its queue
+  std::vector<OrderIdOfL3> getOrderIdGroupOfLevel(Side side,
+                                                  PriceOfL3 price) const;
+
+ private:
+  bool isCrossed(Side side, PriceOfL3 price) const;
+
+  void flushPendingOrder();
+  void restOrder(OrderIdOfL3 orderId, OrderOfL3& order);
+  void reduceOrder(OrderIdOfL3 orderId, std::int64_t size);
+  void unlinkOrder(LevelOfL3& level, const OrderOfL3& order);
+
+  const LevelOfL3* getLevel(Side side, PriceOfL3 price) const;
+
+ private:
+  OrderId2OrderOfL3 orderId2Order_;
+  AsksOfL3 asks_;
+  BidsOfL3 bids_;
+
+  bool hasPendingOrder_{false};
+  OrderIdOfL3 pendingOrderId_{0};
+
+  PriceOfL3 lastPrice_{0};
+  std::int64_t totalVol_{0};
+  std::int64_t totalAmt_{0};  // in units of price of l3
+  std::uint64_t tradesCount_{0};
+};
+
+}  // namespace bq::md::svc
@@ -0,0 +1,261 @@
+/*!
+ * \file L3Books.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/12/22
+ *
+ * \brief
+ */
+
+#include "L3Books.hpp"
+
+#include "def/MarketDataIF.hpp"
+
+namespace bq::md::svc {
+
+void L3Books::addOrder(OrderIdOfL3 orderId, Side side, PriceOfL3 price,
+                       std::int64_t size) {
+  flushPendingOrder();
+  if (size <= 0) return;
+
+  const auto [iter, isTheFirstTime] =
+      orderId2Order_.emplace(orderId, OrderOfL3{side, price, size});
+  if (!isTheFirstTime) return;
+
+  if (isCrossed(side, price)) {
+    hasPendingOrder_ = true;
+    pendingOrderId_ = orderId;
+  } else {
+    restOrder(orderId, iter->second);
+  }
+}
+
+void L3Books::addMarketOrder(OrderIdOfL3 orderId, Side side,
+                             std::int64_t size) {
+  flushPendingOrder();
+  if (size <= 0) return;
+
+  const auto [iter, isTheFirstTime] =
+      orderId2Order_.emplace(orderId, OrderOfL3{side, 0, size, true});
+  if (!isTheFirstTime) return;
+
+  hasPendingOrder_ = true;
+  pendingOrderId_ = orderId;
+}
+
+void L3Books::onTrade(OrderIdOfL3 bidOrderId, OrderIdOfL3 askOrderId,
+                      PriceOfL3 price, std::int64_t size) {
+  if (hasPendingOrder_ && pendingOrderId_ != bidOrderId &&
+      pendingOrderId_ != askOrderId) {
+    flushPendingOrder();
+  }
+
+  lastPrice_ = price;
+  totalVol_ += size;
+  totalAmt_ += price * size;
+  ++tradesCount_;
+
+  if (hasPendingOrder_) {
+    const auto iter = orderId2Order_.find(pendingOrderId_);
+    if (iter != std::end(orderId2Order_)) iter->second.lastTradePrice_ = price;
+  }
+
+  reduceOrder(bidOrderId, size);
+  reduceOrder(askOrderId, size);
+}
+
+void L3Books::onCancel(OrderIdOfL3 orderId, std::int64_t size) {
+  if (hasPendingOrder_ && pendingOrderId_ != orderId) {
+    flushPendingOrder();
+  }
+  reduceOrder(orderId, size);
+}
+
+void L3Books::settle() {
+  if (!hasPendingOrder_) return;
+  const auto iter = orderId2Order_.find(pendingOrderId_);
+  if (iter == std::end(orderId2Order_)) {
+    hasPendingOrder_ = false;
+    return;
+  }
+  const auto& order = iter->second;
+  if (order.isMarketOrder_) return;
+  if (!isCrossed(order.side_, order.price_)) flushPendingOrder();
+}
+
+std::tuple<bool, PriceOfL3> L3Books::getBestPrice(Side side) const {
+  if (side == Side::Bid) {
+    if (bids_.empty()) return {false, 0};
+    return {true, bids_.begin()->first};
+  } else {
+    if (asks_.empty()) return {false, 0};
+    return {true, asks_.begin()->first};
+  }
+}
+
+void L3Books::fillBooks(Books* books, std::uint32_t maxLevel) const {
+  maxLevel = std::min(maxLevel, MAX_DEPTH_LEVEL);
+
+  books->lastPrice_ = ToDecimal(lastPrice_);
+  books->totalVol_ = Decimal(totalVol_);
+  books->totalAmt_ = ToDecimal(totalAmt_);
+  books->tradesCount_ = tradesCount_;
+
+  const auto fillDepth = [maxLevel](Depth* depth, const auto& levels) {
+    std::uint32_t no = 0;
+    for (auto iter = std::begin(levels);
+         iter != std::end(levels) && no < maxLevel; ++iter, ++no) {
+      depth[no].price_ = ToDecimal(iter->first);
+      depth[no].size_ = Decimal(iter->second.size_);
+      depth[no].orderNum_ = iter->second.orderNum_;
+    }
+    for (; no < maxLevel; ++no) depth[no] = Depth();
+  };
+  fillDepth(books->asks_, asks_);
+  fillDepth(books->bids_, bids_);
+}
+
+bool L3Books::isCrossed(Side side, PriceOfL3 price) const {
+  if (side == Side::Bid) {
+    return !asks_.empty() && price >= asks_.begin()->first;
+  } else {
+    return !bids_.empty() && price <= bids_.begin()->first;
+  }
+}
+
+void L3Books::flushPendingOrder() {
+  if (!hasPendingOrder_) return;
+  hasPendingOrder_ = false;
+
+  const auto iter = orderId2Order_.find(pendingOrderId_);
+  if (iter == std::end(orderId2Order_)) return;
+
+  auto& order = iter->second;
+  if (order.isMarketOrder_) {
+    if (order.lastTradePrice_ == 0) {
+      orderId2Order_.erase(iter);
+      return;
+    }
+    order.price_ = order.lastTradePrice_;
+    order.isMarketOrder_ = false;
+  }
+  restOrder(pendingOrderId_, order);
+}
+
+void L3Books::restOrder(OrderIdOfL3 orderId, OrderOfL3& order) {
+  LevelOfL3* level = nullptr;
+  if (order.side_ == Side::Bid) {
+    level = &bids_[order.price_];
+  } else {
+    level = &asks_[order.price_];
+  }
+  level->size_ += order.size_;
+  ++level->orderNum_;
+
+  order.prevOrderId_ = level->tailOrderId_;
+  order.nextOrderId_ = INVALID_ORDER_ID_OF_L3;
+  if (level->tailOrderId_ == INVALID_ORDER_ID_OF_L3) {
+    level->headOrderId_ = orderId;
+  } else {
+    orderId2Order_.find(level->tailOrderId_)->second.nextOrderId_ = orderId;
+  }
+  level->tailOrderId_ = orderId;
+}
+
+void L3Books::reduceOrder(OrderIdOfL3 orderId, std::int64_t size) {
+  const auto iter = orderId2Order_.find(orderId);
+  if (iter == std::end(orderId2Order_)) return;
+
+  auto& order = iter->second;
+  size = std::min(size, order.size_);
+  order.size_ -= size;
+
+  const auto isPendingOrder = hasPendingOrder_ && pendingOrderId_ == orderId;
+  if (!isPendingOrder) {
+    const auto reduceLevel = [&](auto& levels) {
+      const auto iterOfLevel = levels.find(order.price_);
+      if (iterOfLevel == std::end(levels)) return;
+      auto& level = iterOfLevel->second;
+      level.size_ -= size;
+      if (order.size_ == 0) {
+        --level.orderNum_;
+        unlinkOrder(level, order);
+      }
+      if (level.orderNum_ == 0 || level.size_ <= 0) levels.erase(iterOfLevel);
+    };
+    if (order.side_ == Side::Bid) {
+      reduceLevel(bids_);
+    } else {
+      reduceLevel(asks_);
+    }
+  }
+
+  if (order.size_ == 0) {
+    orderId2Order_.erase(iter);
+    if (isPendingOrder) hasPendingOrder_ = false;
+  }
+}
+
+void L3Books::unlinkOrder(LevelOfL3& level, const OrderOfL3& order) {
+  if (order.prevOrderId_ == INVALID_ORDER_ID_OF_L3) {
+    level.headOrderId_ = order.nextOrderId_;
+  } else {
+    orderId2Order_.find(order.prevOrderId_)->second.nextOrderId_ =
+        order.nextOrderId_;
+  }
+  if (order.nextOrderId_ == INVALID_ORDER_ID_OF_L3) {
+    level.tailOrderId_ = order.prevOrderId_;
+  } else {
+    orderId2Order_.find(order.nextOrderId_)->second.prevOrderId_ =
+        order.prevOrderId_;
+  }
+}
+
+std::tuple<bool, std::int64_t, std::uint32_t> L3Books::getQueuePos(
+    OrderIdOfL3 orderId) const {
+  const auto iter = orderId2Order_.find(orderId);
+  if (iter == std::end(orderId2Order_)) return {false, 0, 0};
+  const auto& order = iter->second;
+  if (hasPendingOrder_ && pendingOrderId_ == orderId) return {false, 0, 0};
+  if (order.isMarketOrder_) return {false, 0, 0};
+
+  const auto level = getLevel(order.side_, order.price_);
+  if (!level) return {false, 0, 0};
+
+  std::int64_t sizeAhead = 0;
+  std::uint32_t numAhead = 0;
+  for (auto orderIdAhead = level->headOrderId_; orderIdAhead != orderId;) {
+    const auto& orderAhead = orderId2Order_.find(orderIdAhead)->second;
+    sizeAhead += orderAhead.size_;
+    ++numAhead;
+    orderIdAhead = orderAhead.nextOrderId_;
+  }
+  return {true, sizeAhead, numAhead};
+}
+
+std::vector<OrderIdOfL3> L3Books::getOrderIdGroupOfLevel(
+    Side side, PriceOfL3 price) const {
+  std::vector<OrderIdOfL3> ret;
+  const auto level = getLevel(side, price);
+  if (!level) return ret;
+  ret.reserve(level->orderNum_);
+  auto orderIdOfLevel = level->headOrderId_;
+  while (orderIdOfLevel != INVALID_ORDER_ID_OF_L3) {
+    ret.emplace_back(orderIdOfLevel);
+    orderIdOfLevel = orderId2Order_.find(orderIdOfLevel)->second.nextOrderId_;
+  }
+  return ret;
+}
+
+const LevelOfL3* L3Books::getLevel(Side side, PriceOfL3 price) const {
+  if (side == Side::Bid) {
+    const auto iter = bids_.find(price);
+    return iter == std::end(bids_) ? nullptr : &iter->second;
+  } else {
+    const auto iter = asks_.find(price);
+    return iter == std::end(asks_) ? nullptr : &iter->second;
+  }
+}
+
+}  // namespace bq::md::svc
@@ -13,6 +13,12 @@
 
 #include <string>
 
+#include "L3Books.hpp"
+#include "def/MarketDataIF.hpp"
+
+using namespace bq;
+using namespace bq::md::svc;
+
 class global_event : public testing::Environment {
  public:
   virtual void SetUp() {}
@@ -21,6 +27,88 @@ class global_event : public testing::Environment {
 
 TEST(test, test1) {}
 
+TEST(test, testL3Books) {
+  L3Books l3Books;
+  l3Books.addOrder(1, Side::Bid, ToPriceOfL3(10.01), 100);
+  l3Books.addOrder(2, Side::Bid, ToPriceOfL3(10.01), 200);
+  l3Books.addOrder(3, Side::Bid, ToPriceOfL3(10.00), 300);
+  l3Books.addOrder(4, Side::Ask, ToPriceOfL3(10.02), 400);
+  EXPECT_TRUE(l3Books.getBids().size() == 2);
+  EXPECT_TRUE(l3Books.getBids().begin()->second.size_ == 300);
+  EXPECT_TRUE(l3Books.getBids().begin()->second.orderNum_ == 2);
+
+  // An aggressor is kept out of the levels until its trades are applied.
+  l3Books.addOrder(5, Side::Ask, ToPriceOfL3(10.01), 500);
+  EXPECT_TRUE(std::get<1>(l3Books.getBestPrice(Side::Ask)) ==
+              ToPriceOfL3(10.02));
+  l3Books.onTrade(1, 5, ToPriceOfL3(10.01), 100);
+  l3Books.onTrade(2, 5, ToPriceOfL3(10.01), 200);
+  l3Books.settle();
+  EXPECT_TRUE(std::get<1>(l3Books.getBestPrice(Side::Bid)) ==
+              ToPriceOfL3(10.00));
+  EXPECT_TRUE(std::get<1>(l3Books.getBestPrice(Side::Ask)) ==
+              ToPriceOfL3(10.01));
+  EXPECT_TRUE(l3Books.getAsks().begin()->second.size_ == 200);
+
+  // Cancel part of the order then the rest of it.
+  l3Books.onCancel(3, 100);
+  EXPECT_TRUE(l3Books.getBids().begin()->second.size_ == 200);
+  l3Books.onCancel(3, 200);
+  EXPECT_TRUE(l3Books.getBids().empty());
+
+  // Market order which does not trade is dropped.
+  l3Books.addMarketOrder(6, Side::Bid, 100);
+  l3Books.onCancel(6, 100);
+  EXPECT_TRUE(l3Books.getBids().empty());
+
+  // Remainder of a market order which traded rests at its last trade price.
+  l3Books.addMarketOrder(7, Side::Bid, 300);
+  l3Books.onTrade(7, 5, ToPriceOfL3(10.01), 200);
+  l3Books.addOrder(8, Side::Ask, ToPriceOfL3(10.03), 100);
+  EXPECT_TRUE(std::get<1>(l3Books.getBestPrice(Side::Bid)) ==
+              ToPriceOfL3(10.01));
+  EXPECT_TRUE(l3Books.getBids().begin()->second.size_ == 100);
+  EXPECT_TRUE(l3Books.getOrderNum() == 3);
+
+  auto books = std::make_unique<Books>();
+  l3Books.fillBooks(books.get());
+  EXPECT_TRUE(books->tradesCount_ == 3);
+  EXPECT_TRUE(books->totalVol_ == 500);
+  EXPECT_TRUE(books->asks_[0].price_ == ToDecimal(ToPriceOfL3(10.02)));
+  EXPECT_TRUE(books->asks_[0].size_ == 400);
+  EXPECT_TRUE(books->asks_[1].size_ == 100);
+  EXPECT_TRUE(books->asks_[2].size_ == 0);
+  EXPECT_TRUE(books->bids_[0].orderNum_ == 1);
+}
+
+TEST(test, testQueueOfL3Books) {
+  L3Books l3Books;
+  for (OrderIdOfL3 orderId = 1; orderId <= 4; ++orderId) {
+    l3Books.addOrder(orderId, Side::Bid, ToPriceOfL3(10.01), orderId * 100);
+  }
+  EXPECT_TRUE(l3Books.getOrderIdGroupOfLevel(Side::Bid, ToPriceOfL3(10.01)) ==
+              std::vector<OrderIdOfL3>({1, 2, 3, 4}));
+  const auto [found, sizeAhead, numAhead] = l3Books.getQueuePos(3);
+  EXPECT_TRUE(found && sizeAhead == 300 && numAhead == 2);
+
+  // The head is filled first, cancels leave the rest of the queue in order.
+  l3Books.addOrder(5, Side::Ask, ToPriceOfL3(10.01), 150);
+  l3Books.onTrade(1, 5, ToPriceOfL3(10.01), 100);
+  l3Books.onTrade(2, 5, ToPriceOfL3(10.01), 50);
+  l3Books.onCancel(3, 300);
+  l3Books.addOrder(6, Side::Bid, ToPriceOfL3(10.01), 600);
+  EXPECT_TRUE(l3Books.getOrderIdGroupOfLevel(Side::Bid, ToPriceOfL3(10.01)) ==
+              std::vector<OrderIdOfL3>({2, 4, 6}));
+  const auto [foundOf6, sizeAheadOf6, numAheadOf6] = l3Books.getQueuePos(6);
+  EXPECT_TRUE(foundOf6 && sizeAheadOf6 == 550 && numAheadOf6 == 2);
+
+  l3Books.onCancel(6, 600);
+  l3Books.onCancel(2, 150);
+  EXPECT_TRUE(l3Books.getOrderIdGroupOfLevel(Side::Bid, ToPriceOfL3(10.01)) ==
+              std::vector<OrderIdOfL3>({4}));
+  EXPECT_FALSE(std::get<0>(l3Books.getQueuePos(6)));
+}
+
 int main(int argc, char** argv) {
   testing::AddGlobalTestEnvironment(new global_event);
   testing::InitGoogleTest(&argc, argv);
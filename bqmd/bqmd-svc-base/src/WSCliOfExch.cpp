@@ -25,6 +25,7 @@
 #include "util/BQMDUtil.hpp"
 #include "util/Datetime.hpp"
 #include "util/FlowCtrlSvc.hpp"
+#include "util/LatencyHist.hpp"
 #include "util/Literal.hpp"
 #include "util/String.hpp"
 
@@ -180,9 +181,7 @@ void WSCliOfExch::handleAsyncTask(WSCliAsyncTaskSPtr& asyncTask) {
     updateActiveTimeOfTopic(topic);
   }
 
-#ifdef PERF_TEST
-  EXEC_PERF_TEST("HandleAsyncTask", asyncTask->task_->localTs_, 10000, 100);
-#endif
+  LATENCY_PROBE("MDSvc.HandleAsyncTask", asyncTask->task_->localTs_);
 
   if (!topic.empty() && mdSvc_->saveMarketData()) {
     mdSvc_->getMDStorageSvc()->handle(asyncTask);
@@ -0,0 +1,103 @@
+/*!
+ * \file L3BooksBuilderOfXTP.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/12/22
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "L3Books.hpp"
+#include "def/BQDef.hpp"
+#include "util/Pch.hpp"
+#include "xtp_quote_api.h"
+
+namespace bq::md::svc {
+class MDSvcOfCN;
+}
+
+namespace bq::md::svc::xtp {
+
+struct TBTOfXTP {
+  XTPTBT tbt_;
+  std::uint64_t localTs_{0};
+};
+
+struct L3BooksOfSymbol {
+  L3Books l3Books_;
+  MarketCode marketCode_;
+  std::string symbolCode_;
+  TopicHash topicHash_{0};
+  std::int64_t dataTime_{0};
+  std::uint64_t localTs_{0};
+  bool dirty_{false};
+};
+using L3BooksOfSymbolSPtr = std::shared_ptr<L3BooksOfSymbol>;
+using Ticker2L3BooksOfSymbol =
+    absl::flat_hash_map<std::string, L3BooksOfSymbolSPtr>;
+
+/*
+ * Tick by tick data of szse shares one sequence of entrust and trade in each
+ * channel, while sse numbers them separately. Once a gap is found the books
+ * of the channel can not be trusted any more, they are no longer published.
+ */
+struct ChannelOfTBT {
+  std::int64_t expectedSeqOfEntrust_{1};
+  std::int64_t expectedSeqOfTrade_{1};
+  bool stale_{false};
+  Ticker2L3BooksOfSymbol ticker2L3Books_;
+};
+using ChannelOfTBTSPtr = std::shared_ptr<ChannelOfTBT>;
+using ChannelNo2ChannelOfTBT =
+    absl::flat_hash_map<std::uint64_t, ChannelOfTBTSPtr>;
+
+/*
+ * Rebuilds the full depth books from the tick by tick stream. Channels are
+ * sharded over the worker threads so that entrusts and trades of a symbol
+ * are applied in order, books touched by a batch of the stream are published
+ * once at the end of the batch.
+ */
+class L3BooksBuilderOfXTP {
+ public:
+  L3BooksBuilderOfXTP(const L3BooksBuilderOfXTP&) = delete;
+  L3BooksBuilderOfXTP& operator=(const L3BooksBuilderOfXTP&) = delete;
+  L3BooksBuilderOfXTP(const L3BooksBuilderOfXTP&&) = delete;
+  L3BooksBuilderOfXTP& operator=(const L3BooksBuilderOfXTP&&) = delete;
+
+  explicit L3BooksBuilderOfXTP(MDSvcOfCN const* mdSvc);
+
+ public:
+  void start();
+  void stop();
+
+ public:
+  void dispatch(const XTPTBT* tbt);
+
+ private:
+  void doStart(std::uint32_t threadNo);
+
+  L3BooksOfSymbol* handle(ChannelNo2ChannelOfTBT& channelNo2Channel,
+                          const TBTOfXTP& tbtOfXTP);
+  bool checkSeq(ChannelOfTBT& channel, const XTPTBT& tbt);
+
+  void handleEntrust(L3BooksOfSymbol& l3BooksOfSymbol, const XTPTBT& tbt);
+  void handleTrade(L3BooksOfSymbol& l3BooksOfSymbol, const XTPTBT& tbt);
+
+  void pub(L3BooksOfSymbol& l3BooksOfSymbol, const std::string& tradingDay);
+
+ private:
+  MDSvcOfCN const* mdSvc_{nullptr};
+
+  std::uint32_t numOfThread_{4};
+  std::uint32_t maxBulkRecvTBTNumEveryTime_{256};
+
+  std::atomic_bool stopped_{false};
+  std::vector<moodycamel::BlockingConcurrentQueue<TBTOfXTP>> tbtQueueGroup_;
+  std::vector<std::thread> threadPool_;
+};
+using L3BooksBuilderOfXTPSPtr = std::shared_ptr<L3BooksBuilderOfXTP>;
+
+}  // namespace bq::md::svc::xtp
@@ -24,6 +24,9 @@ namespace bq::md::svc::xtp {
 class BQQuoteSpi;
 using BQQuoteSpiSPtr = std::shared_ptr<BQQuoteSpi>;
 
+class L3BooksBuilderOfXTP;
+using L3BooksBuilderOfXTPSPtr = std::shared_ptr<L3BooksBuilderOfXTP>;
+
 class MDSvcOfXTP : public MDSvcOfCN {
  public:
   MDSvcOfXTP(const MDSvcOfXTP&) = delete;
@@ -50,8 +53,14 @@ class MDSvcOfXTP : public MDSvcOfCN {
   void doSub(const MarketDataCondGroup& marketDataCond) final;
   void doUnSub(const MarketDataCondGroup& marketDataCond) final;
 
+  bool isL3Books(const MarketDataCondSPtr& marketDataCond) const;
+
+ public:
+  L3BooksBuilderOfXTPSPtr getL3BooksBuilder() const { return l3BooksBuilder_; }
+
  private:
   XTP::API::QuoteApi* api_{nullptr};
+  L3BooksBuilderOfXTPSPtr l3BooksBuilder_{nullptr};
 };
 
 }  // namespace bq::md::svc::xtp
@@ -11,6 +11,7 @@
 #include "BQQuoteSpi.hpp"
 
 #include "Config.hpp"
+#include "L3BooksBuilderOfXTP.hpp"
 #include "MDSvcOfXTP.hpp"
 #include "MDSvcOfXTPUtil.hpp"
 #include "RawMDHandler.hpp"
@@ -239,6 +240,12 @@ void BQQuoteSpi::OnDepthMarketData(XTPMD *market_data, int64_t bid1_qty[],
 }
 
 void BQQuoteSpi::OnTickByTick(XTPTBT *tbt_data) {
+  const auto l3BooksBuilder =
+      static_cast<MDSvcOfXTP *>(mdSvc_)->getL3BooksBuilder();
+  if (l3BooksBuilder) {
+    l3BooksBuilder->dispatch(tbt_data);
+  }
+
   switch (tbt_data->type) {
     case XTP_TBT_TRADE: {
       auto rawMD = mdSvc_->getRawMDHandler()->makeRawMD(
@@ -0,0 +1,256 @@
+/*!
+ * \file L3BooksBuilderOfXTP.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/12/22
+ *
+ * \brief
+ */
+
+#include "L3BooksBuilderOfXTP.hpp"
+
+#include "Config.hpp"
+#include "MDSvcOfCN.hpp"
+#include "MDSvcOfXTPUtil.hpp"
+#include "SHMIPCConst.hpp"
+#include "SHMIPCMsgId.hpp"
+#include "SHMSrv.hpp"
+#include "def/BQConst.hpp"
+#include "def/DataStruOfMD.hpp"
+#include "util/BQUtil.hpp"
+#include "util/Datetime.hpp"
+#include "util/Logger.hpp"
+#include "util/String.hpp"
+
+namespace bq::md::svc::xtp {
+
+L3BooksBuilderOfXTP::L3BooksBuilderOfXTP(MDSvcOfCN const* mdSvc)
+    : mdSvc_(mdSvc),
+      numOfThread_(
+          std::max(CONFIG["l3BooksBuilder"]["numOfThread"].as<std::uint32_t>(4),
+                   1U)),
+      maxBulkRecvTBTNumEveryTime_(
+          CONFIG["l3BooksBuilder"]["maxBulkRecvTBTNumEveryTime"]
+              .as<std::uint32_t>(256)),
+      tbtQueueGroup_(numOfThread_) {}
+
+void L3BooksBuilderOfXTP::start() {
+  stopped_ = false;
+  for (std::uint32_t threadNo = 0; threadNo < numOfThread_; ++threadNo) {
+    threadPool_.emplace_back([this, threadNo]() { doStart(threadNo); });
+  }
+  LOG_I("Start l3 books builder. [numOfThread = {}]", numOfThread_);
+}
+
+void L3BooksBuilderOfXTP::stop() {
+  stopped_ = true;
+  for (auto& thread : threadPool_) {
+    if (thread.joinable()) thread.join();
+  }
+  threadPool_.clear();
+}
+
+void L3BooksBuilderOfXTP::dispatch(const XTPTBT* tbt) {
+  std::int32_t channelNo = 0;
+  switch (tbt->type) {
+    case XTP_TBT_ENTRUST:
+      channelNo = tbt->entrust.channel_no;
+      break;
+    case XTP_TBT_TRADE:
+      channelNo = tbt->trade.channel_no;
+      break;
+    default:
+      return;
+  }
+  const auto threadNo = static_cast<std::uint32_t>(channelNo) % numOfThread_;
+  tbtQueueGroup_[threadNo].enqueue(TBTOfXTP{*tbt, GetTotalUSSince1970OfHotPath()});
+}
+
+void L3BooksBuilderOfXTP::doStart(std::uint32_t threadNo) {
+  auto& tbtQueue = tbtQueueGroup_[threadNo];
+
+  ChannelNo2ChannelOfTBT channelNo2Channel;
+  std::vector<TBTOfXTP> tbtGroup(maxBulkRecvTBTNumEveryTime_);
+  std::vector<L3BooksOfSymbol*> dirtyGroup;
+
+  while (stopped_ == false || tbtQueue.size_approx() != 0) {
+    const auto tbtNumInQue = tbtQueue.wait_dequeue_bulk_timed(
+        std::begin(tbtGroup), maxBulkRecvTBTNumEveryTime_,
+        std::chrono::milliseconds(10));
+    if (tbtNumInQue == 0) continue;
+
+    for (std::size_t i = 0; i < tbtNumInQue; ++i) {
+      const auto l3BooksOfSymbol = handle(channelNo2Channel, tbtGroup[i]);
+      if (l3BooksOfSymbol && !l3BooksOfSymbol->dirty_) {
+        l3BooksOfSymbol->dirty_ = true;
+        dirtyGroup.emplace_back(l3BooksOfSymbol);
+      }
+    }
+
+    // books touched many times in the batch are only published once
+    const auto tradingDay = mdSvc_->getTradingDay();
+    for (const auto l3BooksOfSymbol : dirtyGroup) {
+      l3BooksOfSymbol->dirty_ = false;
+      pub(*l3BooksOfSymbol, tradingDay);
+    }
+    dirtyGroup.clear();
+  }
+}
+
+L3BooksOfSymbol* L3BooksBuilderOfXTP::handle(
+    ChannelNo2ChannelOfTBT& channelNo2Channel, const TBTOfXTP& tbtOfXTP) {
+  const auto& tbt = tbtOfXTP.tbt_;
+  const auto channelNo = tbt.type == XTP_TBT_TRADE ? tbt.trade.channel_no
+                                                   : tbt.entrust.channel_no;
+  const auto key = static_cast<std::uint64_t>(tbt.exchange_id) << 32 |
+                   static_cast<std::uint32_t>(channelNo);
+
+  auto iterOfChannel = channelNo2Channel.find(key);
+  if (iterOfChannel == std::end(channelNo2Channel)) {
+    iterOfChannel =
+        channelNo2Channel.emplace(key, std::make_shared<ChannelOfTBT>()).first;
+  }
+  auto& channel = *iterOfChannel->second;
+  if (!checkSeq(channel, tbt)) return nullptr;
+
+  auto iterOfBooks = channel.ticker2L3Books_.find(tbt.ticker);
+  if (iterOfBooks == std::end(channel.ticker2L3Books_)) {
+    auto l3BooksOfSymbol = std::make_shared<L3BooksOfSymbol>();
+    l3BooksOfSymbol->marketCode_ = GetMarketCode(tbt.exchange_id);
+    l3BooksOfSymbol->symbolCode_ = tbt.ticker;
+    l3BooksOfSymbol->topicHash_ = std::get<1>(MakeTopicInfo(
+        GetMarketName(l3BooksOfSymbol->marketCode_),
+        ENUM_TO_STR(SymbolType::Spot), l3BooksOfSymbol->symbolCode_,
+        MDType::Books, Int2StrInCompileTime<MAX_DEPTH_LEVEL>::type::value));
+    iterOfBooks =
+        channel.ticker2L3Books_.emplace(tbt.ticker, l3BooksOfSymbol).first;
+  }
+  auto& l3BooksOfSymbol = *iterOfBooks->second;
+  l3BooksOfSymbol.dataTime_ = tbt.data_time;
+  l3BooksOfSymbol.localTs_ = tbtOfXTP.localTs_;
+
+  if (tbt.type == XTP_TBT_TRADE) {
+    handleTrade(l3BooksOfSymbol, tbt);
+  } else {
+    handleEntrust(l3BooksOfSymbol, tbt);
+  }
+  return &l3BooksOfSymbol;
+}
+
+bool L3BooksBuilderOfXTP::checkSeq(ChannelOfTBT& channel, const XTPTBT& tbt) {
+  const auto isTrade = tbt.type == XTP_TBT_TRADE;
+  const auto seq = isTrade ? tbt.trade.seq : tbt.entrust.seq;
+  auto& expectedSeq = isTrade && tbt.exchange_id == XTP_EXCHANGE_SH
+                          ? channel.expectedSeqOfTrade_
+                          : channel.expectedSeqOfEntrust_;
+
+  if (seq < expectedSeq) return false;
+  if (seq > expectedSeq && !channel.stale_) {
+    channel.stale_ = true;
+    LOG_W(
+        "Found gap of tick by tick data in channel {} of {}, "
+        "stop publishing l3 books of the channel. "
+        "[expectedSeq = {}, seq = {}]",
+        isTrade ? tbt.trade.channel_no : tbt.entrust.channel_no,
+        GetMarketName(GetMarketCode(tbt.exchange_id)), expectedSeq, seq);
+  }
+  expectedSeq = seq + 1;
+  return !channel.stale_;
+}
+
+void L3BooksBuilderOfXTP::handleEntrust(L3BooksOfSymbol& l3BooksOfSymbol,
+                                        const XTPTBT& tbt) {
+  const auto& entrust = tbt.entrust;
+  const auto side =
+      GetSideFromOrders(l3BooksOfSymbol.marketCode_, entrust.side);
+  if (side == Side::Others) return;
+
+  auto& l3Books = l3BooksOfSymbol.l3Books_;
+  if (l3BooksOfSymbol.marketCode_ == MarketCode::SSE) {
+    // sse refers to orders by order_no both in entrusts and trades
+    switch (entrust.ord_type) {
+      case 'A':
+        l3Books.addOrder(entrust.order_no, side, ToPriceOfL3(entrust.price),
+                         entrust.qty);
+        break;
+      case 'D':
+        l3Books.onCancel(entrust.order_no, entrust.qty);
+        break;
+      default:
+        break;
+    }
+  } else {
+    switch (entrust.ord_type) {
+      case '2':
+        l3Books.addOrder(entrust.seq, side, ToPriceOfL3(entrust.price),
+                         entrust.qty);
+        break;
+      case '1':
+        l3Books.addMarketOrder(entrust.seq, side, entrust.qty);
+        break;
+      case 'U': {
+        const auto [hasBestPrice, bestPrice] = l3Books.getBestPrice(side);
+        if (hasBestPrice) {
+          l3Books.addOrder(entrust.seq, side, bestPrice, entrust.qty);
+        } else {
+          l3Books.addMarketOrder(entrust.seq, side, entrust.qty);
+        }
+      } break;
+      default:
+        break;
+    }
+  }
+}
+
+void L3BooksBuilderOfXTP::handleTrade(L3BooksOfSymbol& l3BooksOfSymbol,
+                                      const XTPTBT& tbt) {
+  const auto& trade = tbt.trade;
+  auto& l3Books = l3BooksOfSymbol.l3Books_;
+  if (l3BooksOfSymbol.marketCode_ == MarketCode::SZSE &&
+      trade.trade_flag == '4') {
+    // cancel of szse is published as a trade with one of the order no
+    const auto orderId = trade.bid_no != 0 ? trade.bid_no : trade.ask_no;
+    l3Books.onCancel(orderId, trade.qty);
+    return;
+  }
+  l3Books.onTrade(trade.bid_no, trade.ask_no, ToPriceOfL3(trade.price),
+                  trade.qty);
+}
+
+void L3BooksBuilderOfXTP::pub(L3BooksOfSymbol& l3BooksOfSymbol,
+                              const std::string& tradingDay) {
+  const auto shmSrv = mdSvc_->getSHMSrv(l3BooksOfSymbol.marketCode_);
+  if (!shmSrv) {
+    LOG_W("Invalid market code {}.",
+          GetMarketName(l3BooksOfSymbol.marketCode_));
+    return;
+  }
+
+  auto& l3Books = l3BooksOfSymbol.l3Books_;
+  l3Books.settle();
+
+  const auto exchTs =
+      ConvertDatetimeToTs(l3BooksOfSymbol.dataTime_) - USEC_DIFF_OF_CN;
+
+  shmSrv->pushMsgWithZeroCopy(
+      [&](void* shmBuf) {
+        auto books = static_cast<Books*>(shmBuf);
+        books->shmHeader_.topicHash_ = l3BooksOfSymbol.topicHash_;
+        books->mdHeader_.exchTs_ = exchTs;
+        books->mdHeader_.localTs_ = l3BooksOfSymbol.localTs_;
+        books->mdHeader_.marketCode_ = l3BooksOfSymbol.marketCode_;
+        books->mdHeader_.symbolType_ = SymbolType::Spot;
+        strncpy(books->mdHeader_.symbolCode_,
+                l3BooksOfSymbol.symbolCode_.c_str(),
+                sizeof(books->mdHeader_.symbolCode_) - 1);
+        books->mdHeader_.mdType_ = MDType::Books;
+        l3Books.fillBooks(books);
+        strncpy(books->tradingDay_, tradingDay.c_str(),
+                sizeof(books->tradingDay_) - 1);
+        books->extDataLen_ = 0;
+      },
+      PUB_CHANNEL, MSG_ID_ON_MD_BOOKS, sizeof(Books));
+}
+
+}  // namespace bq::md::svc::xtp
@@ -13,6 +13,7 @@
 #include "API.hpp"
 #include "BQQuoteSpi.hpp"
 #include "Config.hpp"
+#include "L3BooksBuilderOfXTP.hpp"
 #include "MDStorageSvc.hpp"
 #include "MDSvcOfXTPUtil.hpp"
 #include "RawMDHandlerOfXTP.hpp"
@@ -44,6 +45,10 @@ int MDSvcOfXTP::beforeInit() {
   const auto raMDHandler = std::make_shared<RawMDHandlerOfXTP>(this);
   setRawMDHandler(raMDHandler);
 
+  if (CONFIG["l3BooksBuilder"]["enable"].as<bool>(false)) {
+    l3BooksBuilder_ = std::make_shared<L3BooksBuilderOfXTP>(this);
+  }
+
   return 0;
 }
 
@@ -55,6 +60,10 @@ int MDSvcOfXTP::startGateway() {
     api_ = nullptr;
   }
 
+  if (l3BooksBuilder_) {
+    l3BooksBuilder_->start();
+  }
+
 #ifdef _NDEBUG
   XTP_LOG_LEVEL logLevel = XTP_LOG_LEVEL_INFO;
 #else
@@ -103,6 +112,10 @@ void MDSvcOfXTP::stopGateway() {
     api_->Release();
     api_ = nullptr;
   }
+
+  if (l3BooksBuilder_) {
+    l3BooksBuilder_->stop();
+  }
 }
 
 void MDSvcOfXTP::doSub(const MarketDataCondGroup& marketDataCondGroup) {
@@ -113,7 +126,10 @@ void MDSvcOfXTP::doSub(const MarketDataCondGroup& marketDataCondGroup) {
 
   for (const auto& marketDataCond : marketDataCondGroup) {
     const auto exchMarketCode = GetExchMarketCode(marketDataCond->marketCode_);
-    const auto key = std::make_tuple(exchMarketCode, marketDataCond->mdType_);
+    auto mdType = marketDataCond->mdType_;
+    // books of full depth are rebuilt from tick by tick data
+    if (isL3Books(marketDataCond)) mdType = MDType::Orders;
+    const auto key = std::make_tuple(exchMarketCode, mdType);
     m[key].emplace_back(marketDataCond);
   }
 
@@ -164,6 +180,8 @@ void MDSvcOfXTP::doUnSub(const MarketDataCondGroup& marketDataCondGroup) {
   std::map<KeyType, ValType> m;
 
   for (const auto& marketDataCond : marketDataCondGroup) {
+    // tick by tick data may still be needed by trades and orders
+    if (isL3Books(marketDataCond)) continue;
     const auto exchMarketCode = GetExchMarketCode(marketDataCond->marketCode_);
     const auto key = std::make_tuple(exchMarketCode, marketDataCond->mdType_);
     m[key].emplace_back(marketDataCond);
@@ -211,4 +229,10 @@ void MDSvcOfXTP::doUnSub(const MarketDataCondGroup& marketDataCondGroup) {
   }
 }
 
+bool MDSvcOfXTP::isL3Books(const MarketDataCondSPtr& marketDataCond) const {
+  return l3BooksBuilder_ && marketDataCond->mdType_ == MDType::Books &&
+         marketDataCond->ext_ ==
+             Int2StrInCompileTime<MAX_DEPTH_LEVEL>::type::value;
+}
+
 }  // namespace bq::md::svc::xtp
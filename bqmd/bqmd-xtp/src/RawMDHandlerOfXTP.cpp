@@ -285,7 +285,7 @@ bool RawMDHandlerOfXTP::handleMDTrades(RawMDAsyncTaskSPtr& asyncTask) {
   trades->mdHeader_.mdType_ = asyncTask->task_->mdType_;
   trades->mdHeader_.exchTs_ = exchTs;
 
-  trades->tradeTime_ = ConvertDatetimeToTs(md->data_time) - USEC_DIFF_OF_CN;
+  trades->tradeTime_ = exchTs;
   snprintf(trades->tradeNo_, sizeof(trades->tradeNo_) - 1, "%d-%" PRIu64 "",
            md->trade.channel_no, md->trade.seq);
   trades->side_ =
@@ -336,7 +336,7 @@ bool RawMDHandlerOfXTP::handleMDOrders(RawMDAsyncTaskSPtr& asyncTask) {
   orders->mdHeader_.mdType_ = asyncTask->task_->mdType_;
   orders->mdHeader_.exchTs_ = exchTs;
 
-  orders->orderTime_ = ConvertDatetimeToTs(md->data_time) - USEC_DIFF_OF_CN;
+  orders->orderTime_ = exchTs;
   snprintf(orders->orderNo_, sizeof(orders->orderNo_) - 1, "%d-%" PRIu64 "",
            md->entrust.channel_no, md->entrust.seq);
   orders->side_ =
@@ -10,21 +10,112 @@
 
 #include <benchmark/benchmark.h>
 
+#include "OrdMgr.hpp"
+#include "def/DataStruOfTD.hpp"
+
+using namespace bq;
+
+namespace {
+
+constexpr ExchOrderId EXCH_ORDER_ID_BASE = 100000000;
+
+OrderInfoSPtr MakeOrderInfo(OrderId orderId) {
+  auto ret = std::make_shared<OrderInfo>();
+  ret->orderId_ = orderId;
+  ret->exchOrderId_ = EXCH_ORDER_ID_BASE + orderId;
+  ret->acctId_ = orderId % 100;
+  ret->marketCode_ = MarketCode::Binance;
+  ret->symbolType_ = SymbolType::Perp;
+  strncpy(ret->symbolCode_, "BTC-USDT-PERP", sizeof(ret->symbolCode_) - 1);
+  ret->side_ = Side::Bid;
+  ret->posSide_ = PosSide::Long;
+  ret->orderPrice_ = 16500;
+  ret->orderSize_ = 10;
+  ret->orderStatus_ = OrderStatus::ConfirmedByExch;
+  return ret;
+}
+
+}  // namespace
+
 class FixtureTest : public benchmark::Fixture {
  public:
-  void SetUp(const ::benchmark::State& state) {}
-  void TearDown(const ::benchmark::State& state) {}
+  void SetUp(const ::benchmark::State& state) {
+    ordMgr_ = std::make_shared<OrdMgr>();
+    const OrderId numOfOrder = state.range(0);
+    for (OrderId orderId = 1; orderId <= numOfOrder; ++orderId) {
+      ordMgr_->add(MakeOrderInfo(orderId), DeepClone::False);
+    }
+  }
+  void TearDown(const ::benchmark::State& state) { ordMgr_.reset(); }
+
+ protected:
+  std::shared_ptr<OrdMgr> ordMgr_;
 };
 
-BENCHMARK_DEFINE_F(FixtureTest, test)(benchmark::State& st) {
+/*
+ * Unclosed orders kept by ordmgr are range(0), an order is added on order req
+ * and removed when it is closed.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, addAndRemove)(benchmark::State& st) {
+  const auto orderInfo = MakeOrderInfo(st.range(0) + 1);
   for (auto _ : st) {
-    int times = st.range(0);
-    for (int i = 0; i < times; ++i) {
-    }
+    ordMgr_->add(orderInfo, DeepClone::True);
+    ordMgr_->remove(orderInfo->orderId_);
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, addAndRemove)->Arg(1000)->Arg(100000);
+
+BENCHMARK_DEFINE_F(FixtureTest, getOrderInfo)(benchmark::State& st) {
+  OrderId orderId = 0;
+  for (auto _ : st) {
+    orderId = orderId % st.range(0) + 1;
+    benchmark::DoNotOptimize(ordMgr_->getOrderInfo(orderId, DeepClone::False));
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, getOrderInfo)->Arg(1000)->Arg(100000);
+
+BENCHMARK_DEFINE_F(FixtureTest, getOrderInfoByExchOrderId)
+(benchmark::State& st) {
+  OrderId orderId = 0;
+  for (auto _ : st) {
+    orderId = orderId % st.range(0) + 1;
+    benchmark::DoNotOptimize(ordMgr_->getOrderInfo(
+        MarketCode::Binance, EXCH_ORDER_ID_BASE + orderId, DeepClone::False));
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, getOrderInfoByExchOrderId)
+    ->Arg(1000)
+    ->Arg(100000);
+
+/*
+ * Order rets of the exch which leave the orders unclosed, found by exch order
+ * id as the order id is unknown to most of the exchs.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, updateByOrderInfoFromExch)
+(benchmark::State& st) {
+  std::vector<OrderInfoSPtr> orderInfoFromExchGroup;
+  const OrderId numOfOrder = st.range(0);
+  for (OrderId orderId = 1; orderId <= numOfOrder; ++orderId) {
+    auto orderInfoFromExch = MakeOrderInfo(orderId);
+    orderInfoFromExch->orderId_ = 0;
+    orderInfoFromExch->orderStatus_ = OrderStatus::PartialFilled;
+    orderInfoFromExch->dealSize_ = 1;
+    orderInfoFromExch->avgDealPrice_ = 16500;
+    orderInfoFromExch->lastDealSize_ = 1;
+    orderInfoFromExch->lastDealPrice_ = 16500;
+    orderInfoFromExchGroup.emplace_back(orderInfoFromExch);
+  }
+
+  std::size_t no = 0;
+  std::uint64_t noUsedToCalcPos = 0;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(ordMgr_->updateByOrderInfoFromExch(
+        orderInfoFromExchGroup[no], ++noUsedToCalcPos, DeepClone::True));
+    no = (no + 1) % orderInfoFromExchGroup.size();
   }
 }
-BENCHMARK_REGISTER_F(FixtureTest, test)
-    ->Unit(benchmark::kMicrosecond)
-    ->Arg(1000);
+BENCHMARK_REGISTER_F(FixtureTest, updateByOrderInfoFromExch)
+    ->Arg(1000)
+    ->Arg(100000);
 
 BENCHMARK_MAIN();
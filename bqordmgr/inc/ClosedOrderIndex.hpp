@@ -0,0 +1,104 @@
+/*!
+ * \file ClosedOrderIndex.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "def/BQDef.hpp"
+#include "def/Def.hpp"
+#include "def/OrderInfo.hpp"
+#include "util/Pch.hpp"
+
+namespace bq {
+
+enum class TypeOfLateReport {
+  // no tombstone of the order, it was never in the ord mgr or is too old
+  NotFound = 1,
+  // the same deal size and status as the order when it was closed
+  Duplicate = 2,
+  // an older state of the order, overtaken by the report that closed it
+  Stale = 3,
+  // more is dealed than when the order was closed, a fill was lost
+  Missed = 4
+};
+
+struct StatOfLateReport {
+  std::uint64_t numOfNotFound_{0};
+  std::uint64_t numOfDuplicate_{0};
+  std::uint64_t numOfStale_{0};
+  std::uint64_t numOfMissed_{0};
+};
+
+/*
+ * Tombstones of the most recently closed orders in a ring, indexed by order id
+ * and by market code + exch order id, so a report of an order which has left
+ * the ord mgr is classified in O(1). All the memory is taken in the ctor, the
+ * oldest tombstone is overwritten once the ring is full.
+ *
+ * Not thread safe, the caller guards it together with its orders.
+ */
+class ClosedOrderIndex {
+  struct Tombstone {
+    OrderId orderId_{0};
+    MarketCode marketCode_{MarketCode::Others};
+    ExchOrderId exchOrderId_{0};
+    // abs of the deal size, which is negative for the ask orders in ord mgr
+    Decimal dealSize_{0};
+    OrderStatus orderStatus_{OrderStatus::Others};
+  };
+
+  // slot of the index holds no of the tombstone in the ring + 1, 0 if empty
+  using Index = std::vector<std::uint32_t>;
+
+ public:
+  ClosedOrderIndex(const ClosedOrderIndex&) = delete;
+  ClosedOrderIndex& operator=(const ClosedOrderIndex&) = delete;
+  ClosedOrderIndex(const ClosedOrderIndex&&) = delete;
+  ClosedOrderIndex& operator=(const ClosedOrderIndex&&) = delete;
+
+  explicit ClosedOrderIndex(std::uint32_t capacity = 65536);
+
+ public:
+  void add(const OrderInfo& orderInfo);
+
+  // the deal size of the tombstone is raised to the one of a missed report,
+  // so the same report received again is a duplicate
+  TypeOfLateReport classify(const OrderInfo& orderInfo);
+
+  const StatOfLateReport& getStatOfLateReport() const {
+    return statOfLateReport_;
+  }
+
+  std::size_t size() const { return size_; }
+
+ private:
+  Tombstone* find(const OrderInfo& orderInfo);
+
+  std::size_t getSlot(OrderId orderId) const;
+  std::size_t getSlot(MarketCode marketCode, ExchOrderId exchOrderId) const;
+  std::size_t getSlot(const Index& index, const Tombstone& tombstone) const;
+
+  void insert(Index& index, std::uint32_t no);
+  void erase(Index& index, std::uint32_t no);
+
+ private:
+  std::vector<Tombstone> tombstoneGroup_;
+  std::uint32_t nextNo_{0};
+  std::size_t size_{0};
+
+  Index indexOfOrderId_;
+  Index indexOfExchOrderId_;
+  std::size_t mask_{0};
+
+  StatOfLateReport statOfLateReport_;
+};
+
+using ClosedOrderIndexUPtr = std::unique_ptr<ClosedOrderIndex>;
+
+}  // namespace bq
@@ -10,12 +10,15 @@
 
 #pragma once
 
+#include "ClosedOrderIndex.hpp"
 #include "def/BQConst.hpp"
 #include "def/BQDef.hpp"
 #include "def/Const.hpp"
 #include "def/Def.hpp"
 #include "def/OrderInfo.hpp"
+#include "SyncQueueOfUnclosedOrder.hpp"
 #include "util/PchBase.hpp"
+#include "util/SnapshotStore.hpp"
 
 namespace bq::db {
 class DBEng;
@@ -69,13 +72,27 @@ class OrdMgr {
   OrdMgr& operator=(const OrdMgr&&) = delete;
 
   OrdMgr();
+  ~OrdMgr();
 
  public:
+  /*
+   * If the snapshot store named nameOfSnapshot is enabled in the node, order
+   * infos are restored from its snapshot and journals instead of the db, the
+   * order infos in the db are only compared with them in the background.
+   */
   int init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
-           const std::string& sql);
+           const std::string& sql, const std::string& nameOfSnapshot = "");
+
+  // inits with the order infos loaded by the caller, which are owned by it
+  int init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
+           const std::vector<OrderInfoSPtr>& orderInfoGroup);
 
  private:
   int initOrderInfoGroup(const std::string& sql);
+  int initOrderInfoGroupFromSnapshot(const std::string& nameOfSnapshot);
+  void cmpOrderInfoGroupWithDB(const std::string& sql);
+
+  void journal(OpOfJournal op, const OrderInfo& orderInfo);
 
  public:
   int add(const OrderInfoSPtr& orderInfo, DeepClone deepClone,
@@ -99,6 +116,18 @@ class OrdMgr {
       DeepClone deepClone = DeepClone::True,
       LockFunc lockFunc = LockFunc::True) const;
 
+  /*
+   * After it is enabled the orders not confirmed by the exch are kept in a
+   * sync queue ordered by their deadline, so getOrderInfoGroupToSync only
+   * returns the orders which are due instead of all the orders older than
+   * the threshold.
+   */
+  void enableSyncOfUnclosedOrder(const SyncParamOfUnclosedOrder& param);
+
+  std::vector<OrderInfoSPtr> getOrderInfoGroupToSync(
+      DeepClone deepClone = DeepClone::True,
+      LockFunc lockFunc = LockFunc::True);
+
   std::tuple<IsSomeFieldOfOrderUpdated, OrderInfoSPtr>
   updateByOrderInfoFromExch(const OrderInfoSPtr& orderInfoFromExch,
                             std::uint64_t noUsedToCalcPos, DeepClone deepClone,
@@ -112,11 +141,21 @@ class OrdMgr {
   int updateExchOrderId(OrderId orderId, ExchOrderId exchOrderId,
                         LockFunc lockFunc = LockFunc::True);
 
+  /*
+   * Reports of orders no longer in the ord mgr are classified by the
+   * tombstones of the recently closed orders.
+   */
+  StatOfLateReport getStatOfLateReport(
+      LockFunc lockFunc = LockFunc::True) const;
+
  private:
   OrderInfoSPtr getOrderInfo(const OrderInfoSPtr& orderInfo,
                              DeepClone deepClone,
                              LockFunc lockFunc = LockFunc::True);
 
+  // guarded by the caller
+  TypeOfLateReport classifyLateReport(const OrderInfo& orderInfo);
+
  public:
   YAML::Node& getNode() { return node_; }
 
@@ -127,6 +166,13 @@ class OrdMgr {
 
   OrderInfoGroupSPtr orderInfoGroup_{nullptr};
   mutable std::ext::spin_mutex mtxOrderInfoGroup_;
+
+  // guarded by mtxOrderInfoGroup_
+  SyncQueueOfUnclosedOrderUPtr syncQueueOfUnclosedOrder_{nullptr};
+  ClosedOrderIndexUPtr closedOrderIndex_{nullptr};
+
+  std::unique_ptr<std::thread> threadOfCmpWithDB_{nullptr};
+  SnapshotStoreSPtr<OrderInfo> snapshotStore_{nullptr};
 };
 
 }  // namespace bq
@@ -0,0 +1,93 @@
+/*!
+ * \file SyncQueueOfUnclosedOrder.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "def/BQDef.hpp"
+#include "def/Def.hpp"
+#include "util/Pch.hpp"
+
+namespace bq {
+
+struct SyncParamOfUnclosedOrder {
+  // an order not confirmed by the exch for longer than it is due to be synced
+  std::uint64_t usThreshold_{30 * 1000 * 1000};
+  // the max delay before an order synced but still not confirmed is due again
+  std::uint64_t usMaxBackoff_{600 * 1000 * 1000};
+  // a random delay up to it is added to each deadline
+  std::uint64_t usMaxJitter_{3 * 1000 * 1000};
+  std::uint32_t maxNumOfOrderPerTick_{100};
+};
+
+/*
+ * Orders ordered by the deadline their state has to be synced from the exch,
+ * so each tick only touches the orders which are due instead of sweeping all
+ * the unclosed orders.
+ *
+ * The deadline of an order is its last confirmation by the exch plus the
+ * threshold. Each sync of the order that is not confirmed doubles the delay
+ * before the next sync, up to usMaxBackoff_. The jitter spreads the deadlines
+ * of orders confirmed at the same time.
+ *
+ * Not thread safe, the caller guards it together with its orders.
+ */
+class SyncQueueOfUnclosedOrder {
+  struct SyncStateOfOrder {
+    OrderId orderId_;
+    std::uint64_t usDeadline_;
+    std::uint32_t numOfSyncNotConfirmed_;
+  };
+
+  struct TagOrderId {};
+  using MIdxOrderId = boost::multi_index::ordered_unique<
+      boost::multi_index::tag<TagOrderId>,
+      MIDX_MEMER(SyncStateOfOrder, OrderId, orderId_)>;
+
+  struct TagDeadline {};
+  using MIdxDeadline = boost::multi_index::ordered_non_unique<
+      boost::multi_index::tag<TagDeadline>,
+      MIDX_MEMER(SyncStateOfOrder, std::uint64_t, usDeadline_)>;
+
+  using SyncStateOfOrderGroup = boost::multi_index::multi_index_container<
+      SyncStateOfOrder,
+      boost::multi_index::indexed_by<MIdxOrderId, MIdxDeadline>>;
+
+ public:
+  SyncQueueOfUnclosedOrder(const SyncQueueOfUnclosedOrder&) = delete;
+  SyncQueueOfUnclosedOrder& operator=(const SyncQueueOfUnclosedOrder&) =
+      delete;
+  SyncQueueOfUnclosedOrder(const SyncQueueOfUnclosedOrder&&) = delete;
+  SyncQueueOfUnclosedOrder& operator=(const SyncQueueOfUnclosedOrder&&) =
+      delete;
+
+  explicit SyncQueueOfUnclosedOrder(const SyncParamOfUnclosedOrder& param);
+
+ public:
+  // adds the order if it is not in the queue
+  void confirm(OrderId orderId, std::uint64_t usConfirmTime);
+  void remove(OrderId orderId);
+
+  // the orders returned are due again after their backoff
+  std::vector<OrderId> popOrderIdGroupToSync(std::uint64_t now);
+
+  std::size_t size() const { return syncStateOfOrderGroup_.size(); }
+
+ private:
+  std::uint64_t getJitter();
+
+ private:
+  const SyncParamOfUnclosedOrder param_;
+  SyncStateOfOrderGroup syncStateOfOrderGroup_;
+  std::mt19937_64 generator_;
+};
+
+using SyncQueueOfUnclosedOrderUPtr = std::unique_ptr<SyncQueueOfUnclosedOrder>;
+
+}  // namespace bq
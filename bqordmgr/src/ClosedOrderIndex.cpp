@@ -0,0 +1,167 @@
+/*!
+ * \file ClosedOrderIndex.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "ClosedOrderIndex.hpp"
+
+#include "util/Float.hpp"
+
+namespace bq {
+
+namespace {
+
+// kept as Decimal, std::fabs of a fixed decimal would give a double
+Decimal GetAbsOfDealSize(const OrderInfo& orderInfo) {
+  return orderInfo.dealSize_ < 0 ? -orderInfo.dealSize_ : orderInfo.dealSize_;
+}
+
+std::size_t Mix(std::uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
+
+}  // namespace
+
+ClosedOrderIndex::ClosedOrderIndex(std::uint32_t capacity)
+    : tombstoneGroup_(std::max<std::uint32_t>(capacity, 1)) {
+  // the load factor of the index is kept under 0.5
+  std::size_t sizeOfIndex = 1;
+  while (sizeOfIndex < tombstoneGroup_.size() * 2) sizeOfIndex <<= 1;
+  indexOfOrderId_.resize(sizeOfIndex, 0);
+  indexOfExchOrderId_.resize(sizeOfIndex, 0);
+  mask_ = sizeOfIndex - 1;
+}
+
+void ClosedOrderIndex::add(const OrderInfo& orderInfo) {
+  if (orderInfo.orderId_ == 0) return;
+
+  auto tombstone = find(orderInfo);
+  if (tombstone && tombstone->orderId_ == orderInfo.orderId_) {
+    const auto no = static_cast<std::uint32_t>(tombstone - &tombstoneGroup_[0]);
+    erase(indexOfOrderId_, no);
+    if (tombstone->exchOrderId_ != 0) erase(indexOfExchOrderId_, no);
+    tombstone->orderId_ = 0;
+    --size_;
+  }
+
+  const auto no = nextNo_;
+  nextNo_ = (nextNo_ + 1) % tombstoneGroup_.size();
+
+  auto& oldest = tombstoneGroup_[no];
+  if (oldest.orderId_ != 0) {
+    erase(indexOfOrderId_, no);
+    if (oldest.exchOrderId_ != 0) erase(indexOfExchOrderId_, no);
+    --size_;
+  }
+
+  oldest.orderId_ = orderInfo.orderId_;
+  oldest.marketCode_ = orderInfo.marketCode_;
+  oldest.exchOrderId_ = orderInfo.exchOrderId_;
+  oldest.dealSize_ = GetAbsOfDealSize(orderInfo);
+  oldest.orderStatus_ = orderInfo.orderStatus_;
+  insert(indexOfOrderId_, no);
+  if (oldest.exchOrderId_ != 0) insert(indexOfExchOrderId_, no);
+  ++size_;
+}
+
+TypeOfLateReport ClosedOrderIndex::classify(const OrderInfo& orderInfo) {
+  const auto tombstone = find(orderInfo);
+  if (!tombstone) {
+    ++statOfLateReport_.numOfNotFound_;
+    return TypeOfLateReport::NotFound;
+  }
+
+  const auto dealSize = GetAbsOfDealSize(orderInfo);
+  if (isDefinitelyGreaterThan(dealSize, tombstone->dealSize_)) {
+    tombstone->dealSize_ = dealSize;
+    tombstone->orderStatus_ = orderInfo.orderStatus_;
+    ++statOfLateReport_.numOfMissed_;
+    return TypeOfLateReport::Missed;
+  }
+
+  if (isApproximatelyEqual(dealSize, tombstone->dealSize_) &&
+      orderInfo.orderStatus_ == tombstone->orderStatus_) {
+    ++statOfLateReport_.numOfDuplicate_;
+    return TypeOfLateReport::Duplicate;
+  }
+
+  ++statOfLateReport_.numOfStale_;
+  return TypeOfLateReport::Stale;
+}
+
+ClosedOrderIndex::Tombstone* ClosedOrderIndex::find(
+    const OrderInfo& orderInfo) {
+  if (orderInfo.orderId_ != 0) {
+    for (auto slot = getSlot(orderInfo.orderId_); indexOfOrderId_[slot] != 0;
+         slot = (slot + 1) & mask_) {
+      auto& tombstone = tombstoneGroup_[indexOfOrderId_[slot] - 1];
+      if (tombstone.orderId_ == orderInfo.orderId_) return &tombstone;
+    }
+  }
+
+  if (orderInfo.marketCode_ != MarketCode::Others &&
+      orderInfo.exchOrderId_ != 0) {
+    for (auto slot = getSlot(orderInfo.marketCode_, orderInfo.exchOrderId_);
+         indexOfExchOrderId_[slot] != 0; slot = (slot + 1) & mask_) {
+      auto& tombstone = tombstoneGroup_[indexOfExchOrderId_[slot] - 1];
+      if (tombstone.marketCode_ == orderInfo.marketCode_ &&
+          tombstone.exchOrderId_ == orderInfo.exchOrderId_) {
+        return &tombstone;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+std::size_t ClosedOrderIndex::getSlot(OrderId orderId) const {
+  return Mix(orderId) & mask_;
+}
+
+std::size_t ClosedOrderIndex::getSlot(MarketCode marketCode,
+                                      ExchOrderId exchOrderId) const {
+  const auto key = static_cast<std::uint64_t>(exchOrderId) ^
+                   (static_cast<std::uint64_t>(marketCode) << 56);
+  return Mix(key) & mask_;
+}
+
+std::size_t ClosedOrderIndex::getSlot(const Index& index,
+                                      const Tombstone& tombstone) const {
+  if (&index == &indexOfOrderId_) return getSlot(tombstone.orderId_);
+  return getSlot(tombstone.marketCode_, tombstone.exchOrderId_);
+}
+
+void ClosedOrderIndex::insert(Index& index, std::uint32_t no) {
+  auto slot = getSlot(index, tombstoneGroup_[no]);
+  while (index[slot] != 0) slot = (slot + 1) & mask_;
+  index[slot] = no + 1;
+}
+
+void ClosedOrderIndex::erase(Index& index, std::uint32_t no) {
+  auto slot = getSlot(index, tombstoneGroup_[no]);
+  while (index[slot] != no + 1) slot = (slot + 1) & mask_;
+
+  // move back the entries after the hole which probed past it, so no lookup
+  // stops at the hole before reaching them
+  for (auto next = (slot + 1) & mask_; index[next] != 0;
+       next = (next + 1) & mask_) {
+    const auto home = getSlot(index, tombstoneGroup_[index[next] - 1]);
+    if (((next - home) & mask_) >= ((next - slot) & mask_)) {
+      index[slot] = index[next];
+      slot = next;
+    }
+  }
+  index[slot] = 0;
+}
+
+}  // namespace bq
@@ -23,18 +23,51 @@
 
 namespace bq {
 
-OrdMgr::OrdMgr() : orderInfoGroup_(std::make_shared<OrderInfoGroup>()) {}
+OrdMgr::OrdMgr()
+    : orderInfoGroup_(std::make_shared<OrderInfoGroup>()),
+      closedOrderIndex_(std::make_unique<ClosedOrderIndex>()) {}
+
+OrdMgr::~OrdMgr() {
+  if (threadOfCmpWithDB_ && threadOfCmpWithDB_->joinable()) {
+    threadOfCmpWithDB_->join();
+  }
+}
+
+int OrdMgr::init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
+                 const std::string& sql, const std::string& nameOfSnapshot) {
+  node_ = node;
+  dbEng_ = dbEng;
+
+  if (initOrderInfoGroupFromSnapshot(nameOfSnapshot) == 0) {
+    threadOfCmpWithDB_ = std::make_unique<std::thread>(
+        [this, sql]() { cmpOrderInfoGroupWithDB(sql); });
+  } else {
+    auto retOfInitOrd = initOrderInfoGroup(sql);
+    if (retOfInitOrd != 0) {
+      LOG_W("Init failed. [{}]", sql);
+      return retOfInitOrd;
+    }
+  }
+
+  if (snapshotStore_) {
+    const auto ret = snapshotStore_->start();
+    if (ret != 0) {
+      LOG_W("Init failed because of start snapshot store failed.");
+      return ret;
+    }
+  }
+  return 0;
+}
 
 int OrdMgr::init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
-                 const std::string& sql) {
+                 const std::vector<OrderInfoSPtr>& orderInfoGroup) {
   node_ = node;
   dbEng_ = dbEng;
 
-  auto retOfInitOrd = initOrderInfoGroup(sql);
-  if (retOfInitOrd != 0) {
-    LOG_W("Init failed. [{}]", sql);
-    return retOfInitOrd;
+  for (const auto& orderInfo : orderInfoGroup) {
+    orderInfoGroup_->emplace(orderInfo);
   }
+  LOG_I("Init order info group success. [size = {}]", orderInfoGroup_->size());
   return 0;
 }
 
@@ -55,6 +88,74 @@ int OrdMgr::initOrderInfoGroup(const std::string& sql) {
   return 0;
 }
 
+int OrdMgr::initOrderInfoGroupFromSnapshot(const std::string& nameOfSnapshot) {
+  snapshotStore_ =
+      MakeSnapshotStore<OrderInfo>(node_, nameOfSnapshot, [this]() {
+        std::vector<OrderInfo> ret;
+        std::lock_guard<std::ext::spin_mutex> guard(mtxOrderInfoGroup_);
+        ret.reserve(orderInfoGroup_->size());
+        for (const auto& orderInfo : *orderInfoGroup_) {
+          ret.emplace_back(*orderInfo);
+        }
+        return ret;
+      });
+  if (!snapshotStore_) {
+    return SCODE_SNAPSHOT_NOT_EXISTS;
+  }
+
+  const auto ret =
+      snapshotStore_->load([this](OpOfJournal op, const OrderInfo& orderInfo) {
+        auto& idx = orderInfoGroup_->get<TagOrderId>();
+        const auto iter = idx.find(orderInfo.orderId_);
+        if (iter != std::end(idx)) idx.erase(iter);
+        if (op == OpOfJournal::Upsert) {
+          orderInfoGroup_->emplace(std::make_shared<OrderInfo>(orderInfo));
+        }
+      });
+  if (ret != 0) {
+    LOG_I("Init order info group from snapshot {} failed, init from db.",
+          nameOfSnapshot);
+    orderInfoGroup_->clear();
+    return ret;
+  }
+  LOG_I("Init order info group from snapshot {} success. [size = {}]",
+        nameOfSnapshot, orderInfoGroup_->size());
+  return 0;
+}
+
+void OrdMgr::cmpOrderInfoGroupWithDB(const std::string& sql) {
+  auto [ret, tblRecSet] =
+      db::TBLRecSetMaker<TBLOrderInfo>::ExecSql(dbEng_, sql);
+  if (ret != 0) {
+    LOG_W("Compare order info group with db failed. {}", sql);
+    return;
+  }
+
+  // the db is written behind, so the differences are only logged
+  std::size_t numOfOrderInfoNotInOrdMgr = 0;
+  for (const auto& tblRec : *tblRecSet) {
+    const auto recOrderInfo = tblRec.second->getRecWithAllFields();
+    const auto orderId = MakeOrderInfo(recOrderInfo)->orderId_;
+    {
+      std::lock_guard<std::ext::spin_mutex> guard(mtxOrderInfoGroup_);
+      const auto& idx = orderInfoGroup_->get<TagOrderId>();
+      if (idx.find(orderId) != std::end(idx)) continue;
+    }
+    LOG_I("Order info of order id {} in db not in ord mgr.", orderId);
+    ++numOfOrderInfoNotInOrdMgr;
+  }
+  LOG_I(
+      "Compare order info group with db finished. "
+      "[numInDB = {}; numOfOrderInfoNotInOrdMgr = {}]",
+      tblRecSet->size(), numOfOrderInfoNotInOrdMgr);
+}
+
+void OrdMgr::journal(OpOfJournal op, const OrderInfo& orderInfo) {
+  if (snapshotStore_) {
+    snapshotStore_->append(op, orderInfo);
+  }
+}
+
 int OrdMgr::add(const OrderInfoSPtr& orderInfo, DeepClone deepClone,
                 LockFunc lockFunc) {
   const auto orderInfoClone = deepClone == DeepClone::True
@@ -64,6 +165,13 @@ int OrdMgr::add(const OrderInfoSPtr& orderInfo, DeepClone deepClone,
   {
     SPIN_LOCK(mtxOrderInfoGroup_);
     ret = orderInfoGroup_->emplace(orderInfoClone);
+    if (ret.second) {
+      journal(OpOfJournal::Upsert, *orderInfoClone);
+      if (syncQueueOfUnclosedOrder_) {
+        syncQueueOfUnclosedOrder_->confirm(orderInfoClone->orderId_,
+                                           GetTotalUSSince1970());
+      }
+    }
   }
   if (!ret.second) {
     LOG_W(
@@ -81,6 +189,9 @@ int OrdMgr::remove(OrderId orderId, LockFunc lockFunc) {
     const auto iter = idx.find(orderId);
     if (iter != std::end(idx)) {
       LOG_D("Remove order info in order info group. {}", (*iter)->toShortStr());
+      journal(OpOfJournal::Remove, **iter);
+      if (syncQueueOfUnclosedOrder_) syncQueueOfUnclosedOrder_->remove(orderId);
+      if ((*iter)->closed()) closedOrderIndex_->add(**iter);
       idx.erase(iter);
       return 0;
     }
@@ -178,6 +289,43 @@ std::vector<OrderInfoSPtr> OrdMgr::getOrderInfoGroup(
   return ret;
 }
 
+void OrdMgr::enableSyncOfUnclosedOrder(const SyncParamOfUnclosedOrder& param) {
+  std::lock_guard<std::ext::spin_mutex> guard(mtxOrderInfoGroup_);
+  syncQueueOfUnclosedOrder_ = std::make_unique<SyncQueueOfUnclosedOrder>(param);
+  for (const auto& rec : *orderInfoGroup_) {
+    syncQueueOfUnclosedOrder_->confirm(rec->orderId_, rec->orderTime_);
+  }
+  LOG_I(
+      "Enable sync of unclosed order. [size = {}, usThreshold = {}, "
+      "usMaxBackoff = {}, usMaxJitter = {}, maxNumOfOrderPerTick = {}]",
+      syncQueueOfUnclosedOrder_->size(), param.usThreshold_,
+      param.usMaxBackoff_, param.usMaxJitter_, param.maxNumOfOrderPerTick_);
+}
+
+std::vector<OrderInfoSPtr> OrdMgr::getOrderInfoGroupToSync(
+    DeepClone deepClone, LockFunc lockFunc) {
+  const auto now = GetTotalUSSince1970();
+  std::vector<OrderInfoSPtr> ret;
+  {
+    SPIN_LOCK(mtxOrderInfoGroup_);
+    if (!syncQueueOfUnclosedOrder_) return ret;
+    const auto orderIdGroup =
+        syncQueueOfUnclosedOrder_->popOrderIdGroupToSync(now);
+    const auto& idx = orderInfoGroup_->get<TagOrderId>();
+    for (const auto orderId : orderIdGroup) {
+      const auto iter = idx.find(orderId);
+      if (iter == std::end(idx)) {
+        syncQueueOfUnclosedOrder_->remove(orderId);
+        continue;
+      }
+      ret.emplace_back(deepClone == DeepClone::True
+                           ? std::make_shared<OrderInfo>(**iter)
+                           : *iter);
+    }
+  }
+  return ret;
+}
+
 std::tuple<IsSomeFieldOfOrderUpdated, OrderInfoSPtr>
 OrdMgr::updateByOrderInfoFromExch(const OrderInfoSPtr& orderInfoFromExch,
                                   std::uint64_t noUsedToCalcPos,
@@ -190,6 +338,10 @@ OrdMgr::updateByOrderInfoFromExch(const OrderInfoSPtr& orderInfoFromExch,
     auto orderInfoInOrdMgr =
         getOrderInfo(orderInfoFromExch, DeepClone::False, LockFunc::False);
     if (!orderInfoInOrdMgr) {
+      const auto typeOfLateReport = classifyLateReport(*orderInfoFromExch);
+      if (typeOfLateReport != TypeOfLateReport::NotFound) {
+        return {isTheOrderInfoUpdated, nullptr};
+      }
       LOG_I(
           "Update by order info from exch failed, there may be unclosed orders "
           "that were closed during the process of sync unclosed orders. {}",
@@ -201,6 +353,14 @@ OrdMgr::updateByOrderInfoFromExch(const OrderInfoSPtr& orderInfoFromExch,
         orderInfoFromExch, noUsedToCalcPos, feeInfoCache);
     if (orderInfoInOrdMgr->closed()) {
       remove(orderInfoInOrdMgr->orderId_, LockFunc::False);
+    } else {
+      if (isTheOrderInfoUpdated == IsSomeFieldOfOrderUpdated::True) {
+        journal(OpOfJournal::Upsert, *orderInfoInOrdMgr);
+      }
+      if (syncQueueOfUnclosedOrder_) {
+        syncQueueOfUnclosedOrder_->confirm(orderInfoInOrdMgr->orderId_,
+                                           GetTotalUSSince1970());
+      }
     }
 
     const auto orderInfo = deepClone == DeepClone::True
@@ -221,6 +381,10 @@ OrdMgr::updateByOrderInfoFromTDGW(const OrderInfoSPtr& orderInfoFromTDGW,
     auto orderInfoInOrdMgr =
         getOrderInfo(orderInfoFromTDGW, DeepClone::False, LockFunc::False);
     if (!orderInfoInOrdMgr) {
+      const auto typeOfLateReport = classifyLateReport(*orderInfoFromTDGW);
+      if (typeOfLateReport != TypeOfLateReport::NotFound) {
+        return {IsTheOrderCanBeUsedCalcPos::False, nullptr};
+      }
       LOG_W(
           "Update by order info from tdsrv failed because of order info in "
           "ordmgr not exists. {}",
@@ -232,6 +396,8 @@ OrdMgr::updateByOrderInfoFromTDGW(const OrderInfoSPtr& orderInfoFromTDGW,
         orderInfoInOrdMgr->updateByOrderInfoFromTDGW(orderInfoFromTDGW);
     if (orderInfoInOrdMgr->closed()) {
       remove(orderInfoInOrdMgr->orderId_, LockFunc::False);
+    } else {
+      journal(OpOfJournal::Upsert, *orderInfoInOrdMgr);
     }
     return {isTheOrderCanBeUsedCalcPos, orderInfoInOrdMgr};
   }
@@ -248,6 +414,7 @@ int OrdMgr::updateExchOrderId(OrderId orderId, ExchOrderId exchOrderId,
     if (iter != std::end(idx)) {
       if ((*iter)->exchOrderId_ == 0 && exchOrderId != 0) {
         (*iter)->exchOrderId_ = exchOrderId;
+        journal(OpOfJournal::Upsert, **iter);
       }
       return 0;
     } else {
@@ -256,6 +423,11 @@ int OrdMgr::updateExchOrderId(OrderId orderId, ExchOrderId exchOrderId,
   }
 }
 
+StatOfLateReport OrdMgr::getStatOfLateReport(LockFunc lockFunc) const {
+  SPIN_LOCK(mtxOrderInfoGroup_);
+  return closedOrderIndex_->getStatOfLateReport();
+}
+
 OrderInfoSPtr OrdMgr::getOrderInfo(const OrderInfoSPtr& orderInfo,
                                    DeepClone deepClone, LockFunc lockFunc) {
   {
@@ -291,4 +463,25 @@ OrderInfoSPtr OrdMgr::getOrderInfo(const OrderInfoSPtr& orderInfo,
   return nullptr;
 }
 
+TypeOfLateReport OrdMgr::classifyLateReport(const OrderInfo& orderInfo) {
+  const auto typeOfLateReport = closedOrderIndex_->classify(orderInfo);
+  switch (typeOfLateReport) {
+    case TypeOfLateReport::Duplicate:
+      LOG_D("Duplicate report of closed order. {}", orderInfo.toShortStr());
+      break;
+    case TypeOfLateReport::Stale:
+      LOG_D("Stale report of closed order. {}", orderInfo.toShortStr());
+      break;
+    case TypeOfLateReport::Missed:
+      LOG_W(
+          "Report of closed order with more dealed than when it was closed, "
+          "a fill may be missed. {}",
+          orderInfo.toShortStr());
+      break;
+    default:
+      break;
+  }
+  return typeOfLateReport;
+}
+
 }  // namespace bq
@@ -0,0 +1,73 @@
+/*!
+ * \file SyncQueueOfUnclosedOrder.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "SyncQueueOfUnclosedOrder.hpp"
+
+namespace bq {
+
+namespace {
+
+constexpr std::uint32_t MAX_SHIFT_OF_BACKOFF = 20;
+
+}  // namespace
+
+SyncQueueOfUnclosedOrder::SyncQueueOfUnclosedOrder(
+    const SyncParamOfUnclosedOrder& param)
+    : param_(param), generator_(std::random_device()()) {}
+
+void SyncQueueOfUnclosedOrder::confirm(OrderId orderId,
+                                       std::uint64_t usConfirmTime) {
+  const auto usDeadline = usConfirmTime + param_.usThreshold_ + getJitter();
+  auto& idx = syncStateOfOrderGroup_.get<TagOrderId>();
+  const auto iter = idx.find(orderId);
+  if (iter == std::end(idx)) {
+    idx.emplace(SyncStateOfOrder{orderId, usDeadline, 0});
+    return;
+  }
+  idx.modify(iter, [&](auto& syncStateOfOrder) {
+    syncStateOfOrder.usDeadline_ = usDeadline;
+    syncStateOfOrder.numOfSyncNotConfirmed_ = 0;
+  });
+}
+
+void SyncQueueOfUnclosedOrder::remove(OrderId orderId) {
+  syncStateOfOrderGroup_.get<TagOrderId>().erase(orderId);
+}
+
+std::vector<OrderId> SyncQueueOfUnclosedOrder::popOrderIdGroupToSync(
+    std::uint64_t now) {
+  std::vector<OrderId> ret;
+  const auto& idxOfDeadline = syncStateOfOrderGroup_.get<TagDeadline>();
+  for (const auto& syncStateOfOrder : idxOfDeadline) {
+    if (syncStateOfOrder.usDeadline_ > now) break;
+    if (ret.size() >= param_.maxNumOfOrderPerTick_) break;
+    ret.emplace_back(syncStateOfOrder.orderId_);
+  }
+
+  auto& idx = syncStateOfOrderGroup_.get<TagOrderId>();
+  for (const auto orderId : ret) {
+    idx.modify(idx.find(orderId), [&](auto& syncStateOfOrder) {
+      const auto shift = std::min(syncStateOfOrder.numOfSyncNotConfirmed_,
+                                  MAX_SHIFT_OF_BACKOFF);
+      const auto usBackoff =
+          std::min(param_.usThreshold_ << shift, param_.usMaxBackoff_);
+      syncStateOfOrder.usDeadline_ = now + usBackoff + getJitter();
+      ++syncStateOfOrder.numOfSyncNotConfirmed_;
+    });
+  }
+  return ret;
+}
+
+std::uint64_t SyncQueueOfUnclosedOrder::getJitter() {
+  if (param_.usMaxJitter_ == 0) return 0;
+  return generator_() % (param_.usMaxJitter_ + 1);
+}
+
+}  // namespace bq
@@ -13,6 +13,11 @@
 
 #include <string>
 
+#include "ClosedOrderIndex.hpp"
+#include "SyncQueueOfUnclosedOrder.hpp"
+
+using namespace bq;
+
 class global_event : public testing::Environment {
  public:
   virtual void SetUp() {}
@@ -21,6 +26,134 @@ class global_event : public testing::Environment {
 
 TEST(test, test1) {}
 
+TEST(test, testSyncQueueOfUnclosedOrder) {
+  SyncParamOfUnclosedOrder param;
+  param.usThreshold_ = 10;
+  param.usMaxBackoff_ = 40;
+  param.usMaxJitter_ = 0;
+  param.maxNumOfOrderPerTick_ = 2;
+  SyncQueueOfUnclosedOrder syncQueue(param);
+
+  syncQueue.confirm(1, 0);
+  syncQueue.confirm(2, 0);
+  syncQueue.confirm(3, 0);
+  syncQueue.confirm(4, 5);
+  EXPECT_TRUE(syncQueue.size() == 4);
+
+  // nothing is due before the threshold
+  EXPECT_TRUE(syncQueue.popOrderIdGroupToSync(9).empty());
+
+  // the budget of each tick
+  auto orderIdGroup = syncQueue.popOrderIdGroupToSync(10);
+  EXPECT_TRUE(orderIdGroup == std::vector<OrderId>({1, 2}));
+  orderIdGroup = syncQueue.popOrderIdGroupToSync(10);
+  EXPECT_TRUE(orderIdGroup == std::vector<OrderId>({3}));
+  orderIdGroup = syncQueue.popOrderIdGroupToSync(15);
+  EXPECT_TRUE(orderIdGroup == std::vector<OrderId>({4}));
+
+  // the order confirmed by the exch is due after the threshold again
+  syncQueue.confirm(2, 12);
+  syncQueue.remove(3);
+  syncQueue.remove(4);
+  EXPECT_TRUE(syncQueue.size() == 2);
+
+  // the delay of the order not confirmed doubles up to the max backoff
+  EXPECT_TRUE(syncQueue.popOrderIdGroupToSync(19).empty());
+  orderIdGroup = syncQueue.popOrderIdGroupToSync(20);
+  EXPECT_TRUE(orderIdGroup == std::vector<OrderId>({1}));
+  orderIdGroup = syncQueue.popOrderIdGroupToSync(22);
+  EXPECT_TRUE(orderIdGroup == std::vector<OrderId>({2}));
+  syncQueue.remove(2);
+  EXPECT_TRUE(syncQueue.popOrderIdGroupToSync(39).empty());
+  orderIdGroup = syncQueue.popOrderIdGroupToSync(40);
+  EXPECT_TRUE(orderIdGroup == std::vector<OrderId>({1}));
+  EXPECT_TRUE(syncQueue.popOrderIdGroupToSync(79).empty());
+  orderIdGroup = syncQueue.popOrderIdGroupToSync(80);
+  EXPECT_TRUE(orderIdGroup == std::vector<OrderId>({1}));
+  EXPECT_TRUE(syncQueue.popOrderIdGroupToSync(119).empty());
+  orderIdGroup = syncQueue.popOrderIdGroupToSync(120);
+  EXPECT_TRUE(orderIdGroup == std::vector<OrderId>({1}));
+}
+
+TEST(test, testClosedOrderIndex) {
+  ClosedOrderIndex closedOrderIndex(4);
+
+  const auto makeOrderInfo = [](OrderId orderId, ExchOrderId exchOrderId,
+                                Decimal dealSize, OrderStatus orderStatus) {
+    OrderInfo orderInfo;
+    orderInfo.orderId_ = orderId;
+    orderInfo.marketCode_ = MarketCode::Binance;
+    orderInfo.exchOrderId_ = exchOrderId;
+    orderInfo.dealSize_ = dealSize;
+    orderInfo.orderStatus_ = orderStatus;
+    return orderInfo;
+  };
+  const auto classify = [&](OrderId orderId, ExchOrderId exchOrderId,
+                            Decimal dealSize, OrderStatus orderStatus) {
+    return closedOrderIndex.classify(
+        makeOrderInfo(orderId, exchOrderId, dealSize, orderStatus));
+  };
+
+  for (OrderId orderId = 1; orderId <= 4; ++orderId) {
+    closedOrderIndex.add(
+        makeOrderInfo(orderId, orderId + 100, 2, OrderStatus::Filled));
+  }
+  EXPECT_TRUE(closedOrderIndex.size() == 4);
+
+  EXPECT_TRUE(classify(1, 101, 2, OrderStatus::Filled) ==
+              TypeOfLateReport::Duplicate);
+  EXPECT_TRUE(classify(2, 102, 1, OrderStatus::PartialFilled) ==
+              TypeOfLateReport::Stale);
+
+  // found by the exch order id if the report has no order id
+  EXPECT_TRUE(classify(0, 103, 3, OrderStatus::Filled) ==
+              TypeOfLateReport::Missed);
+  EXPECT_TRUE(classify(0, 103, 3, OrderStatus::Filled) ==
+              TypeOfLateReport::Duplicate);
+
+  // the oldest tombstone is overwritten once the ring is full
+  closedOrderIndex.add(makeOrderInfo(5, 105, 2, OrderStatus::Canceled));
+  EXPECT_TRUE(closedOrderIndex.size() == 4);
+  EXPECT_TRUE(classify(1, 101, 2, OrderStatus::Filled) ==
+              TypeOfLateReport::NotFound);
+  EXPECT_TRUE(classify(0, 104, 2, OrderStatus::Filled) ==
+              TypeOfLateReport::Duplicate);
+  EXPECT_TRUE(classify(5, 0, 2, OrderStatus::Canceled) ==
+              TypeOfLateReport::Duplicate);
+
+  const auto& stat = closedOrderIndex.getStatOfLateReport();
+  EXPECT_TRUE(stat.numOfNotFound_ == 1);
+  EXPECT_TRUE(stat.numOfDuplicate_ == 4);
+  EXPECT_TRUE(stat.numOfStale_ == 1);
+  EXPECT_TRUE(stat.numOfMissed_ == 1);
+
+  // the index stays consistent after many tombstones are overwritten
+  for (OrderId orderId = 6; orderId <= 10000; ++orderId) {
+    closedOrderIndex.add(
+        makeOrderInfo(orderId, orderId + 100, 1, OrderStatus::Filled));
+  }
+  for (OrderId orderId = 9997; orderId <= 10000; ++orderId) {
+    EXPECT_TRUE(classify(orderId, 0, 1, OrderStatus::Filled) ==
+                TypeOfLateReport::Duplicate);
+    EXPECT_TRUE(classify(0, orderId + 100, 1, OrderStatus::Filled) ==
+                TypeOfLateReport::Duplicate);
+  }
+  EXPECT_TRUE(classify(9996, 10096, 1, OrderStatus::Filled) ==
+              TypeOfLateReport::NotFound);
+
+  // the deal size of an ask order is negative in the ord mgr but not in the
+  // reports from the exch
+  closedOrderIndex.add(makeOrderInfo(10001, 10101, -2, OrderStatus::Filled));
+  EXPECT_TRUE(classify(10001, 10101, 2, OrderStatus::Filled) ==
+              TypeOfLateReport::Duplicate);
+  EXPECT_TRUE(classify(10001, 10101, 1, OrderStatus::PartialFilled) ==
+              TypeOfLateReport::Stale);
+  EXPECT_TRUE(classify(10001, 10101, 3, OrderStatus::Filled) ==
+              TypeOfLateReport::Missed);
+  EXPECT_TRUE(classify(10001, 10101, -3, OrderStatus::Filled) ==
+              TypeOfLateReport::Duplicate);
+}
+
 int main(int argc, char** argv) {
   testing::AddGlobalTestEnvironment(new global_event);
   testing::InitGoogleTest(&argc, argv);
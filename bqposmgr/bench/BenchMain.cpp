@@ -12,4 +12,101 @@
 
 #include <iostream>
 
+#include "PosKey.hpp"
+#include "PosMgr.hpp"
+#include "def/DataStruOfAssets.hpp"
+#include "def/DataStruOfTD.hpp"
+
+using namespace bq;
+
+namespace {
+
+constexpr std::uint32_t NUM_OF_ACCT = 100;
+
+OrderInfoSPtr MakeFill(std::uint32_t no) {
+  auto ret = std::make_shared<OrderInfo>();
+  ret->userId_ = 1;
+  ret->acctId_ = no % NUM_OF_ACCT;
+  ret->stgId_ = 1;
+  ret->stgInstId_ = 1;
+  ret->marketCode_ = MarketCode::Binance;
+  ret->symbolType_ = SymbolType::Perp;
+  const auto symbolCode = fmt::format("SYM{}-USDT-PERP", no / NUM_OF_ACCT);
+  strncpy(ret->symbolCode_, symbolCode.c_str(), sizeof(ret->symbolCode_) - 1);
+  ret->side_ = Side::Bid;
+  ret->posSide_ = PosSide::Long;
+  strncpy(ret->feeCurrency_, "USDT", sizeof(ret->feeCurrency_) - 1);
+  ret->fee_ = 0.01;
+  ret->dealSize_ = 1;
+  ret->lastDealSize_ = 1;
+  ret->lastDealPrice_ = 100;
+  ret->orderStatus_ = OrderStatus::Filled;
+  return ret;
+}
+
+}  // namespace
+
+class FixtureTest : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) {
+    posMgr_ = std::make_shared<PosMgr>();
+    posMgr_->setSyncToDB(SyncToDB::False);
+    fillGroup_.clear();
+    for (std::int64_t no = 0; no < state.range(0); ++no) {
+      fillGroup_.emplace_back(MakeFill(no));
+      posMgr_->updateByOrderInfoFromTDGW(fillGroup_.back());
+    }
+  }
+  void TearDown(const ::benchmark::State& state) {
+    posMgr_.reset();
+    fillGroup_.clear();
+  }
+
+ protected:
+  std::shared_ptr<PosMgr> posMgr_;
+  std::vector<OrderInfoSPtr> fillGroup_;
+};
+
+/*
+ * Per fill cost of updating one of the open positions, the positions are
+ * spread over NUM_OF_ACCT accounts.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, updateByOrderInfoFromTDGW)
+(benchmark::State& st) {
+  std::size_t no = 0;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(
+        posMgr_->updateByOrderInfoFromTDGW(fillGroup_[no]));
+    no = (no + 7919) % fillGroup_.size();
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, updateByOrderInfoFromTDGW)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000);
+
+/*
+ * The string key and its hash built on every fill before positions were keyed
+ * by PosKey.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, getPosKeyHashByStr)(benchmark::State& st) {
+  std::size_t no = 0;
+  for (auto _ : st) {
+    const auto posKey = fillGroup_[no]->getPosKey();
+    benchmark::DoNotOptimize(XXH3_64bits(posKey.data(), posKey.size()));
+    no = (no + 1) % fillGroup_.size();
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, getPosKeyHashByStr)->Arg(1000);
+
+BENCHMARK_DEFINE_F(FixtureTest, getPosKeyHash)(benchmark::State& st) {
+  std::size_t no = 0;
+  for (auto _ : st) {
+    const auto posKey = MakePosKey(*fillGroup_[no], fillGroup_[no]->side_);
+    benchmark::DoNotOptimize(PosKeyHash()(posKey));
+    no = (no + 1) % fillGroup_.size();
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, getPosKeyHash)->Arg(1000);
+
 BENCHMARK_MAIN();
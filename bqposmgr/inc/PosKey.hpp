@@ -0,0 +1,60 @@
+/*!
+ * \file PosKey.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "def/BQConst.hpp"
+#include "def/BQDef.hpp"
+#include "util/Pch.hpp"
+
+namespace bq {
+
+struct OrderInfo;
+struct PosInfo;
+
+/*
+ * Fixed size binary key of a position, it holds the same fields as
+ * PosInfo::getKey() but is filled without formatting or allocating. Fields are
+ * laid out without padding and char arrays are zero filled after the
+ * terminator, so the key can be hashed and compared as raw bytes.
+ */
+struct PosKey {
+  ProductId productId_{0};
+  UserId userId_{0};
+  AcctId acctId_{0};
+  StgId stgId_{0};
+  StgInstId stgInstId_{0};
+  MarketCode marketCode_{MarketCode::Others};
+  AlgoId algoId_{0};
+  std::uint32_t parValue_{0};
+  SymbolType symbolType_{SymbolType::Others};
+  Side side_{Side::Others};
+  PosSide posSide_{PosSide::Others};
+  std::uint8_t reserved_{0};
+  char symbolCode_[MAX_SYMBOL_CODE_LEN]{};
+  char feeCurrency_[MAX_CURRENCY_LEN]{};
+
+  bool operator==(const PosKey& rhs) const {
+    return std::memcmp(this, &rhs, sizeof(PosKey)) == 0;
+  }
+};
+static_assert(std::has_unique_object_representations_v<PosKey>,
+              "PosKey must not have padding.");
+
+struct PosKeyHash {
+  std::size_t operator()(const PosKey& posKey) const {
+    return XXH3_64bits(&posKey, sizeof(PosKey));
+  }
+};
+
+PosKey MakePosKey(const OrderInfo& orderInfo, Side side);
+PosKey MakePosKey(const PosInfo& posInfo);
+
+}  // namespace bq
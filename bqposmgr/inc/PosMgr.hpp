@@ -10,10 +10,12 @@
 
 #pragma once
 
+#include "PosKey.hpp"
 #include "def/Const.hpp"
 #include "def/DataStruOfAssets.hpp"
 #include "def/Def.hpp"
 #include "util/Pch.hpp"
+#include "util/SnapshotStore.hpp"
 #include "util/StdExt.hpp"
 
 namespace bq::db {
@@ -28,18 +30,19 @@ using OrderInfoSPtr = std::shared_ptr<OrderInfo>;
 
 namespace bq {
 
+/*
+ * Positions are sharded by acct id, each shard has its own lock, so fills of
+ * accounts in different shards never contend.
+ */
 class PosMgr {
-  struct TagMain {};
-  struct KeyMain : boost::multi_index::composite_key<
-                       PosInfo, MIDX_MEMER(PosInfo, std::uint64_t, keyHash_)> {
+  using PosKey2PosInfo = absl::flat_hash_map<PosKey, PosInfoSPtr, PosKeyHash>;
+
+  struct alignas(64) PosInfoShard {
+    mutable std::ext::spin_mutex mtx_;
+    PosKey2PosInfo posKey2PosInfo_;
   };
-  using MIdxMain = boost::multi_index::ordered_unique<
-      boost::multi_index::tag<TagMain>, KeyMain,
-      boost::multi_index::composite_key_result_less<KeyMain::result_type>>;
 
-  using PosInfoTable = boost::multi_index::multi_index_container<
-      PosInfoSPtr, boost::multi_index::indexed_by<MIdxMain>>;
-  using PosInfoTableSPtr = std::shared_ptr<PosInfoTable>;
+  constexpr static std::size_t NUM_OF_POS_INFO_SHARD = 64;
 
  public:
   PosMgr(const PosMgr&) = delete;
@@ -48,38 +51,61 @@ class PosMgr {
   PosMgr& operator=(const PosMgr&&) = delete;
 
   PosMgr();
+  ~PosMgr();
 
  public:
+  /*
+   * If the snapshot store named nameOfSnapshot is enabled in the node, pos
+   * infos are restored from its snapshot and journals instead of the db, the
+   * pos infos in the db are only compared with them in the background.
+   */
+  int init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
+           const std::string& sql, const std::string& nameOfSnapshot = "");
+
+  // inits with the pos infos loaded by the caller, which are owned by it
   int init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
-           const std::string& sql);
+           const PosInfoGroup& posInfoGroup);
 
   void setSyncToDB(SyncToDB value) { syncToDB_ = value; }
 
  private:
   int initPosInfoTable(const std::string& sql);
+  int initPosInfoTableFromSnapshot(const std::string& nameOfSnapshot);
+  void cmpPosInfoTableWithDB(const std::string& sql);
 
  public:
   PosChgInfoSPtr updateByOrderInfoFromTDGW(const OrderInfoSPtr& orderInfo,
                                            LockFunc lockFunc = LockFunc::False);
 
  private:
-  PosChgInfoSPtr updateByOrderInfo(const OrderInfoSPtr& orderInfo);
+  PosInfoShard& getPosInfoShard(AcctId acctId) {
+    return posInfoShardGroup_[acctId % NUM_OF_POS_INFO_SHARD];
+  }
 
-  PosChgInfoSPtr updateByOrderInfoSinglePosSide(const OrderInfoSPtr& orderInfo);
+  PosChgInfoSPtr updateByOrderInfo(const OrderInfoSPtr& orderInfo,
+                                   PosKey2PosInfo& posKey2PosInfo);
+
+  PosChgInfoSPtr updateByOrderInfoSinglePosSide(
+      const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo);
   PosChgInfoSPtr updateByOrderInfoSinglePosSideOfBid(
-      const OrderInfoSPtr& orderInfo);
+      const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo);
   PosChgInfoSPtr updateByOrderInfoSinglePosSideOfAsk(
-      const OrderInfoSPtr& orderInfo);
+      const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo);
 
-  PosChgInfoSPtr updateByOrderInfoDoublePosSide(const OrderInfoSPtr& orderInfo);
+  PosChgInfoSPtr updateByOrderInfoDoublePosSide(
+      const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo);
   PosChgInfoSPtr updateByOrderInfoDoublePosSideOfBidLong(
-      const OrderInfoSPtr& orderInfo);
+      const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo);
   PosChgInfoSPtr updateByOrderInfoDoublePosSideOfAskLong(
-      const OrderInfoSPtr& orderInfo);
+      const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo);
   PosChgInfoSPtr updateByOrderInfoDoublePosSideOfAskShort(
-      const OrderInfoSPtr& orderInfo);
+      const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo);
   PosChgInfoSPtr updateByOrderInfoDoublePosSideOfBidShort(
-      const OrderInfoSPtr& orderInfo);
+      const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo);
+
+  PosInfoSPtr getOrMakePosInfoWithKeyFields(const OrderInfoSPtr& orderInfo,
+                                            Side side,
+                                            PosKey2PosInfo& posKey2PosInfo);
 
  private:
   Decimal recalcAvgOpenPrice(const OrderInfoSPtr& orderInfo,
@@ -111,8 +137,10 @@ class PosMgr {
   db::DBEngSPtr dbEng_{nullptr};
   SyncToDB syncToDB_{SyncToDB::True};
 
-  PosInfoTableSPtr posInfoTable_{nullptr};
-  mutable std::ext::spin_mutex mtxPosInfoTable_;
+  std::array<PosInfoShard, NUM_OF_POS_INFO_SHARD> posInfoShardGroup_;
+
+  std::unique_ptr<std::thread> threadOfCmpWithDB_{nullptr};
+  SnapshotStoreSPtr<PosInfo> snapshotStore_{nullptr};
 };
 
 }  // namespace bq
@@ -0,0 +1,57 @@
+/*!
+ * \file PosKey.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "PosKey.hpp"
+
+#include "def/DataStruOfAssets.hpp"
+#include "def/DataStruOfTD.hpp"
+
+namespace bq {
+
+PosKey MakePosKey(const OrderInfo& orderInfo, Side side) {
+  PosKey ret;
+  ret.productId_ = orderInfo.productId_;
+  ret.userId_ = orderInfo.userId_;
+  ret.acctId_ = orderInfo.acctId_;
+  ret.stgId_ = orderInfo.stgId_;
+  ret.stgInstId_ = orderInfo.stgInstId_;
+  ret.marketCode_ = orderInfo.marketCode_;
+  ret.algoId_ = orderInfo.algoId_;
+  ret.parValue_ = orderInfo.parValue_;
+  ret.symbolType_ = orderInfo.symbolType_;
+  ret.side_ = side;
+  ret.posSide_ = orderInfo.posSide_;
+  strncpy(ret.symbolCode_, orderInfo.symbolCode_,
+          sizeof(ret.symbolCode_) - 1);
+  strncpy(ret.feeCurrency_, orderInfo.feeCurrency_,
+          sizeof(ret.feeCurrency_) - 1);
+  return ret;
+}
+
+PosKey MakePosKey(const PosInfo& posInfo) {
+  PosKey ret;
+  ret.productId_ = posInfo.productId_;
+  ret.userId_ = posInfo.userId_;
+  ret.acctId_ = posInfo.acctId_;
+  ret.stgId_ = posInfo.stgId_;
+  ret.stgInstId_ = posInfo.stgInstId_;
+  ret.marketCode_ = posInfo.marketCode_;
+  ret.algoId_ = posInfo.algoId_;
+  ret.parValue_ = posInfo.parValue_;
+  ret.symbolType_ = posInfo.symbolType_;
+  ret.side_ = posInfo.side_;
+  ret.posSide_ = posInfo.posSide_;
+  strncpy(ret.symbolCode_, posInfo.symbolCode_, sizeof(ret.symbolCode_) - 1);
+  strncpy(ret.feeCurrency_, posInfo.feeCurrency_,
+          sizeof(ret.feeCurrency_) - 1);
+  return ret;
+}
+
+}  // namespace bq
@@ -24,18 +24,51 @@
 
 namespace bq {
 
-PosMgr::PosMgr() : posInfoTable_(std::make_shared<PosInfoTable>()) {}
+PosMgr::PosMgr() {}
+
+PosMgr::~PosMgr() {
+  if (threadOfCmpWithDB_ && threadOfCmpWithDB_->joinable()) {
+    threadOfCmpWithDB_->join();
+  }
+}
 
 int PosMgr::init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
-                 const std::string& sql) {
+                 const std::string& sql, const std::string& nameOfSnapshot) {
   node_ = node;
   dbEng_ = dbEng;
 
-  const auto ret = initPosInfoTable(sql);
-  if (ret != 0) {
-    LOG_W("Init failed. [{}]", sql);
-    return ret;
+  if (initPosInfoTableFromSnapshot(nameOfSnapshot) == 0) {
+    threadOfCmpWithDB_ = std::make_unique<std::thread>(
+        [this, sql]() { cmpPosInfoTableWithDB(sql); });
+  } else {
+    const auto ret = initPosInfoTable(sql);
+    if (ret != 0) {
+      LOG_W("Init failed. [{}]", sql);
+      return ret;
+    }
+  }
+
+  if (snapshotStore_) {
+    const auto ret = snapshotStore_->start();
+    if (ret != 0) {
+      LOG_W("Init failed because of start snapshot store failed.");
+      return ret;
+    }
+  }
+  return 0;
+}
+
+int PosMgr::init(const YAML::Node& node, const db::DBEngSPtr& dbEng,
+                 const PosInfoGroup& posInfoGroup) {
+  node_ = node;
+  dbEng_ = dbEng;
+
+  for (const auto& posInfo : posInfoGroup) {
+    auto& posInfoShard = getPosInfoShard(posInfo->acctId_);
+    posInfoShard.posKey2PosInfo_.emplace(MakePosKey(*posInfo), posInfo);
   }
+  LOG_I("Init pos info group success. [size = {}]", posInfoGroup.size());
+
   return 0;
 }
 
@@ -50,19 +83,98 @@ int PosMgr::initPosInfoTable(const std::string& sql) {
   for (const auto& tblRec : *tblRecSet) {
     const auto recPosInfo = tblRec.second->getRecWithAllFields();
     const auto posInfo = MakePosInfo(recPosInfo);
-    posInfoTable_->emplace(posInfo);
+    auto& posInfoShard = getPosInfoShard(posInfo->acctId_);
+    posInfoShard.posKey2PosInfo_.emplace(MakePosKey(*posInfo), posInfo);
+  }
+  LOG_I("Init pos info group success. [size = {}]", tblRecSet->size());
+
+  return 0;
+}
+
+int PosMgr::initPosInfoTableFromSnapshot(const std::string& nameOfSnapshot) {
+  snapshotStore_ = MakeSnapshotStore<PosInfo>(node_, nameOfSnapshot, [this]() {
+    std::vector<PosInfo> ret;
+    for (const auto& posInfoShard : posInfoShardGroup_) {
+      std::lock_guard<std::ext::spin_mutex> guard(posInfoShard.mtx_);
+      for (const auto& [posKey, posInfo] : posInfoShard.posKey2PosInfo_) {
+        ret.emplace_back(*posInfo);
+      }
+    }
+    return ret;
+  });
+  if (!snapshotStore_) {
+    return SCODE_SNAPSHOT_NOT_EXISTS;
+  }
+
+  std::size_t num = 0;
+  const auto ret =
+      snapshotStore_->load([&](OpOfJournal op, const PosInfo& posInfo) {
+        auto& posKey2PosInfo =
+            getPosInfoShard(posInfo.acctId_).posKey2PosInfo_;
+        if (op == OpOfJournal::Upsert) {
+          posKey2PosInfo[MakePosKey(posInfo)] =
+              std::make_shared<PosInfo>(posInfo);
+        } else {
+          posKey2PosInfo.erase(MakePosKey(posInfo));
+        }
+      });
+  if (ret != 0) {
+    LOG_I("Init pos info group from snapshot {} failed, init from db.",
+          nameOfSnapshot);
+    for (auto& posInfoShard : posInfoShardGroup_) {
+      posInfoShard.posKey2PosInfo_.clear();
+    }
+    return ret;
   }
-  LOG_I("Init pos info group success. [size = {}]", posInfoTable_->size());
 
+  for (const auto& posInfoShard : posInfoShardGroup_) {
+    num += posInfoShard.posKey2PosInfo_.size();
+  }
+  LOG_I("Init pos info group from snapshot {} success. [size = {}]",
+        nameOfSnapshot, num);
   return 0;
 }
 
+void PosMgr::cmpPosInfoTableWithDB(const std::string& sql) {
+  const auto [ret, tblRecSet] =
+      db::TBLRecSetMaker<TBLPosInfo>::ExecSql(dbEng_, sql);
+  if (ret != 0) {
+    LOG_W("Compare pos info group with db failed. {}", sql);
+    return;
+  }
+
+  // the db is written behind, so the differences are only logged
+  std::size_t numOfPosInfoDiff = 0;
+  for (const auto& tblRec : *tblRecSet) {
+    const auto recPosInfo = tblRec.second->getRecWithAllFields();
+    const auto posInfo = MakePosInfo(recPosInfo);
+    PosInfoSPtr posInfoInPosMgr;
+    {
+      const auto& posInfoShard = getPosInfoShard(posInfo->acctId_);
+      std::lock_guard<std::ext::spin_mutex> guard(posInfoShard.mtx_);
+      const auto iter = posInfoShard.posKey2PosInfo_.find(MakePosKey(*posInfo));
+      if (iter != std::end(posInfoShard.posKey2PosInfo_)) {
+        posInfoInPosMgr = std::make_shared<PosInfo>(*iter->second);
+      }
+    }
+    if (!posInfoInPosMgr) {
+      LOG_I("Pos info in db not in pos mgr. {}", posInfo->toStr());
+      ++numOfPosInfoDiff;
+    } else if (!posInfoInPosMgr->isEqual(posInfo)) {
+      LOG_I("Pos info in db not equal to pos mgr. {}", posInfo->toStr());
+      ++numOfPosInfoDiff;
+    }
+  }
+  LOG_I(
+      "Compare pos info group with db finished. "
+      "[numInDB = {}; numOfPosInfoDiff = {}]",
+      tblRecSet->size(), numOfPosInfoDiff);
+}
+
 std::string PosMgr::toStr() const {
   std::string ret;
-  {
-    for (const auto& rec : *posInfoTable_) {
-      ret = ret + "\n" + rec->toStr();
-    }
+  for (const auto& rec : getPosInfoGroup(LockFunc::True)) {
+    ret = ret + "\n" + rec->toStr();
   }
   return ret;
 }
@@ -77,7 +189,8 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoFromTDGW(const OrderInfoSPtr& orderInfo,
   }
 
   {
-    SPIN_LOCK(mtxPosInfoTable_);
+    auto& posInfoShard = getPosInfoShard(orderInfo->acctId_);
+    SPIN_LOCK(posInfoShard.mtx_);
 
     if (orderInfo->symbolType_ == SymbolType::Spot ||
         orderInfo->symbolType_ == SymbolType::Perp ||
@@ -88,7 +201,14 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoFromTDGW(const OrderInfoSPtr& orderInfo,
         orderInfo->symbolType_ == SymbolType::CN_SecondBoard ||
         orderInfo->symbolType_ == SymbolType::CN_StartupBoard ||
         orderInfo->symbolType_ == SymbolType::CN_TechBoard) {
-      return updateByOrderInfo(orderInfo);
+      const auto ret =
+          updateByOrderInfo(orderInfo, posInfoShard.posKey2PosInfo_);
+      if (snapshotStore_) {
+        for (const auto& posInfo : *ret) {
+          snapshotStore_->append(OpOfJournal::Upsert, *posInfo);
+        }
+      }
+      return ret;
 
     } else {
       LOG_W("Unhandled symbolType {}.",
@@ -98,13 +218,14 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoFromTDGW(const OrderInfoSPtr& orderInfo,
   }
 }
 
-PosChgInfoSPtr PosMgr::updateByOrderInfo(const OrderInfoSPtr& orderInfo) {
+PosChgInfoSPtr PosMgr::updateByOrderInfo(const OrderInfoSPtr& orderInfo,
+                                         PosKey2PosInfo& posKey2PosInfo) {
   if (orderInfo->posSide_ == PosSide::Both) {
-    return updateByOrderInfoSinglePosSide(orderInfo);
+    return updateByOrderInfoSinglePosSide(orderInfo, posKey2PosInfo);
 
   } else if (orderInfo->posSide_ == PosSide::Long ||
              orderInfo->posSide_ == PosSide::Short) {
-    return updateByOrderInfoDoublePosSide(orderInfo);
+    return updateByOrderInfoDoublePosSide(orderInfo, posKey2PosInfo);
 
   } else {
     return std::make_shared<PosChgInfo>();
@@ -113,12 +234,12 @@ PosChgInfoSPtr PosMgr::updateByOrderInfo(const OrderInfoSPtr& orderInfo) {
 }
 
 PosChgInfoSPtr PosMgr::updateByOrderInfoSinglePosSide(
-    const OrderInfoSPtr& orderInfo) {
+    const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo) {
   if (orderInfo->side_ == Side::Bid) {
-    return updateByOrderInfoSinglePosSideOfBid(orderInfo);
+    return updateByOrderInfoSinglePosSideOfBid(orderInfo, posKey2PosInfo);
 
   } else if (orderInfo->side_ == Side::Ask) {
-    return updateByOrderInfoSinglePosSideOfAsk(orderInfo);
+    return updateByOrderInfoSinglePosSideOfAsk(orderInfo, posKey2PosInfo);
 
   } else {
     return std::make_shared<PosChgInfo>();
@@ -127,37 +248,16 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoSinglePosSide(
 }
 
 PosChgInfoSPtr PosMgr::updateByOrderInfoSinglePosSideOfBid(
-    const OrderInfoSPtr& orderInfo) {
+    const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo) {
   auto ret = std::make_shared<PosChgInfo>();
 
-  PosInfoSPtr origPosInfoOfBid;
-  PosInfoSPtr origPosInfoOfAsk;
-  auto& idx = posInfoTable_->get<TagMain>();
-
-  const auto posKeyOfBid = orderInfo->getPosKeyOfBid();
-  const auto posKeyOfBidHash =
-      XXH3_64bits(posKeyOfBid.data(), posKeyOfBid.size());
-  auto iterBid = idx.find(posKeyOfBidHash);
-  if (iterBid != std::end(idx)) {
-    origPosInfoOfBid = *iterBid;
-  } else {
-    origPosInfoOfBid = MakePosInfoOfContractWithKeyFields(orderInfo, Side::Bid);
-    posInfoTable_->emplace(origPosInfoOfBid);
-  }
-
-  const auto posKeyOfAsk = orderInfo->getPosKeyOfAsk();
-  const auto posKeyOfAskHash =
-      XXH3_64bits(posKeyOfAsk.data(), posKeyOfAsk.size());
-  auto iterAsk = idx.find(posKeyOfAskHash);
-  if (iterAsk != std::end(idx)) {
-    origPosInfoOfAsk = *iterAsk;
-  } else {
-    origPosInfoOfAsk = MakePosInfoOfContractWithKeyFields(orderInfo, Side::Ask);
-    posInfoTable_->emplace(origPosInfoOfAsk);
-  }
+  const auto origPosInfoOfBid =
+      getOrMakePosInfoWithKeyFields(orderInfo, Side::Bid, posKey2PosInfo);
+  const auto origPosInfoOfAsk =
+      getOrMakePosInfoWithKeyFields(orderInfo, Side::Ask, posKey2PosInfo);
 
   const auto origPosSide =
-      origPosInfoOfBid->pos_ >= (-1.0 * origPosInfoOfAsk->pos_)
+      origPosInfoOfBid->pos_ >= -origPosInfoOfAsk->pos_
           ? PosSide::Long
           : PosSide::Short;
 
@@ -205,38 +305,17 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoSinglePosSideOfBid(
 }
 
 PosChgInfoSPtr PosMgr::updateByOrderInfoSinglePosSideOfAsk(
-    const OrderInfoSPtr& orderInfo) {
+    const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo) {
   auto ret = std::make_shared<PosChgInfo>();
 
-  PosInfoSPtr origPosInfoOfBid;
-  PosInfoSPtr origPosInfoOfAsk;
-  auto& idx = posInfoTable_->get<TagMain>();
-
-  const auto posKeyOfBid = orderInfo->getPosKeyOfBid();
-  const auto posKeyOfBidHash =
-      XXH3_64bits(posKeyOfBid.data(), posKeyOfBid.size());
-  auto iterBid = idx.find(posKeyOfBidHash);
-  if (iterBid != std::end(idx)) {
-    origPosInfoOfBid = *iterBid;
-  } else {
-    origPosInfoOfBid = MakePosInfoOfContractWithKeyFields(orderInfo, Side::Bid);
-    posInfoTable_->emplace(origPosInfoOfBid);
-  }
-
-  const auto posKeyOfAsk = orderInfo->getPosKeyOfAsk();
-  const auto posKeyOfAskHash =
-      XXH3_64bits(posKeyOfAsk.data(), posKeyOfAsk.size());
-  auto iterAsk = idx.find(posKeyOfAskHash);
-  if (iterAsk != std::end(idx)) {
-    origPosInfoOfAsk = *iterAsk;
-  } else {
-    origPosInfoOfAsk = MakePosInfoOfContractWithKeyFields(orderInfo, Side::Ask);
-    posInfoTable_->emplace(origPosInfoOfAsk);
-  }
+  const auto origPosInfoOfBid =
+      getOrMakePosInfoWithKeyFields(orderInfo, Side::Bid, posKey2PosInfo);
+  const auto origPosInfoOfAsk =
+      getOrMakePosInfoWithKeyFields(orderInfo, Side::Ask, posKey2PosInfo);
 
   const auto origPosSide =
-      (-1.0 * origPosInfoOfAsk->pos_) >= origPosInfoOfBid->pos_ ? PosSide::Short
-                                                                : PosSide::Long;
+      -origPosInfoOfAsk->pos_ >= origPosInfoOfBid->pos_ ? PosSide::Short
+                                                         : PosSide::Long;
 
   if (origPosSide == PosSide::Short) {
     const auto newPos = origPosInfoOfAsk->pos_ + orderInfo->lastDealSize_;
@@ -282,13 +361,15 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoSinglePosSideOfAsk(
 }
 
 PosChgInfoSPtr PosMgr::updateByOrderInfoDoublePosSide(
-    const OrderInfoSPtr& orderInfo) {
+    const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo) {
   if (orderInfo->posSide_ == PosSide::Long) {
     if (orderInfo->side_ == Side::Bid) {
-      return updateByOrderInfoDoublePosSideOfBidLong(orderInfo);
+      return updateByOrderInfoDoublePosSideOfBidLong(orderInfo,
+                                                     posKey2PosInfo);
 
     } else if (orderInfo->side_ == Side::Ask) {
-      return updateByOrderInfoDoublePosSideOfAskLong(orderInfo);
+      return updateByOrderInfoDoublePosSideOfAskLong(orderInfo,
+                                                     posKey2PosInfo);
 
     } else {
       return std::make_shared<PosChgInfo>();
@@ -297,10 +378,12 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoDoublePosSide(
 
   } else if (orderInfo->posSide_ == PosSide::Short) {
     if (orderInfo->side_ == Side::Ask) {
-      return updateByOrderInfoDoublePosSideOfAskShort(orderInfo);
+      return updateByOrderInfoDoublePosSideOfAskShort(orderInfo,
+                                                      posKey2PosInfo);
 
     } else if (orderInfo->side_ == Side::Bid) {
-      return updateByOrderInfoDoublePosSideOfBidShort(orderInfo);
+      return updateByOrderInfoDoublePosSideOfBidShort(orderInfo,
+                                                      posKey2PosInfo);
 
     } else {
       return std::make_shared<PosChgInfo>();
@@ -314,23 +397,21 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoDoublePosSide(
 }
 
 PosChgInfoSPtr PosMgr::updateByOrderInfoDoublePosSideOfBidLong(
-    const OrderInfoSPtr& orderInfo) {
+    const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo) {
   auto ret = std::make_shared<PosChgInfo>();
 
-  auto& idx = posInfoTable_->get<TagMain>();
-  const auto posKey = orderInfo->getPosKey();
-  const auto posKeyHash = XXH3_64bits(posKey.data(), posKey.size());
-  auto iter = idx.find(posKeyHash);
-  if (iter == std::end(idx)) {
+  const auto posKey = MakePosKey(*orderInfo, orderInfo->side_);
+  auto iter = posKey2PosInfo.find(posKey);
+  if (iter == std::end(posKey2PosInfo)) {
     const auto posInfo = MakePosInfoOfContract(orderInfo);
-    posInfoTable_->emplace(posInfo);
+    posKey2PosInfo.emplace(posKey, posInfo);
     posInfo->totalBidSize_ += orderInfo->lastDealSize_;
     posInfo->lastNoUsedToCalcPos_ = orderInfo->noUsedToCalcPos_;
     ret->emplace_back(posInfo);
     return ret;
   }
 
-  auto& origPosInfo = *iter;
+  auto& origPosInfo = iter->second;
   const auto newPos = origPosInfo->pos_ + orderInfo->lastDealSize_;
   origPosInfo->fee_ = origPosInfo->fee_ + orderInfo->getFeeOfLastTrade();
   origPosInfo->totalBidSize_ += orderInfo->lastDealSize_;
@@ -345,24 +426,22 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoDoublePosSideOfBidLong(
 }
 
 PosChgInfoSPtr PosMgr::updateByOrderInfoDoublePosSideOfAskLong(
-    const OrderInfoSPtr& orderInfo) {
+    const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo) {
   auto ret = std::make_shared<PosChgInfo>();
 
-  auto& idx = posInfoTable_->get<TagMain>();
-  const auto posKeyOfBid = orderInfo->getPosKeyOfBid();
-  const auto posKeyOfBidHash =
-      XXH3_64bits(posKeyOfBid.data(), posKeyOfBid.size());
-  auto iter = idx.find(posKeyOfBidHash);
-  if (iter == std::end(idx) || (*iter)->pos_ == 0) {
-    LOG_W("Can not find long pos when ask long. {}", posKeyOfBid);
+  auto iter = posKey2PosInfo.find(MakePosKey(*orderInfo, Side::Bid));
+  if (iter == std::end(posKey2PosInfo) || iter->second->pos_ == 0) {
+    LOG_W("Can not find long pos when ask long. {}",
+          orderInfo->getPosKeyOfBid());
     return ret;
   }
 
-  auto& origPosInfo = *iter;
+  auto& origPosInfo = iter->second;
 
   auto newPos = origPosInfo->pos_ + orderInfo->lastDealSize_;
   if (newPos < 0) {  // like -3.469446951953614e-18 or invalid value
-    LOG_I("Long pos {} less than 0 after ask long. {}", newPos, posKeyOfBid);
+    LOG_I("Long pos {} less than 0 after ask long. {}", newPos,
+          orderInfo->getPosKeyOfBid());
     newPos = 0;
   }
   origPosInfo->fee_ = origPosInfo->fee_ + orderInfo->getFeeOfLastTrade();
@@ -379,23 +458,21 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoDoublePosSideOfAskLong(
 }
 
 PosChgInfoSPtr PosMgr::updateByOrderInfoDoublePosSideOfAskShort(
-    const OrderInfoSPtr& orderInfo) {
+    const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo) {
   auto ret = std::make_shared<PosChgInfo>();
 
-  auto& idx = posInfoTable_->get<TagMain>();
-  const auto posKey = orderInfo->getPosKey();
-  const auto posKeyHash = XXH3_64bits(posKey.data(), posKey.size());
-  auto iter = idx.find(posKeyHash);
-  if (iter == std::end(idx)) {
+  const auto posKey = MakePosKey(*orderInfo, orderInfo->side_);
+  auto iter = posKey2PosInfo.find(posKey);
+  if (iter == std::end(posKey2PosInfo)) {
     const auto posInfo = MakePosInfoOfContract(orderInfo);
-    posInfoTable_->emplace(posInfo);
+    posKey2PosInfo.emplace(posKey, posInfo);
     posInfo->totalAskSize_ += orderInfo->lastDealSize_;
     posInfo->lastNoUsedToCalcPos_ = orderInfo->noUsedToCalcPos_;
     ret->emplace_back(posInfo);
     return ret;
   }
 
-  auto& origPosInfo = *iter;
+  auto& origPosInfo = iter->second;
   const auto newPos = origPosInfo->pos_ + orderInfo->lastDealSize_;
   origPosInfo->fee_ = origPosInfo->fee_ + orderInfo->getFeeOfLastTrade();
   origPosInfo->totalAskSize_ += orderInfo->lastDealSize_;
@@ -410,25 +487,22 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoDoublePosSideOfAskShort(
 }
 
 PosChgInfoSPtr PosMgr::updateByOrderInfoDoublePosSideOfBidShort(
-    const OrderInfoSPtr& orderInfo) {
+    const OrderInfoSPtr& orderInfo, PosKey2PosInfo& posKey2PosInfo) {
   auto ret = std::make_shared<PosChgInfo>();
 
-  auto& idx = posInfoTable_->get<TagMain>();
-  const auto posKeyOfAsk = orderInfo->getPosKeyOfAsk();
-  const auto posKeyOfAskHash =
-      XXH3_64bits(posKeyOfAsk.data(), posKeyOfAsk.size());
-  auto iter = idx.find(posKeyOfAskHash);
-  if (iter == std::end(idx) || (*iter)->pos_ == 0) {
-    LOG_W("Can not find short pos when bid short. {}", posKeyOfAsk);
+  auto iter = posKey2PosInfo.find(MakePosKey(*orderInfo, Side::Ask));
+  if (iter == std::end(posKey2PosInfo) || iter->second->pos_ == 0) {
+    LOG_W("Can not find short pos when bid short. {}",
+          orderInfo->getPosKeyOfAsk());
     return ret;
   }
 
-  auto& origPosInfo = *iter;
+  auto& origPosInfo = iter->second;
 
   auto newPos = origPosInfo->pos_ + orderInfo->lastDealSize_;
   if (newPos > 0) {  // like 3.469446951953614e-18 or invalid value
     LOG_I("Short pos {} greater than 0 after bid short. {}", newPos,
-          posKeyOfAsk);
+          orderInfo->getPosKeyOfAsk());
     newPos = 0;
   }
   origPosInfo->fee_ = origPosInfo->fee_ + orderInfo->getFeeOfLastTrade();
@@ -444,6 +518,20 @@ PosChgInfoSPtr PosMgr::updateByOrderInfoDoublePosSideOfBidShort(
   return ret;
 }
 
+PosInfoSPtr PosMgr::getOrMakePosInfoWithKeyFields(
+    const OrderInfoSPtr& orderInfo, Side side,
+    PosKey2PosInfo& posKey2PosInfo) {
+  const auto posKey = MakePosKey(*orderInfo, side);
+  auto iter = posKey2PosInfo.find(posKey);
+  if (iter == std::end(posKey2PosInfo)) {
+    iter = posKey2PosInfo
+               .emplace(posKey,
+                        MakePosInfoOfContractWithKeyFields(orderInfo, side))
+               .first;
+  }
+  return iter->second;
+}
+
 Decimal PosMgr::recalcAvgOpenPrice(const OrderInfoSPtr& orderInfo,
                                    const PosInfoSPtr& origPosInfo,
                                    Decimal newPos) {
@@ -465,11 +553,26 @@ Decimal PosMgr::recalcAvgOpenPrice(const OrderInfoSPtr& orderInfo,
 
   } else if (orderInfo->symbolType_ == SymbolType::CPerp ||
              orderInfo->symbolType_ == SymbolType::CFutures) {
-    if (!isApproximatelyZero(origPosInfo->avgOpenPrice_)) {
-      ret = newPos / (origPosInfo->pos_ / origPosInfo->avgOpenPrice_ +
-                      orderInfo->lastDealSize_ / orderInfo->lastDealPrice_);
+    if constexpr (std::is_floating_point_v<Decimal>) {
+      if (!isApproximatelyZero(origPosInfo->avgOpenPrice_)) {
+        ret = newPos / (origPosInfo->pos_ / origPosInfo->avgOpenPrice_ +
+                        orderInfo->lastDealSize_ / orderInfo->lastDealPrice_);
+      } else {
+        ret = newPos / (orderInfo->lastDealSize_ / orderInfo->lastDealPrice_);
+      }
     } else {
-      ret = newPos / (orderInfo->lastDealSize_ / orderInfo->lastDealPrice_);
+      // Same as above without the small quotients, which lose precision
+      // with a fixed point decimal. The quotients taken are close to 1 and
+      // no two prices are multiplied, so nothing overflows either.
+      if (!isApproximatelyZero(origPosInfo->avgOpenPrice_)) {
+        const auto ratioOfPrice =
+            orderInfo->lastDealPrice_ / origPosInfo->avgOpenPrice_;
+        ret = orderInfo->lastDealPrice_ *
+              (newPos / (origPosInfo->pos_ * ratioOfPrice +
+                         orderInfo->lastDealSize_));
+      } else {
+        ret = orderInfo->lastDealPrice_ * (newPos / orderInfo->lastDealSize_);
+      }
     }
 
   } else {
@@ -483,7 +586,7 @@ Decimal PosMgr::calcCurPnlRealOfCloseShort(const OrderInfoSPtr& orderInfo,
                                            const PosInfoSPtr& origPosInfo,
                                            Decimal newPos) {
   const auto closePos =
-      newPos > 0 ? (origPosInfo->pos_ * -1) : orderInfo->lastDealSize_;
+      newPos > 0 ? -origPosInfo->pos_ : orderInfo->lastDealSize_;
 
   const auto ret = calcPnlOfCloseShort(
       orderInfo->symbolType_, origPosInfo->avgOpenPrice_,
@@ -496,7 +599,7 @@ Decimal PosMgr::calcCurPnlRealOfCloseLong(const OrderInfoSPtr& orderInfo,
                                           const PosInfoSPtr& origPosInfo,
                                           Decimal newPos) {
   const auto closePos =
-      newPos < 0 ? origPosInfo->pos_ : (orderInfo->lastDealSize_ * -1);
+      newPos < 0 ? origPosInfo->pos_ : -orderInfo->lastDealSize_;
 
   const auto ret = calcPnlOfCloseLong(
       orderInfo->symbolType_, origPosInfo->avgOpenPrice_,
@@ -507,12 +610,17 @@ Decimal PosMgr::calcCurPnlRealOfCloseLong(const OrderInfoSPtr& orderInfo,
 
 PosInfoGroup PosMgr::getPosInfoGroup(LockFunc lockFunc) const {
   PosInfoGroup ret;
-  {
-    SPIN_LOCK(mtxPosInfoTable_);
-    for (const auto& posInfo : *posInfoTable_) {
+  for (const auto& posInfoShard : posInfoShardGroup_) {
+    SPIN_LOCK(posInfoShard.mtx_);
+    for (const auto& [posKey, posInfo] : posInfoShard.posKey2PosInfo_) {
       ret.emplace_back(std::make_shared<PosInfo>(*posInfo));
     }
   }
+  // keep the order of the key hash as before the table was sharded
+  std::sort(std::begin(ret), std::end(ret),
+            [](const auto& lhs, const auto& rhs) {
+              return lhs->keyHash_ < rhs->keyHash_;
+            });
   return ret;
 }
 
@@ -522,7 +630,8 @@ void PosMgr::syncToDB(const PosInfoSPtr& posInfo) {
   }
   const auto identity = GET_RAND_STR();
   const auto sql = posInfo->getSqlOfReplace();
-  const auto [ret, execRet] = dbEng_->asyncExec(identity, sql);
+  const auto [ret, execRet] = dbEng_->asyncExec(
+      identity, sql, WriteLog::True, posInfo->getKey(), db::Coalesce::True);
   if (ret != 0) {
     LOG_W("Replace pos info from db failed. [{}]", sql);
   }
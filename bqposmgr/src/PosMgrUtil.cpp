@@ -32,8 +32,16 @@ Decimal calcPnlOfCloseShort(SymbolType symbolType, Decimal openPrice,
 
   } else if (symbolType == SymbolType::CPerp ||
              symbolType == SymbolType::CFutures) {
-    ret = static_cast<Decimal>(parValue) * closePos *
-          (1.0 / closePrice - 1.0 / openPrice);
+    if constexpr (std::is_floating_point_v<Decimal>) {
+      ret = static_cast<Decimal>(parValue) * closePos *
+            (1.0 / closePrice - 1.0 / openPrice);
+    } else {
+      // divides by each price in turn instead of by their product, which
+      // overflows the fixed decimal
+      const auto valueOfCoin =
+          static_cast<Decimal>(parValue) * closePos / closePrice;
+      ret = valueOfCoin * (openPrice - closePrice) / openPrice;
+    }
 
   } else {
     LOG_W("Unhandled symbolType {}.", magic_enum::enum_name(symbolType));
@@ -60,8 +68,16 @@ Decimal calcPnlOfCloseLong(SymbolType symbolType, Decimal openPrice,
 
   } else if (symbolType == SymbolType::CPerp ||
              symbolType == SymbolType::CFutures) {
-    ret = static_cast<Decimal>(parValue) * closePos *
-          (1.0 / openPrice - 1.0 / closePrice);
+    if constexpr (std::is_floating_point_v<Decimal>) {
+      ret = static_cast<Decimal>(parValue) * closePos *
+            (1.0 / openPrice - 1.0 / closePrice);
+    } else {
+      // divides by each price in turn instead of by their product, which
+      // overflows the fixed decimal
+      const auto valueOfCoin =
+          static_cast<Decimal>(parValue) * closePos / closePrice;
+      ret = valueOfCoin * (closePrice - openPrice) / openPrice;
+    }
 
   } else {
     LOG_W("Unhandled symbolType {}.", magic_enum::enum_name(symbolType));
@@ -10,21 +10,58 @@
 
 #include <benchmark/benchmark.h>
 
-class FixtureTest : public benchmark::Fixture {
- public:
-  void SetUp(const ::benchmark::State& state) {}
-  void TearDown(const ::benchmark::State& state) {}
-};
+#include "def/BQConst.hpp"
+#include "def/ConditionUtil.hpp"
+#include "def/DataStruOfTD.hpp"
+#include "util/BQUtil.hpp"
 
-BENCHMARK_DEFINE_F(FixtureTest, test)(benchmark::State& st) {
+using namespace bq;
+
+namespace {
+
+OrderInfoSPtr MakeOrderInfoForRouting() {
+  auto orderInfo = std::make_shared<OrderInfo>();
+  orderInfo->acctId_ = 10001;
+  orderInfo->marketCode_ = MarketCode::Binance;
+  orderInfo->symbolType_ = SymbolType::Perp;
+  strncpy(orderInfo->symbolCode_, "BTC-USDT",
+          sizeof(orderInfo->symbolCode_) - 1);
+  return orderInfo;
+}
+
+}  // namespace
+
+/*
+ * Per msg cost of routing an order to its thread by the hash of the str made
+ * of the condition fields, which is how orders were routed before.
+ */
+static void BM_GetHashFromOrderInfoInStrFmt(benchmark::State& st) {
+  const auto [statusCode, statusMsg, conditionFieldGroup] =
+      MakeConditionFieldGroup(ORDER_INFO_OFFLOAD_GRANULARITY);
+  const auto orderInfo = MakeOrderInfoForRouting();
+  for (auto _ : st) {
+    const auto s =
+        MakeConditioFieldInfoInStrFmt(orderInfo.get(), conditionFieldGroup);
+    benchmark::DoNotOptimize(XXH3_64bits(s.data(), s.size()));
+  }
+}
+BENCHMARK(BM_GetHashFromOrderInfoInStrFmt);
+
+/*
+ * Per msg cost of routing an order to its thread by the bytes of the compiled
+ * condition fields.
+ */
+static void BM_GetHashFromOrderInfo(benchmark::State& st) {
+  const auto [statusCode, statusMsg, conditionFieldGroup] =
+      MakeConditionFieldGroup(ORDER_INFO_OFFLOAD_GRANULARITY);
+  const auto [retOfCompile, msgOfCompile, compiledConditionFieldGroup] =
+      CompileConditionFieldGroup(conditionFieldGroup);
+  const auto orderInfo = MakeOrderInfoForRouting();
   for (auto _ : st) {
-    int times = st.range(0);
-    for (int i = 0; i < times; ++i) {
-    }
+    benchmark::DoNotOptimize(
+        GetHashFromOrderInfo(orderInfo.get(), compiledConditionFieldGroup));
   }
 }
-BENCHMARK_REGISTER_F(FixtureTest, test)
-    ->Unit(benchmark::kMicrosecond)
-    ->Arg(1000);
+BENCHMARK(BM_GetHashFromOrderInfo);
 
 BENCHMARK_MAIN();
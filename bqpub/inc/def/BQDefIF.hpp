@@ -13,6 +13,10 @@
 #include "def/BQConstIF.hpp"
 #include "util/PchBase.hpp"
 
+#if defined(BQ_FIXED_DECIMAL) || defined(BQ_FIXED_DECIMAL_128)
+#include "util/FixedDecimal.hpp"
+#endif
+
 namespace bq {
 
 template <typename Task>
@@ -24,7 +28,13 @@ using SHMIPCTaskSPtr = std::shared_ptr<SHMIPCTask>;
 using SHMIPCAsyncTask = AsyncTask<SHMIPCTaskSPtr>;
 using SHMIPCAsyncTaskSPtr = std::shared_ptr<SHMIPCAsyncTask>;
 
+#if defined(BQ_FIXED_DECIMAL_128)
+using Decimal = FixedDecimal128;
+#elif defined(BQ_FIXED_DECIMAL)
+using Decimal = FixedDecimal64;
+#else
 using Decimal = double;
+#endif
 
 using ProductId = std::uint16_t;
 
@@ -21,6 +21,18 @@ namespace bq {
 
 using ConditionFieldGroup = std::vector<std::string>;
 
+enum class TypeOfConditionField { Num = 1, Str = 2 };
+
+// the bytes of a condition field in OrderInfo
+struct CompiledConditionField {
+  std::size_t offset_{0};
+  std::size_t width_{0};
+  TypeOfConditionField type_{TypeOfConditionField::Num};
+};
+using CompiledConditionFieldGroup = std::vector<CompiledConditionField>;
+
+constexpr static std::size_t MAX_WIDTH_OF_COMPILED_CONDITION_FIELD_GROUP = 256;
+
 using ConditionTemplate = std::map<std::string, std::string>;
 
 using ConditionValue = std::map<std::string, std::string>;
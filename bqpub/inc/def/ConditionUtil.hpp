@@ -32,6 +32,18 @@ std::tuple<int, std::string, std::string, ConditionValue> MakeConditioValue(
 std::string MakeConditioFieldInfoInStrFmt(
     const OrderInfo* orderInfo, const ConditionFieldGroup& conditionFieldGroup);
 
+/*
+ * Compiles the condition fields into their offsets and widths in OrderInfo,
+ * so orders can be hashed by them without making a str of the fields.
+ */
+std::tuple<int, std::string, CompiledConditionFieldGroup>
+CompileConditionFieldGroup(const ConditionFieldGroup& conditionFieldGroup);
+
+// orders with the same condition fields have the same hash
+std::uint64_t GetHashOfConditionFields(
+    const OrderInfo* orderInfo,
+    const CompiledConditionFieldGroup& compiledConditionFieldGroup);
+
 std::tuple<int, std::string, bool> MatchConditionTemplate(
     const ConditionValue& conditionValue,
     const ConditionTemplate& conditionTemplate);
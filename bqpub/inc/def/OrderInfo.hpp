@@ -12,3 +12,14 @@
 
 #include "def/OrderInfoExt.hpp"
 #include "def/OrderInfoIF.hpp"
+
+// formats the order info as its short str, such as by the bin log
+template <>
+struct fmt::formatter<bq::OrderInfo> : fmt::formatter<std::string_view> {
+  template <typename FormatContext>
+  auto format(const bq::OrderInfo& orderInfo, FormatContext& ctx)
+      -> decltype(ctx.out()) {
+    return fmt::formatter<std::string_view>::format(orderInfo.toShortStr(),
+                                                    ctx);
+  }
+};
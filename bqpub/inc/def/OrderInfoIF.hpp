@@ -100,4 +100,23 @@ struct OrderInfo {
 
 inline OrderInfoSPtr MakeOrderInfo() { return std::make_shared<OrderInfo>(); }
 
+/*
+ * Order infos of one acct synced to the risk mgr in one msg, the msg id of
+ * each order info is kept in its own shm header. The order infos follow the
+ * struct, whose size is padded to its alignment, so each of them starts at an
+ * 8-byte boundary. They are copied in and out with memcpy.
+ */
+struct alignas(8) OrderInfoGroupForSync {
+  SHMHeader shmHeader_{MSG_ID_SYNC_ORDER_INFO_GROUP};
+  AcctId acctId_{0};
+  std::uint16_t num_{0};
+
+  char* getOrderInfoGroup() { return reinterpret_cast<char*>(this + 1); }
+  const char* getOrderInfoGroup() const {
+    return reinterpret_cast<const char*>(this + 1);
+  }
+};
+static_assert(sizeof(OrderInfoGroupForSync) % alignof(OrderInfo) == 0);
+static_assert(sizeof(OrderInfo) % alignof(OrderInfo) == 0);
+
 }  // namespace bq
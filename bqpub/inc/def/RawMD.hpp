@@ -22,7 +22,7 @@ struct AsyncTask;
 
 struct RawMD {
   RawMD(MsgType msgType, const void* data, std::uint32_t dataLen,
-        std::uint64_t localTs = GetTotalUSSince1970()) {
+        std::uint64_t localTs = GetTotalUSSince1970OfHotPath()) {
     msgType_ = msgType;
     localTs_ = localTs;
 
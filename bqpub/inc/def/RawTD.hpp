@@ -23,7 +23,7 @@ struct AsyncTask;
 struct RawTD {
   RawTD(MsgType msgType, void* data, std::uint32_t dataLen) {
     msgType_ = msgType;
-    localTs_ = GetTotalUSSince1970();
+    localTs_ = GetTotalUSSince1970OfHotPath();
 
     dataLen_ = dataLen;
     data_ = malloc(dataLen);
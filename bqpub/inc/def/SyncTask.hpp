@@ -10,28 +10,51 @@
 
 #pragma once
 
+#include "SHMIPCMsgId.hpp"
+#include "def/Const.hpp"
 #include "def/Def.hpp"
+#include "def/OrderInfo.hpp"
 #include "util/Pch.hpp"
 
 namespace bq {
 
+struct UpdateInfoOfAssetGroup;
+using UpdateInfoOfAssetGroupSPtr = std::shared_ptr<UpdateInfoOfAssetGroup>;
+
+struct PosInfo;
+using PosInfoSPtr = std::shared_ptr<PosInfo>;
+using PosChgInfo = std::vector<PosInfoSPtr>;
+using PosChgInfoSPtr = std::shared_ptr<PosChgInfo>;
+
 enum class SyncToRiskMgr { True = 1, False = 2 };
 
+/*
+ * The order info is copied into the task in place, so caching the sync of an
+ * order event allocs nothing once the buffer holding the task has grown. The
+ * asset and pos groups are built by the caller anyway and only referenced.
+ */
 struct SyncTask {
-  SyncTask(MsgId msgId, const std::any& task, SyncToRiskMgr syncToRiskMgr,
-           SyncToDB syncToDB)
-      : msgId_(msgId),
-        task_(task),
-        syncToRiskMgr_(syncToRiskMgr),
-        syncToDB_(syncToDB) {}
-  MsgId msgId_;
-  std::any task_;
+  std::uint64_t seqNo_{0};
+  MsgId msgId_{0};
   SyncToRiskMgr syncToRiskMgr_{SyncToRiskMgr::True};
   SyncToDB syncToDB_{SyncToDB::False};
+  OrderInfo orderInfo_;
+  UpdateInfoOfAssetGroupSPtr updateInfoOfAssetGroup_{nullptr};
+  PosChgInfoSPtr posChgInfo_{nullptr};
 };
-using SyncTaskSPtr = std::shared_ptr<SyncTask>;
 
-using SyncTaskGroup = std::vector<SyncTaskSPtr>;
-using SyncTaskGroupSPtr = std::shared_ptr<SyncTaskGroup>;
+// the tasks are owned by the buffer they are cached in
+using SyncTaskGroup = std::vector<const SyncTask*>;
+
+bool IsSyncTaskOfOrderInfo(const SyncTask& syncTask);
+
+/*
+ * Keeps only the latest task of each order id and msg id. An order info holds
+ * the full state of the order, fills included, so only the intermediate
+ * states are dropped. The tasks kept stay in the order of their latest
+ * occurrence, so the terminal state of an order is never sent before an
+ * earlier state of it. Tasks other than order infos are kept as they are.
+ */
+SyncTaskGroup CoalesceSyncTaskGroup(const SyncTaskGroup& syncTaskGroup);
 
 }  // namespace bq
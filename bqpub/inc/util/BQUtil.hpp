@@ -19,7 +19,12 @@ namespace bq {
 
 enum class MDType : std::uint8_t;
 
-using ConditionFieldGroup = std::vector<std::string>;
+struct OrderInfo;
+struct PosInfo;
+struct AssetInfo;
+
+struct CompiledConditionField;
+using CompiledConditionFieldGroup = std::vector<CompiledConditionField>;
 
 std::string convertTopic(const std::string& topic);
 
@@ -34,8 +39,18 @@ std::tuple<std::string, TopicHash> MakeTopicInfo(const std::string& marketCode,
                                                  MDType mdType,
                                                  const std::string& ext = "");
 
-std::uint64_t GetHashFromTask(const SHMIPCTaskSPtr& task,
-                              const ConditionFieldGroup& conditionFieldGroup);
+std::uint64_t GetHashFromTask(
+    const SHMIPCTaskSPtr& task,
+    const CompiledConditionFieldGroup& compiledConditionFieldGroup);
+
+// the same hash as that of the tasks which update the rec
+std::uint64_t GetHashFromOrderInfo(
+    const OrderInfo* orderInfo,
+    const CompiledConditionFieldGroup& compiledConditionFieldGroup);
+std::uint64_t GetHashFromPosInfo(
+    const PosInfo* posInfo,
+    const CompiledConditionFieldGroup& compiledConditionFieldGroup);
+std::uint64_t GetHashFromAssetInfo(const AssetInfo* assetInfo);
 
 AcctId GetAcctIdFromTask(const SHMIPCTaskSPtr& task);
 
@@ -57,6 +57,9 @@ class PosSnapshot {
   std::tuple<int, Key2PosInfoBundleSPtr> queryPosInfoGroupBy(
       const std::string& groupCond);
 
+  std::tuple<int, std::vector<Key2PosInfoBundleSPtr>>
+  queryPosInfoGroupByCondGroup(const std::vector<std::string>& groupCondGroup);
+
  private:
   PosSnapshotImplSPtr posSnapshotImpl_{nullptr};
 };
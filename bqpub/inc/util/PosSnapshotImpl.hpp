@@ -22,12 +22,43 @@ using PnlSPtr = std::shared_ptr<Pnl>;
 class PosSnapshotImpl;
 using PosSnapshotImplSPtr = std::shared_ptr<PosSnapshotImpl>;
 
+enum class PosInfoField : std::uint8_t {
+  ProductId,
+  UserId,
+  AcctId,
+  StgId,
+  StgInstId,
+  AlgoId,
+  MarketCode,
+  SymbolType,
+  SymbolCode,
+  Side,
+  PosSide,
+  ParValue,
+  FeeCurrency
+};
+
+struct GroupByField {
+  std::string fieldName_;
+  PosInfoField posInfoField_;
+};
+using GroupByFieldGroup = std::vector<GroupByField>;
+
 class PosSnapshotImpl {
-  inline static std::map<std::string, int> FieldName2NoInPosInfo{
-      {"productId", 0},   {"userId", 1}, {"acctId", 2},     {"stgId", 3},
-      {"stgInstId", 4},   {"algoId", 5}, {"marketCode", 6}, {"symbolType", 7},
-      {"symbolCode", 8},  {"side", 9},   {"posSide", 10},   {"parValue", 11},
-      {"feeCurrency", 12}};
+  inline static std::map<std::string, PosInfoField> FieldName2PosInfoField{
+      {"productId", PosInfoField::ProductId},
+      {"userId", PosInfoField::UserId},
+      {"acctId", PosInfoField::AcctId},
+      {"stgId", PosInfoField::StgId},
+      {"stgInstId", PosInfoField::StgInstId},
+      {"algoId", PosInfoField::AlgoId},
+      {"marketCode", PosInfoField::MarketCode},
+      {"symbolType", PosInfoField::SymbolType},
+      {"symbolCode", PosInfoField::SymbolCode},
+      {"side", PosInfoField::Side},
+      {"posSide", PosInfoField::PosSide},
+      {"parValue", PosInfoField::ParValue},
+      {"feeCurrency", PosInfoField::FeeCurrency}};
 
  public:
   PosSnapshotImpl(const PosSnapshotImpl&) = delete;
@@ -59,8 +90,24 @@ class PosSnapshotImpl {
   std::tuple<int, Key2PosInfoBundleSPtr> queryPosInfoGroupBy(
       const std::string& groupCond);
 
+  /*
+   * Groups the snapshot by all the conds in one pass, the result of each cond
+   * is in the same position as the cond in groupCondGroup.
+   */
+  std::tuple<int, std::vector<Key2PosInfoBundleSPtr>>
+  queryPosInfoGroupByCondGroup(const std::vector<std::string>& groupCondGroup);
+
+ private:
+  static std::tuple<int, GroupByFieldGroup> MakeGroupByFieldGroup(
+      const std::string& groupCond);
+
+  static void AppendKeyOfCond(std::string& keyOfCond,
+                              const GroupByFieldGroup& groupByFieldGroup,
+                              const PosInfo& posInfo);
+
  private:
   std::map<std::string, PosInfoSPtr> posInfoDetail_;
+  PosInfoGroup posInfoGroup_;
   MarketDataCacheSPtr marketDataCache_{nullptr};
 
   std::map<std::string, Key2PnlGroupSPtr> cond2Key2PnlGroup_;
@@ -0,0 +1,89 @@
+/*!
+ * \file SimedOrderMatcher.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/12/01
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "def/BQConst.hpp"
+#include "def/BQDef.hpp"
+#include "util/Pch.hpp"
+
+namespace bq {
+
+struct OrderInfo;
+struct Books;
+struct Trades;
+
+struct SimedFill {
+  OrderId orderId_{0};
+  Decimal price_{0};
+  Decimal size_{0};
+  LiquidityDirection liquidityDirection_{LiquidityDirection::Others};
+};
+using SimedFillGroup = std::vector<SimedFill>;
+
+/*
+ * Fills of the orders and the orders whose rest is canceled by the matcher,
+ * which are the rest of ioc orders and fok or make only orders which can not
+ * be matched as required.
+ */
+struct SimedMatchRet {
+  SimedFillGroup fillGroup_;
+  std::vector<OrderId> canceledOrderIdGroup_;
+};
+
+/*
+ * Matches simed orders against the books and trades of the market.
+ *
+ * An incoming order takes the liquidity of the latest books as taker, the
+ * size taken stays out of the books until the next books arrive. The rest of
+ * the order is queued behind the size of its price level in the books, the
+ * size ahead only shrinks, by cancels seen in later books and by trades at
+ * that price. Trades at the price of a resting order fill it as maker after
+ * the size ahead is used up, trades through the price fill it directly.
+ *
+ * Sizes are positive on both sides. Not thread safe.
+ */
+class SimedOrderMatcher {
+  struct Level {
+    Decimal price_{0};
+    Decimal size_{0};
+  };
+  using LevelGroup = std::vector<Level>;
+
+  struct RestingOrder {
+    OrderId orderId_{0};
+    Side side_{Side::Others};
+    Decimal price_{0};
+    Decimal leftSize_{0};
+    Decimal sizeAhead_{0};
+  };
+
+  struct SymbolOfMatcher {
+    LevelGroup asks_;
+    LevelGroup bids_;
+    std::vector<RestingOrder> restingOrderGroup_;
+  };
+  using SymbolCode2SymbolOfMatcher =
+      absl::node_hash_map<std::string, SymbolOfMatcher>;
+
+ public:
+  SimedMatchRet onOrder(const OrderInfo& orderInfo);
+  bool cancelOrder(const std::string& symbolCode, OrderId orderId);
+
+  void onBooks(const Books& books);
+  SimedMatchRet onTrades(const Trades& trades);
+
+  std::size_t getRestingOrderNum(const std::string& symbolCode) const;
+
+ private:
+  SymbolCode2SymbolOfMatcher symbolCode2SymbolOfMatcher_;
+};
+
+}  // namespace bq
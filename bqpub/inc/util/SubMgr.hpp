@@ -14,13 +14,10 @@
 #include "def/Def.hpp"
 #include "util/Pch.hpp"
 #include "util/StdExt.hpp"
+#include "util/SubRoutingTable.hpp"
 
 namespace bq {
 
-using SubscriberGroup = std::vector<ClientChannel>;
-using TopicHash2SubscriberGroup =
-    absl::node_hash_map<TopicHash, SubscriberGroup>;
-
 using Addr2SHMCliGroup = std::map<std::string, SHMCliSPtr>;
 using SHMCliGroup = std::vector<SHMCliSPtr>;
 
@@ -44,6 +41,18 @@ class SubMgr {
 
  public:
   SubscriberGroup getSubscriberGroupByTopicHash(TopicHash topicHash) const;
+
+  /*
+   * Used on the receive path, subscribers are visited without locks or
+   * copies. The callback must not sub or unsub.
+   */
+  template <typename Callback>
+  void forEachSubscriberOfTopicHash(TopicHash topicHash,
+                                    Callback&& callback) const {
+    subRoutingTable_.forEachSubscriber(topicHash,
+                                       std::forward<Callback>(callback));
+  }
+
   Addr2SHMCliGroup getSHMCliGroup() const;
 
  private:
@@ -55,6 +64,7 @@ class SubMgr {
 
   TopicHash2SubscriberGroup topicHash2SubscriberGroup_;
   mutable std::ext::spin_mutex mtxTopicHash2SubscriberGroup_;
+  SubRoutingTable subRoutingTable_;
 
   Addr2SHMCliGroup addr2SHMCliGroup_;
   mutable std::ext::spin_mutex mtxAddr2SHMCliGroup_;
@@ -0,0 +1,106 @@
+/*!
+ * \file SubRoutingTable.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "SHMIPCDef.hpp"
+#include "def/Def.hpp"
+#include "util/Pch.hpp"
+
+namespace bq {
+
+using SubscriberGroup = std::vector<ClientChannel>;
+using TopicHash2SubscriberGroup =
+    absl::node_hash_map<TopicHash, SubscriberGroup>;
+
+/*
+ * Read mostly routing table from topic hash to subscribers. Readers walk an
+ * immutable open addressing table without locks or copies, writers rebuild
+ * the table and retire the old one after the readers in flight have left.
+ *
+ * Subscribers are visited inside forEachSubscriber, the callback must not
+ * update the table.
+ */
+class SubRoutingTable {
+ public:
+  SubRoutingTable(const SubRoutingTable&) = delete;
+  SubRoutingTable& operator=(const SubRoutingTable&) = delete;
+  SubRoutingTable(const SubRoutingTable&&) = delete;
+  SubRoutingTable& operator=(const SubRoutingTable&&) = delete;
+
+  SubRoutingTable();
+  ~SubRoutingTable();
+
+ public:
+  void update(const TopicHash2SubscriberGroup& topicHash2SubscriberGroup);
+
+  template <typename Callback>
+  void forEachSubscriber(TopicHash topicHash, Callback&& callback) const {
+    const auto epoch = epoch_.load();
+    ReaderGuard readerGuard(readerNumGroup_[epoch & 1].value_);
+    const auto table = table_.load();
+    const auto slot = table->find(topicHash);
+    if (slot == nullptr) return;
+    const auto begin = table->subscriberGroup_.data() + slot->offset_;
+    for (auto iter = begin; iter != begin + slot->num_; ++iter) {
+      callback(*iter);
+    }
+  }
+
+  SubscriberGroup getSubscriberGroup(TopicHash topicHash) const;
+
+ private:
+  struct Slot {
+    TopicHash topicHash_{0};
+    std::uint32_t offset_{0};
+    std::uint32_t num_{0};
+  };
+
+  struct Table {
+    const Slot* find(TopicHash topicHash) const {
+      for (auto pos = topicHash & mask_;; pos = (pos + 1) & mask_) {
+        const auto& slot = slotGroup_[pos];
+        if (slot.num_ == 0) return nullptr;
+        if (slot.topicHash_ == topicHash) return &slot;
+      }
+    }
+    std::uint64_t mask_{0};
+    std::vector<Slot> slotGroup_;
+    std::vector<ClientChannel> subscriberGroup_;
+  };
+
+  struct alignas(64) ReaderNum {
+    std::atomic<std::uint64_t> value_{0};
+  };
+
+  struct ReaderGuard {
+    explicit ReaderGuard(std::atomic<std::uint64_t>& readerNum)
+        : readerNum_(readerNum) {
+      readerNum_.fetch_add(1);
+    }
+    ~ReaderGuard() { readerNum_.fetch_sub(1); }
+    std::atomic<std::uint64_t>& readerNum_;
+  };
+
+  static Table* MakeTable(
+      const TopicHash2SubscriberGroup& topicHash2SubscriberGroup);
+
+  void waitForReadersInFlight();
+
+ private:
+  std::atomic<Table*> table_{nullptr};
+
+  alignas(64) std::atomic<std::uint64_t> epoch_{0};
+  mutable ReaderNum readerNumGroup_[2];
+
+  std::mutex mtxUpdate_;
+};
+
+}  // namespace bq
@@ -0,0 +1,103 @@
+/*!
+ * \file SyncTaskBuffer.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "def/SyncTask.hpp"
+#include "util/Pch.hpp"
+#include "util/StdExt.hpp"
+
+namespace bq {
+
+class SyncTaskBuffer;
+using SyncTaskBufferSPtr = std::shared_ptr<SyncTaskBuffer>;
+
+/*
+ * Caches the sync tasks of many producers for a single flush thread.
+ *
+ * Each producer thread writes the tasks in place into its own pair of
+ * buffers, the flush thread flips all producers to the other buffer of the
+ * pair with one atomic op and takes the buffers written before, so neither
+ * side takes a lock and the buffers keep their capacity between flushes.
+ *
+ * The seq no and the buffer written are taken from the same atomic, so all
+ * the tasks of a flush are cached before the tasks of the next one, and the
+ * tasks of a flush are ordered by their seq no across the producers.
+ */
+class SyncTaskBuffer {
+  // 0 idle, 1 taking the seq no, 2 + no of the buffer being written
+  static constexpr std::uint32_t STATUS_OF_IDLE = 0;
+  static constexpr std::uint32_t STATUS_OF_TAKING_SEQ_NO = 1;
+  static constexpr std::uint32_t STATUS_OF_WRITING = 2;
+
+  struct Producer {
+    std::atomic<std::uint32_t> status_{STATUS_OF_IDLE};
+    std::vector<SyncTask> syncTaskGroup_[2];
+  };
+  using ProducerUPtr = std::unique_ptr<Producer>;
+
+ public:
+  static constexpr std::size_t MAX_NUM_OF_PRODUCER = 256;
+
+  SyncTaskBuffer(const SyncTaskBuffer&) = delete;
+  SyncTaskBuffer& operator=(const SyncTaskBuffer&) = delete;
+  SyncTaskBuffer(const SyncTaskBuffer&&) = delete;
+  SyncTaskBuffer& operator=(const SyncTaskBuffer&&) = delete;
+
+  explicit SyncTaskBuffer(std::size_t reservedSizeOfProducer = 1024);
+
+ public:
+  void cache(MsgId msgId, const OrderInfo& orderInfo,
+             SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB);
+
+  void cache(MsgId msgId,
+             const UpdateInfoOfAssetGroupSPtr& updateInfoOfAssetGroup,
+             SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB);
+
+  void cache(MsgId msgId, const PosChgInfoSPtr& posChgInfo,
+             SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB);
+
+  /*
+   * Only called by the flush thread. Returns the tasks cached since the last
+   * call, which stay valid until the next call.
+   */
+  const SyncTaskGroup& swap();
+
+ private:
+  template <typename InitSyncTask>
+  void cache(MsgId msgId, SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB,
+             InitSyncTask&& initSyncTask);
+
+  Producer* getProducer();
+  Producer* addProducer();
+
+  template <typename Func>
+  void forEachProducer(std::size_t numOfProducer, Func&& func);
+
+ private:
+  // the key of the producers of this buffer in the thread local cache
+  const std::uint64_t bufferId_;
+  const std::size_t reservedSizeOfProducer_;
+
+  // seq no << 1 | no of the buffer being written
+  std::atomic<std::uint64_t> seqNoAndBufferNo_{0};
+
+  std::vector<ProducerUPtr> producerGroup_;
+  std::atomic<std::size_t> numOfProducer_{0};
+  std::mutex mtxProducerGroup_;
+
+  // shared by the threads beyond MAX_NUM_OF_PRODUCER, which write under mtx
+  ProducerUPtr sharedProducer_{nullptr};
+  std::ext::spin_mutex mtxSharedProducer_;
+
+  SyncTaskGroup syncTaskGroup_;
+};
+
+}  // namespace bq
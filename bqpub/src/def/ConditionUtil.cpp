@@ -333,6 +333,81 @@ std::string MakeConditioFieldInfoInStrFmt(
   return conditionValueInStrFmt;
 }
 
+std::tuple<int, std::string, CompiledConditionFieldGroup>
+CompileConditionFieldGroup(const ConditionFieldGroup& conditionFieldGroup) {
+#define COMPILED_CONDITION_FIELD(field, type)                         \
+  CompiledConditionField {                                            \
+    offsetof(OrderInfo, field), sizeof(OrderInfo::field),             \
+        TypeOfConditionField::type                                    \
+  }
+  const static std::map<std::string, CompiledConditionField>
+      fieldName2CompiledConditionField = {
+          {FIELD_ACCT_ID, COMPILED_CONDITION_FIELD(acctId_, Num)},
+          {FIELD_MARKET_CODE, COMPILED_CONDITION_FIELD(marketCode_, Num)},
+          {FIELD_SYMBOL_CODE, COMPILED_CONDITION_FIELD(symbolCode_, Str)},
+          {FIELD_PRODUCT_ID, COMPILED_CONDITION_FIELD(productId_, Num)},
+          {FIELD_USER_ID, COMPILED_CONDITION_FIELD(userId_, Num)},
+          {FIELD_STG_ID, COMPILED_CONDITION_FIELD(stgId_, Num)},
+          {FIELD_STG_INST_ID, COMPILED_CONDITION_FIELD(stgInstId_, Num)},
+          {FIELD_ALGO_ID, COMPILED_CONDITION_FIELD(algoId_, Num)},
+          {FIELD_SYMBOL_TYPE, COMPILED_CONDITION_FIELD(symbolType_, Num)},
+          {FIELD_SIDE, COMPILED_CONDITION_FIELD(side_, Num)},
+          {FIELD_POS_SIDE, COMPILED_CONDITION_FIELD(posSide_, Num)},
+          {FIELD_PAR_VALUE, COMPILED_CONDITION_FIELD(parValue_, Num)},
+          {FIELD_ORDER_TYPE, COMPILED_CONDITION_FIELD(orderType_, Num)},
+          {FIELD_ORDER_TYPE_EXTRA,
+           COMPILED_CONDITION_FIELD(orderTypeExtra_, Num)},
+          {FIELD_FEE_CURRENCY, COMPILED_CONDITION_FIELD(feeCurrency_, Str)}};
+#undef COMPILED_CONDITION_FIELD
+
+  CompiledConditionFieldGroup ret;
+  std::size_t width = 0;
+  for (const auto& fieldName : conditionFieldGroup) {
+    const auto iter = fieldName2CompiledConditionField.find(fieldName);
+    if (iter == std::end(fieldName2CompiledConditionField)) {
+      const auto statusMsg = fmt::format(
+          "Compile condition field group failed "
+          "because of invalid field name {} in condition field Group.",
+          fieldName);
+      return {-1, statusMsg, ret};
+    }
+    ret.emplace_back(iter->second);
+    // a str also ends with a 0
+    width += iter->second.width_ + 1;
+  }
+
+  if (width > MAX_WIDTH_OF_COMPILED_CONDITION_FIELD_GROUP) {
+    const auto statusMsg = fmt::format(
+        "Compile condition field group failed "
+        "because of the width {} of the fields is greater than {}.",
+        width, MAX_WIDTH_OF_COMPILED_CONDITION_FIELD_GROUP);
+    return {-1, statusMsg, ret};
+  }
+
+  return {0, "", ret};
+}
+
+std::uint64_t GetHashOfConditionFields(
+    const OrderInfo* orderInfo,
+    const CompiledConditionFieldGroup& compiledConditionFieldGroup) {
+  char buf[MAX_WIDTH_OF_COMPILED_CONDITION_FIELD_GROUP];
+  std::size_t len = 0;
+  const auto data = reinterpret_cast<const char*>(orderInfo);
+  for (const auto& field : compiledConditionFieldGroup) {
+    if (field.type_ == TypeOfConditionField::Num) {
+      memcpy(buf + len, data + field.offset_, field.width_);
+      len += field.width_;
+    } else {
+      // the bytes after the end of a str may not be initialized
+      const auto lenOfStr = strnlen(data + field.offset_, field.width_);
+      memcpy(buf + len, data + field.offset_, lenOfStr);
+      len += lenOfStr;
+      buf[len++] = '\0';
+    }
+  }
+  return XXH3_64bits(buf, len);
+}
+
 std::tuple<int, std::string, bool> MatchConditionTemplate(
     const ConditionValue& conditionValue,
     const ConditionTemplate& conditionTemplate) {
@@ -0,0 +1,43 @@
+/*!
+ * \file SyncTask.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "def/SyncTask.hpp"
+
+#include "def/DataStruOfTD.hpp"
+
+namespace bq {
+
+bool IsSyncTaskOfOrderInfo(const SyncTask& syncTask) {
+  return syncTask.msgId_ == MSG_ID_ON_ORDER ||
+         syncTask.msgId_ == MSG_ID_ON_ORDER_RET ||
+         syncTask.msgId_ == MSG_ID_ON_CANCEL_ORDER ||
+         syncTask.msgId_ == MSG_ID_ON_CANCEL_ORDER_RET;
+}
+
+SyncTaskGroup CoalesceSyncTaskGroup(const SyncTaskGroup& syncTaskGroup) {
+  SyncTaskGroup ret;
+  std::set<std::tuple<OrderId, MsgId>> keyGroupOfSyncTaskKept;
+  for (auto iter = std::rbegin(syncTaskGroup); iter != std::rend(syncTaskGroup);
+       ++iter) {
+    const auto syncTask = *iter;
+    if (IsSyncTaskOfOrderInfo(*syncTask)) {
+      const auto isTheLatestOne =
+          keyGroupOfSyncTaskKept
+              .emplace(syncTask->orderInfo_.orderId_, syncTask->msgId_)
+              .second;
+      if (!isTheLatestOne) continue;
+    }
+    ret.emplace_back(syncTask);
+  }
+  std::reverse(std::begin(ret), std::end(ret));
+  return ret;
+}
+
+}  // namespace bq
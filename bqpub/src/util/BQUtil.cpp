@@ -84,8 +84,9 @@ std::tuple<std::string, TopicHash> MakeTopicInfo(const std::string& marketCode,
   return {topic, topicHash};
 }
 
-std::uint64_t GetHashFromTask(const SHMIPCTaskSPtr& task,
-                              const ConditionFieldGroup& conditionFieldGroup) {
+std::uint64_t GetHashFromTask(
+    const SHMIPCTaskSPtr& task,
+    const CompiledConditionFieldGroup& compiledConditionFieldGroup) {
   std::uint64_t ret = 0;
   const auto shmHeader = static_cast<const SHMHeader*>(task->data_);
   switch (shmHeader->msgId_) {
@@ -94,9 +95,7 @@ std::uint64_t GetHashFromTask(const SHMIPCTaskSPtr& task,
     case MSG_ID_ON_ORDER_RET:
     case MSG_ID_ON_CANCEL_ORDER_RET: {
       const auto orderInfo = static_cast<const OrderInfo*>(task->data_);
-      const auto s =
-          MakeConditioFieldInfoInStrFmt(orderInfo, conditionFieldGroup);
-      ret = XXH3_64bits(s.data(), s.size());
+      ret = GetHashFromOrderInfo(orderInfo, compiledConditionFieldGroup);
     } break;
     case MSG_ID_SYNC_ASSETS:
       ret = static_cast<const AssetInfoNotify*>(task->data_)->acctId_;
@@ -107,6 +106,37 @@ std::uint64_t GetHashFromTask(const SHMIPCTaskSPtr& task,
   return ret;
 }
 
+std::uint64_t GetHashFromOrderInfo(
+    const OrderInfo* orderInfo,
+    const CompiledConditionFieldGroup& compiledConditionFieldGroup) {
+  return GetHashOfConditionFields(orderInfo, compiledConditionFieldGroup);
+}
+
+std::uint64_t GetHashFromPosInfo(
+    const PosInfo* posInfo,
+    const CompiledConditionFieldGroup& compiledConditionFieldGroup) {
+  // a pos is updated by the orders with the same key fields
+  OrderInfo orderInfo{};
+  orderInfo.productId_ = posInfo->productId_;
+  orderInfo.userId_ = posInfo->userId_;
+  orderInfo.acctId_ = posInfo->acctId_;
+  orderInfo.stgId_ = posInfo->stgId_;
+  orderInfo.stgInstId_ = posInfo->stgInstId_;
+  orderInfo.algoId_ = posInfo->algoId_;
+  orderInfo.marketCode_ = posInfo->marketCode_;
+  orderInfo.symbolType_ = posInfo->symbolType_;
+  strncpy(orderInfo.symbolCode_, posInfo->symbolCode_,
+          sizeof(orderInfo.symbolCode_) - 1);
+  orderInfo.side_ = posInfo->side_;
+  orderInfo.posSide_ = posInfo->posSide_;
+  orderInfo.parValue_ = posInfo->parValue_;
+  return GetHashFromOrderInfo(&orderInfo, compiledConditionFieldGroup);
+}
+
+std::uint64_t GetHashFromAssetInfo(const AssetInfo* assetInfo) {
+  return assetInfo->acctId_;
+}
+
 AcctId GetAcctIdFromTask(const SHMIPCTaskSPtr& task) {
   AcctId ret = 0;
   const auto shmHeader = static_cast<const SHMHeader*>(task->data_);
@@ -120,6 +150,9 @@ AcctId GetAcctIdFromTask(const SHMIPCTaskSPtr& task) {
     case MSG_ID_SYNC_ASSETS:
       ret = static_cast<const AssetInfoNotify*>(task->data_)->acctId_;
       break;
+    case MSG_ID_SYNC_ORDER_INFO_GROUP:
+      ret = static_cast<const OrderInfoGroupForSync*>(task->data_)->acctId_;
+      break;
     default:
       break;
   }
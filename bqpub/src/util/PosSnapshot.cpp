@@ -53,4 +53,10 @@ std::tuple<int, Key2PosInfoBundleSPtr> PosSnapshot::queryPosInfoGroupBy(
   return posSnapshotImpl_->queryPosInfoGroupBy(groupCond);
 }
 
+std::tuple<int, std::vector<Key2PosInfoBundleSPtr>>
+PosSnapshot::queryPosInfoGroupByCondGroup(
+    const std::vector<std::string>& groupCondGroup) {
+  return posSnapshotImpl_->queryPosInfoGroupByCondGroup(groupCondGroup);
+}
+
 }  // namespace bq
@@ -16,6 +16,7 @@
 #include "def/StatusCode.hpp"
 #include "def/SymbolInfo.hpp"
 #include "util/BQUtil.hpp"
+#include "util/Float.hpp"
 #include "util/Logger.hpp"
 
 namespace bq {
@@ -23,7 +24,12 @@ namespace bq {
 PosSnapshotImpl::PosSnapshotImpl(
     const std::map<std::string, PosInfoSPtr>& posInfoDetail,
     const MarketDataCacheSPtr& marketDataCache)
-    : posInfoDetail_(posInfoDetail), marketDataCache_(marketDataCache) {}
+    : posInfoDetail_(posInfoDetail), marketDataCache_(marketDataCache) {
+  posInfoGroup_.reserve(posInfoDetail_.size());
+  for (const auto& rec : posInfoDetail_) {
+    posInfoGroup_.emplace_back(rec.second);
+  }
+}
 
 const std::map<std::string, PosInfoSPtr>& PosSnapshotImpl::getPosInfoDetail()
     const {
@@ -88,14 +94,18 @@ std::tuple<int, Key2PnlGroupSPtr> PosSnapshotImpl::queryPnlGroupBy(
     pnl->queryCond_ = rec.first;
     pnl->quoteCurrencyForCalc_ = quoteCurrencyForCalc;
 
+    ExactSum<Decimal> fee;
+    ExactSum<Decimal> pnlUnReal;
+    ExactSum<Decimal> pnlReal;
+
     const auto& posInfoGroup = rec.second;
     for (const auto& posInfo : *posInfoGroup) {
       const auto curPnl = posInfo->calcPnl(
           marketDataCache_, quoteCurrencyForCalc, quoteCurrencyForConv,
           origQuoteCurrencyOfUBasedContract);
-      pnl->fee_ += curPnl->fee_;
-      pnl->pnlUnReal_ += curPnl->pnlUnReal_;
-      pnl->pnlReal_ += curPnl->pnlReal_;
+      fee += curPnl->fee_;
+      pnlUnReal += curPnl->pnlUnReal_;
+      pnlReal += curPnl->pnlReal_;
 
       if (curPnl->updateTime_ < pnl->updateTime_ || 0 == pnl->updateTime_) {
         pnl->updateTime_ = curPnl->updateTime_;
@@ -111,6 +121,10 @@ std::tuple<int, Key2PnlGroupSPtr> PosSnapshotImpl::queryPnlGroupBy(
             posInfo->toStr());
       }
     }
+    pnl->fee_ = fee.get();
+    pnl->pnlUnReal_ = pnlUnReal.get();
+    pnl->pnlReal_ = pnlReal.get();
+
     const auto& keyOfCond = rec.first;
     key2PnlGroup->emplace(keyOfCond, pnl);
   }
@@ -154,62 +168,141 @@ std::tuple<int, PosInfoGroupSPtr> PosSnapshotImpl::queryPosInfoGroup(
 
 std::tuple<int, Key2PosInfoBundleSPtr> PosSnapshotImpl::queryPosInfoGroupBy(
     const std::string& groupCond) {
-  const auto makeKeyOfCond =
-      [this](const std::vector<std::string>& fieldNameGroupInCond,
-             const std::vector<std::string>& fieldValueGroupInKey) {
-        std::string ret;
-        for (const auto& fieldNameInCond : fieldNameGroupInCond) {
-          const auto iter = FieldName2NoInPosInfo.find(fieldNameInCond);
-          if (iter == std::end(FieldName2NoInPosInfo)) return std::string("");
-          const auto fieldValue = fieldValueGroupInKey[iter->second];
-          ret = ret + fmt::format("{}={}{}", fieldNameInCond, fieldValue,
-                                  SEP_OF_COND_AND);
-        }
-        if (!ret.empty()) ret.pop_back();
-        return ret;
-      };
-
-  const auto iter = cond2Key2PosInfoBundle_.find(groupCond);
-  if (iter != std::end(cond2Key2PosInfoBundle_)) {
-    LOG_D("Query Key2PosInfoBundle of {} from cache success.", groupCond);
-    return {0, iter->second};
+  const auto [statusCode, key2PosInfoBundleGroup] =
+      queryPosInfoGroupByCondGroup({groupCond});
+  if (statusCode != 0) {
+    return {statusCode, nullptr};
   }
+  return {0, key2PosInfoBundleGroup.front()};
+}
 
+std::tuple<int, std::vector<Key2PosInfoBundleSPtr>>
+PosSnapshotImpl::queryPosInfoGroupByCondGroup(
+    const std::vector<std::string>& groupCondGroup) {
+  struct GroupBy {
+    std::string groupCond_;
+    GroupByFieldGroup groupByFieldGroup_;
+    Key2PosInfoBundleSPtr key2PosInfoBundle_;
+  };
+
+  std::vector<Key2PosInfoBundleSPtr> ret(groupCondGroup.size());
+  std::vector<GroupBy> groupByGroup;
+  for (std::size_t no = 0; no < groupCondGroup.size(); ++no) {
+    const auto& groupCond = groupCondGroup[no];
+    const auto iter = cond2Key2PosInfoBundle_.find(groupCond);
+    if (iter != std::end(cond2Key2PosInfoBundle_)) {
+      LOG_D("Query Key2PosInfoBundle of {} from cache success.", groupCond);
+      ret[no] = iter->second;
+      continue;
+    }
+
+    const auto iterOfGroupBy = std::find_if(
+        std::begin(groupByGroup), std::end(groupByGroup),
+        [&](const auto& groupBy) { return groupBy.groupCond_ == groupCond; });
+    if (iterOfGroupBy != std::end(groupByGroup)) {
+      ret[no] = iterOfGroupBy->key2PosInfoBundle_;
+      continue;
+    }
+
+    auto [statusCode, groupByFieldGroup] = MakeGroupByFieldGroup(groupCond);
+    if (statusCode != 0) {
+      return {statusCode, {}};
+    }
+    ret[no] = std::make_shared<Key2PosInfoBundle>();
+    groupByGroup.emplace_back(
+        GroupBy{groupCond, std::move(groupByFieldGroup), ret[no]});
+  }
+
+  std::string keyOfCond;
+  for (const auto& posInfo : posInfoGroup_) {
+    for (const auto& groupBy : groupByGroup) {
+      keyOfCond.clear();
+      AppendKeyOfCond(keyOfCond, groupBy.groupByFieldGroup_, *posInfo);
+      auto& posInfoGroup = (*groupBy.key2PosInfoBundle_)[keyOfCond];
+      if (posInfoGroup == nullptr) {
+        posInfoGroup = std::make_shared<PosInfoGroup>();
+      }
+      posInfoGroup->emplace_back(posInfo);
+    }
+  }
+
+  for (const auto& groupBy : groupByGroup) {
+    cond2Key2PosInfoBundle_[groupBy.groupCond_] = groupBy.key2PosInfoBundle_;
+  }
+  return {0, ret};
+}
+
+std::tuple<int, GroupByFieldGroup> PosSnapshotImpl::MakeGroupByFieldGroup(
+    const std::string& groupCond) {
   std::vector<std::string> fieldNameGroupInCond;
   boost::algorithm::split(fieldNameGroupInCond, groupCond,
                           boost::is_any_of(SEP_OF_COND_AND));
-  if (fieldNameGroupInCond.empty()) {
-    LOG_W(
-        "Query posinfo group by {} failed "
-        "because of the query cond is invalid.",
-        groupCond);
-    return {SCODE_BQPUB_INVALID_QRY_COND, nullptr};
-  }
-
-  auto key2PosInfoBundle = std::make_shared<Key2PosInfoBundle>();
-  for (const auto& rec : posInfoDetail_) {
-    std::vector<std::string> fieldValueGroupInKey;
-    const auto& key = rec.first;
-    boost::algorithm::split(fieldValueGroupInKey, key, boost::is_any_of("/"));
 
-    const auto keyOfCond =
-        makeKeyOfCond(fieldNameGroupInCond, fieldValueGroupInKey);
-    if (keyOfCond.empty()) {
+  GroupByFieldGroup ret;
+  for (const auto& fieldNameInCond : fieldNameGroupInCond) {
+    const auto iter = FieldName2PosInfoField.find(fieldNameInCond);
+    if (iter == std::end(FieldName2PosInfoField)) {
       LOG_W(
-          "Query posinfo group by {} failed, "
-          "maybe the query cond is invalid.",
+          "Query posinfo group by {} failed "
+          "because of the query cond is invalid.",
           groupCond);
-      return {SCODE_BQPUB_INVALID_QRY_COND, nullptr};
+      return {SCODE_BQPUB_INVALID_QRY_COND, GroupByFieldGroup()};
     }
+    ret.emplace_back(GroupByField{fieldNameInCond, iter->second});
+  }
+  return {0, ret};
+}
 
-    if (key2PosInfoBundle->find(keyOfCond) == std::end(*key2PosInfoBundle)) {
-      (*key2PosInfoBundle)[keyOfCond] = std::make_shared<PosInfoGroup>();
+void PosSnapshotImpl::AppendKeyOfCond(
+    std::string& keyOfCond, const GroupByFieldGroup& groupByFieldGroup,
+    const PosInfo& posInfo) {
+  auto out = std::back_inserter(keyOfCond);
+  for (const auto& groupByField : groupByFieldGroup) {
+    if (!keyOfCond.empty()) keyOfCond.append(SEP_OF_COND_AND);
+    keyOfCond.append(groupByField.fieldName_);
+    keyOfCond.push_back('=');
+    switch (groupByField.posInfoField_) {
+      case PosInfoField::ProductId:
+        fmt::format_to(out, "{}", posInfo.productId_);
+        break;
+      case PosInfoField::UserId:
+        fmt::format_to(out, "{}", posInfo.userId_);
+        break;
+      case PosInfoField::AcctId:
+        fmt::format_to(out, "{}", posInfo.acctId_);
+        break;
+      case PosInfoField::StgId:
+        fmt::format_to(out, "{}", posInfo.stgId_);
+        break;
+      case PosInfoField::StgInstId:
+        fmt::format_to(out, "{}", posInfo.stgInstId_);
+        break;
+      case PosInfoField::AlgoId:
+        fmt::format_to(out, "{}", posInfo.algoId_);
+        break;
+      case PosInfoField::MarketCode:
+        keyOfCond.append(GetMarketName(posInfo.marketCode_));
+        break;
+      case PosInfoField::SymbolType:
+        keyOfCond.append(magic_enum::enum_name(posInfo.symbolType_));
+        break;
+      case PosInfoField::SymbolCode:
+        keyOfCond.append(posInfo.symbolCode_);
+        break;
+      case PosInfoField::Side:
+        keyOfCond.append(magic_enum::enum_name(posInfo.side_));
+        break;
+      case PosInfoField::PosSide:
+        keyOfCond.append(magic_enum::enum_name(posInfo.posSide_));
+        break;
+      case PosInfoField::ParValue:
+        fmt::format_to(out, "{}", posInfo.parValue_);
+        break;
+      case PosInfoField::FeeCurrency:
+        keyOfCond.append(posInfo.feeCurrency_);
+        break;
     }
-    (*key2PosInfoBundle)[keyOfCond]->emplace_back(rec.second);
   }
-
-  cond2Key2PosInfoBundle_[groupCond] = key2PosInfoBundle;
-  return {0, key2PosInfoBundle};
 }
 
 }  // namespace bq
@@ -0,0 +1,221 @@
+/*!
+ * \file SimedOrderMatcher.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/12/01
+ *
+ * \brief
+ */
+
+#include "util/SimedOrderMatcher.hpp"
+
+#include "def/DataStruOfMD.hpp"
+#include "def/DataStruOfTD.hpp"
+#include "util/Float.hpp"
+
+namespace bq {
+
+namespace {
+
+// whether a bid of priceOfBid and an ask of priceOfAsk can be matched
+bool IsCrossed(Decimal priceOfBid, Decimal priceOfAsk) {
+  return priceOfBid > priceOfAsk ||
+         isApproximatelyEqual(priceOfBid, priceOfAsk);
+}
+
+}  // namespace
+
+SimedMatchRet SimedOrderMatcher::onOrder(const OrderInfo& orderInfo) {
+  SimedMatchRet ret;
+  auto& symbol = symbolCode2SymbolOfMatcher_[orderInfo.symbolCode_];
+
+  const auto isBid = orderInfo.side_ == Side::Bid;
+  const auto price = orderInfo.orderPrice_;
+  auto leftSize = orderInfo.orderSize_ < 0 ? -orderInfo.orderSize_
+                                           : orderInfo.orderSize_;
+  auto& levelGroupOfOpposite = isBid ? symbol.asks_ : symbol.bids_;
+  const auto canBeMatched = [&](const Level& level) {
+    return isBid ? IsCrossed(price, level.price_)
+                 : IsCrossed(level.price_, price);
+  };
+
+  if (orderInfo.orderTypeExtra_ == OrderTypeExtra::MakeOnly &&
+      !levelGroupOfOpposite.empty() && canBeMatched(levelGroupOfOpposite[0])) {
+    ret.canceledOrderIdGroup_.emplace_back(orderInfo.orderId_);
+    return ret;
+  }
+
+  if (orderInfo.orderTypeExtra_ == OrderTypeExtra::Fok) {
+    Decimal sizeCanBeMatched = 0;
+    for (const auto& level : levelGroupOfOpposite) {
+      if (!canBeMatched(level)) break;
+      sizeCanBeMatched += level.size_;
+    }
+    if (isDefinitelyLessThan(sizeCanBeMatched, leftSize)) {
+      ret.canceledOrderIdGroup_.emplace_back(orderInfo.orderId_);
+      return ret;
+    }
+  }
+
+  auto iter = std::begin(levelGroupOfOpposite);
+  for (; iter != std::end(levelGroupOfOpposite); ++iter) {
+    if (isApproximatelyZero(leftSize) || !canBeMatched(*iter)) break;
+    const auto size = std::min(leftSize, iter->size_);
+    ret.fillGroup_.emplace_back(SimedFill{orderInfo.orderId_, iter->price_,
+                                          size, LiquidityDirection::Taker});
+    iter->size_ -= size;
+    leftSize -= size;
+    if (!isApproximatelyZero(iter->size_)) break;
+  }
+  levelGroupOfOpposite.erase(std::begin(levelGroupOfOpposite), iter);
+
+  if (isApproximatelyZero(leftSize)) {
+    return ret;
+  }
+
+  if (orderInfo.orderTypeExtra_ == OrderTypeExtra::Ioc ||
+      orderInfo.orderTypeExtra_ == OrderTypeExtra::Fok) {
+    ret.canceledOrderIdGroup_.emplace_back(orderInfo.orderId_);
+    return ret;
+  }
+
+  Decimal sizeAhead = 0;
+  for (const auto& level : isBid ? symbol.bids_ : symbol.asks_) {
+    if (isApproximatelyEqual(level.price_, price)) {
+      sizeAhead = level.size_;
+      break;
+    }
+  }
+  symbol.restingOrderGroup_.emplace_back(RestingOrder{
+      orderInfo.orderId_, orderInfo.side_, price, leftSize, sizeAhead});
+
+  return ret;
+}
+
+bool SimedOrderMatcher::cancelOrder(const std::string& symbolCode,
+                                    OrderId orderId) {
+  const auto iterOfSymbol = symbolCode2SymbolOfMatcher_.find(symbolCode);
+  if (iterOfSymbol == std::end(symbolCode2SymbolOfMatcher_)) {
+    return false;
+  }
+
+  auto& restingOrderGroup = iterOfSymbol->second.restingOrderGroup_;
+  const auto iter =
+      std::find_if(std::begin(restingOrderGroup), std::end(restingOrderGroup),
+                   [&](const auto& restingOrder) {
+                     return restingOrder.orderId_ == orderId;
+                   });
+  if (iter == std::end(restingOrderGroup)) {
+    return false;
+  }
+  restingOrderGroup.erase(iter);
+  return true;
+}
+
+void SimedOrderMatcher::onBooks(const Books& books) {
+  auto& symbol = symbolCode2SymbolOfMatcher_[books.mdHeader_.symbolCode_];
+
+  const auto assign = [](LevelGroup& levelGroup, const Depth* depthGroup) {
+    levelGroup.clear();
+    for (std::size_t i = 0; i < MAX_DEPTH_LEVEL; ++i) {
+      if (isApproximatelyZero(depthGroup[i].size_)) break;
+      levelGroup.emplace_back(Level{depthGroup[i].price_, depthGroup[i].size_});
+    }
+  };
+  assign(symbol.asks_, books.asks_);
+  assign(symbol.bids_, books.bids_);
+
+  // sizes ahead can only be canceled, sizes added later queue behind
+  for (auto& restingOrder : symbol.restingOrderGroup_) {
+    Decimal sizeOfLevel = 0;
+    for (const auto& level :
+         restingOrder.side_ == Side::Bid ? symbol.bids_ : symbol.asks_) {
+      if (isApproximatelyEqual(level.price_, restingOrder.price_)) {
+        sizeOfLevel = level.size_;
+        break;
+      }
+    }
+    restingOrder.sizeAhead_ = std::min(restingOrder.sizeAhead_, sizeOfLevel);
+  }
+}
+
+SimedMatchRet SimedOrderMatcher::onTrades(const Trades& trades) {
+  SimedMatchRet ret;
+  const auto iterOfSymbol =
+      symbolCode2SymbolOfMatcher_.find(trades.mdHeader_.symbolCode_);
+  if (iterOfSymbol == std::end(symbolCode2SymbolOfMatcher_)) {
+    return ret;
+  }
+  auto& restingOrderGroup = iterOfSymbol->second.restingOrderGroup_;
+
+  // an aggressive bid trades with asks and an aggressive ask with bids
+  const auto canBeMatched = [&](const RestingOrder& restingOrder) {
+    if (restingOrder.side_ == Side::Bid) {
+      return trades.side_ != Side::Bid &&
+             IsCrossed(restingOrder.price_, trades.price_);
+    } else {
+      return trades.side_ != Side::Ask &&
+             IsCrossed(trades.price_, restingOrder.price_);
+    }
+  };
+
+  std::vector<RestingOrder*> restingOrderGroupCanBeMatched;
+  for (auto& restingOrder : restingOrderGroup) {
+    if (canBeMatched(restingOrder)) {
+      restingOrderGroupCanBeMatched.emplace_back(&restingOrder);
+    }
+  }
+  // better prices first, then in the order of arrival
+  std::stable_sort(std::begin(restingOrderGroupCanBeMatched),
+                   std::end(restingOrderGroupCanBeMatched),
+                   [](const auto lhs, const auto rhs) {
+                     return lhs->side_ == Side::Bid ? lhs->price_ > rhs->price_
+                                                    : lhs->price_ < rhs->price_;
+                   });
+
+  auto leftSizeOfTrades = trades.size_;
+  for (const auto restingOrder : restingOrderGroupCanBeMatched) {
+    if (isApproximatelyZero(leftSizeOfTrades)) break;
+    if (isApproximatelyEqual(restingOrder->price_, trades.price_)) {
+      const auto sizeTradedAhead =
+          std::min(restingOrder->sizeAhead_, leftSizeOfTrades);
+      restingOrder->sizeAhead_ -= sizeTradedAhead;
+      if (isApproximatelyZero(leftSizeOfTrades - sizeTradedAhead)) continue;
+      const auto size =
+          std::min(restingOrder->leftSize_, leftSizeOfTrades - sizeTradedAhead);
+      ret.fillGroup_.emplace_back(SimedFill{restingOrder->orderId_,
+                                            restingOrder->price_, size,
+                                            LiquidityDirection::Maker});
+      restingOrder->leftSize_ -= size;
+      leftSizeOfTrades -= size;
+    } else {
+      const auto size = std::min(restingOrder->leftSize_, leftSizeOfTrades);
+      ret.fillGroup_.emplace_back(SimedFill{restingOrder->orderId_,
+                                            restingOrder->price_, size,
+                                            LiquidityDirection::Maker});
+      restingOrder->leftSize_ -= size;
+      leftSizeOfTrades -= size;
+    }
+  }
+
+  restingOrderGroup.erase(
+      std::remove_if(std::begin(restingOrderGroup), std::end(restingOrderGroup),
+                     [](const auto& restingOrder) {
+                       return isApproximatelyZero(restingOrder.leftSize_);
+                     }),
+      std::end(restingOrderGroup));
+
+  return ret;
+}
+
+std::size_t SimedOrderMatcher::getRestingOrderNum(
+    const std::string& symbolCode) const {
+  const auto iter = symbolCode2SymbolOfMatcher_.find(symbolCode);
+  if (iter == std::end(symbolCode2SymbolOfMatcher_)) {
+    return 0;
+  }
+  return iter->second.restingOrderGroup_.size();
+}
+
+}  // namespace bq
@@ -61,6 +61,7 @@ int SubMgr::sub(ClientChannel subscriber, const std::string& topic) {
         return SCODE_BQPUB_TOPIC_ALREADY_SUB;
       }
     }
+    subRoutingTable_.update(topicHash2SubscriberGroup_);
   }
 
   const auto ret = startSHMCliIfNotExists(internalTopic);
@@ -114,6 +115,8 @@ int SubMgr::unSub(ClientChannel subscriber, const std::string& topic) {
       return SCODE_BQPUB_TOPIC_NOT_SUB;
     }
     subscriberGroup.erase(iterSubscriber);
+    if (subscriberGroup.empty()) topicHash2SubscriberGroup_.erase(iter);
+    subRoutingTable_.update(topicHash2SubscriberGroup_);
     LOG_I("UNSUB {} [{}]", topic, internalTopic);
   }
   return 0;
@@ -121,16 +124,7 @@ int SubMgr::unSub(ClientChannel subscriber, const std::string& topic) {
 
 SubscriberGroup SubMgr::getSubscriberGroupByTopicHash(
     TopicHash topicHash) const {
-  SubscriberGroup ret;
-  {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxTopicHash2SubscriberGroup_);
-    const auto iter = topicHash2SubscriberGroup_.find(topicHash);
-    if (iter != std::end(topicHash2SubscriberGroup_)) {
-      const auto& subscriberGroup = iter->second;
-      ret.assign(std::begin(subscriberGroup), std::end(subscriberGroup));
-    }
-  }
-  return ret;
+  return subRoutingTable_.getSubscriberGroup(topicHash);
 }
 
 Addr2SHMCliGroup SubMgr::getSHMCliGroup() const {
@@ -0,0 +1,75 @@
+/*!
+ * \file SubRoutingTable.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "util/SubRoutingTable.hpp"
+
+namespace bq {
+
+SubRoutingTable::SubRoutingTable()
+    : table_(MakeTable(TopicHash2SubscriberGroup())) {}
+
+SubRoutingTable::~SubRoutingTable() { delete table_.load(); }
+
+void SubRoutingTable::update(
+    const TopicHash2SubscriberGroup& topicHash2SubscriberGroup) {
+  std::lock_guard<std::mutex> guard(mtxUpdate_);
+  const auto oldTable = table_.exchange(MakeTable(topicHash2SubscriberGroup));
+  waitForReadersInFlight();
+  delete oldTable;
+}
+
+SubscriberGroup SubRoutingTable::getSubscriberGroup(TopicHash topicHash) const {
+  SubscriberGroup ret;
+  forEachSubscriber(topicHash, [&](ClientChannel subscriber) {
+    ret.emplace_back(subscriber);
+  });
+  return ret;
+}
+
+SubRoutingTable::Table* SubRoutingTable::MakeTable(
+    const TopicHash2SubscriberGroup& topicHash2SubscriberGroup) {
+  // keep the load factor no more than 0.5 so that probes stay short
+  std::uint64_t capacity = 16;
+  while (capacity < topicHash2SubscriberGroup.size() * 2) capacity <<= 1;
+
+  auto table = new Table();
+  table->mask_ = capacity - 1;
+  table->slotGroup_.resize(capacity);
+  for (const auto& [topicHash, subscriberGroup] : topicHash2SubscriberGroup) {
+    if (subscriberGroup.empty()) continue;
+    auto pos = topicHash & table->mask_;
+    while (table->slotGroup_[pos].num_ != 0) pos = (pos + 1) & table->mask_;
+    auto& slot = table->slotGroup_[pos];
+    slot.topicHash_ = topicHash;
+    slot.offset_ = table->subscriberGroup_.size();
+    slot.num_ = subscriberGroup.size();
+    table->subscriberGroup_.insert(std::end(table->subscriberGroup_),
+                                   std::begin(subscriberGroup),
+                                   std::end(subscriberGroup));
+  }
+  return table;
+}
+
+/*
+ * A reader holding the old table has counted itself in one of the reader nums
+ * before the table was swapped, so the old table is no longer read once both
+ * of them have been seen as zero after the swap. The epoch is flipped before
+ * each wait so that new readers count themselves in the other one.
+ */
+void SubRoutingTable::waitForReadersInFlight() {
+  for (int i = 0; i < 2; ++i) {
+    const auto epoch = epoch_.fetch_add(1);
+    while (readerNumGroup_[epoch & 1].value_.load() != 0) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+}  // namespace bq
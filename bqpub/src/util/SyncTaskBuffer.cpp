@@ -0,0 +1,141 @@
+/*!
+ * \file SyncTaskBuffer.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "util/SyncTaskBuffer.hpp"
+
+#include "util/Logger.hpp"
+
+namespace bq {
+
+namespace {
+
+std::atomic<std::uint64_t> g_BufferIdOfSyncTask{0};
+
+}  // namespace
+
+SyncTaskBuffer::SyncTaskBuffer(std::size_t reservedSizeOfProducer)
+    : bufferId_(++g_BufferIdOfSyncTask),
+      reservedSizeOfProducer_(reservedSizeOfProducer),
+      producerGroup_(MAX_NUM_OF_PRODUCER),
+      sharedProducer_(std::make_unique<Producer>()) {}
+
+void SyncTaskBuffer::cache(MsgId msgId, const OrderInfo& orderInfo,
+                           SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB) {
+  cache(msgId, syncToRiskMgr, syncToDB,
+        [&](auto& syncTask) { syncTask.orderInfo_ = orderInfo; });
+}
+
+void SyncTaskBuffer::cache(
+    MsgId msgId, const UpdateInfoOfAssetGroupSPtr& updateInfoOfAssetGroup,
+    SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB) {
+  cache(msgId, syncToRiskMgr, syncToDB, [&](auto& syncTask) {
+    syncTask.updateInfoOfAssetGroup_ = updateInfoOfAssetGroup;
+  });
+}
+
+void SyncTaskBuffer::cache(MsgId msgId, const PosChgInfoSPtr& posChgInfo,
+                           SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB) {
+  cache(msgId, syncToRiskMgr, syncToDB,
+        [&](auto& syncTask) { syncTask.posChgInfo_ = posChgInfo; });
+}
+
+template <typename InitSyncTask>
+void SyncTaskBuffer::cache(MsgId msgId, SyncToRiskMgr syncToRiskMgr,
+                           SyncToDB syncToDB, InitSyncTask&& initSyncTask) {
+  const auto producer = getProducer();
+  std::unique_lock<std::ext::spin_mutex> guard(mtxSharedProducer_,
+                                               std::defer_lock);
+  if (producer == sharedProducer_.get()) guard.lock();
+
+  // the status is set before the buffer no is taken, so a flip that does not
+  // see it is always taken before the buffer no
+  producer->status_.store(STATUS_OF_TAKING_SEQ_NO);
+  const auto seqNoAndBufferNo = seqNoAndBufferNo_.fetch_add(2);
+  const auto bufferNo = seqNoAndBufferNo & 1;
+  producer->status_.store(STATUS_OF_WRITING + bufferNo,
+                          std::memory_order_release);
+
+  auto& syncTask = producer->syncTaskGroup_[bufferNo].emplace_back();
+  syncTask.seqNo_ = seqNoAndBufferNo >> 1;
+  syncTask.msgId_ = msgId;
+  syncTask.syncToRiskMgr_ = syncToRiskMgr;
+  syncTask.syncToDB_ = syncToDB;
+  initSyncTask(syncTask);
+
+  producer->status_.store(STATUS_OF_IDLE, std::memory_order_release);
+}
+
+const SyncTaskGroup& SyncTaskBuffer::swap() {
+  // the tasks returned by the last call are in the buffers written next
+  const auto bufferNo = seqNoAndBufferNo_.load() & 1;
+  syncTaskGroup_.clear();
+  forEachProducer(numOfProducer_.load(), [&](auto& producer) {
+    producer.syncTaskGroup_[bufferNo ^ 1].clear();
+  });
+
+  seqNoAndBufferNo_.fetch_xor(1);
+
+  forEachProducer(numOfProducer_.load(), [&](auto& producer) {
+    for (;;) {
+      const auto status = producer.status_.load();
+      if (status != STATUS_OF_TAKING_SEQ_NO &&
+          status != STATUS_OF_WRITING + bufferNo) {
+        break;
+      }
+    }
+    for (const auto& syncTask : producer.syncTaskGroup_[bufferNo]) {
+      syncTaskGroup_.emplace_back(&syncTask);
+    }
+  });
+
+  std::sort(std::begin(syncTaskGroup_), std::end(syncTaskGroup_),
+            [](const auto lhs, const auto rhs) {
+              return lhs->seqNo_ < rhs->seqNo_;
+            });
+  return syncTaskGroup_;
+}
+
+SyncTaskBuffer::Producer* SyncTaskBuffer::getProducer() {
+  thread_local std::vector<std::tuple<std::uint64_t, Producer*>>
+      bufferId2Producer;
+  for (const auto& [bufferId, producer] : bufferId2Producer) {
+    if (bufferId == bufferId_) return producer;
+  }
+  const auto producer = addProducer();
+  bufferId2Producer.emplace_back(bufferId_, producer);
+  return producer;
+}
+
+SyncTaskBuffer::Producer* SyncTaskBuffer::addProducer() {
+  std::lock_guard<std::mutex> guard(mtxProducerGroup_);
+  const auto numOfProducer = numOfProducer_.load();
+  if (numOfProducer == MAX_NUM_OF_PRODUCER) {
+    LOG_W("Too many producers of sync task, use the shared one. [num = {}]",
+          numOfProducer);
+    return sharedProducer_.get();
+  }
+
+  auto producer = std::make_unique<Producer>();
+  producer->syncTaskGroup_[0].reserve(reservedSizeOfProducer_);
+  producer->syncTaskGroup_[1].reserve(reservedSizeOfProducer_);
+  producerGroup_[numOfProducer] = std::move(producer);
+  numOfProducer_.store(numOfProducer + 1);
+  return producerGroup_[numOfProducer].get();
+}
+
+template <typename Func>
+void SyncTaskBuffer::forEachProducer(std::size_t numOfProducer, Func&& func) {
+  for (std::size_t i = 0; i < numOfProducer; ++i) {
+    func(*producerGroup_[i]);
+  }
+  func(*sharedProducer_);
+}
+
+}  // namespace bq
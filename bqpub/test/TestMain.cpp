@@ -15,10 +15,19 @@
 
 #include "def/BQConst.hpp"
 #include "def/BQDef.hpp"
+#include "def/ConditionUtil.hpp"
+#include "def/DataStruOfMD.hpp"
+#include "def/DataStruOfTD.hpp"
 #include "def/PosInfo.hpp"
 #include "def/SimedTDInfo.hpp"
+#include "def/StatusCode.hpp"
 #include "def/SymbolInfo.hpp"
+#include "def/SyncTask.hpp"
+#include "util/BQUtil.hpp"
 #include "util/PosSnapshotImpl.hpp"
+#include "util/SimedOrderMatcher.hpp"
+#include "util/SubRoutingTable.hpp"
+#include "util/SyncTaskBuffer.hpp"
 #include "util/TopicMgr.hpp"
 
 using namespace bq;
@@ -341,10 +350,334 @@ TEST(testPosSnapshotImpl, testPosSnapshotImplGroupBy) {
       posSnapshotImpl->queryPosInfoGroupBy("acctId&userId");
   EXPECT_TRUE((*posInfoGroup)["acctId=1&userId=2"]->size() == 2);
   EXPECT_TRUE((*posInfoGroup)["acctId=2&userId=1"]->size() == 2);
+
+  const auto [statusCode, key2PosInfoBundleGroup] =
+      posSnapshotImpl->queryPosInfoGroupByCondGroup(
+          {"userId", "acctId&userId", "stgId", "userId"});
+  EXPECT_TRUE(statusCode == 0);
+  EXPECT_TRUE(key2PosInfoBundleGroup.size() == 4);
+  EXPECT_TRUE((*key2PosInfoBundleGroup[0])["userId=1"]->size() == 2);
+  EXPECT_TRUE(key2PosInfoBundleGroup[1] == posInfoGroup);
+  EXPECT_TRUE((*key2PosInfoBundleGroup[2])["stgId=3"]->size() == 4);
+  EXPECT_TRUE(key2PosInfoBundleGroup[3] == key2PosInfoBundleGroup[0]);
+
+  EXPECT_TRUE(std::get<0>(posSnapshotImpl->queryPosInfoGroupBy(
+                  "acctId&volume")) == SCODE_BQPUB_INVALID_QRY_COND);
+}
+
+TEST(testSyncTask, testCoalesceSyncTaskGroup) {
+  std::vector<SyncTask> syncTaskGroupCached(7);
+  const auto makeSyncTask = [&](std::size_t no, MsgId msgId, OrderId orderId,
+                                OrderStatus orderStatus) {
+    auto& syncTask = syncTaskGroupCached[no];
+    syncTask.msgId_ = msgId;
+    syncTask.orderInfo_.orderId_ = orderId;
+    syncTask.orderInfo_.orderStatus_ = orderStatus;
+    return &syncTask;
+  };
+  syncTaskGroupCached[6].msgId_ = MSG_ID_SYNC_ASSETS;
+
+  const auto syncTaskGroup = CoalesceSyncTaskGroup({
+      makeSyncTask(0, MSG_ID_ON_ORDER_RET, 1, OrderStatus::ConfirmedByExch),
+      makeSyncTask(1, MSG_ID_ON_ORDER_RET, 2, OrderStatus::ConfirmedByExch),
+      makeSyncTask(2, MSG_ID_ON_ORDER_RET, 1, OrderStatus::PartialFilled),
+      makeSyncTask(3, MSG_ID_ON_CANCEL_ORDER_RET, 2, OrderStatus::Failed),
+      makeSyncTask(4, MSG_ID_ON_ORDER_RET, 2, OrderStatus::Filled),
+      makeSyncTask(5, MSG_ID_ON_ORDER_RET, 1, OrderStatus::Filled),
+      &syncTaskGroupCached[6],
+  });
+
+  EXPECT_TRUE(syncTaskGroup.size() == 4);
+  EXPECT_TRUE(syncTaskGroup[0]->msgId_ == MSG_ID_ON_CANCEL_ORDER_RET);
+  EXPECT_TRUE(syncTaskGroup[0]->orderInfo_.orderId_ == 2);
+  EXPECT_TRUE(syncTaskGroup[1]->orderInfo_.orderId_ == 2);
+  EXPECT_TRUE(syncTaskGroup[1]->orderInfo_.orderStatus_ ==
+              OrderStatus::Filled);
+  EXPECT_TRUE(syncTaskGroup[2]->orderInfo_.orderId_ == 1);
+  EXPECT_TRUE(syncTaskGroup[2]->orderInfo_.orderStatus_ ==
+              OrderStatus::Filled);
+  EXPECT_TRUE(syncTaskGroup[3]->msgId_ == MSG_ID_SYNC_ASSETS);
+}
+
+TEST(testSyncTask, testSyncTaskBuffer) {
+  SyncTaskBuffer syncTaskBuffer(16);
+  OrderInfo orderInfo;
+  orderInfo.orderId_ = 1;
+  syncTaskBuffer.cache(MSG_ID_ON_ORDER, orderInfo, SyncToRiskMgr::True,
+                       SyncToDB::True);
+  syncTaskBuffer.cache(MSG_ID_SYNC_POS_INFO, std::make_shared<PosChgInfo>(),
+                       SyncToRiskMgr::False, SyncToDB::True);
+  orderInfo.orderId_ = 2;
+  syncTaskBuffer.cache(MSG_ID_ON_CANCEL_ORDER, orderInfo, SyncToRiskMgr::True,
+                       SyncToDB::False);
+
+  const auto& syncTaskGroup = syncTaskBuffer.swap();
+  EXPECT_TRUE(syncTaskGroup.size() == 3);
+  EXPECT_TRUE(syncTaskGroup[0]->orderInfo_.orderId_ == 1);
+  EXPECT_TRUE(syncTaskGroup[1]->posChgInfo_ != nullptr);
+  EXPECT_TRUE(syncTaskGroup[2]->orderInfo_.orderId_ == 2);
+  EXPECT_TRUE(syncTaskGroup[2]->syncToDB_ == SyncToDB::False);
+  EXPECT_TRUE(syncTaskBuffer.swap().empty());
+
+  // the tasks of all producers are flushed once and in the order of seq no
+  constexpr std::size_t numOfProducer = 4;
+  constexpr std::size_t numOfTaskOfProducer = 100000;
+  std::atomic_bool stopped{false};
+  std::vector<std::size_t> numOfTaskRecv(numOfProducer, 0);
+  std::uint64_t seqNoOfPrev = 0;
+  bool ordered = true;
+  const auto handleSyncTaskGroup = [&]() {
+    for (const auto syncTask : syncTaskBuffer.swap()) {
+      if (syncTask->seqNo_ <= seqNoOfPrev) ordered = false;
+      seqNoOfPrev = syncTask->seqNo_;
+      ++numOfTaskRecv[syncTask->orderInfo_.acctId_];
+    }
+  };
+  std::thread threadOfFlush([&]() {
+    while (!stopped) handleSyncTaskGroup();
+  });
+
+  std::vector<std::thread> threadGroupOfProducer;
+  for (std::size_t i = 0; i < numOfProducer; ++i) {
+    threadGroupOfProducer.emplace_back([&, i]() {
+      OrderInfo orderInfo;
+      orderInfo.acctId_ = i;
+      for (std::size_t no = 0; no < numOfTaskOfProducer; ++no) {
+        syncTaskBuffer.cache(MSG_ID_ON_ORDER_RET, orderInfo,
+                             SyncToRiskMgr::True, SyncToDB::True);
+      }
+    });
+  }
+  for (auto& thread : threadGroupOfProducer) thread.join();
+  stopped = true;
+  threadOfFlush.join();
+  handleSyncTaskGroup();
+
+  EXPECT_TRUE(ordered);
+  for (const auto num : numOfTaskRecv) {
+    EXPECT_TRUE(num == numOfTaskOfProducer);
+  }
+}
+
+TEST(testBQUtil, testGetHashFromPosInfo) {
+  const auto [statusCode, statusMsg, conditionFieldGroup] =
+      MakeConditionFieldGroup(ORDER_INFO_OFFLOAD_GRANULARITY);
+  EXPECT_TRUE(statusCode == 0);
+  const auto [retOfCompile, msgOfCompile, compiledConditionFieldGroup] =
+      CompileConditionFieldGroup(conditionFieldGroup);
+  EXPECT_TRUE(retOfCompile == 0);
+
+  auto orderInfo = std::make_shared<OrderInfo>();
+  orderInfo->acctId_ = 10001;
+  orderInfo->stgId_ = 1;
+  orderInfo->marketCode_ = MarketCode::Binance;
+  orderInfo->symbolType_ = SymbolType::Perp;
+  strncpy(orderInfo->symbolCode_, "BTC-USDT",
+          sizeof(orderInfo->symbolCode_) - 1);
+  orderInfo->side_ = Side::Bid;
+  orderInfo->posSide_ = PosSide::Long;
+
+  // a pos is owned by the thread that handles the orders of it
+  const auto posInfo = MakePosInfoOfContract(orderInfo);
+  EXPECT_TRUE(
+      GetHashFromPosInfo(posInfo.get(), compiledConditionFieldGroup) ==
+      GetHashFromOrderInfo(orderInfo.get(), compiledConditionFieldGroup));
+
+  strncpy(posInfo->symbolCode_, "ETH-USDT", sizeof(posInfo->symbolCode_) - 1);
+  EXPECT_TRUE(
+      GetHashFromPosInfo(posInfo.get(), compiledConditionFieldGroup) !=
+      GetHashFromOrderInfo(orderInfo.get(), compiledConditionFieldGroup));
+}
+
+TEST(testConditionUtil, testGetHashOfConditionFields) {
+  const auto [statusCode, statusMsg, conditionFieldGroup] =
+      MakeConditionFieldGroup(ORDER_INFO_OFFLOAD_GRANULARITY);
+  EXPECT_TRUE(statusCode == 0);
+  const auto [retOfCompile, msgOfCompile, compiledConditionFieldGroup] =
+      CompileConditionFieldGroup(conditionFieldGroup);
+  EXPECT_TRUE(retOfCompile == 0);
+  EXPECT_TRUE(compiledConditionFieldGroup.size() == conditionFieldGroup.size());
+
+  const auto makeOrderInfo = [](const std::string& symbolCode) {
+    auto orderInfo = std::make_shared<OrderInfo>();
+    orderInfo->acctId_ = 10001;
+    orderInfo->marketCode_ = MarketCode::Binance;
+    strncpy(orderInfo->symbolCode_, symbolCode.c_str(),
+            sizeof(orderInfo->symbolCode_) - 1);
+    return orderInfo;
+  };
+
+  const auto orderInfo = makeOrderInfo("BTC-USDT");
+  const auto hash =
+      GetHashOfConditionFields(orderInfo.get(), compiledConditionFieldGroup);
+
+  // fields not in the condition do not change the hash
+  auto orderInfoOfSameKey = makeOrderInfo("BTC-USDT");
+  orderInfoOfSameKey->orderId_ = 2;
+  orderInfoOfSameKey->side_ = Side::Ask;
+  EXPECT_TRUE(GetHashOfConditionFields(orderInfoOfSameKey.get(),
+                                       compiledConditionFieldGroup) == hash);
+
+  // nor do the bytes after the end of a str field
+  orderInfoOfSameKey->symbolCode_[sizeof(orderInfo->symbolCode_) - 2] = 'X';
+  EXPECT_TRUE(GetHashOfConditionFields(orderInfoOfSameKey.get(),
+                                       compiledConditionFieldGroup) == hash);
+
+  const auto orderInfoOfOtherSymbol = makeOrderInfo("ETH-USDT");
+  EXPECT_TRUE(GetHashOfConditionFields(orderInfoOfOtherSymbol.get(),
+                                       compiledConditionFieldGroup) != hash);
+
+  auto orderInfoOfOtherAcct = makeOrderInfo("BTC-USDT");
+  orderInfoOfOtherAcct->acctId_ = 10002;
+  EXPECT_TRUE(GetHashOfConditionFields(orderInfoOfOtherAcct.get(),
+                                       compiledConditionFieldGroup) != hash);
+
+  const auto [retOfInvalidField, msgOfInvalidField, compiledOfInvalidField] =
+      CompileConditionFieldGroup({"acctId", "noSuchField"});
+  EXPECT_TRUE(retOfInvalidField != 0);
 }
 
 TEST(testTopicMgr, testTopicMgr) {}
 
+TEST(testSubRoutingTable, testSubRoutingTable) {
+  SubRoutingTable subRoutingTable;
+  EXPECT_TRUE(subRoutingTable.getSubscriberGroup(1).empty());
+
+  TopicHash2SubscriberGroup topicHash2SubscriberGroup;
+  for (TopicHash topicHash = 0; topicHash < 100; ++topicHash) {
+    // colliding hashes probe into the next slots
+    topicHash2SubscriberGroup[topicHash << 32] =
+        SubscriberGroup{static_cast<ClientChannel>(topicHash), 1000};
+  }
+  topicHash2SubscriberGroup[7] = SubscriberGroup();
+  subRoutingTable.update(topicHash2SubscriberGroup);
+
+  EXPECT_TRUE(subRoutingTable.getSubscriberGroup(7).empty());
+  EXPECT_TRUE(subRoutingTable.getSubscriberGroup(100ULL << 32).empty());
+  const auto subscriberGroup = subRoutingTable.getSubscriberGroup(42ULL << 32);
+  EXPECT_TRUE(subscriberGroup == SubscriberGroup({42, 1000}));
+
+  std::atomic_bool stopped{false};
+  std::atomic<std::uint64_t> numOfMismatch{0};
+  std::vector<std::thread> readerGroup;
+  for (int i = 0; i < 4; ++i) {
+    readerGroup.emplace_back([&]() {
+      while (!stopped) {
+        std::uint32_t sum = 0;
+        subRoutingTable.forEachSubscriber(
+            42ULL << 32, [&](ClientChannel subscriber) { sum += subscriber; });
+        if (sum != 1042 && sum != 1042 + 2000) ++numOfMismatch;
+      }
+    });
+  }
+  for (int i = 0; i < 100; ++i) {
+    topicHash2SubscriberGroup[42ULL << 32] =
+        i % 2 == 0 ? SubscriberGroup{42, 1000, 2000}
+                   : SubscriberGroup{42, 1000};
+    subRoutingTable.update(topicHash2SubscriberGroup);
+  }
+  stopped = true;
+  for (auto& reader : readerGroup) reader.join();
+  EXPECT_TRUE(numOfMismatch == 0);
+}
+
+TEST(testSimedOrderMatcher, testSimedOrderMatcher) {
+  auto books = std::make_unique<Books>();
+  strncpy(books->mdHeader_.symbolCode_, "BTC-USDT",
+          sizeof(books->mdHeader_.symbolCode_) - 1);
+  books->asks_[0] = Depth{101, 2};
+  books->asks_[1] = Depth{102, 3};
+  books->bids_[0] = Depth{99, 4};
+  books->bids_[1] = Depth{98, 5};
+
+  SimedOrderMatcher simedOrderMatcher;
+  simedOrderMatcher.onBooks(*books);
+
+  const auto makeOrder = [](OrderId orderId, Side side, Decimal price,
+                            Decimal size, OrderTypeExtra orderTypeExtra) {
+    OrderInfo orderInfo;
+    orderInfo.orderId_ = orderId;
+    strncpy(orderInfo.symbolCode_, "BTC-USDT",
+            sizeof(orderInfo.symbolCode_) - 1);
+    orderInfo.side_ = side;
+    orderInfo.orderPrice_ = price;
+    orderInfo.orderSize_ = size;
+    orderInfo.orderTypeExtra_ = orderTypeExtra;
+    return orderInfo;
+  };
+
+  // fok can not be filled by the 5 within the price
+  auto ret = simedOrderMatcher.onOrder(
+      makeOrder(1, Side::Bid, 102, 6, OrderTypeExtra::Fok));
+  EXPECT_TRUE(ret.fillGroup_.empty());
+  EXPECT_TRUE(ret.canceledOrderIdGroup_ == std::vector<OrderId>{1});
+
+  // make only crosses the best ask
+  ret = simedOrderMatcher.onOrder(
+      makeOrder(2, Side::Bid, 101, 1, OrderTypeExtra::MakeOnly));
+  EXPECT_TRUE(ret.canceledOrderIdGroup_ == std::vector<OrderId>{2});
+
+  // ioc sweeps 2 levels and cancels the rest
+  ret = simedOrderMatcher.onOrder(
+      makeOrder(3, Side::Bid, 102, 6, OrderTypeExtra::Ioc));
+  EXPECT_TRUE(ret.fillGroup_.size() == 2);
+  EXPECT_TRUE(ret.fillGroup_[0].price_ == 101 && ret.fillGroup_[0].size_ == 2);
+  EXPECT_TRUE(ret.fillGroup_[1].price_ == 102 && ret.fillGroup_[1].size_ == 3);
+  EXPECT_TRUE(ret.fillGroup_[1].liquidityDirection_ ==
+              LiquidityDirection::Taker);
+  EXPECT_TRUE(ret.canceledOrderIdGroup_ == std::vector<OrderId>{3});
+
+  // liquidity taken stays out until the next books
+  ret = simedOrderMatcher.onOrder(
+      makeOrder(4, Side::Bid, 102, 1, OrderTypeExtra::Ioc));
+  EXPECT_TRUE(ret.fillGroup_.empty());
+
+  // queued behind the 4 at 99
+  ret = simedOrderMatcher.onOrder(
+      makeOrder(5, Side::Bid, 99, 3, OrderTypeExtra::Normal));
+  EXPECT_TRUE(ret.fillGroup_.empty() && ret.canceledOrderIdGroup_.empty());
+  EXPECT_TRUE(simedOrderMatcher.getRestingOrderNum("BTC-USDT") == 1);
+
+  // 1 of the size ahead is canceled
+  books->bids_[0] = Depth{99, 3};
+  simedOrderMatcher.onBooks(*books);
+
+  auto trades = std::make_unique<Trades>();
+  strncpy(trades->mdHeader_.symbolCode_, "BTC-USDT",
+          sizeof(trades->mdHeader_.symbolCode_) - 1);
+  trades->price_ = 99;
+  trades->size_ = 2;
+  trades->side_ = Side::Ask;
+  ret = simedOrderMatcher.onTrades(*trades);
+  EXPECT_TRUE(ret.fillGroup_.empty());
+
+  trades->size_ = 2;
+  ret = simedOrderMatcher.onTrades(*trades);
+  EXPECT_TRUE(ret.fillGroup_.size() == 1);
+  EXPECT_TRUE(ret.fillGroup_[0].size_ == 1);
+  EXPECT_TRUE(ret.fillGroup_[0].liquidityDirection_ ==
+              LiquidityDirection::Maker);
+
+  // aggressive bids do not fill resting bids
+  trades->side_ = Side::Bid;
+  ret = simedOrderMatcher.onTrades(*trades);
+  EXPECT_TRUE(ret.fillGroup_.empty());
+
+  // trades through the price fill the rest
+  trades->price_ = 98;
+  trades->size_ = 5;
+  trades->side_ = Side::Ask;
+  ret = simedOrderMatcher.onTrades(*trades);
+  EXPECT_TRUE(ret.fillGroup_.size() == 1);
+  EXPECT_TRUE(ret.fillGroup_[0].price_ == 99 && ret.fillGroup_[0].size_ == 2);
+  EXPECT_TRUE(simedOrderMatcher.getRestingOrderNum("BTC-USDT") == 0);
+
+  ret = simedOrderMatcher.onOrder(
+      makeOrder(6, Side::Ask, 105, 1, OrderTypeExtra::Normal));
+  EXPECT_TRUE(simedOrderMatcher.cancelOrder("BTC-USDT", 6));
+  EXPECT_FALSE(simedOrderMatcher.cancelOrder("BTC-USDT", 6));
+}
+
 int main(int argc, char** argv) {
   testing::AddGlobalTestEnvironment(new global_event);
   testing::InitGoogleTest(&argc, argv);
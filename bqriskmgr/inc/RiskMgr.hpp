@@ -33,8 +33,8 @@ using TaskDispatcherSPtr = std::shared_ptr<TaskDispatcher<Task>>;
 class SubMgr;
 using SubMgrSPtr = std::shared_ptr<SubMgr>;
 
-class Scheduler;
-using SchedulerSPtr = std::shared_ptr<Scheduler>;
+class ScheduleTaskExecutor;
+using ScheduleTaskExecutorSPtr = std::shared_ptr<ScheduleTaskExecutor>;
 
 struct ScheduleTask;
 using ScheduleTaskSPtr = std::shared_ptr<ScheduleTask>;
@@ -146,7 +146,7 @@ class RiskMgr : public SvcBase {
   SHMSrvSPtr shmSrvOfPub_{nullptr};
 
   ScheduleTaskBundleSPtr scheduleTaskBundle_{nullptr};
-  SchedulerSPtr scheduleTaskBundleExecutor_{nullptr};
+  ScheduleTaskExecutorSPtr scheduleTaskBundleExecutor_{nullptr};
 };
 
 }  // namespace bq::riskmgr
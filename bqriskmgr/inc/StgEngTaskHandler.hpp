@@ -40,6 +40,7 @@ class StgEngTaskHandler {
  private:
   void handleMsgIdOnOrder(const SHMIPCAsyncTaskSPtr& asyncTask);
   void handleMsgIdOnCancelOrder(const SHMIPCAsyncTaskSPtr& asyncTask);
+  void handleMsgIdSyncOrderInfoGroup(const SHMIPCAsyncTaskSPtr& asyncTask);
 
   void handleMsgIdOnStgReg(const SHMIPCAsyncTaskSPtr& asyncTask);
 
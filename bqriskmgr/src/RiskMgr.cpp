@@ -31,7 +31,7 @@
 #include "util/Logger.hpp"
 #include "util/MarketDataCache.hpp"
 #include "util/ScheduleTaskBundle.hpp"
-#include "util/Scheduler.hpp"
+#include "util/ScheduleTaskExecutor.hpp"
 #include "util/StdExt.hpp"
 #include "util/String.hpp"
 #include "util/SubMgr.hpp"
@@ -98,9 +98,8 @@ int RiskMgr::doInit() {
 
   scheduleTaskBundle_ = std::make_shared<ScheduleTaskBundle>();
   initScheduleTaskBundle();
-  scheduleTaskBundleExecutor_ = std::make_shared<Scheduler>(
-      std::string("RISK_MGR"),
-      [this]() { ExecScheduleTaskBundle(getScheduleTaskBundle()); }, 1);
+  scheduleTaskBundleExecutor_ = std::make_shared<ScheduleTaskExecutor>(
+      std::string("RISK_MGR"), getScheduleTaskBundle());
 
   return 0;
 }
@@ -138,7 +137,7 @@ void RiskMgr::initTBLMonitorOfSymbolInfo() {
 void RiskMgr::initPosMgr() {
   posMgr_ = std::make_shared<PosMgr>();
   const auto sql = fmt::format("SELECT * FROM `posInfo`");
-  posMgr_->init(CONFIG, getDBEng(), sql);
+  posMgr_->init(CONFIG, getDBEng(), sql, "riskmgr-PosMgr");
 }
 
 void RiskMgr::initAssetsMgr() {
@@ -152,7 +151,7 @@ void RiskMgr::initOrdMgr() {
   const auto filled = magic_enum::enum_integer(OrderStatus::Filled);
   const auto sql = fmt::format(
       "SELECT * FROM `orderInfo` WHERE `orderStatus` < {}; ", filled);
-  ordMgr_->init(CONFIG, getDBEng(), sql);
+  ordMgr_->init(CONFIG, getDBEng(), sql, "riskmgr-OrdMgr");
 }
 
 int RiskMgr::initRiskMgrTaskDispatcher() {
@@ -188,6 +187,9 @@ int RiskMgr::initRiskMgrTaskDispatcher() {
       case MSG_ID_ON_CANCEL_ORDER:
         stgEngTaskHandler_->handleAsyncTask(asyncTask);
         break;
+      case MSG_ID_SYNC_ORDER_INFO_GROUP:
+        stgEngTaskHandler_->handleAsyncTask(asyncTask);
+        break;
       case MSG_ID_ON_STG_REG:
         stgEngTaskHandler_->handleAsyncTask(asyncTask);
         break;
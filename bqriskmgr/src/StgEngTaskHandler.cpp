@@ -41,6 +41,9 @@ void StgEngTaskHandler::handleAsyncTask(
     case MSG_ID_ON_CANCEL_ORDER:
       handleMsgIdOnCancelOrder(asyncTask);
       break;
+    case MSG_ID_SYNC_ORDER_INFO_GROUP:
+      handleMsgIdSyncOrderInfoGroup(asyncTask);
+      break;
     case MSG_ID_ON_STG_REG:
       handleMsgIdOnStgReg(asyncTask);
       break;
@@ -62,6 +65,23 @@ void StgEngTaskHandler::handleMsgIdOnCancelOrder(
   LOG_I("Recv cancel order {}", ordReq->toShortStr());
 }
 
+void StgEngTaskHandler::handleMsgIdSyncOrderInfoGroup(
+    const AsyncTaskSPtr<SHMIPCTaskSPtr>& asyncTask) {
+  const auto orderInfoGroupForSync =
+      static_cast<const OrderInfoGroupForSync*>(asyncTask->task_->data_);
+  auto orderInfoAddr = orderInfoGroupForSync->getOrderInfoGroup();
+  for (std::uint16_t i = 0; i < orderInfoGroupForSync->num_; ++i) {
+    const auto ordReq = std::make_shared<OrderInfo>();
+    memcpy(ordReq.get(), orderInfoAddr, sizeof(OrderInfo));
+    if (ordReq->shmHeader_.msgId_ == MSG_ID_ON_CANCEL_ORDER) {
+      LOG_I("Recv cancel order {}", ordReq->toShortStr());
+    } else {
+      LOG_I("Recv order {}", ordReq->toShortStr());
+    }
+    orderInfoAddr += sizeof(OrderInfo);
+  }
+}
+
 void StgEngTaskHandler::handleMsgIdOnStgReg(
     const AsyncTaskSPtr<SHMIPCTaskSPtr>& asyncTask) {
   const auto reqHeader = static_cast<const SHMHeader*>(asyncTask->task_->data_);
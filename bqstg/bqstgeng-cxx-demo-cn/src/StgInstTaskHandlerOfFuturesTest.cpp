@@ -11,6 +11,7 @@
 #include "StgInstTaskHandlerOfFuturesTest.hpp"
 
 #include "StgEng.hpp"
+#include "util/LatencyHist.hpp"
 #include "util/Literal.hpp"
 #include "util/Logger.hpp"
 
@@ -77,7 +78,7 @@ void StgInstTaskHandlerOfFuturesTest::onStgInstTimer(
 void StgInstTaskHandlerOfFuturesTest::onTrades(
     const StgInstInfoSPtr& stgInstInfo, const TradesSPtr& trades) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Trades", trades->mdHeader_.localTs_, 10000, 100);
+  LATENCY_PROBE("Stg.Trades", trades->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, trades->toStr());
@@ -90,7 +91,7 @@ void StgInstTaskHandlerOfFuturesTest::onTrades(
 void StgInstTaskHandlerOfFuturesTest::onOrders(
     const StgInstInfoSPtr& stgInstInfo, const OrdersSPtr& orders) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Orders", orders->mdHeader_.localTs_, 10000, 100);
+  LATENCY_PROBE("Stg.Orders", orders->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, orders->toStr());
@@ -99,7 +100,7 @@ void StgInstTaskHandlerOfFuturesTest::onOrders(
 void StgInstTaskHandlerOfFuturesTest::onBooks(
     const StgInstInfoSPtr& stgInstInfo, const BooksSPtr& books) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Books", books->mdHeader_.localTs_, 10000, 100);
+  LATENCY_PROBE("Stg.Books", books->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, books->toStr());
@@ -108,7 +109,7 @@ void StgInstTaskHandlerOfFuturesTest::onBooks(
 void StgInstTaskHandlerOfFuturesTest::onCandle(
     const StgInstInfoSPtr& stgInstInfo, const CandleSPtr& candle) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Candle", candle->mdHeader_.localTs_, 1000, 10);
+  LATENCY_PROBE("Stg.Candle", candle->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, candle->toStr());
@@ -117,7 +118,7 @@ void StgInstTaskHandlerOfFuturesTest::onCandle(
 void StgInstTaskHandlerOfFuturesTest::onTickers(
     const StgInstInfoSPtr& stgInstInfo, const TickersSPtr& tickers) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Tickers", tickers->mdHeader_.localTs_, 1000, 10);
+  LATENCY_PROBE("Stg.Tickers", tickers->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, tickers->toStr());
@@ -11,6 +11,7 @@
 #include "StgInstTaskHandlerOfCPerpTest.hpp"
 
 #include "StgEng.hpp"
+#include "util/LatencyHist.hpp"
 #include "util/Literal.hpp"
 #include "util/Logger.hpp"
 
@@ -76,7 +77,7 @@ void StgInstTaskHandlerOfCPerpTest::onStgInstTimer(
 void StgInstTaskHandlerOfCPerpTest::onTrades(const StgInstInfoSPtr& stgInstInfo,
                                              const TradesSPtr& trades) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Trades", trades->mdHeader_.localTs_, 10000, 100);
+  LATENCY_PROBE("Stg.Trades", trades->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, trades->toStr());
@@ -89,7 +90,7 @@ void StgInstTaskHandlerOfCPerpTest::onTrades(const StgInstInfoSPtr& stgInstInfo,
 void StgInstTaskHandlerOfCPerpTest::onBooks(const StgInstInfoSPtr& stgInstInfo,
                                             const BooksSPtr& books) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Books", books->mdHeader_.localTs_, 10000, 100);
+  LATENCY_PROBE("Stg.Books", books->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, books->toStr());
@@ -98,7 +99,7 @@ void StgInstTaskHandlerOfCPerpTest::onBooks(const StgInstInfoSPtr& stgInstInfo,
 void StgInstTaskHandlerOfCPerpTest::onCandle(const StgInstInfoSPtr& stgInstInfo,
                                              const CandleSPtr& candle) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Candle", candle->mdHeader_.localTs_, 1000, 10);
+  LATENCY_PROBE("Stg.Candle", candle->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, candle->toStr());
@@ -107,7 +108,7 @@ void StgInstTaskHandlerOfCPerpTest::onCandle(const StgInstInfoSPtr& stgInstInfo,
 void StgInstTaskHandlerOfCPerpTest::onTickers(
     const StgInstInfoSPtr& stgInstInfo, const TickersSPtr& tickers) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Tickers", tickers->mdHeader_.localTs_, 1000, 10);
+  LATENCY_PROBE("Stg.Tickers", tickers->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, tickers->toStr());
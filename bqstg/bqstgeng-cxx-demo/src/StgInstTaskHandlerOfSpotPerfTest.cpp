@@ -11,6 +11,7 @@
 #include "StgInstTaskHandlerOfSpotPerfTest.hpp"
 
 #include "StgEng.hpp"
+#include "util/LatencyHist.hpp"
 #include "util/Literal.hpp"
 #include "util/Logger.hpp"
 #include "util/PosSnapshot.hpp"
@@ -156,7 +157,7 @@ void StgInstTaskHandlerOfSpotPerfTest::onStgInstTimer(
 void StgInstTaskHandlerOfSpotPerfTest::onTrades(
     const StgInstInfoSPtr& stgInstInfo, const TradesSPtr& trades) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Trades", trades->mdHeader_.localTs_, 10000, 100);
+  LATENCY_PROBE("Stg.Trades", trades->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, trades->toStr());
@@ -169,7 +170,7 @@ void StgInstTaskHandlerOfSpotPerfTest::onTrades(
 void StgInstTaskHandlerOfSpotPerfTest::onBooks(
     const StgInstInfoSPtr& stgInstInfo, const BooksSPtr& books) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Books", books->mdHeader_.localTs_, 10000, 100);
+  LATENCY_PROBE("Stg.Books", books->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, books->toStr());
@@ -178,7 +179,7 @@ void StgInstTaskHandlerOfSpotPerfTest::onBooks(
 void StgInstTaskHandlerOfSpotPerfTest::onCandle(
     const StgInstInfoSPtr& stgInstInfo, const CandleSPtr& candle) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Candle", candle->mdHeader_.localTs_, 1000, 10);
+  LATENCY_PROBE("Stg.Candle", candle->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, candle->toStr());
@@ -187,7 +188,7 @@ void StgInstTaskHandlerOfSpotPerfTest::onCandle(
 void StgInstTaskHandlerOfSpotPerfTest::onTickers(
     const StgInstInfoSPtr& stgInstInfo, const TickersSPtr& tickers) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Tickers", tickers->mdHeader_.localTs_, 1000, 10);
+  LATENCY_PROBE("Stg.Tickers", tickers->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, tickers->toStr());
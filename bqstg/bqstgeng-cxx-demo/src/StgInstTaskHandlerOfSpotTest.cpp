@@ -12,6 +12,7 @@
 
 #include "StgEng.hpp"
 #include "def/CommonIPCData.hpp"
+#include "util/LatencyHist.hpp"
 #include "util/Literal.hpp"
 #include "util/Logger.hpp"
 #include "util/PosSnapshot.hpp"
@@ -180,7 +181,7 @@ void StgInstTaskHandlerOfSpotTest::onStgInstTimer(
 void StgInstTaskHandlerOfSpotTest::onTrades(const StgInstInfoSPtr& stgInstInfo,
                                             const TradesSPtr& trades) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Trades", trades->mdHeader_.localTs_, 10000, 100);
+  LATENCY_PROBE("Stg.Trades", trades->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, trades->toStr());
@@ -193,7 +194,7 @@ void StgInstTaskHandlerOfSpotTest::onTrades(const StgInstInfoSPtr& stgInstInfo,
 void StgInstTaskHandlerOfSpotTest::onBooks(const StgInstInfoSPtr& stgInstInfo,
                                            const BooksSPtr& books) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Books", books->mdHeader_.localTs_, 10000, 100);
+  LATENCY_PROBE("Stg.Books", books->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, books->toStr());
@@ -202,7 +203,7 @@ void StgInstTaskHandlerOfSpotTest::onBooks(const StgInstInfoSPtr& stgInstInfo,
 void StgInstTaskHandlerOfSpotTest::onCandle(const StgInstInfoSPtr& stgInstInfo,
                                             const CandleSPtr& candle) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Candle", candle->mdHeader_.localTs_, 1000, 10);
+  LATENCY_PROBE("Stg.Candle", candle->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, candle->toStr());
@@ -211,7 +212,7 @@ void StgInstTaskHandlerOfSpotTest::onCandle(const StgInstInfoSPtr& stgInstInfo,
 void StgInstTaskHandlerOfSpotTest::onTickers(const StgInstInfoSPtr& stgInstInfo,
                                              const TickersSPtr& tickers) {
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Tickers", tickers->mdHeader_.localTs_, 1000, 10);
+  LATENCY_PROBE("Stg.Tickers", tickers->mdHeader_.localTs_);
   return;
 #endif
   LOG_D("{}: {}", stgInstInfo->stgInstId_, tickers->toStr());
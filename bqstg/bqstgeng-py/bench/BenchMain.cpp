@@ -10,21 +10,72 @@
 
 #include <benchmark/benchmark.h>
 
-class FixtureTest : public benchmark::Fixture {
- public:
-  void SetUp(const ::benchmark::State& state) {}
-  void TearDown(const ::benchmark::State& state) {}
-};
+#include "MarketDataView.hpp"
+#include "def/DataStruOfMD.hpp"
 
-BENCHMARK_DEFINE_F(FixtureTest, test)(benchmark::State& st) {
+using namespace bq;
+using namespace bq::stg;
+
+namespace {
+
+BooksSPtr MakeBooks() {
+  const auto ret = std::make_shared<Books>();
+  ret->mdHeader_.marketCode_ = MarketCode::Binance;
+  ret->mdHeader_.symbolType_ = SymbolType::Spot;
+  strncpy(ret->mdHeader_.symbolCode_, "BTC-USDT",
+          sizeof(ret->mdHeader_.symbolCode_) - 1);
+  ret->mdHeader_.mdType_ = MDType::Books;
+  for (std::uint32_t level = 0; level < MAX_DEPTH_LEVEL; ++level) {
+    ret->asks_[level] = Depth{16541.77 + level * 0.01, 0.0021, 1};
+    ret->bids_[level] = Depth{16541.76 - level * 0.01, 0.0021, 1};
+  }
+  return ret;
+}
+
+}  // namespace
+
+/*
+ * Per callback cost of passing books to a python stg, including the parsing
+ * of the stg, in json of range(0) levels.
+ */
+static void BM_PassBooksToPYInJsonFmt(benchmark::State& st) {
+  const auto books = MakeBooks();
+  const auto loads = boost::python::import("json").attr("loads");
   for (auto _ : st) {
-    int times = st.range(0);
-    for (int i = 0; i < times; ++i) {
-    }
+    const auto marketData = books->toJson(st.range(0));
+    const auto obj = loads(marketData);
+    benchmark::DoNotOptimize(obj.ptr());
   }
 }
-BENCHMARK_REGISTER_F(FixtureTest, test)
+BENCHMARK(BM_PassBooksToPYInJsonFmt)
     ->Unit(benchmark::kMicrosecond)
-    ->Arg(1000);
+    ->Arg(5)
+    ->Arg(20)
+    ->Arg(MAX_DEPTH_LEVEL);
 
-BENCHMARK_MAIN();
+/*
+ * Per callback cost of passing books to a python stg as a numpy view, it does
+ * not depend on the levels used by the stg.
+ */
+static void BM_PassBooksToPYInNDArrayFmt(benchmark::State& st) {
+  MarketDataViewMaker marketDataViewMaker;
+  if (marketDataViewMaker.init() != 0) {
+    st.SkipWithError("Init market data view failed.");
+    return;
+  }
+  const auto books = MakeBooks();
+  for (auto _ : st) {
+    const auto obj = marketDataViewMaker.makeView(books);
+    benchmark::DoNotOptimize(obj.ptr());
+  }
+}
+BENCHMARK(BM_PassBooksToPYInNDArrayFmt)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char** argv) {
+  Py_Initialize();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,80 @@
+/*!
+ * \file MarketDataView.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/12/29
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include <boost/python.hpp>
+
+#include "def/BQDef.hpp"
+#include "util/Pch.hpp"
+
+namespace bq {
+struct Trades;
+using TradesSPtr = std::shared_ptr<Trades>;
+struct Orders;
+using OrdersSPtr = std::shared_ptr<Orders>;
+struct Books;
+using BooksSPtr = std::shared_ptr<Books>;
+struct Tickers;
+using TickersSPtr = std::shared_ptr<Tickers>;
+struct Candle;
+using CandleSPtr = std::shared_ptr<Candle>;
+}  // namespace bq
+
+namespace bq::stg {
+
+enum class MarketDataFmtOfPY { Json = 1, NDArray = 2 };
+
+/*
+ * Makes read-only numpy views of the market data passed to python stgs, so
+ * they get typed fields without a json round trip. A view is a record of a
+ * structured dtype mapped onto the msg itself, the fields are named as in the
+ * json of the msg, such as books["asks"]["price"][:10].
+ *
+ * A view holds the msg, so it is still valid after the callback returns. Use
+ * copy() of the view or of its fields to get data that can be modified.
+ * Decimals are f8, or the raw scaled ints if built with fixed decimals.
+ */
+class MarketDataViewMaker {
+ public:
+  MarketDataViewMaker(const MarketDataViewMaker&) = delete;
+  MarketDataViewMaker& operator=(const MarketDataViewMaker&) = delete;
+  MarketDataViewMaker(const MarketDataViewMaker&&) = delete;
+  MarketDataViewMaker& operator=(const MarketDataViewMaker&&) = delete;
+
+  MarketDataViewMaker() = default;
+
+ public:
+  // imports numpy and makes the dtypes, the gil must be held
+  int init();
+
+  // the gil must be held
+  boost::python::object makeView(const TradesSPtr& trades) const;
+  boost::python::object makeView(const OrdersSPtr& orders) const;
+  boost::python::object makeView(const BooksSPtr& books) const;
+  boost::python::object makeView(const TickersSPtr& tickers) const;
+  boost::python::object makeView(const CandleSPtr& candle) const;
+
+ private:
+  boost::python::object makeView(const std::shared_ptr<const void>& marketData,
+                                 std::size_t len,
+                                 const boost::python::object& dtype) const;
+
+ private:
+  boost::python::object frombuffer_;
+
+  boost::python::object dtypeOfTrades_;
+  boost::python::object dtypeOfOrders_;
+  boost::python::object dtypeOfBooks_;
+  boost::python::object dtypeOfTickers_;
+  boost::python::object dtypeOfCandle_;
+};
+
+}  // namespace bq::stg
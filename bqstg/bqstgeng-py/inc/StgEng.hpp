@@ -13,6 +13,7 @@
 #include <boost/python.hpp>
 
 #include "BQPub.hpp"
+#include "MarketDataView.hpp"
 #include "Pub.hpp"
 #include "SHMIPCPub.hpp"
 #include "util/Pch.hpp"
@@ -114,6 +115,9 @@ class StgEng {
   PyObject* stgInstTaskHandler_;
   mutable std::mutex mtxPY_;
 
+  MarketDataFmtOfPY marketDataFmtOfPY_{MarketDataFmtOfPY::Json};
+  MarketDataViewMaker marketDataViewMaker_;
+
   absl::node_hash_map<StgInstId, std::uint32_t> stgInstId2RealDepthLevel_;
   mutable std::mutex mtxStgInstId2RealDepthLevel_;
 };
@@ -0,0 +1,281 @@
+/*!
+ * \file MarketDataView.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/12/29
+ *
+ * \brief
+ */
+
+#include "MarketDataView.hpp"
+
+#include "StgEngPYUtil.hpp"
+#include "def/DataStruOfMD.hpp"
+#include "def/StatusCode.hpp"
+#include "util/Logger.hpp"
+
+namespace bq::stg {
+
+namespace {
+
+/*
+ * A read-only python buffer over a msg, the msg is held until the last numpy
+ * array made from the buffer is released.
+ */
+struct BufferOfMarketData {
+  PyObject ob_base;
+  std::shared_ptr<const void>* marketData_;
+  Py_ssize_t len_;
+};
+
+int GetBufferOfMarketData(PyObject* self, Py_buffer* view, int flags) {
+  const auto buffer = reinterpret_cast<BufferOfMarketData*>(self);
+  return PyBuffer_FillInfo(view, self,
+                           const_cast<void*>(buffer->marketData_->get()),
+                           buffer->len_, 1, flags);
+}
+
+void DeallocBufferOfMarketData(PyObject* self) {
+  delete reinterpret_cast<BufferOfMarketData*>(self)->marketData_;
+  Py_TYPE(self)->tp_free(self);
+}
+
+PyBufferProcs BufferProcsOfMarketData{GetBufferOfMarketData, nullptr};
+PyTypeObject TypeOfBufferOfMarketData{PyVarObject_HEAD_INIT(nullptr, 0)};
+
+int InitTypeOfBufferOfMarketData() {
+  if (TypeOfBufferOfMarketData.tp_flags & Py_TPFLAGS_READY) return 0;
+  TypeOfBufferOfMarketData.tp_name = "bqstgeng.BufferOfMarketData";
+  TypeOfBufferOfMarketData.tp_basicsize = sizeof(BufferOfMarketData);
+  TypeOfBufferOfMarketData.tp_flags = Py_TPFLAGS_DEFAULT;
+  TypeOfBufferOfMarketData.tp_dealloc = DeallocBufferOfMarketData;
+  TypeOfBufferOfMarketData.tp_as_buffer = &BufferProcsOfMarketData;
+  return PyType_Ready(&TypeOfBufferOfMarketData);
+}
+
+template <typename T>
+std::string GetFmtOfField() {
+  if constexpr (std::is_enum_v<T>) {
+    return GetFmtOfField<std::underlying_type_t<T>>();
+  } else if constexpr (std::is_same_v<T, bool>) {
+    return "?";
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return fmt::format("<f{}", sizeof(T));
+  } else if constexpr (std::is_integral_v<T>) {
+    return fmt::format("<{}{}", std::is_signed_v<T> ? 'i' : 'u', sizeof(T));
+  } else if constexpr (std::is_array_v<T>) {
+    static_assert(std::is_same_v<std::remove_extent_t<T>, char>);
+    return fmt::format("S{}", std::extent_v<T>);
+  } else {
+    // fixed decimals are viewed as their raw scaled ints
+    static_assert(std::is_trivially_copyable_v<T>);
+    return sizeof(T) <= 8 ? fmt::format("<i{}", sizeof(T))
+                          : fmt::format("V{}", sizeof(T));
+  }
+}
+
+class FieldGroupOfDType {
+ public:
+  template <typename T>
+  void add(const std::string& name, std::size_t offset) {
+    add(name, boost::python::str(GetFmtOfField<T>()), offset);
+  }
+
+  void add(const std::string& name, const boost::python::object& format,
+           std::size_t offset) {
+    nameGroup_.append(name);
+    formatGroup_.append(format);
+    offsetGroup_.append(offset);
+  }
+
+  void addMDHeader(std::size_t offsetOfMDHeader) {
+    add<decltype(MDHeader::exchTs_)>(
+        "exchTs", offsetOfMDHeader + offsetof(MDHeader, exchTs_));
+    add<decltype(MDHeader::localTs_)>(
+        "localTs", offsetOfMDHeader + offsetof(MDHeader, localTs_));
+    add<decltype(MDHeader::marketCode_)>(
+        "marketCode", offsetOfMDHeader + offsetof(MDHeader, marketCode_));
+    add<decltype(MDHeader::symbolType_)>(
+        "symbolType", offsetOfMDHeader + offsetof(MDHeader, symbolType_));
+    add<decltype(MDHeader::symbolCode_)>(
+        "symbolCode", offsetOfMDHeader + offsetof(MDHeader, symbolCode_));
+    add<decltype(MDHeader::mdType_)>(
+        "mdType", offsetOfMDHeader + offsetof(MDHeader, mdType_));
+  }
+
+  boost::python::object makeDType(const boost::python::object& numpy,
+                                  std::size_t itemSize) const {
+    boost::python::dict param;
+    param["names"] = nameGroup_;
+    param["formats"] = formatGroup_;
+    param["offsets"] = offsetGroup_;
+    param["itemsize"] = itemSize;
+    return numpy.attr("dtype")(param);
+  }
+
+ private:
+  boost::python::list nameGroup_;
+  boost::python::list formatGroup_;
+  boost::python::list offsetGroup_;
+};
+
+#define ADD_FIELD(fieldGroup, Stru, name, member) \
+  fieldGroup.add<decltype(Stru::member)>(name, offsetof(Stru, member))
+
+}  // namespace
+
+int MarketDataViewMaker::init() {
+  try {
+    if (InitTypeOfBufferOfMarketData() != 0) {
+      boost::python::throw_error_already_set();
+    }
+
+    const auto numpy = boost::python::import("numpy");
+    frombuffer_ = numpy.attr("frombuffer");
+
+    FieldGroupOfDType fieldGroupOfDepth;
+    ADD_FIELD(fieldGroupOfDepth, Depth, "price", price_);
+    ADD_FIELD(fieldGroupOfDepth, Depth, "size", size_);
+    ADD_FIELD(fieldGroupOfDepth, Depth, "orderNum", orderNum_);
+    const auto dtypeOfDepth = fieldGroupOfDepth.makeDType(numpy, sizeof(Depth));
+    const auto makeFmtOfDepthGroup = [&](std::uint32_t level) {
+      return boost::python::make_tuple(dtypeOfDepth,
+                                       boost::python::make_tuple(level));
+    };
+
+    FieldGroupOfDType fieldGroupOfTrades;
+    fieldGroupOfTrades.addMDHeader(offsetof(Trades, mdHeader_));
+    ADD_FIELD(fieldGroupOfTrades, Trades, "tradeTime", tradeTime_);
+    ADD_FIELD(fieldGroupOfTrades, Trades, "tradeNo", tradeNo_);
+    ADD_FIELD(fieldGroupOfTrades, Trades, "price", price_);
+    ADD_FIELD(fieldGroupOfTrades, Trades, "size", size_);
+    ADD_FIELD(fieldGroupOfTrades, Trades, "side", side_);
+    ADD_FIELD(fieldGroupOfTrades, Trades, "bidOrderId", bidOrderId_);
+    ADD_FIELD(fieldGroupOfTrades, Trades, "askOrderId", askOrderId_);
+    ADD_FIELD(fieldGroupOfTrades, Trades, "tradingDay", tradingDay_);
+    dtypeOfTrades_ = fieldGroupOfTrades.makeDType(numpy, sizeof(Trades));
+
+    FieldGroupOfDType fieldGroupOfOrders;
+    fieldGroupOfOrders.addMDHeader(offsetof(Orders, mdHeader_));
+    ADD_FIELD(fieldGroupOfOrders, Orders, "orderTime", orderTime_);
+    ADD_FIELD(fieldGroupOfOrders, Orders, "orderNo", orderNo_);
+    ADD_FIELD(fieldGroupOfOrders, Orders, "price", price_);
+    ADD_FIELD(fieldGroupOfOrders, Orders, "size", size_);
+    ADD_FIELD(fieldGroupOfOrders, Orders, "side", side_);
+    ADD_FIELD(fieldGroupOfOrders, Orders, "tradingDay", tradingDay_);
+    dtypeOfOrders_ = fieldGroupOfOrders.makeDType(numpy, sizeof(Orders));
+
+    FieldGroupOfDType fieldGroupOfBooks;
+    fieldGroupOfBooks.addMDHeader(offsetof(Books, mdHeader_));
+    ADD_FIELD(fieldGroupOfBooks, Books, "lastPrice", lastPrice_);
+    ADD_FIELD(fieldGroupOfBooks, Books, "totalVol", totalVol_);
+    ADD_FIELD(fieldGroupOfBooks, Books, "totalAmt", totalAmt_);
+    ADD_FIELD(fieldGroupOfBooks, Books, "tradesCount", tradesCount_);
+    ADD_FIELD(fieldGroupOfBooks, Books, "tradingDay", tradingDay_);
+    fieldGroupOfBooks.add("asks", makeFmtOfDepthGroup(MAX_DEPTH_LEVEL),
+                          offsetof(Books, asks_));
+    fieldGroupOfBooks.add("bids", makeFmtOfDepthGroup(MAX_DEPTH_LEVEL),
+                          offsetof(Books, bids_));
+    dtypeOfBooks_ = fieldGroupOfBooks.makeDType(numpy, sizeof(Books));
+
+    FieldGroupOfDType fieldGroupOfTickers;
+    fieldGroupOfTickers.addMDHeader(offsetof(Tickers, mdHeader_));
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "open", open_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "high", high_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "low", low_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "lastPrice", lastPrice_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "lastSize", lastSize_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "upperLimitPrice",
+              upperLimitPrice_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "lowerLimitPrice",
+              lowerLimitPrice_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "preClosePrice", preClosePrice_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "preSettlementPrice",
+              preSettlementPrice_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "closePrice", closePrice_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "settlementPrice",
+              settlementPrice_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "preOpenInterest",
+              preOpenInterest_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "openInterest", openInterest_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "vol", vol_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "amt", amt_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "askPrice", askPrice_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "askSize", askSize_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "bidPrice", bidPrice_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "bidSize", bidSize_);
+    ADD_FIELD(fieldGroupOfTickers, Tickers, "tradingDay", tradingDay_);
+    fieldGroupOfTickers.add("asks",
+                            makeFmtOfDepthGroup(MAX_DEPTH_LEVEL_IN_TICKER),
+                            offsetof(Tickers, asks_));
+    fieldGroupOfTickers.add("bids",
+                            makeFmtOfDepthGroup(MAX_DEPTH_LEVEL_IN_TICKER),
+                            offsetof(Tickers, bids_));
+    dtypeOfTickers_ = fieldGroupOfTickers.makeDType(numpy, sizeof(Tickers));
+
+    FieldGroupOfDType fieldGroupOfCandle;
+    fieldGroupOfCandle.addMDHeader(offsetof(Candle, mdHeader_));
+    ADD_FIELD(fieldGroupOfCandle, Candle, "open", open_);
+    ADD_FIELD(fieldGroupOfCandle, Candle, "high", high_);
+    ADD_FIELD(fieldGroupOfCandle, Candle, "low", low_);
+    ADD_FIELD(fieldGroupOfCandle, Candle, "close", close_);
+    ADD_FIELD(fieldGroupOfCandle, Candle, "vol", vol_);
+    ADD_FIELD(fieldGroupOfCandle, Candle, "amt", amt_);
+    dtypeOfCandle_ = fieldGroupOfCandle.makeDType(numpy, sizeof(Candle));
+
+  } catch (const boost::python::error_already_set& e) {
+    if (PyErr_Occurred()) {
+      const auto msg = handlePYErr();
+      LOG_E("Init market data view failed, numpy may not be installed. \n {}",
+            msg);
+    }
+    PyErr_Clear();
+    return SCODE_STG_INIT_MARKET_DATA_VIEW_FAILED;
+  }
+
+  return 0;
+}
+
+boost::python::object MarketDataViewMaker::makeView(
+    const TradesSPtr& trades) const {
+  return makeView(trades, sizeof(Trades), dtypeOfTrades_);
+}
+
+boost::python::object MarketDataViewMaker::makeView(
+    const OrdersSPtr& orders) const {
+  return makeView(orders, sizeof(Orders), dtypeOfOrders_);
+}
+
+boost::python::object MarketDataViewMaker::makeView(
+    const BooksSPtr& books) const {
+  return makeView(books, sizeof(Books), dtypeOfBooks_);
+}
+
+boost::python::object MarketDataViewMaker::makeView(
+    const TickersSPtr& tickers) const {
+  return makeView(tickers, sizeof(Tickers), dtypeOfTickers_);
+}
+
+boost::python::object MarketDataViewMaker::makeView(
+    const CandleSPtr& candle) const {
+  return makeView(candle, sizeof(Candle), dtypeOfCandle_);
+}
+
+boost::python::object MarketDataViewMaker::makeView(
+    const std::shared_ptr<const void>& marketData, std::size_t len,
+    const boost::python::object& dtype) const {
+  const auto buffer =
+      PyObject_New(BufferOfMarketData, &TypeOfBufferOfMarketData);
+  if (buffer == nullptr) {
+    boost::python::throw_error_already_set();
+  }
+  buffer->marketData_ = new std::shared_ptr<const void>(marketData);
+  buffer->len_ = len;
+
+  const boost::python::object bufferOfMarketData(
+      boost::python::handle<>(reinterpret_cast<PyObject*>(buffer)));
+  return frombuffer_(bufferOfMarketData, dtype)[0];
+}
+
+}  // namespace bq::stg
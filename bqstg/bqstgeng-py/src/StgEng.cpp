@@ -54,6 +54,17 @@ int StgEng::init(PyObject* stgInstTaskHandler) {
   if (ret != 0) {
     return ret;
   }
+
+  const auto marketDataFmtOfPY =
+      stgEngImpl_->getConfig()["marketDataFmtOfPY"].as<std::string>("json");
+  if (marketDataFmtOfPY == "ndarray") {
+    if (const auto retOfInit = marketDataViewMaker_.init(); retOfInit != 0) {
+      return retOfInit;
+    }
+    marketDataFmtOfPY_ = MarketDataFmtOfPY::NDArray;
+  }
+  LOG_I("Market data is passed to python in {} fmt.", marketDataFmtOfPY);
+
   installStgInstTaskHandler(stgInstTaskHandler);
   return 0;
 }
@@ -147,12 +158,20 @@ void StgEng::installStgInstTaskHandler(PyObject* value) {
       ->getStgInstTaskHandlerBundle()
       .onTrades_ = [this](const StgInstInfoSPtr& stgInstInfo,
                           const TradesSPtr& trades) {
-    const auto marketData = trades->toJson();
+    const auto marketData = marketDataFmtOfPY_ == MarketDataFmtOfPY::Json
+                                ? trades->toJson()
+                                : std::string();
     {
       std::lock_guard<std::mutex> guard(mtxPY_);
       try {
-        boost::python::call_method<void>(stgInstTaskHandler_, "on_trades",
-                                         stgInstInfo, marketData);
+        if (marketDataFmtOfPY_ == MarketDataFmtOfPY::Json) {
+          boost::python::call_method<void>(stgInstTaskHandler_, "on_trades",
+                                           stgInstInfo, marketData);
+        } else {
+          boost::python::call_method<void>(
+              stgInstTaskHandler_, "on_trades", stgInstInfo,
+              marketDataViewMaker_.makeView(trades));
+        }
       } catch (const boost::python::error_already_set& e) {
         if (PyErr_Occurred()) {
           const auto msg = handlePYErr();
@@ -168,12 +187,20 @@ void StgEng::installStgInstTaskHandler(PyObject* value) {
       ->getStgInstTaskHandlerBundle()
       .onOrders_ = [this](const StgInstInfoSPtr& stgInstInfo,
                           const OrdersSPtr& orders) {
-    const auto marketData = orders->toJson();
+    const auto marketData = marketDataFmtOfPY_ == MarketDataFmtOfPY::Json
+                                ? orders->toJson()
+                                : std::string();
     {
       std::lock_guard<std::mutex> guard(mtxPY_);
       try {
-        boost::python::call_method<void>(stgInstTaskHandler_, "on_orders",
-                                         stgInstInfo, marketData);
+        if (marketDataFmtOfPY_ == MarketDataFmtOfPY::Json) {
+          boost::python::call_method<void>(stgInstTaskHandler_, "on_orders",
+                                           stgInstInfo, marketData);
+        } else {
+          boost::python::call_method<void>(
+              stgInstTaskHandler_, "on_orders", stgInstInfo,
+              marketDataViewMaker_.makeView(orders));
+        }
       } catch (const boost::python::error_already_set& e) {
         if (PyErr_Occurred()) {
           const auto msg = handlePYErr();
@@ -193,12 +220,20 @@ void StgEng::installStgInstTaskHandler(PyObject* value) {
           realDepthLevel = stgInstId2RealDepthLevel_[stgInstInfo->stgInstId_];
         }
 
-        const auto marketData = books->toJson(realDepthLevel);
+        const auto marketData = marketDataFmtOfPY_ == MarketDataFmtOfPY::Json
+                                    ? books->toJson(realDepthLevel)
+                                    : std::string();
         {
           std::lock_guard<std::mutex> guard(mtxPY_);
           try {
-            boost::python::call_method<void>(stgInstTaskHandler_, "on_books",
-                                             stgInstInfo, marketData);
+            if (marketDataFmtOfPY_ == MarketDataFmtOfPY::Json) {
+              boost::python::call_method<void>(stgInstTaskHandler_, "on_books",
+                                               stgInstInfo, marketData);
+            } else {
+              boost::python::call_method<void>(
+                  stgInstTaskHandler_, "on_books", stgInstInfo,
+                  marketDataViewMaker_.makeView(books));
+            }
           } catch (const boost::python::error_already_set& e) {
             if (PyErr_Occurred()) {
               const auto msg = handlePYErr();
@@ -214,12 +249,20 @@ void StgEng::installStgInstTaskHandler(PyObject* value) {
       ->getStgInstTaskHandlerBundle()
       .onCandle_ = [this](const StgInstInfoSPtr& stgInstInfo,
                           const CandleSPtr& candle) {
-    const auto marketData = candle->toJson();
+    const auto marketData = marketDataFmtOfPY_ == MarketDataFmtOfPY::Json
+                                ? candle->toJson()
+                                : std::string();
     {
       std::lock_guard<std::mutex> guard(mtxPY_);
       try {
-        boost::python::call_method<void>(stgInstTaskHandler_, "on_candle",
-                                         stgInstInfo, marketData);
+        if (marketDataFmtOfPY_ == MarketDataFmtOfPY::Json) {
+          boost::python::call_method<void>(stgInstTaskHandler_, "on_candle",
+                                           stgInstInfo, marketData);
+        } else {
+          boost::python::call_method<void>(
+              stgInstTaskHandler_, "on_candle", stgInstInfo,
+              marketDataViewMaker_.makeView(candle));
+        }
       } catch (const boost::python::error_already_set& e) {
         if (PyErr_Occurred()) {
           const auto msg = handlePYErr();
@@ -235,12 +278,20 @@ void StgEng::installStgInstTaskHandler(PyObject* value) {
       ->getStgInstTaskHandlerBundle()
       .onTickers_ = [this](const StgInstInfoSPtr& stgInstInfo,
                            const TickersSPtr& tickers) {
-    const auto marketData = tickers->toJson();
+    const auto marketData = marketDataFmtOfPY_ == MarketDataFmtOfPY::Json
+                                ? tickers->toJson()
+                                : std::string();
     {
       std::lock_guard<std::mutex> guard(mtxPY_);
       try {
-        boost::python::call_method<void>(stgInstTaskHandler_, "on_tickers",
-                                         stgInstInfo, marketData);
+        if (marketDataFmtOfPY_ == MarketDataFmtOfPY::Json) {
+          boost::python::call_method<void>(stgInstTaskHandler_, "on_tickers",
+                                           stgInstInfo, marketData);
+        } else {
+          boost::python::call_method<void>(
+              stgInstTaskHandler_, "on_tickers", stgInstInfo,
+              marketDataViewMaker_.makeView(tickers));
+        }
       } catch (const boost::python::error_already_set& e) {
         if (PyErr_Occurred()) {
           const auto msg = handlePYErr();
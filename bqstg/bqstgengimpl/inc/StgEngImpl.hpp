@@ -64,10 +64,12 @@ class PosMgr;
 using PosMgrSPtr = std::shared_ptr<PosMgr>;
 
 struct SyncTask;
-using SyncTaskSPtr = std::shared_ptr<SyncTask>;
+using SyncTaskGroup = std::vector<const SyncTask*>;
+class SyncTaskBuffer;
+using SyncTaskBufferSPtr = std::shared_ptr<SyncTaskBuffer>;
 
-class Scheduler;
-using SchedulerSPtr = std::shared_ptr<Scheduler>;
+class ScheduleTaskExecutor;
+using ScheduleTaskExecutorSPtr = std::shared_ptr<ScheduleTaskExecutor>;
 
 struct ScheduleTask;
 using ScheduleTaskSPtr = std::shared_ptr<ScheduleTask>;
@@ -241,11 +243,14 @@ class StgEngImpl : public SvcBase {
     return barrierOfStgStartSignal_;
   }
 
-  void cacheSyncTaskGroup(MsgId msgId, const std::any& task,
+  void cacheSyncTaskGroup(MsgId msgId, const OrderInfo& orderInfo,
                           SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB);
   void handleSyncTaskGroup();
 
-  ScheduleTaskBundleSPtr getScheduleTaskBundle();
+ private:
+  void syncOrderInfoGroupToRiskMgr(const SyncTaskGroup& syncTaskGroup);
+  void syncOrderInfoGroupToDB(const SyncTaskGroup& syncTaskGroup);
+  void logStatOfSyncTask();
 
  private:
   YAML::Node config_;
@@ -278,12 +283,16 @@ class StgEngImpl : public SvcBase {
 
   std::shared_ptr<std::promise<void>> barrierOfStgStartSignal_{nullptr};
 
-  std::vector<SyncTaskSPtr> syncTaskGroup_;
-  std::ext::spin_mutex mtxSyncTaskGroup_;
+  SyncTaskBufferSPtr syncTaskBuffer_{nullptr};
+
+  std::uint32_t maxNumOfOrderInfoInSyncMsg_{64};
+  std::uint64_t numOfSyncTask_{0};
+  std::uint64_t numOfSyncTaskAfterCoalesce_{0};
+  std::uint64_t numOfSyncMsgToRiskMgr_{0};
 
   ScheduleTaskBundleSPtr scheduleTaskBundle_{nullptr};
   std::ext::spin_mutex mtxScheduleTaskBundle_;
-  SchedulerSPtr scheduleTaskBundleExecutor_{nullptr};
+  ScheduleTaskExecutorSPtr scheduleTaskBundleExecutor_{nullptr};
 };
 
 }  // namespace bq::stg
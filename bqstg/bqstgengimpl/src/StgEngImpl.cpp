@@ -37,14 +37,16 @@
 #include "tdeng/TDEngParam.hpp"
 #include "util/AcctInfoCache.hpp"
 #include "util/File.hpp"
+#include "util/LatencyHist.hpp"
 #include "util/Literal.hpp"
 #include "util/MarketDataCache.hpp"
 #include "util/MarketDataCond.hpp"
 #include "util/Random.hpp"
 #include "util/ScheduleTaskBundle.hpp"
-#include "util/Scheduler.hpp"
+#include "util/ScheduleTaskExecutor.hpp"
 #include "util/String.hpp"
 #include "util/SubMgr.hpp"
+#include "util/SyncTaskBuffer.hpp"
 #include "util/TaskDispatcher.hpp"
 #include "util/TopicMgr.hpp"
 #include "util/Util.hpp"
@@ -55,7 +57,7 @@ StgEngImpl::StgEngImpl(const std::string& configFilename)
     : SvcBase(configFilename) {}
 
 int StgEngImpl::prepareInit() {
-  syncTaskGroup_.reserve(1024);
+  syncTaskBuffer_ = std::make_shared<SyncTaskBuffer>();
 
   try {
     config_ = YAML::LoadFile(configFilename_);
@@ -114,13 +116,8 @@ int StgEngImpl::doInit() {
 
   scheduleTaskBundle_ = std::make_shared<ScheduleTaskBundle>();
   initScheduleTaskBundle();
-  scheduleTaskBundleExecutor_ = std::make_shared<Scheduler>(
-      getAppName(),
-      [this]() {
-        auto scheduleTaskBundle = getScheduleTaskBundle();
-        ExecScheduleTaskBundle(scheduleTaskBundle);
-      },
-      1);
+  scheduleTaskBundleExecutor_ = std::make_shared<ScheduleTaskExecutor>(
+      getAppName(), scheduleTaskBundle_);
 
   return 0;
 }
@@ -217,13 +214,13 @@ void StgEngImpl::initTBLMonitorOfStgInstInfo() {
 void StgEngImpl::initSubMgr() {
   const auto onSHMDataRecv = [this](const void* shmBuf, std::size_t shmBufLen) {
     const auto shmHeader = static_cast<const SHMHeader*>(shmBuf);
-    const auto subscriberGroup =
-        subMgr_->getSubscriberGroupByTopicHash(shmHeader->topicHash_);
-    for (auto stgInstId : subscriberGroup) {
-      auto asyncTask = std::make_shared<SHMIPCAsyncTask>(
-          std::make_shared<SHMIPCTask>(shmBuf, shmBufLen), stgInstId);
-      stgInstTaskDispatcher_->dispatch(asyncTask);
-    }
+    LATENCY_PROBE("StgEng.ShmRecv", shmHeader->timestamp_);
+    subMgr_->forEachSubscriberOfTopicHash(
+        shmHeader->topicHash_, [&](auto stgInstId) {
+          auto asyncTask = std::make_shared<SHMIPCAsyncTask>(
+              std::make_shared<SHMIPCTask>(shmBuf, shmBufLen), stgInstId);
+          stgInstTaskDispatcher_->dispatch(asyncTask);
+        });
   };
 
   subMgr_ = std::make_shared<SubMgr>(appName_, onSHMDataRecv);
@@ -402,15 +399,36 @@ void StgEngImpl::initScheduleTaskBundle() {
         },
         ExecAtStartup::False, MilliSecInterval(5000)));
 
-    const auto milliSecIntervalOfSyncTask =
-        getConfig()["milliSecIntervalOfSyncTask"].as<std::uint32_t>();
+    // the sync flush runs on its own thread, so it is not delayed by the
+    // other tasks and its interval can be less than 1 ms
+    // the old key in ms is only read when the one in us is not configured
+    const auto nodeOfMicroSecInterval =
+        getConfig()["microSecIntervalOfSyncTask"];
+    const auto microSecIntervalOfSyncTask =
+        nodeOfMicroSecInterval
+            ? nodeOfMicroSecInterval.as<std::uint32_t>()
+            : getConfig()["milliSecIntervalOfSyncTask"].as<std::uint32_t>() *
+                  1000;
+    maxNumOfOrderInfoInSyncMsg_ = std::max<std::uint32_t>(
+        1, getConfig()["maxNumOfOrderInfoInSyncMsg"].as<std::uint32_t>(64));
     scheduleTaskBundle_->emplace_back(std::make_shared<ScheduleTask>(
         "syncTask",
         [this]() {
           handleSyncTaskGroup();
           return true;
         },
-        ExecAtStartup::False, milliSecIntervalOfSyncTask));
+        ExecAtStartup::False,
+        std::chrono::microseconds(microSecIntervalOfSyncTask),
+        std::chrono::microseconds(microSecIntervalOfSyncTask),
+        ExecOnDedicatedThread::True));
+
+    scheduleTaskBundle_->emplace_back(std::make_shared<ScheduleTask>(
+        "logStatOfSyncTask",
+        [this]() {
+          logStatOfSyncTask();
+          return true;
+        },
+        ExecAtStartup::False, MilliSecInterval(60000)));
   }
 }
 
@@ -500,67 +518,109 @@ void StgEngImpl::sendStgReg() {
       MSG_ID_ON_STG_REG, sizeof(StgReg));
 }
 
-void StgEngImpl::cacheSyncTaskGroup(MsgId msgId, const std::any& task,
+void StgEngImpl::cacheSyncTaskGroup(MsgId msgId, const OrderInfo& orderInfo,
                                     SyncToRiskMgr syncToRiskMgr,
                                     SyncToDB syncToDB) {
-  {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxSyncTaskGroup_);
-    syncTaskGroup_.emplace_back(
-        std::make_shared<SyncTask>(msgId, task, syncToRiskMgr, syncToDB));
-  }
+  syncTaskBuffer_->cache(msgId, orderInfo, syncToRiskMgr, syncToDB);
 }
 
 void StgEngImpl::handleSyncTaskGroup() {
-  std::vector<SyncTaskSPtr> syncTaskGroup;
-  {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxSyncTaskGroup_);
-    std::swap(syncTaskGroup, syncTaskGroup_);
-  }
-
+  const auto& syncTaskGroup = syncTaskBuffer_->swap();
   if (syncTaskGroup.size() > 100) {
     LOG_W("Too many unprocessed task of sync. [num = {}]",
           syncTaskGroup.size());
   }
 
-  for (const auto& rec : syncTaskGroup) {
-    if (rec->syncToRiskMgr_ == SyncToRiskMgr::False) continue;
-    if (rec->msgId_ == MSG_ID_ON_ORDER || rec->msgId_ == MSG_ID_ON_ORDER_RET ||
-        rec->msgId_ == MSG_ID_ON_CANCEL_ORDER ||
-        rec->msgId_ == MSG_ID_ON_CANCEL_ORDER_RET) {
-      const auto orderInfo = std::any_cast<OrderInfoSPtr>(rec->task_);
+  SyncTaskGroup syncTaskGroupOfRiskMgr;
+  SyncTaskGroup syncTaskGroupOfDB;
+  for (const auto rec : syncTaskGroup) {
+    if (!IsSyncTaskOfOrderInfo(*rec)) {
+      LOG_W("Unhandled task of sync. {} - {}", rec->msgId_,
+            GetMsgName(rec->msgId_));
+      continue;
+    }
+    if (rec->syncToRiskMgr_ == SyncToRiskMgr::True) {
+      syncTaskGroupOfRiskMgr.emplace_back(rec);
+    }
+    if (rec->syncToDB_ == SyncToDB::True) {
+      syncTaskGroupOfDB.emplace_back(rec);
+    }
+  }
+
+  // coalesce after the split, a task not synced to one side must not shadow
+  // an earlier task of the same order that is
+  numOfSyncTask_ += syncTaskGroupOfRiskMgr.size() + syncTaskGroupOfDB.size();
+  syncTaskGroupOfRiskMgr = CoalesceSyncTaskGroup(syncTaskGroupOfRiskMgr);
+  syncTaskGroupOfDB = CoalesceSyncTaskGroup(syncTaskGroupOfDB);
+
+  syncOrderInfoGroupToRiskMgr(syncTaskGroupOfRiskMgr);
+  syncOrderInfoGroupToDB(syncTaskGroupOfDB);
+
+  numOfSyncTaskAfterCoalesce_ +=
+      syncTaskGroupOfRiskMgr.size() + syncTaskGroupOfDB.size();
+}
+
+void StgEngImpl::syncOrderInfoGroupToRiskMgr(
+    const SyncTaskGroup& syncTaskGroup) {
+  // the risk mgr dispatches msgs to its threads by acct id
+  std::map<AcctId, SyncTaskGroup> acctId2SyncTaskGroup;
+  for (const auto rec : syncTaskGroup) {
+    acctId2SyncTaskGroup[rec->orderInfo_.acctId_].emplace_back(rec);
+  }
+
+  for (const auto& [acctId, syncTaskGroupOfAcctId] : acctId2SyncTaskGroup) {
+    for (std::size_t offset = 0; offset < syncTaskGroupOfAcctId.size();
+         offset += maxNumOfOrderInfoInSyncMsg_) {
+      const auto num = std::min<std::size_t>(
+          maxNumOfOrderInfoInSyncMsg_, syncTaskGroupOfAcctId.size() - offset);
       shmCliOfRiskMgr_->asyncSendMsgWithZeroCopy(
           [&](void* shmBufOfReq) {
-            InitMsgBody(shmBufOfReq, *orderInfo);
-            LOG_I("Send order info to risk mgr. {}",
-                  static_cast<OrderInfo*>(shmBufOfReq)->toShortStr());
+            auto orderInfoGroupForSync =
+                static_cast<OrderInfoGroupForSync*>(shmBufOfReq);
+            orderInfoGroupForSync->acctId_ = acctId;
+            orderInfoGroupForSync->num_ = num;
+            auto orderInfoAddr = orderInfoGroupForSync->getOrderInfoGroup();
+            for (std::size_t i = offset; i < offset + num; ++i) {
+              const auto rec = syncTaskGroupOfAcctId[i];
+              auto orderInfo = rec->orderInfo_;
+              orderInfo.shmHeader_.msgId_ = rec->msgId_;
+              memcpy(orderInfoAddr, &orderInfo, sizeof(OrderInfo));
+              LOG_I("Send order info to risk mgr. {}", orderInfo.toShortStr());
+              orderInfoAddr += sizeof(OrderInfo);
+            }
           },
-          rec->msgId_, sizeof(OrderInfo));
-    } else {
-      LOG_W("Unhandled task of sync to riskmgr. {} - {}", rec->msgId_,
-            GetMsgName(rec->msgId_))
+          MSG_ID_SYNC_ORDER_INFO_GROUP,
+          sizeof(OrderInfoGroupForSync) + num * sizeof(OrderInfo));
+      ++numOfSyncMsgToRiskMgr_;
     }
   }
+}
 
-  for (const auto& rec : syncTaskGroup) {
-    if (rec->syncToDB_ == SyncToDB::False) continue;
-    if (rec->msgId_ == MSG_ID_ON_ORDER || rec->msgId_ == MSG_ID_ON_ORDER_RET ||
-        rec->msgId_ == MSG_ID_ON_CANCEL_ORDER ||
-        rec->msgId_ == MSG_ID_ON_CANCEL_ORDER_RET) {
-      const auto orderInfo = std::any_cast<OrderInfoSPtr>(rec->task_);
-      const auto identity = GET_RAND_STR();
-      const auto sql = orderInfo->getSqlOfUSPOrderInfoUpdate();
-      const auto [ret, execRet] = getDBEng()->asyncExec(identity, sql);
-      if (ret != 0) {
-        LOG_W("Sync order info to db failed. [{}]", sql);
-      }
-
-    } else {
-      LOG_W("Unhandled task of sync to db. {} - {}", rec->msgId_,
-            GetMsgName(rec->msgId_))
+void StgEngImpl::syncOrderInfoGroupToDB(const SyncTaskGroup& syncTaskGroup) {
+  for (const auto rec : syncTaskGroup) {
+    const auto& orderInfo = rec->orderInfo_;
+    const auto identity = GET_RAND_STR();
+    const auto sql = orderInfo.getSqlOfUSPOrderInfoUpdate();
+    const auto [ret, execRet] = getDBEng()->asyncExec(identity, sql);
+    if (ret != 0) {
+      LOG_W("Sync order info to db failed. [{}]", sql);
     }
   }
 }
 
+void StgEngImpl::logStatOfSyncTask() {
+  if (numOfSyncTask_ == 0) return;
+  LOG_I(
+      "[SyncTask] num: {}; numAfterCoalesce: {}; ratioOfCoalesce: {:.3f}; "
+      "numOfMsgToRiskMgr: {}",
+      numOfSyncTask_, numOfSyncTaskAfterCoalesce_,
+      static_cast<double>(numOfSyncTaskAfterCoalesce_) / numOfSyncTask_,
+      numOfSyncMsgToRiskMgr_);
+  numOfSyncTask_ = 0;
+  numOfSyncTaskAfterCoalesce_ = 0;
+  numOfSyncMsgToRiskMgr_ = 0;
+}
+
 void StgEngImpl::doExit(const boost::system::error_code* ec, int signalNum) {
   scheduleTaskBundleExecutor_->stop();
   shmCliOfWebSrv_->stop();
@@ -684,10 +744,6 @@ std::tuple<int, OrderId> StgEngImpl::order(OrderInfoSPtr& orderInfo) {
     return {ret, 0};
   }
 
-#ifdef PERF_TEST
-  EXEC_PERF_TEST("Order", orderInfo->orderTime_, 100, 10);
-#endif
-
   shmCliOfTDSrv_->asyncSendMsgWithZeroCopy(
       [&](void* shmBufOfReq) {
         InitMsgBody(shmBufOfReq, *orderInfo);
@@ -698,12 +754,10 @@ std::tuple<int, OrderId> StgEngImpl::order(OrderInfoSPtr& orderInfo) {
       },
       MSG_ID_ON_ORDER, sizeof(OrderInfo));
 
-  cacheSyncTaskGroup(MSG_ID_ON_ORDER, orderInfo, SyncToRiskMgr::True,
+  cacheSyncTaskGroup(MSG_ID_ON_ORDER, *orderInfo, SyncToRiskMgr::True,
                      SyncToDB::True);
 
-#ifdef PERF_TEST
-  EXEC_PERF_TEST("Order", orderInfo->orderTime_, 100, 10);
-#endif
+  LATENCY_PROBE("StgEng.OrderSend", orderInfo->orderTime_);
   return {0, orderInfo->orderId_};
 }
 
@@ -724,8 +778,8 @@ int StgEngImpl::cancelOrder(OrderId orderId) {
       },
       MSG_ID_ON_CANCEL_ORDER, sizeof(OrderInfo));
 
-  cacheSyncTaskGroup(MSG_ID_ON_CANCEL_ORDER, orderInfo, SyncToRiskMgr::True,
-                     SyncToDB::False);
+  cacheSyncTaskGroup(MSG_ID_ON_CANCEL_ORDER, *orderInfo,
+                     SyncToRiskMgr::True, SyncToDB::False);
 
   return 0;
 }
@@ -921,15 +975,9 @@ void StgEngImpl::installStgInstTimer(StgInstId stgInstId,
     return true;
   };
 
-  {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxScheduleTaskBundle_);
-    scheduleTaskBundle_->emplace_back(std::make_shared<ScheduleTask>(
-        timerName, callback, execAtStartUp, milliSecInterval, maxExecTimes));
-    if (scheduleTaskBundle_->size() % 100 == 0) {
-      LOG_W("[{}] Size of scheduleTaskBundle is {}", getAppName(),
-            scheduleTaskBundle_->size());
-    }
-  }
+  // the task is dropped by the executor after its last exec
+  scheduleTaskBundleExecutor_->addScheduleTask(std::make_shared<ScheduleTask>(
+      timerName, callback, execAtStartUp, milliSecInterval, maxExecTimes));
 }
 
 bool StgEngImpl::saveStgPrivateData(StgInstId stgInstId,
@@ -971,26 +1019,4 @@ std::tuple<int, OrderInfoSPtr> StgEngImpl::getOrderInfo(OrderId orderId) const {
   return ordMgr_->getOrderInfo(orderId, DeepClone::True, LockFunc::True);
 }
 
-ScheduleTaskBundleSPtr StgEngImpl::getScheduleTaskBundle() {
-  auto ret = std::make_shared<ScheduleTaskBundle>();
-  {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxScheduleTaskBundle_);
-    std::ext::erase_if(*scheduleTaskBundle_, [this](const auto& scheduleTask) {
-      if (scheduleTask->execTimes_ == scheduleTask->maxExecTimes_) {
-        const auto statusMsg = fmt::format(
-            "[{}] scheduleTask {} finished. [execTimes = {}; maxExecTimes {}]",
-            getAppName(), scheduleTask->scheduleTaskName_,
-            scheduleTask->execTimes_, scheduleTask->maxExecTimes_);
-        LOG_I(statusMsg);
-        return true;
-      } else {
-        return false;
-      }
-    });
-    ret->assign(std::begin(*scheduleTaskBundle_),
-                std::end(*scheduleTaskBundle_));
-  }
-  return ret;
-};
-
 }  // namespace bq::stg
@@ -26,6 +26,7 @@
 #include "def/DataStruOfStg.hpp"
 #include "def/DataStruOfTD.hpp"
 #include "util/Datetime.hpp"
+#include "util/LatencyHist.hpp"
 #include "util/MarketDataCache.hpp"
 #include "util/PosSnapshot.hpp"
 #include "util/TaskDispatcher.hpp"
@@ -43,7 +44,12 @@ void StgInstTaskHandlerImpl::handleAsyncTask(
   const auto [ret, stgInstInfo] =
       getStgEngImpl()->getTBLMonitorOfStgInstInfo()->getStgInstInfo(stgInstId);
   if (ret == 0) {
+    const auto shmHeader =
+        static_cast<const SHMHeader*>(asyncTask->task_->data_);
+    LATENCY_PROBE("StgEng.ShmToStgCallback", shmHeader->timestamp_);
+    const auto tsOfStgCallback = GetTotalUSSince1970OfHotPath();
     handleAsyncTaskImpl(stgInstInfo, asyncTask);
+    LATENCY_PROBE("StgEng.StgCallback", tsOfStgCallback);
   } else {
     LOG_W("Get stg inst info of {} - {} failed. ", stgEng_->getStgId(),
           stgInstId);
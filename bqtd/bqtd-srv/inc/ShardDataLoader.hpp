@@ -0,0 +1,67 @@
+/*!
+ * \file ShardDataLoader.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "def/DataStruOfAssets.hpp"
+#include "util/Pch.hpp"
+#include "util/StdExt.hpp"
+
+namespace bq {
+struct OrderInfo;
+using OrderInfoSPtr = std::shared_ptr<OrderInfo>;
+}  // namespace bq
+
+namespace bq::td::srv {
+
+class TDSrv;
+
+/*
+ * Loads pos infos, asset infos and unclosed order infos once for all the task
+ * specific threads and groups them by the thread that owns them, which is the
+ * thread that handles the tasks of the same hash, so each thread inits its
+ * thread local mgrs only with its own part instead of querying the db.
+ *
+ * The recs are grouped again each time they are loaded, so after a change of
+ * taskSpecificThreadPoolSize they are just moved to the threads that own them.
+ */
+class ShardDataLoader {
+ public:
+  ShardDataLoader(const ShardDataLoader&) = delete;
+  ShardDataLoader& operator=(const ShardDataLoader&) = delete;
+  ShardDataLoader(const ShardDataLoader&&) = delete;
+  ShardDataLoader& operator=(const ShardDataLoader&&) = delete;
+
+  explicit ShardDataLoader(TDSrv* tdSrv);
+
+ public:
+  int load(std::uint32_t numOfShard);
+
+  // each part can only be taken once, the loader does not hold it anymore
+  PosInfoGroup takePosInfoGroup(std::uint32_t shardNo);
+  AssetInfoGroupSPtr takeAssetInfoGroup(std::uint32_t shardNo);
+  std::vector<OrderInfoSPtr> takeOrderInfoGroup(std::uint32_t shardNo);
+
+ private:
+  int loadPosInfoGroup();
+  int loadAssetInfoGroup();
+  int loadOrderInfoGroup();
+
+ private:
+  TDSrv* tdSrv_;
+  std::uint32_t numOfShard_{0};
+
+  std::ext::spin_mutex mtxShardData_;
+  std::vector<PosInfoGroup> shardNo2PosInfoGroup_;
+  std::vector<AssetInfoGroupSPtr> shardNo2AssetInfoGroup_;
+  std::vector<std::vector<OrderInfoSPtr>> shardNo2OrderInfoGroup_;
+};
+
+}  // namespace bq::td::srv
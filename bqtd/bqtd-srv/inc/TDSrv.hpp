@@ -13,6 +13,7 @@
 #include "SHMIPCDef.hpp"
 #include "SHMIPCMsgId.hpp"
 #include "db/DBEngDef.hpp"
+#include "def/ConditionDef.hpp"
 #include "util/Pch.hpp"
 #include "util/StdExt.hpp"
 #include "util/SvcBase.hpp"
@@ -32,24 +33,29 @@ class TaskDispatcher;
 template <typename Task>
 using TaskDispatcherSPtr = std::shared_ptr<TaskDispatcher<Task>>;
 
-class Scheduler;
-using SchedulerSPtr = std::shared_ptr<Scheduler>;
+class ScheduleTaskExecutor;
+using ScheduleTaskExecutorSPtr = std::shared_ptr<ScheduleTaskExecutor>;
 
 struct ScheduleTask;
 using ScheduleTaskSPtr = std::shared_ptr<ScheduleTask>;
 using ScheduleTaskBundle = std::vector<ScheduleTaskSPtr>;
 using ScheduleTaskBundleSPtr = std::shared_ptr<ScheduleTaskBundle>;
 
-struct SyncTask;
-using SyncTaskSPtr = std::shared_ptr<SyncTask>;
+struct OrderInfo;
+
+struct PosInfo;
+using PosInfoSPtr = std::shared_ptr<PosInfo>;
+using PosChgInfo = std::vector<PosInfoSPtr>;
+using PosChgInfoSPtr = std::shared_ptr<PosChgInfo>;
+
+class SyncTaskBuffer;
+using SyncTaskBufferSPtr = std::shared_ptr<SyncTaskBuffer>;
 
 enum class SyncToRiskMgr;
 enum class SyncToDB;
 
 class FlowCtrlRuleMgr;
 using FlowCtrlRuleMgrSPtr = std::shared_ptr<FlowCtrlRuleMgr>;
-
-using ConditionFieldGroup = std::vector<std::string>;
 }  // namespace bq
 
 namespace bq::db {
@@ -67,6 +73,9 @@ using TDSrvRiskPluginMgrSPtr = std::shared_ptr<TDSrvRiskPluginMgr>;
 class PosMgrRestorer;
 using PosMgrRestorerSPtr = std::shared_ptr<PosMgrRestorer>;
 
+class ShardDataLoader;
+using ShardDataLoaderSPtr = std::shared_ptr<ShardDataLoader>;
+
 class TDGWTaskHandler;
 using TDGWTaskHandlerSPtr = std::shared_ptr<TDGWTaskHandler>;
 
@@ -89,9 +98,9 @@ class TDSrv : public SvcBase {
   void initTBLMonitorOfFlowCtrlRule();
   void initTBLMonitorOfSymbolInfo();
   void initFlowCtrlRuleMgr();
-  void initPosMgr();
-  void initAssetsMgr();
-  void initOrdMgr();
+  void initPosMgr(std::uint32_t threadNo);
+  void initAssetsMgr(std::uint32_t threadNo);
+  void initOrdMgr(std::uint32_t threadNo);
   int initTDSrvTaskDispatcher();
   void initSHMSrv();
   void initScheduleTaskBundle();
@@ -105,6 +114,10 @@ class TDSrv : public SvcBase {
  public:
   db::DBEngSPtr getDBEng() const { return dbEng_; }
 
+  const CompiledConditionFieldGroup& getCompiledConditionFieldGroup() const {
+    return compiledConditionFieldGroup_;
+  }
+
   const TDSrvRiskPluginMgrSPtr& getTDSrvRiskPluginMgr() const {
     return tdSrvRiskPluginMgr_;
   }
@@ -133,7 +146,9 @@ class TDSrv : public SvcBase {
     return topicOfTriggerRiskCtrl_;
   }
 
-  void cacheSyncTaskGroup(MsgId msgId, const std::any& task,
+  void cacheSyncTaskGroup(MsgId msgId, const OrderInfo& orderInfo,
+                          SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB);
+  void cacheSyncTaskGroup(MsgId msgId, const PosChgInfoSPtr& posChgInfo,
                           SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB);
   void handleSyncTaskGroup();
 
@@ -148,9 +163,11 @@ class TDSrv : public SvcBase {
   db::TBLMonitorOfSymbolInfoSPtr tblMonitorOfSymbolInfo_{nullptr};
 
   ConditionFieldGroup conditionFieldGroup_;
+  CompiledConditionFieldGroup compiledConditionFieldGroup_;
 
   TDSrvRiskPluginMgrSPtr tdSrvRiskPluginMgr_{nullptr};
   PosMgrRestorerSPtr posMgrRestorer_{nullptr};
+  ShardDataLoaderSPtr shardDataLoader_{nullptr};
 
   ClientChannelGroupSPtr tdGWGroup_{nullptr};
   ClientChannelGroupSPtr stgEngGroup_{nullptr};
@@ -167,11 +184,10 @@ class TDSrv : public SvcBase {
   std::string plugInChannel_;
   std::string topicOfTriggerRiskCtrl_;
 
-  std::vector<SyncTaskSPtr> syncTaskGroup_;
-  std::ext::spin_mutex mtxSyncTaskGroup_;
+  SyncTaskBufferSPtr syncTaskBuffer_{nullptr};
 
   ScheduleTaskBundleSPtr scheduleTaskBundle_{nullptr};
-  SchedulerSPtr scheduleTaskBundleExecutor_{nullptr};
+  ScheduleTaskExecutorSPtr scheduleTaskBundleExecutor_{nullptr};
 };
 
 }  // namespace bq::td::srv
@@ -29,23 +29,14 @@ class TDSrv;
 class TDSrvRiskPlugin;
 using TDSrvRiskPluginSPtr = std::shared_ptr<TDSrvRiskPlugin>;
 
-class SafeTDSrvRiskPlugin {
- public:
-  void set(const TDSrvRiskPluginSPtr& value) {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxTDSrvRiskPlugin_);
-    tdSrvRiskPlugin_ = value;
-  }
-
-  TDSrvRiskPluginSPtr get() const {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxTDSrvRiskPlugin_);
-    return tdSrvRiskPlugin_;
-  }
-
- private:
-  TDSrvRiskPluginSPtr tdSrvRiskPlugin_{nullptr};
-  mutable std::ext::spin_mutex mtxTDSrvRiskPlugin_;
-};
-
+/*
+ * The active plugins are published as an immutable chain in the order of their
+ * no, so orders walk the chain without locks or copies of the plugins. Each
+ * load makes a new chain and swaps it in, the plugins it retires are unloaded
+ * after the orders in flight on the old chain have left.
+ *
+ * The callbacks of the plugins must not load the plugins again.
+ */
 class TDSrvRiskPluginMgr {
  public:
   TDSrvRiskPluginMgr(const TDSrvRiskPluginMgr&) = delete;
@@ -54,6 +45,7 @@ class TDSrvRiskPluginMgr {
   TDSrvRiskPluginMgr& operator=(const TDSrvRiskPluginMgr&&) = delete;
 
   explicit TDSrvRiskPluginMgr(TDSrv* tdSrv);
+  ~TDSrvRiskPluginMgr();
 
  public:
   int load();
@@ -76,10 +68,54 @@ class TDSrvRiskPluginMgr {
   int onOrderRet(const OrderInfoSPtr& order);
   int onCancelOrderRet(const OrderInfoSPtr& order);
 
+ private:
+  using No2TDSrvRiskPlugin =
+      std::array<TDSrvRiskPluginSPtr, MAX_TD_SRV_RISK_PLUGIN_NUM>;
+
+  struct Chain {
+    std::vector<TDSrvRiskPluginSPtr> tdSrvRiskPluginGroup_;
+  };
+
+  struct alignas(64) ReaderNum {
+    std::atomic<std::uint64_t> value_{0};
+  };
+
+  struct ReaderGuard {
+    explicit ReaderGuard(std::atomic<std::uint64_t>& readerNum)
+        : readerNum_(readerNum) {
+      readerNum_.fetch_add(1);
+    }
+    ~ReaderGuard() { readerNum_.fetch_sub(1); }
+    std::atomic<std::uint64_t>& readerNum_;
+  };
+
+  // stops at the first plugin which returns a non-zero status code
+  template <typename Callback>
+  int forEachPlugin(Callback&& callback) const {
+    const auto epoch = epoch_.load();
+    ReaderGuard readerGuard(readerNumGroup_[epoch & 1].value_);
+    const auto chain = chain_.load();
+    for (const auto& plugin : chain->tdSrvRiskPluginGroup_) {
+      const auto statusCode = callback(plugin);
+      if (statusCode != 0) return statusCode;
+    }
+    return 0;
+  }
+
+  void publish(const No2TDSrvRiskPlugin& no2TDSrvRiskPlugin);
+  void waitForReadersInFlight();
+
  private:
   TDSrv* tdSrv_{nullptr};
-  std::array<SafeTDSrvRiskPlugin, MAX_TD_SRV_RISK_PLUGIN_NUM>
-      safeTDSrvRiskPluginGroup_;
+
+  // only used by load
+  No2TDSrvRiskPlugin no2TDSrvRiskPlugin_;
+  std::mutex mtxLoad_;
+
+  std::atomic<Chain*> chain_{nullptr};
+
+  alignas(64) std::atomic<std::uint64_t> epoch_{0};
+  mutable ReaderNum readerNumGroup_[2];
 };
 
 }  // namespace bq::td::srv
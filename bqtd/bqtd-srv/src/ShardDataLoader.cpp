@@ -0,0 +1,144 @@
+/*!
+ * \file ShardDataLoader.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "ShardDataLoader.hpp"
+
+#include "TDSrv.hpp"
+#include "db/DBEng.hpp"
+#include "db/TBLAssetInfo.hpp"
+#include "db/TBLOrderInfo.hpp"
+#include "db/TBLPosInfo.hpp"
+#include "db/TBLRecSetMaker.hpp"
+#include "def/DataStruOfTD.hpp"
+#include "util/BQUtil.hpp"
+#include "util/Logger.hpp"
+
+namespace bq::td::srv {
+
+ShardDataLoader::ShardDataLoader(TDSrv* tdSrv) : tdSrv_(tdSrv) {}
+
+int ShardDataLoader::load(std::uint32_t numOfShard) {
+  numOfShard_ = numOfShard;
+  shardNo2PosInfoGroup_.assign(numOfShard_, PosInfoGroup());
+  shardNo2AssetInfoGroup_.clear();
+  for (std::uint32_t shardNo = 0; shardNo < numOfShard_; ++shardNo) {
+    shardNo2AssetInfoGroup_.emplace_back(std::make_shared<AssetInfoGroup>());
+  }
+  shardNo2OrderInfoGroup_.assign(numOfShard_, std::vector<OrderInfoSPtr>());
+
+  if (const auto ret = loadPosInfoGroup(); ret != 0) {
+    LOG_W("Load shard data failed.");
+    return ret;
+  }
+
+  if (const auto ret = loadAssetInfoGroup(); ret != 0) {
+    LOG_W("Load shard data failed.");
+    return ret;
+  }
+
+  if (const auto ret = loadOrderInfoGroup(); ret != 0) {
+    LOG_W("Load shard data failed.");
+    return ret;
+  }
+
+  return 0;
+}
+
+int ShardDataLoader::loadPosInfoGroup() {
+  const auto sql = fmt::format("SELECT * FROM `posInfo`");
+  const auto [ret, tblRecSet] =
+      db::TBLRecSetMaker<TBLPosInfo>::ExecSql(tdSrv_->getDBEng(), sql);
+  if (ret != 0) {
+    LOG_W("Load pos info group failed. {}", sql);
+    return ret;
+  }
+
+  for (const auto& tblRec : *tblRecSet) {
+    const auto recPosInfo = tblRec.second->getRecWithAllFields();
+    const auto posInfo = MakePosInfo(recPosInfo);
+    const auto hash = GetHashFromPosInfo(
+        posInfo.get(), tdSrv_->getCompiledConditionFieldGroup());
+    shardNo2PosInfoGroup_[hash % numOfShard_].emplace_back(posInfo);
+  }
+  LOG_I("Load pos info group success. [size = {}, num of shard = {}]",
+        tblRecSet->size(), numOfShard_);
+
+  return 0;
+}
+
+int ShardDataLoader::loadAssetInfoGroup() {
+  const auto sql = fmt::format("SELECT * FROM `assetInfo`");
+  const auto [ret, tblRecSet] =
+      db::TBLRecSetMaker<TBLAssetInfo>::ExecSql(tdSrv_->getDBEng(), sql);
+  if (ret != 0) {
+    LOG_W("Load asset info group failed. {}", sql);
+    return ret;
+  }
+
+  for (const auto& tblRec : *tblRecSet) {
+    const auto recAssetInfo = tblRec.second->getRecWithAllFields();
+    const auto assetInfo = MakeAssetInfo(recAssetInfo);
+    const auto hash = GetHashFromAssetInfo(assetInfo.get());
+    shardNo2AssetInfoGroup_[hash % numOfShard_]->emplace(assetInfo->keyHash_,
+                                                         assetInfo);
+  }
+  LOG_I("Load asset info group success. [size = {}, num of shard = {}]",
+        tblRecSet->size(), numOfShard_);
+
+  return 0;
+}
+
+int ShardDataLoader::loadOrderInfoGroup() {
+  const auto filled = magic_enum::enum_integer(OrderStatus::Filled);
+  const auto sql = fmt::format(
+      "SELECT * FROM `orderInfo` WHERE `orderStatus` < {}; ", filled);
+  const auto [ret, tblRecSet] =
+      db::TBLRecSetMaker<TBLOrderInfo>::ExecSql(tdSrv_->getDBEng(), sql);
+  if (ret != 0) {
+    LOG_W("Load order info group failed. {}", sql);
+    return ret;
+  }
+
+  for (const auto& tblRec : *tblRecSet) {
+    const auto recOrderInfo = tblRec.second->getRecWithAllFields();
+    const auto orderInfo = MakeOrderInfo(recOrderInfo);
+    const auto hash = GetHashFromOrderInfo(
+        orderInfo.get(), tdSrv_->getCompiledConditionFieldGroup());
+    shardNo2OrderInfoGroup_[hash % numOfShard_].emplace_back(orderInfo);
+  }
+  LOG_I("Load order info group success. [size = {}, num of shard = {}]",
+        tblRecSet->size(), numOfShard_);
+
+  return 0;
+}
+
+PosInfoGroup ShardDataLoader::takePosInfoGroup(std::uint32_t shardNo) {
+  PosInfoGroup ret;
+  std::lock_guard<std::ext::spin_mutex> guard(mtxShardData_);
+  ret.swap(shardNo2PosInfoGroup_[shardNo]);
+  return ret;
+}
+
+AssetInfoGroupSPtr ShardDataLoader::takeAssetInfoGroup(std::uint32_t shardNo) {
+  auto ret = std::make_shared<AssetInfoGroup>();
+  std::lock_guard<std::ext::spin_mutex> guard(mtxShardData_);
+  ret.swap(shardNo2AssetInfoGroup_[shardNo]);
+  return ret;
+}
+
+std::vector<OrderInfoSPtr> ShardDataLoader::takeOrderInfoGroup(
+    std::uint32_t shardNo) {
+  std::vector<OrderInfoSPtr> ret;
+  std::lock_guard<std::ext::spin_mutex> guard(mtxShardData_);
+  ret.swap(shardNo2OrderInfoGroup_[shardNo]);
+  return ret;
+}
+
+}  // namespace bq::td::srv
@@ -28,7 +28,9 @@
 #include "def/DataStruOfTD.hpp"
 #include "def/StatusCode.hpp"
 #include "def/SyncTask.hpp"
+#include "util/BinLogger.hpp"
 #include "util/Datetime.hpp"
+#include "util/LatencyHist.hpp"
 #include "util/StdExt.hpp"
 #include "util/TaskDispatcher.hpp"
 #include "util/Util.hpp"
@@ -60,7 +62,7 @@ void StgEngTaskHandler::handleMsgIdOnOrder(
     const AsyncTaskSPtr<SHMIPCTaskSPtr>& asyncTask) {
   auto ordReq = MakeMsgSPtrByTask<OrderInfo>(asyncTask->task_);
 #ifndef OPT_LOG
-  LOG_I("Recv order {}", ordReq->toShortStr());
+  BLOG_I("Recv order {}", *ordReq);
 #endif
 
   if (tdSrv_->getTDGWGroup()->exists(ordReq->acctId_) == false) {
@@ -71,12 +73,11 @@ void StgEngTaskHandler::handleMsgIdOnOrder(
     tdSrv_->getSHMSrvOfStgEng()->pushMsgWithZeroCopy(
         [&](void* shmBuf) {
           InitMsgBody(shmBuf, *ordReq);
-          LOG_I("Forward order ret {}",
-                static_cast<OrderInfo*>(shmBuf)->toShortStr());
+          BLOG_I("Forward order ret {}", *static_cast<OrderInfo*>(shmBuf));
         },
         ordReq->stgId_, MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-    tdSrv_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, ordReq,
+    tdSrv_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *ordReq,
                                SyncToRiskMgr::False, SyncToDB::True);
     return;
   }
@@ -91,17 +92,18 @@ void StgEngTaskHandler::handleMsgIdOnOrder(
     tdSrv_->getSHMSrvOfStgEng()->pushMsgWithZeroCopy(
         [&](void* shmBuf) {
           InitMsgBody(shmBuf, *ordReq);
-          LOG_I("Forward order ret {}",
-                static_cast<OrderInfo*>(shmBuf)->toShortStr());
+          BLOG_I("Forward order ret {}", *static_cast<OrderInfo*>(shmBuf));
         },
         ordReq->stgId_, MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-    tdSrv_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, ordReq,
+    tdSrv_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *ordReq,
                                SyncToRiskMgr::False, SyncToDB::True);
     return;
   }
 
+  const auto tsOfRiskCheck = GetTotalUSSince1970OfHotPath();
   const auto statusCode = tdSrv_->getTDSrvRiskPluginMgr()->onOrder(ordReq);
+  LATENCY_PROBE("TDSrv.RiskCheck", tsOfRiskCheck);
   if (statusCode != 0) {
     LOG_W("Risk check order failed. [{} - {}] {}", statusCode,
           GetStatusMsg(statusCode), ordReq->toShortStr());
@@ -111,8 +113,7 @@ void StgEngTaskHandler::handleMsgIdOnOrder(
     tdSrv_->getSHMSrvOfStgEng()->pushMsgWithZeroCopy(
         [&](void* shmBuf) {
           InitMsgBody(shmBuf, *ordReq);
-          LOG_I("Forward order ret {}",
-                static_cast<OrderInfo*>(shmBuf)->toShortStr());
+          BLOG_I("Forward order ret {}", *static_cast<OrderInfo*>(shmBuf));
         },
         ordReq->stgId_, MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
@@ -127,7 +128,7 @@ void StgEngTaskHandler::handleMsgIdOnOrder(
             ordReq->statusCode_);
     }
 
-    tdSrv_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, ordReq,
+    tdSrv_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *ordReq,
                                SyncToRiskMgr::False, SyncToDB::True);
     return;
   }
@@ -136,15 +137,12 @@ void StgEngTaskHandler::handleMsgIdOnOrder(
       [&](void* shmBuf) {
         InitMsgBody(shmBuf, *ordReq);
 #ifndef OPT_LOG
-        LOG_I("Forward order {}",
-              static_cast<OrderInfo*>(shmBuf)->toShortStr());
+        BLOG_I("Forward order {}", *static_cast<OrderInfo*>(shmBuf));
 #endif
       },
       ordReq->acctId_, MSG_ID_ON_ORDER, sizeof(OrderInfo));
 
-#ifdef PERF_TEST
-  EXEC_PERF_TEST("Order", ordReq->orderTime_, 100, 10);
-#endif
+  LATENCY_PROBE("TDSrv.OrderForward", ordReq->orderTime_);
 }
 
 void StgEngTaskHandler::handleMsgIdOnCancelOrder(
@@ -158,8 +156,8 @@ void StgEngTaskHandler::handleMsgIdOnCancelOrder(
     tdSrv_->getSHMSrvOfStgEng()->pushMsgWithZeroCopy(
         [&](void* shmBuf) {
           InitMsgBody(shmBuf, *ordReq);
-          LOG_I("Forward cancel order ret {}",
-                static_cast<OrderInfo*>(shmBuf)->toShortStr());
+          BLOG_I("Forward cancel order ret {}",
+                 *static_cast<OrderInfo*>(shmBuf));
         },
         ordReq->stgId_, MSG_ID_ON_CANCEL_ORDER_RET, sizeof(OrderInfo));
 
@@ -176,8 +174,8 @@ void StgEngTaskHandler::handleMsgIdOnCancelOrder(
     tdSrv_->getSHMSrvOfStgEng()->pushMsgWithZeroCopy(
         [&](void* shmBuf) {
           InitMsgBody(shmBuf, *ordReq);
-          LOG_I("Forward cancel order ret {}",
-                static_cast<OrderInfo*>(shmBuf)->toShortStr());
+          BLOG_I("Forward cancel order ret {}",
+                 *static_cast<OrderInfo*>(shmBuf));
         },
         ordReq->stgId_, MSG_ID_ON_CANCEL_ORDER_RET, sizeof(OrderInfo));
 
@@ -199,8 +197,7 @@ void StgEngTaskHandler::handleMsgIdOnCancelOrder(
       [&](void* shmBuf) {
         InitMsgBody(shmBuf, *ordReq);
 #ifndef OPT_LOG
-        LOG_I("Forward cancel order {}",
-              static_cast<OrderInfo*>(shmBuf)->toShortStr());
+        BLOG_I("Forward cancel order {}", *static_cast<OrderInfo*>(shmBuf));
 #endif
       },
       ordReq->acctId_, MSG_ID_ON_CANCEL_ORDER, sizeof(OrderInfo));
@@ -27,6 +27,7 @@
 #include "def/DataStruOfOthers.hpp"
 #include "def/DataStruOfTD.hpp"
 #include "def/SyncTask.hpp"
+#include "util/BinLogger.hpp"
 #include "util/Datetime.hpp"
 #include "util/StdExt.hpp"
 #include "util/TaskDispatcher.hpp"
@@ -60,15 +61,14 @@ void TDGWTaskHandler::handleMsgIdOnOrderRet(
     const SHMIPCAsyncTaskSPtr& asyncTask) {
   const auto ordRet = MakeMsgSPtrByTask<OrderInfo>(asyncTask->task_);
 #ifndef OPT_LOG
-  LOG_I("Recv order ret {}", ordRet->toShortStr());
+  BLOG_I("Recv order ret {}", *ordRet);
 #endif
 
   tdSrv_->getSHMSrvOfStgEng()->pushMsgWithZeroCopy(
       [&](void* shmBuf) {
         InitMsgBody(shmBuf, *ordRet);
 #ifndef OPT_LOG
-        LOG_I("Forward order ret {}",
-              static_cast<OrderInfo*>(shmBuf)->toShortStr());
+        BLOG_I("Forward order ret {}", *static_cast<OrderInfo*>(shmBuf));
 #endif
       },
       ordRet->stgId_, MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
@@ -84,7 +84,7 @@ void TDGWTaskHandler::handleMsgIdOnOrderRet(
                                                             LockFunc::False);
 
   if (isTheOrderCanBeUsedCalcPos == IsTheOrderCanBeUsedCalcPos::True) {
-    LOG_I("Begin to calc pos by order info. {}", ordRet->toShortStr());
+    BLOG_I("Begin to calc pos by order info. {}", *ordRet);
     const auto posChgInfo =
         std::ext::tls_get<PosMgr>().updateByOrderInfoFromTDGW(ordRet,
                                                               LockFunc::False);
@@ -104,14 +104,13 @@ void TDGWTaskHandler::handleMsgIdOnOrderRet(
 void TDGWTaskHandler::handleMsgIdOnCancelOrderRet(
     const SHMIPCAsyncTaskSPtr& asyncTask) {
   auto ordRet = MakeMsgSPtrByTask<OrderInfo>(asyncTask->task_);
-  LOG_I("Recv cancel order ret {}", ordRet->toShortStr());
+  BLOG_I("Recv cancel order ret {}", *ordRet);
 
   tdSrv_->getSHMSrvOfStgEng()->pushMsgWithZeroCopy(
       [&](void* shmBuf) {
         InitMsgBody(shmBuf, *ordRet);
 #ifndef OPT_LOG
-        LOG_I("Forward cancel order ret {}",
-              static_cast<OrderInfo*>(shmBuf)->toShortStr());
+        BLOG_I("Forward cancel order ret {}", *static_cast<OrderInfo*>(shmBuf));
 #endif
       },
       ordRet->stgId_, MSG_ID_ON_CANCEL_ORDER_RET, sizeof(OrderInfo));
@@ -20,6 +20,7 @@
 #include "SHMHeader.hpp"
 #include "SHMIPCTask.hpp"
 #include "SHMSrv.hpp"
+#include "ShardDataLoader.hpp"
 #include "StgEngTaskHandler.hpp"
 #include "TDGWTaskHandler.hpp"
 #include "TDSrvConst.hpp"
@@ -38,14 +39,17 @@
 #include "util/Literal.hpp"
 #include "util/Logger.hpp"
 #include "util/ScheduleTaskBundle.hpp"
-#include "util/Scheduler.hpp"
+#include "util/ScheduleTaskExecutor.hpp"
 #include "util/StdExt.hpp"
 #include "util/String.hpp"
+#include "util/SyncTaskBuffer.hpp"
 #include "util/TaskDispatcher.hpp"
 
 namespace bq::td::srv {
 
 int TDSrv::prepareInit() {
+  syncTaskBuffer_ = std::make_shared<SyncTaskBuffer>();
+
   if (const auto ret = Config::get_mutable_instance().init(configFilename_);
       ret != 0) {
     const auto statusMsg = fmt::format("Prepare init failed.");
@@ -79,6 +83,13 @@ int TDSrv::doInit() {
     return statusCode;
   }
 
+  std::tie(statusCode, statusMsg, compiledConditionFieldGroup_) =
+      CompileConditionFieldGroup(conditionFieldGroup_);
+  if (statusCode != 0) {
+    LOG_W("Do init failed. [{}]", statusMsg);
+    return statusCode;
+  }
+
   initTBLMonitorOfFlowCtrlRule();
 
   tdSrvRiskPluginMgr_ = std::make_shared<TDSrvRiskPluginMgr>(this);
@@ -107,9 +118,8 @@ int TDSrv::doInit() {
 
   scheduleTaskBundle_ = std::make_shared<ScheduleTaskBundle>();
   initScheduleTaskBundle();
-  scheduleTaskBundleExecutor_ = std::make_shared<Scheduler>(
-      std::string("TD_SRV"),
-      [this]() { ExecScheduleTaskBundle(getScheduleTaskBundle()); }, 1 * 1000);
+  scheduleTaskBundleExecutor_ = std::make_shared<ScheduleTaskExecutor>(
+      std::string("TD_SRV"), getScheduleTaskBundle());
 
   return 0;
 }
@@ -194,21 +204,19 @@ void TDSrv::initFlowCtrlRuleMgr() {
   }
 }
 
-void TDSrv::initPosMgr() {
-  const auto sql = fmt::format("SELECT * FROM `posInfo`");
-  std::ext::tls_get<PosMgr>().init(CONFIG, getDBEng(), sql);
+void TDSrv::initPosMgr(std::uint32_t threadNo) {
+  const auto posInfoGroup = shardDataLoader_->takePosInfoGroup(threadNo);
+  std::ext::tls_get<PosMgr>().init(CONFIG, getDBEng(), posInfoGroup);
 }
 
-void TDSrv::initAssetsMgr() {
-  const auto sql = fmt::format("SELECT * FROM `assetInfo`");
-  std::ext::tls_get<AssetsMgr>().init(CONFIG, getDBEng(), sql);
+void TDSrv::initAssetsMgr(std::uint32_t threadNo) {
+  const auto assetInfoGroup = shardDataLoader_->takeAssetInfoGroup(threadNo);
+  std::ext::tls_get<AssetsMgr>().init(CONFIG, getDBEng(), assetInfoGroup);
 }
 
-void TDSrv::initOrdMgr() {
-  const auto filled = magic_enum::enum_integer(OrderStatus::Filled);
-  const auto sql = fmt::format(
-      "SELECT * FROM `orderInfo` WHERE `orderStatus` < {}; ", filled);
-  std::ext::tls_get<OrdMgr>().init(CONFIG, getDBEng(), sql);
+void TDSrv::initOrdMgr(std::uint32_t threadNo) {
+  const auto orderInfoGroup = shardDataLoader_->takeOrderInfoGroup(threadNo);
+  std::ext::tls_get<OrdMgr>().init(CONFIG, getDBEng(), orderInfoGroup);
 }
 
 int TDSrv::initTDSrvTaskDispatcher() {
@@ -222,8 +230,17 @@ int TDSrv::initTDSrvTaskDispatcher() {
     return ret;
   }
 
+  // the recs owned by each thread are loaded once for all the threads
+  shardDataLoader_ = std::make_shared<ShardDataLoader>(this);
+  if (const auto retOfLoad = shardDataLoader_->load(
+          tdSrvTaskDispatcherParam->taskSpecificThreadPoolSize_);
+      retOfLoad != 0) {
+    LOG_E("Init taskdispatcher failed because of load shard data failed.");
+    return retOfLoad;
+  }
+
   const auto makeAsyncTask = [this](const auto& task) {
-    const auto hash = GetHashFromTask(task, conditionFieldGroup_);
+    const auto hash = GetHashFromTask(task, compiledConditionFieldGroup_);
     return std::make_tuple(0, std::make_shared<SHMIPCAsyncTask>(task, hash));
   };
 
@@ -270,9 +287,9 @@ int TDSrv::initTDSrvTaskDispatcher() {
   auto onThreadStart = [this](std::uint32_t threadNo) {
     LOG_I("Init thread local data for thread {}.", threadNo);
     initFlowCtrlRuleMgr();
-    initPosMgr();
-    initAssetsMgr();
-    initOrdMgr();
+    initPosMgr(threadNo);
+    initAssetsMgr(threadNo);
+    initOrdMgr(threadNo);
     getTDSrvRiskPluginMgr()->onThreadStart(threadNo);
   };
 
@@ -367,46 +384,46 @@ int TDSrv::doRun() {
   return 0;
 }
 
-void TDSrv::cacheSyncTaskGroup(MsgId msgId, const std::any& task,
+void TDSrv::cacheSyncTaskGroup(MsgId msgId, const OrderInfo& orderInfo,
                                SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB) {
-  {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxSyncTaskGroup_);
-    syncTaskGroup_.emplace_back(
-        std::make_shared<SyncTask>(msgId, task, syncToRiskMgr, syncToDB));
-  }
+  syncTaskBuffer_->cache(msgId, orderInfo, syncToRiskMgr, syncToDB);
 }
 
-void TDSrv::handleSyncTaskGroup() {
-  std::vector<SyncTaskSPtr> taskGroup;
-  {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxSyncTaskGroup_);
-    std::swap(taskGroup, syncTaskGroup_);
-  }
+void TDSrv::cacheSyncTaskGroup(MsgId msgId, const PosChgInfoSPtr& posChgInfo,
+                               SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB) {
+  syncTaskBuffer_->cache(msgId, posChgInfo, syncToRiskMgr, syncToDB);
+}
 
+void TDSrv::handleSyncTaskGroup() {
+  const auto& taskGroup = syncTaskBuffer_->swap();
   if (taskGroup.size() > 100) {
     LOG_W("Too many unprocessed task of sync. [num = {}]", taskGroup.size());
   }
 
-  for (const auto& rec : taskGroup) {
+  for (const auto rec : taskGroup) {
     if (rec->syncToDB_ == SyncToDB::False) continue;
 
     if (rec->msgId_ == MSG_ID_ON_ORDER || rec->msgId_ == MSG_ID_ON_ORDER_RET ||
         rec->msgId_ == MSG_ID_ON_CANCEL_ORDER ||
         rec->msgId_ == MSG_ID_ON_CANCEL_ORDER_RET) {
-      const auto orderInfo = std::any_cast<OrderInfoSPtr>(rec->task_);
+      const auto& orderInfo = rec->orderInfo_;
       const auto identity = GET_RAND_STR();
-      const auto sql = orderInfo->getSqlOfUSPOrderInfoUpdate();
-      const auto [ret, execRet] = getDBEng()->asyncExec(identity, sql);
+      const auto sql = orderInfo.getSqlOfUSPOrderInfoUpdate();
+      const auto [ret, execRet] = getDBEng()->asyncExec(
+          identity, sql, WriteLog::True, std::to_string(orderInfo.orderId_),
+          db::Coalesce::False);
       if (ret != 0) {
         LOG_W("Sync order info to db failed. [{}]", sql);
       }
 
     } else if (rec->msgId_ == MSG_ID_SYNC_POS_INFO) {
-      const auto posChgInfo = std::any_cast<PosChgInfoSPtr>(rec->task_);
+      const auto& posChgInfo = rec->posChgInfo_;
       for (const auto& posInfo : *posChgInfo) {
         const auto identity = GET_RAND_STR();
         const auto sql = posInfo->getSqlOfReplace();
-        const auto [ret, execRet] = dbEng_->asyncExec(identity, sql);
+        const auto [ret, execRet] = dbEng_->asyncExec(
+            identity, sql, WriteLog::True, posInfo->getKey(),
+            db::Coalesce::True);
         if (ret != 0) {
           LOG_W("Replace pos info from db failed. [{}]", sql);
         }
@@ -18,9 +18,13 @@
 
 namespace bq::td::srv {
 
-TDSrvRiskPluginMgr::TDSrvRiskPluginMgr(TDSrv* tdSrv) : tdSrv_(tdSrv) {}
+TDSrvRiskPluginMgr::TDSrvRiskPluginMgr(TDSrv* tdSrv)
+    : tdSrv_(tdSrv), chain_(new Chain()) {}
+
+TDSrvRiskPluginMgr::~TDSrvRiskPluginMgr() { delete chain_.load(); }
 
 int TDSrvRiskPluginMgr::load() {
+  std::lock_guard<std::mutex> guard(mtxLoad_);
   const auto [statusCode, no2LibPath] = initNo2LibPath();
   if (statusCode != 0) {
     return statusCode;
@@ -97,14 +101,16 @@ std::tuple<int, No2LibPath> TDSrvRiskPluginMgr::initNo2LibPath() {
 }
 
 void TDSrvRiskPluginMgr::initPlugIn(const No2LibPath& no2LibPath) {
+  auto no2TDSrvRiskPlugin = no2TDSrvRiskPlugin_;
+  std::vector<std::tuple<std::size_t, TDSrvRiskPluginSPtr>> retiredPluginGroup;
+
   for (std::size_t no = 0; no < MAX_TD_SRV_RISK_PLUGIN_NUM; ++no) {
     const auto iter = no2LibPath.find(no);
     if (iter == std::end(no2LibPath)) {
-      const auto oldPlugin = safeTDSrvRiskPluginGroup_[no].get();
+      const auto oldPlugin = no2TDSrvRiskPlugin[no];
       if (oldPlugin != nullptr) {
-        oldPlugin->unload();
-        safeTDSrvRiskPluginGroup_[no].set(nullptr);
-        LOG_I("Unload risk plugin {} - {} success.", no, oldPlugin->name());
+        no2TDSrvRiskPlugin[no] = nullptr;
+        retiredPluginGroup.emplace_back(no, oldPlugin);
       } else {
       }
 
@@ -113,47 +119,27 @@ void TDSrvRiskPluginMgr::initPlugIn(const No2LibPath& no2LibPath) {
       const auto newPlugin = createPlugin(no, libPath);
       if (!newPlugin) continue;
 
-      const auto oldPlugin = safeTDSrvRiskPluginGroup_[no].get();
+      const auto oldPlugin = no2TDSrvRiskPlugin[no];
       if (oldPlugin != nullptr) {
         if (newPlugin->getMD5SumOfConf() != oldPlugin->getMD5SumOfConf()) {
           if (newPlugin->enable()) {
-            if (oldPlugin->enable()) {
-              oldPlugin->unload();
-              const auto ret = newPlugin->load();
-              if (ret == 0) {
-                safeTDSrvRiskPluginGroup_[no].set(newPlugin);
-                LOG_I("Update risk plugin {} - {} to {} success.", no,
-                      oldPlugin->name(), newPlugin->name());
-              } else {
-                LOG_W("Update risk plugin {} - {} to {} failed. [{} - {}]", no,
-                      oldPlugin->name(), newPlugin->name(), ret,
-                      GetStatusMsg(ret));
-              }
-
+            // the old plugin keeps checking orders until the new one is loaded
+            const auto ret = newPlugin->load();
+            if (ret == 0) {
+              no2TDSrvRiskPlugin[no] = newPlugin;
+              retiredPluginGroup.emplace_back(no, oldPlugin);
+              LOG_I("Update risk plugin {} - {} to {} success.", no,
+                    oldPlugin->name(), newPlugin->name());
             } else {
-              // newPlugin enable oldPlugin disable
-              const auto ret = newPlugin->load();
-              if (ret == 0) {
-                safeTDSrvRiskPluginGroup_[no].set(newPlugin);
-                LOG_I("Load risk plugin {} - {} success.", no,
-                      newPlugin->name());
-              } else {
-                LOG_W("Load risk plugin {} - {} failed. [{} - {}]", no,
-                      newPlugin->name(), ret, GetStatusMsg(ret));
-              }
+              LOG_W("Update risk plugin {} - {} to {} failed. [{} - {}]", no,
+                    oldPlugin->name(), newPlugin->name(), ret,
+                    GetStatusMsg(ret));
             }
 
           } else {
-            if (oldPlugin->enable()) {
-              // newPlugin disable old plugin enable
-              oldPlugin->unload();
-              safeTDSrvRiskPluginGroup_[no].set(nullptr);
-              LOG_I("Unload risk plugin {} - {} success.", no,
-                    oldPlugin->name());
-
-            } else {
-              // newPlugin and oldPlugin are all disable
-            }
+            // newPlugin disable old plugin enable
+            no2TDSrvRiskPlugin[no] = nullptr;
+            retiredPluginGroup.emplace_back(no, oldPlugin);
           }
         } else {
         }
@@ -162,7 +148,7 @@ void TDSrvRiskPluginMgr::initPlugIn(const No2LibPath& no2LibPath) {
         if (newPlugin->enable()) {
           const auto ret = newPlugin->load();
           if (ret == 0) {
-            safeTDSrvRiskPluginGroup_[no].set(newPlugin);
+            no2TDSrvRiskPlugin[no] = newPlugin;
             LOG_I("Load risk plugin {} - {} success.", no, newPlugin->name());
           } else {
             LOG_W("Load risk plugin {} - {} failed. [{} - {}]", no,
@@ -174,6 +160,40 @@ void TDSrvRiskPluginMgr::initPlugIn(const No2LibPath& no2LibPath) {
       }
     }
   }
+
+  if (no2TDSrvRiskPlugin == no2TDSrvRiskPlugin_) return;
+  publish(no2TDSrvRiskPlugin);
+  no2TDSrvRiskPlugin_ = no2TDSrvRiskPlugin;
+
+  for (const auto& [no, oldPlugin] : retiredPluginGroup) {
+    oldPlugin->unload();
+    LOG_I("Unload risk plugin {} - {} success.", no, oldPlugin->name());
+  }
+}
+
+void TDSrvRiskPluginMgr::publish(
+    const No2TDSrvRiskPlugin& no2TDSrvRiskPlugin) {
+  auto chain = new Chain();
+  for (const auto& plugin : no2TDSrvRiskPlugin) {
+    if (!plugin) continue;
+    chain->tdSrvRiskPluginGroup_.emplace_back(plugin);
+  }
+  const auto oldChain = chain_.exchange(chain);
+  waitForReadersInFlight();
+  delete oldChain;
+}
+
+/*
+ * Same as the routing table of the subscribers, the old chain is no longer
+ * walked once both of the reader nums have been seen as zero after the swap.
+ */
+void TDSrvRiskPluginMgr::waitForReadersInFlight() {
+  for (int i = 0; i < 2; ++i) {
+    const auto epoch = epoch_.fetch_add(1);
+    while (readerNumGroup_[epoch & 1].value_.load() != 0) {
+      std::this_thread::yield();
+    }
+  }
 }
 
 TDSrvRiskPluginSPtr TDSrvRiskPluginMgr::createPlugin(
@@ -190,67 +210,37 @@ TDSrvRiskPluginSPtr TDSrvRiskPluginMgr::createPlugin(
 }
 
 void TDSrvRiskPluginMgr::onThreadStart(std::uint32_t threadNo) {
-  for (const auto& safePlugin : safeTDSrvRiskPluginGroup_) {
-    auto plugin = safePlugin.get();
-    if (!plugin) continue;
+  forEachPlugin([&](const auto& plugin) {
     plugin->onThreadStart(threadNo);
-  }
+    return 0;
+  });
 }
 
 void TDSrvRiskPluginMgr::onThreadExit(std::uint32_t threadNo) {
-  for (const auto& safePlugin : safeTDSrvRiskPluginGroup_) {
-    auto plugin = safePlugin.get();
-    if (!plugin) continue;
+  forEachPlugin([&](const auto& plugin) {
     plugin->onThreadExit(threadNo);
-  }
+    return 0;
+  });
 }
 
 int TDSrvRiskPluginMgr::onOrder(const OrderInfoSPtr& order) {
-  for (const auto& safePlugin : safeTDSrvRiskPluginGroup_) {
-    auto plugin = safePlugin.get();
-    if (!plugin) continue;
-    const auto statusCode = plugin->onOrder(order);
-    if (statusCode != 0) {
-      return statusCode;
-    }
-  }
-  return 0;
+  return forEachPlugin(
+      [&](const auto& plugin) { return plugin->onOrder(order); });
 }
 
 int TDSrvRiskPluginMgr::onCancelOrder(const OrderInfoSPtr& order) {
-  for (const auto& safePlugin : safeTDSrvRiskPluginGroup_) {
-    auto plugin = safePlugin.get();
-    if (!plugin) continue;
-    const auto statusCode = plugin->onCancelOrder(order);
-    if (statusCode != 0) {
-      return statusCode;
-    }
-  }
-  return 0;
+  return forEachPlugin(
+      [&](const auto& plugin) { return plugin->onCancelOrder(order); });
 }
 
 int TDSrvRiskPluginMgr::onOrderRet(const OrderInfoSPtr& order) {
-  for (const auto& safePlugin : safeTDSrvRiskPluginGroup_) {
-    auto plugin = safePlugin.get();
-    if (!plugin) continue;
-    const auto statusCode = plugin->onOrderRet(order);
-    if (statusCode != 0) {
-      return statusCode;
-    }
-  }
-  return 0;
+  return forEachPlugin(
+      [&](const auto& plugin) { return plugin->onOrderRet(order); });
 }
 
 int TDSrvRiskPluginMgr::onCancelOrderRet(const OrderInfoSPtr& order) {
-  for (const auto& safePlugin : safeTDSrvRiskPluginGroup_) {
-    auto plugin = safePlugin.get();
-    if (!plugin) continue;
-    const auto statusCode = plugin->onCancelOrderRet(order);
-    if (statusCode != 0) {
-      return statusCode;
-    }
-  }
-  return 0;
+  return forEachPlugin(
+      [&](const auto& plugin) { return plugin->onCancelOrderRet(order); });
 }
 
 }  // namespace bq::td::srv
@@ -1,2 +1,4 @@
 set(SOLUTION_ROOT_DIR ".." CACHE STRING "Root dir of solution.")
 set(3RDPARTY_PATH ${SOLUTION_ROOT_DIR}/3rdparty)
+
+include(${SOLUTION_ROOT_DIR}/cmake/decimal.cmake)
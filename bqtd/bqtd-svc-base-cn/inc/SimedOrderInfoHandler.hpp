@@ -15,12 +15,23 @@
 #include "def/Const.hpp"
 #include "def/Def.hpp"
 #include "util/Pch.hpp"
+#include "util/StdExt.hpp"
 
 namespace bq {
 struct OrderInfo;
 using OrderInfoSPTr = std::shared_ptr<OrderInfo>;
 struct SimedTDInfo;
 using SimedTDInfoSPtr = std::shared_ptr<SimedTDInfo>;
+
+class TimerWheel;
+using TimerWheelSPtr = std::shared_ptr<TimerWheel>;
+
+class SubMgr;
+using SubMgrSPtr = std::shared_ptr<SubMgr>;
+
+class SimedOrderMatcher;
+using SimedOrderMatcherSPtr = std::shared_ptr<SimedOrderMatcher>;
+struct SimedMatchRet;
 }  // namespace bq
 
 namespace bq::db::symbolInfo {
@@ -34,6 +45,13 @@ namespace bq::td::svc {
 class TDSvcOfCN;
 
 class SimedOrderInfoHandler {
+  // order ret of the matcher, sent after mtxSimedOrderMatcher_ is unlocked
+  struct SimedOrderRet {
+    OrderInfoSPTr ordRet_{nullptr};
+    bool canceled_{false};
+  };
+  using SimedOrderRetGroup = std::vector<SimedOrderRet>;
+
  public:
   SimedOrderInfoHandler(const SimedOrderInfoHandler&) = delete;
   SimedOrderInfoHandler& operator=(const SimedOrderInfoHandler&) = delete;
@@ -41,6 +59,7 @@ class SimedOrderInfoHandler {
   SimedOrderInfoHandler& operator=(const SimedOrderInfoHandler&&) = delete;
 
   explicit SimedOrderInfoHandler(TDSvcOfCN* tdSvc);
+  ~SimedOrderInfoHandler();
 
  public:
 #ifdef SIMED_MODE
@@ -58,14 +77,34 @@ class SimedOrderInfoHandler {
   void simOnOrderPartialFilled(OrderInfoSPTr& ordReq,
                                const SimedTDInfoSPtr& simedTDInfo,
                                const db::symbolInfo::RecordSPtr& symbolInfo);
+  void simOnTransDetailGroup(OrderInfoSPTr& ordReq,
+                             const SimedTDInfoSPtr& simedTDInfo,
+                             const db::symbolInfo::RecordSPtr& symbolInfo,
+                             OrderStatus orderStatusOfLastTransDetail);
+  void applyTrade(OrderInfoSPTr& ordReq, Decimal lastDealPrice,
+                  Decimal lastDealSize, LiquidityDirection liquidityDirection,
+                  const db::symbolInfo::RecordSPtr& symbolInfo);
+  void simOnTrade(const OrderInfoSPTr& ordRet);
   void simOnOrderFailed(OrderInfoSPTr& ordReq,
                         const SimedTDInfoSPtr& simedTDInfo);
   void simOnOrderOfUnknownOrderStatus(OrderInfoSPTr& ordReq,
                                       const SimedTDInfoSPtr& simedTDInfo);
 
+ private:
+  void simOnOrderByMatcher(OrderInfoSPTr& ordReq);
+  void subMarketData(const OrderInfoSPTr& ordReq);
+  void onMarketData(const void* shmBuf);
+  SimedOrderRetGroup handleSimedMatchRet(const SimedMatchRet& simedMatchRet);
+  void sendSimedOrderRetGroup(const SimedOrderRetGroup& simedOrderRetGroup);
+  void simOnCancelOrderByMatcher(OrderInfoSPTr& ordReq);
+
  public:
   void simOnCancelOrder(OrderInfoSPTr& ordReq);
 
+ private:
+  void doSimOnCancelOrder(OrderInfoSPTr& ordReq);
+  void simOnCancelOrderFailed(OrderInfoSPTr& ordReq);
+
  private:
   TDSvcOfCN* tdSvc_;
 
@@ -73,6 +112,24 @@ class SimedOrderInfoHandler {
   Decimal feeRatioOfMaker_;
   Decimal feeRatioOfTaker_;
   std::uint32_t milliSecIntervalOfSimOrderStatus_{0};
+
+  TimerWheelSPtr timerWheel_{nullptr};
+
+  // orders are matched against the market data instead of simed td info
+  bool enableMatcher_{false};
+  std::uint32_t milliSecLatencyOfOrder_{0};
+  std::uint32_t milliSecLatencyOfCancel_{0};
+
+  SubMgrSPtr subMgr_{nullptr};
+  TopicGroup topicGroupOfMarketData_;
+
+  struct SimedOrder {
+    OrderInfoSPTr ordReq_{nullptr};
+    db::symbolInfo::RecordSPtr symbolInfo_{nullptr};
+  };
+  SimedOrderMatcherSPtr simedOrderMatcher_{nullptr};
+  absl::node_hash_map<OrderId, SimedOrder> orderId2SimedOrder_;
+  std::ext::spin_mutex mtxSimedOrderMatcher_;
 };
 
 }  // namespace bq::td::svc
@@ -62,6 +62,8 @@ class TDSrvTaskHandler {
 
  private:
   TDSvcOfCN* tdSvc_;
+  const std::uint32_t taskIdOfOnOrder_;
+  const std::uint32_t taskIdOfOnCancelOrder_;
 };
 
 }  // namespace bq::td::svc
@@ -14,10 +14,12 @@
 #include "OrdMgr.hpp"
 #include "PosMgr.hpp"
 #include "SHMIPC.hpp"
+#include "SHMIPCConst.hpp"
 #include "TDSvcDef.hpp"
 #include "TDSvcOfCN.hpp"
 #include "db/TBLMonitorOfSymbolInfo.hpp"
 #include "db/TBLSymbolInfo.hpp"
+#include "def/BQConstIF.hpp"
 #include "def/BQDef.hpp"
 #include "def/Const.hpp"
 #include "def/DataStruOfMD.hpp"
@@ -27,11 +29,16 @@
 #include "def/SimedTDInfo.hpp"
 #include "def/StatusCode.hpp"
 #include "def/SyncTask.hpp"
+#include "util/BQUtil.hpp"
 #include "util/Datetime.hpp"
 #include "util/Fee.hpp"
 #include "util/Float.hpp"
 #include "util/Logger.hpp"
 #include "util/Random.hpp"
+#include "util/SimedOrderMatcher.hpp"
+#include "util/String.hpp"
+#include "util/SubMgr.hpp"
+#include "util/TimerWheel.hpp"
 
 namespace bq::td::svc {
 
@@ -42,10 +49,42 @@ SimedOrderInfoHandler::SimedOrderInfoHandler(TDSvcOfCN* tdSvc) : tdSvc_(tdSvc) {
   milliSecIntervalOfSimOrderStatus_ =
       CONFIG["simedMode"]["milliSecIntervalOfSimOrderStatus"].as<std::uint32_t>(
           0);
+
+  const auto& nodeOfMatcher = CONFIG["simedMode"]["matcher"];
+  enableMatcher_ = nodeOfMatcher["enable"].as<bool>(false);
+  milliSecLatencyOfOrder_ =
+      nodeOfMatcher["milliSecLatencyOfOrder"].as<std::uint32_t>(0);
+  milliSecLatencyOfCancel_ =
+      nodeOfMatcher["milliSecLatencyOfCancel"].as<std::uint32_t>(0);
+  if (enableMatcher_) {
+    simedOrderMatcher_ = std::make_shared<SimedOrderMatcher>();
+    subMgr_ = std::make_shared<SubMgr>(
+        tdSvc_->getAppName(),
+        [this](const auto shmBuf, auto shmBufLen) { onMarketData(shmBuf); });
+  }
+
+  // the wheel only drives the latency of the matcher and the interval of sim
+  // order status, no thread is started when neither is used
+  if (enableMatcher_ || milliSecIntervalOfSimOrderStatus_ != 0) {
+    timerWheel_ = std::make_shared<TimerWheel>("SIMED_ORDER_INFO_HANDLER");
+    timerWheel_->start();
+  }
+}
+
+SimedOrderInfoHandler::~SimedOrderInfoHandler() {
+  subMgr_.reset();
+  if (timerWheel_) {
+    timerWheel_->stop();
+  }
 }
 
 #ifdef SIMED_MODE
 void SimedOrderInfoHandler::simOnOrder(OrderInfoSPtr& ordReq) {
+  if (enableMatcher_) {
+    simOnOrderByMatcher(ordReq);
+    return;
+  }
+
   const auto [statusCode, simedTDInfo] = MakeSimedTDInfo(ordReq->simedTDInfo_);
   if (statusCode != 0) {
     ordReq->orderStatus_ = OrderStatus::Failed;
@@ -63,8 +102,7 @@ void SimedOrderInfoHandler::simOnOrder(OrderInfoSPtr& ordReq) {
         },
         MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET,
-                               std::make_shared<OrderInfo>(*ordReq),
+    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *ordReq,
                                SyncToRiskMgr::True, SyncToDB::True);
     return;
   }
@@ -126,8 +164,7 @@ db::symbolInfo::RecordSPtr SimedOrderInfoHandler::simOnOrderConfirmedByExch(
 #endif
         },
         MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET,
-                               std::make_shared<OrderInfo>(*ordReq),
+    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *ordReq,
                                SyncToRiskMgr::True, SyncToDB::True);
     return nullptr;
   }
@@ -162,7 +199,7 @@ db::symbolInfo::RecordSPtr SimedOrderInfoHandler::simOnOrderConfirmedByExch(
       },
       MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, orderInfoInOrdMgr,
+  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *orderInfoInOrdMgr,
                              SyncToRiskMgr::True, SyncToDB::True);
 
   return symbolInfo;
@@ -171,137 +208,104 @@ db::symbolInfo::RecordSPtr SimedOrderInfoHandler::simOnOrderConfirmedByExch(
 void SimedOrderInfoHandler::simOnOrderFilled(
     OrderInfoSPTr& ordReq, const SimedTDInfoSPtr& simedTDInfo,
     const db::symbolInfo::RecordSPtr& symbolInfo) {
-  ordReq->orderStatus_ = OrderStatus::PartialFilled;
-  ordReq->statusCode_ = SCODE_SUCCESS;
-  ordReq->exchOrderId_ = 0;
-
-  for (std::size_t i = 0; i < simedTDInfo->transDetailGroup_.size(); ++i) {
-    if (milliSecIntervalOfSimOrderStatus_ != 0) {
-      std::this_thread::sleep_for(
-          std::chrono::milliseconds(milliSecIntervalOfSimOrderStatus_));
-    }
-
-    if (i == simedTDInfo->transDetailGroup_.size() - 1) {
-      ordReq->orderStatus_ = OrderStatus::Filled;
-    }
-
-    const auto lastTradeId = fmt::format("{}", GET_RAND_INT());
-    strncpy(ordReq->lastTradeId_, lastTradeId.c_str(),
-            sizeof(ordReq->lastTradeId_));
-    if (ordReq->side_ == Side::Bid) {
-      ordReq->lastDealSize_ =
-          ordReq->orderSize_ * simedTDInfo->transDetailGroup_[i]->filledPer_;
-      ordReq->lastDealPrice_ =
-          ordReq->orderPrice_ -
-          ordReq->orderPrice_ * simedTDInfo->transDetailGroup_[i]->slippage_;
-    } else {
-      ordReq->lastDealSize_ = ordReq->orderSize_ *
-                              simedTDInfo->transDetailGroup_[i]->filledPer_ *
-                              -1;
-      ordReq->lastDealPrice_ =
-          ordReq->orderPrice_ +
-          ordReq->orderPrice_ * simedTDInfo->transDetailGroup_[i]->slippage_;
-    }
-    ordReq->lastDealTime_ = GetTotalUSSince1970();
-
-    const auto prevDealAmt = ordReq->avgDealPrice_ * ordReq->dealSize_;
-    const auto lastDealAmt = ordReq->lastDealPrice_ * ordReq->lastDealSize_;
-    const auto totalDealSize = ordReq->dealSize_ + ordReq->lastDealSize_;
-    if (!isApproximatelyZero(totalDealSize)) {
-      ordReq->avgDealPrice_ = (prevDealAmt + lastDealAmt) / totalDealSize;
-    }
-    ordReq->dealSize_ = totalDealSize;
-
-    const auto liquidityDirection =
-        simedTDInfo->transDetailGroup_[i]->liquidityDirection_;
-    const auto feeRatio = liquidityDirection == LiquidityDirection::Maker
-                              ? feeRatioOfMaker_
-                              : feeRatioOfTaker_;
-    ordReq->fee_ = calcFee(ordReq, feeRatio, symbolInfo->parValue);
-
-    const auto [isTheOrderInfoUpdated, orderInfoInOrdMgr] =
-        tdSvc_->getOrdMgr()->updateByOrderInfoFromExch(
-            ordReq, tdSvc_->getNextNoUsedToCalcPos(), DeepClone::True);
-
-    tdSvc_->getSHMCliOfTDSrv()->asyncSendMsgWithZeroCopy(
-        [&](void* shmBuf) {
-          InitMsgBody(shmBuf, *orderInfoInOrdMgr);
-#ifndef OPT_LOG
-          LOG_I("Send simed order ret. {}",
-                static_cast<OrderInfo*>(shmBuf)->toShortStr());
-#endif
-        },
-        MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
-
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, orderInfoInOrdMgr,
-                               SyncToRiskMgr::True, SyncToDB::True);
-  }
+  simOnTransDetailGroup(ordReq, simedTDInfo, symbolInfo, OrderStatus::Filled);
 }
 
 void SimedOrderInfoHandler::simOnOrderPartialFilled(
     OrderInfoSPTr& ordReq, const SimedTDInfoSPtr& simedTDInfo,
     const db::symbolInfo::RecordSPtr& symbolInfo) {
-  ordReq->orderStatus_ = OrderStatus::PartialFilled;
-  ordReq->statusCode_ = SCODE_SUCCESS;
-  ordReq->exchOrderId_ = 0;
+  simOnTransDetailGroup(ordReq, simedTDInfo, symbolInfo,
+                        OrderStatus::PartialFilled);
+}
 
-  for (std::size_t i = 0; i < simedTDInfo->transDetailGroup_.size(); ++i) {
-    if (milliSecIntervalOfSimOrderStatus_ != 0) {
-      std::this_thread::sleep_for(
-          std::chrono::milliseconds(milliSecIntervalOfSimOrderStatus_));
+/*
+ * Trans details are played at the interval of sim order status on the thread
+ * of the timer wheel, the handler thread is not blocked by the interval. The
+ * deal fields of each trans detail are accumulated here and every timer owns
+ * a copy of the order, so nothing is shared with the handler thread.
+ */
+void SimedOrderInfoHandler::simOnTransDetailGroup(
+    OrderInfoSPTr& ordReq, const SimedTDInfoSPtr& simedTDInfo,
+    const db::symbolInfo::RecordSPtr& symbolInfo,
+    OrderStatus orderStatusOfLastTransDetail) {
+  auto ordRet = std::make_shared<OrderInfo>(*ordReq);
+  ordRet->statusCode_ = SCODE_SUCCESS;
+  ordRet->exchOrderId_ = 0;
+
+  const auto& transDetailGroup = simedTDInfo->transDetailGroup_;
+  for (std::size_t i = 0; i < transDetailGroup.size(); ++i) {
+    const auto& transDetail = transDetailGroup[i];
+    ordRet->orderStatus_ = i == transDetailGroup.size() - 1
+                               ? orderStatusOfLastTransDetail
+                               : OrderStatus::PartialFilled;
+    const auto slippage = ordRet->orderPrice_ * transDetail->slippage_;
+    const auto lastDealSize = ordRet->orderSize_ * transDetail->filledPer_;
+    if (ordRet->side_ == Side::Bid) {
+      applyTrade(ordRet, ordRet->orderPrice_ - slippage, lastDealSize,
+                 transDetail->liquidityDirection_, symbolInfo);
+    } else {
+      applyTrade(ordRet, ordRet->orderPrice_ + slippage, lastDealSize * -1,
+                 transDetail->liquidityDirection_, symbolInfo);
     }
 
-    const auto lastTradeId = fmt::format("{}", GET_RAND_INT());
-    strncpy(ordReq->lastTradeId_, lastTradeId.c_str(),
-            sizeof(ordReq->lastTradeId_));
-    if (ordReq->side_ == Side::Bid) {
-      ordReq->lastDealSize_ =
-          ordReq->orderSize_ * simedTDInfo->transDetailGroup_[i]->filledPer_;
-      ordReq->lastDealPrice_ =
-          ordReq->orderPrice_ -
-          ordReq->orderPrice_ * simedTDInfo->transDetailGroup_[i]->slippage_;
+    const auto ordRetOfTransDetail = std::make_shared<OrderInfo>(*ordRet);
+    if (milliSecIntervalOfSimOrderStatus_ == 0) {
+      simOnTrade(ordRetOfTransDetail);
     } else {
-      ordReq->lastDealSize_ = ordReq->orderSize_ *
-                              simedTDInfo->transDetailGroup_[i]->filledPer_ *
-                              -1;
-      ordReq->lastDealPrice_ =
-          ordReq->orderPrice_ +
-          ordReq->orderPrice_ * simedTDInfo->transDetailGroup_[i]->slippage_;
+      timerWheel_->addTimer(
+          milliSecIntervalOfSimOrderStatus_ * (i + 1),
+          [this, ordRetOfTransDetail]() { simOnTrade(ordRetOfTransDetail); });
     }
-    ordReq->lastDealTime_ = GetTotalUSSince1970();
+  }
+}
 
-    const auto prevDealAmt = ordReq->avgDealPrice_ * ordReq->dealSize_;
-    const auto lastDealAmt = ordReq->lastDealPrice_ * ordReq->lastDealSize_;
-    const auto totalDealSize = ordReq->dealSize_ + ordReq->lastDealSize_;
-    if (!isApproximatelyZero(totalDealSize)) {
-      ordReq->avgDealPrice_ = (prevDealAmt + lastDealAmt) / totalDealSize;
-    }
-    ordReq->dealSize_ = totalDealSize;
+void SimedOrderInfoHandler::applyTrade(
+    OrderInfoSPTr& ordReq, Decimal lastDealPrice, Decimal lastDealSize,
+    LiquidityDirection liquidityDirection,
+    const db::symbolInfo::RecordSPtr& symbolInfo) {
+  const auto lastTradeId = fmt::format("{}", GET_RAND_INT());
+  strncpy(ordReq->lastTradeId_, lastTradeId.c_str(),
+          sizeof(ordReq->lastTradeId_));
+  ordReq->lastDealSize_ = lastDealSize;
+  ordReq->lastDealPrice_ = lastDealPrice;
+
+  const auto prevDealAmt = ordReq->avgDealPrice_ * ordReq->dealSize_;
+  const auto lastDealAmt = ordReq->lastDealPrice_ * ordReq->lastDealSize_;
+  const auto totalDealSize = ordReq->dealSize_ + ordReq->lastDealSize_;
+  if (!isApproximatelyZero(totalDealSize)) {
+    ordReq->avgDealPrice_ = (prevDealAmt + lastDealAmt) / totalDealSize;
+  }
+  ordReq->dealSize_ = totalDealSize;
 
-    const auto liquidityDirection =
-        simedTDInfo->transDetailGroup_[i]->liquidityDirection_;
-    const auto feeRatio = liquidityDirection == LiquidityDirection::Maker
-                              ? feeRatioOfMaker_
-                              : feeRatioOfTaker_;
-    ordReq->fee_ = calcFee(ordReq, feeRatio, symbolInfo->parValue);
+  const auto feeRatio = liquidityDirection == LiquidityDirection::Maker
+                            ? feeRatioOfMaker_
+                            : feeRatioOfTaker_;
+  ordReq->fee_ = calcFee(ordReq, feeRatio, symbolInfo->parValue);
+}
 
-    const auto [isTheOrderInfoUpdated, orderInfoInOrdMgr] =
-        tdSvc_->getOrdMgr()->updateByOrderInfoFromExch(
-            ordReq, tdSvc_->getNextNoUsedToCalcPos(), DeepClone::True);
+void SimedOrderInfoHandler::simOnTrade(const OrderInfoSPTr& ordRet) {
+  ordRet->lastDealTime_ = GetTotalUSSince1970();
 
-    tdSvc_->getSHMCliOfTDSrv()->asyncSendMsgWithZeroCopy(
-        [&](void* shmBuf) {
-          InitMsgBody(shmBuf, *orderInfoInOrdMgr);
+  // the order may have been canceled while the trade was pending
+  const auto [isTheOrderInfoUpdated, orderInfoInOrdMgr] =
+      tdSvc_->getOrdMgr()->updateByOrderInfoFromExch(
+          ordRet, tdSvc_->getNextNoUsedToCalcPos(), DeepClone::True);
+  if (!orderInfoInOrdMgr) {
+    return;
+  }
+
+  tdSvc_->getSHMCliOfTDSrv()->asyncSendMsgWithZeroCopy(
+      [&](void* shmBuf) {
+        InitMsgBody(shmBuf, *orderInfoInOrdMgr);
 #ifndef OPT_LOG
-          LOG_I("Send simed order ret. {}",
-                static_cast<OrderInfo*>(shmBuf)->toShortStr());
+        LOG_I("Send simed order ret. {}",
+              static_cast<OrderInfo*>(shmBuf)->toShortStr());
 #endif
-        },
-        MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
+      },
+      MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, orderInfoInOrdMgr,
-                               SyncToRiskMgr::True, SyncToDB::True);
-  }
+  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *orderInfoInOrdMgr,
+                             SyncToRiskMgr::True, SyncToDB::True);
 }
 
 void SimedOrderInfoHandler::simOnOrderFailed(
@@ -318,26 +322,26 @@ void SimedOrderInfoHandler::simOnOrderFailed(
 #endif
       },
       MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
-  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, ordReq, SyncToRiskMgr::True,
+  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *ordReq, SyncToRiskMgr::True,
                              SyncToDB::True);
 }
 
 void SimedOrderInfoHandler::simOnCancelOrder(OrderInfoSPtr& ordReq) {
+  if (enableMatcher_) {
+    simOnCancelOrderByMatcher(ordReq);
+    return;
+  }
+  doSimOnCancelOrder(ordReq);
+}
+
+void SimedOrderInfoHandler::doSimOnCancelOrder(OrderInfoSPtr& ordReq) {
   int statusCode = 0;
   OrderInfoSPtr orderInfoInOrdMgr{nullptr};
   std::tie(statusCode, orderInfoInOrdMgr) =
       tdSvc_->getOrdMgr()->getOrderInfo(ordReq->orderId_, DeepClone::False);
-  if (statusCode != 0 || orderInfoInOrdMgr == nullptr) {
-    ordReq->statusCode_ = -1;
-    tdSvc_->getSHMCliOfTDSrv()->asyncSendMsgWithZeroCopy(
-        [&](void* shmBuf) {
-          InitMsgBody(shmBuf, *ordReq);
-#ifndef OPT_LOG
-          LOG_I("Send simed order ret. {}",
-                static_cast<OrderInfo*>(shmBuf)->toShortStr());
-#endif
-        },
-        MSG_ID_ON_CANCEL_ORDER_RET, sizeof(OrderInfo));
+  if (statusCode != 0 || orderInfoInOrdMgr == nullptr ||
+      orderInfoInOrdMgr->closed()) {
+    simOnCancelOrderFailed(ordReq);
     return;
   }
 
@@ -356,8 +360,164 @@ void SimedOrderInfoHandler::simOnCancelOrder(OrderInfoSPtr& ordReq) {
 #endif
       },
       MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
-  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, orderInfoInOrdMgr,
+  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *orderInfoInOrdMgr,
                              SyncToRiskMgr::True, SyncToDB::True);
 }
 
+void SimedOrderInfoHandler::simOnCancelOrderFailed(OrderInfoSPtr& ordReq) {
+  ordReq->statusCode_ = -1;
+  tdSvc_->getSHMCliOfTDSrv()->asyncSendMsgWithZeroCopy(
+      [&](void* shmBuf) {
+        InitMsgBody(shmBuf, *ordReq);
+#ifndef OPT_LOG
+        LOG_I("Send simed order ret. {}",
+              static_cast<OrderInfo*>(shmBuf)->toShortStr());
+#endif
+      },
+      MSG_ID_ON_CANCEL_ORDER_RET, sizeof(OrderInfo));
+}
+
+/*
+ * The order is confirmed at once and reaches the matcher after the latency of
+ * order, fills and cancels of the matcher are sent as order rets.
+ */
+void SimedOrderInfoHandler::simOnOrderByMatcher(OrderInfoSPTr& ordReq) {
+  const auto symbolInfo = simOnOrderConfirmedByExch(ordReq, nullptr);
+  if (!symbolInfo) {
+    return;
+  }
+  subMarketData(ordReq);
+
+  {
+    SPIN_LOCK(mtxSimedOrderMatcher_);
+    orderId2SimedOrder_.emplace(ordReq->orderId_,
+                                SimedOrder{ordReq, symbolInfo});
+  }
+
+  timerWheel_->addTimer(
+      milliSecLatencyOfOrder_, [this, orderId = ordReq->orderId_]() {
+        SimedOrderRetGroup simedOrderRetGroup;
+        {
+          SPIN_LOCK(mtxSimedOrderMatcher_);
+          const auto iter = orderId2SimedOrder_.find(orderId);
+          if (iter == std::end(orderId2SimedOrder_)) {
+            return;  // canceled before reaching the matcher
+          }
+          simedOrderRetGroup = handleSimedMatchRet(
+              simedOrderMatcher_->onOrder(*iter->second.ordReq_));
+        }
+        sendSimedOrderRetGroup(simedOrderRetGroup);
+      });
+}
+
+void SimedOrderInfoHandler::subMarketData(const OrderInfoSPTr& ordReq) {
+  const std::vector<std::tuple<MDType, std::string>> mdTypeGroup{
+      {MDType::Books, Int2StrInCompileTime<MAX_DEPTH_LEVEL>::type::value},
+      {MDType::Trades, ""}};
+  for (const auto& [mdType, ext] : mdTypeGroup) {
+    const auto [topic, topicHash] =
+        MakeTopicInfo(GetMarketName(ordReq->marketCode_),
+                      ENUM_TO_STR(SymbolType::Spot),
+                      ordReq->symbolCode_, mdType, ext);
+    {
+      SPIN_LOCK(mtxSimedOrderMatcher_);
+      if (!topicGroupOfMarketData_.emplace(topic).second) continue;
+    }
+    if (const auto ret = subMgr_->sub(PUB_CHANNEL, topic); ret != 0) {
+      LOG_W("Sub market data of simed order matcher failed. [{}]", topic);
+    }
+  }
+}
+
+void SimedOrderInfoHandler::onMarketData(const void* shmBuf) {
+  const auto header = static_cast<const SHMHeader*>(shmBuf);
+  SimedOrderRetGroup simedOrderRetGroup;
+  {
+    SPIN_LOCK(mtxSimedOrderMatcher_);
+    if (header->msgId_ == MSG_ID_ON_MD_BOOKS) {
+      simedOrderMatcher_->onBooks(*static_cast<const Books*>(shmBuf));
+    } else if (header->msgId_ == MSG_ID_ON_MD_TRADES) {
+      simedOrderRetGroup = handleSimedMatchRet(
+          simedOrderMatcher_->onTrades(*static_cast<const Trades*>(shmBuf)));
+    }
+  }
+  sendSimedOrderRetGroup(simedOrderRetGroup);
+}
+
+/*
+ * Called with mtxSimedOrderMatcher_ locked, the deal fields are applied to the
+ * order of the matcher and a copy of it is returned, the rets are sent by
+ * sendSimedOrderRetGroup after the lock is released.
+ */
+SimedOrderInfoHandler::SimedOrderRetGroup
+SimedOrderInfoHandler::handleSimedMatchRet(const SimedMatchRet& simedMatchRet) {
+  SimedOrderRetGroup simedOrderRetGroup;
+  for (const auto& simedFill : simedMatchRet.fillGroup_) {
+    const auto iter = orderId2SimedOrder_.find(simedFill.orderId_);
+    if (iter == std::end(orderId2SimedOrder_)) continue;
+    auto& [ordReq, symbolInfo] = iter->second;
+
+    const auto isBid = ordReq->side_ == Side::Bid;
+    const auto dealSize =
+        (isBid ? ordReq->dealSize_ : -ordReq->dealSize_) + simedFill.size_;
+    const auto isFilled = !isDefinitelyLessThan(dealSize, ordReq->orderSize_);
+    ordReq->orderStatus_ =
+        isFilled ? OrderStatus::Filled : OrderStatus::PartialFilled;
+    ordReq->statusCode_ = SCODE_SUCCESS;
+    applyTrade(ordReq, simedFill.price_,
+               isBid ? simedFill.size_ : -simedFill.size_,
+               simedFill.liquidityDirection_, symbolInfo);
+    simedOrderRetGroup.emplace_back(
+        SimedOrderRet{std::make_shared<OrderInfo>(*ordReq), false});
+    if (isFilled) {
+      orderId2SimedOrder_.erase(iter);
+    }
+  }
+
+  for (const auto orderId : simedMatchRet.canceledOrderIdGroup_) {
+    const auto iter = orderId2SimedOrder_.find(orderId);
+    if (iter == std::end(orderId2SimedOrder_)) continue;
+    simedOrderRetGroup.emplace_back(SimedOrderRet{iter->second.ordReq_, true});
+    orderId2SimedOrder_.erase(iter);
+  }
+
+  return simedOrderRetGroup;
+}
+
+void SimedOrderInfoHandler::sendSimedOrderRetGroup(
+    const SimedOrderRetGroup& simedOrderRetGroup) {
+  for (auto [ordRet, canceled] : simedOrderRetGroup) {
+    if (canceled) {
+      doSimOnCancelOrder(ordRet);
+    } else {
+      simOnTrade(ordRet);
+    }
+  }
+}
+
+/*
+ * An order which has left the matcher is filled or canceled already, the
+ * cancel of it fails instead of closing it a second time.
+ */
+void SimedOrderInfoHandler::simOnCancelOrderByMatcher(OrderInfoSPTr& ordReq) {
+  timerWheel_->addTimer(milliSecLatencyOfCancel_, [this, ordReq]() mutable {
+    bool isTheOrderOnMatcher = false;
+    {
+      SPIN_LOCK(mtxSimedOrderMatcher_);
+      const auto iter = orderId2SimedOrder_.find(ordReq->orderId_);
+      if (iter != std::end(orderId2SimedOrder_)) {
+        simedOrderMatcher_->cancelOrder(iter->second.ordReq_->symbolCode_,
+                                        ordReq->orderId_);
+        orderId2SimedOrder_.erase(iter);
+        isTheOrderOnMatcher = true;
+      }
+    }
+    if (isTheOrderOnMatcher) {
+      doSimOnCancelOrder(ordReq);
+    } else {
+      simOnCancelOrderFailed(ordReq);
+    }
+  });
+}
+
 }  // namespace bq::td::svc
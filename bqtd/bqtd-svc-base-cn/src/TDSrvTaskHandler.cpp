@@ -30,13 +30,19 @@
 #include "util/Datetime.hpp"
 #include "util/ExceedFlowCtrlHandler.hpp"
 #include "util/FlowCtrlSvc.hpp"
+#include "util/LatencyHist.hpp"
 #include "util/Logger.hpp"
 #include "util/TaskDispatcher.hpp"
 #include "util/TrdSymbolCache.hpp"
 
 namespace bq::td::svc {
 
-TDSrvTaskHandler::TDSrvTaskHandler(TDSvcOfCN* tdSvc) : tdSvc_(tdSvc) {}
+TDSrvTaskHandler::TDSrvTaskHandler(TDSvcOfCN* tdSvc)
+    : tdSvc_(tdSvc),
+      taskIdOfOnOrder_(
+          tdSvc_->getFlowCtrlSvc()->getTaskId(GetMsgName(MSG_ID_ON_ORDER))),
+      taskIdOfOnCancelOrder_(tdSvc_->getFlowCtrlSvc()->getTaskId(
+          GetMsgName(MSG_ID_ON_CANCEL_ORDER))) {}
 
 void TDSrvTaskHandler::handleAsyncTask(SHMIPCAsyncTaskSPtr& asyncTask) {
   const auto shmHeader = static_cast<const SHMHeader*>(asyncTask->task_->data_);
@@ -79,7 +85,7 @@ void TDSrvTaskHandler::handleMsgIdOnOrder(SHMIPCAsyncTaskSPtr& asyncTask) {
 #endif
 
   bool exceedFlowCtrl =
-      tdSvc_->getFlowCtrlSvc()->exceedFlowCtrl(GetMsgName(MSG_ID_ON_ORDER));
+      tdSvc_->getFlowCtrlSvc()->exceedFlowCtrl(taskIdOfOnOrder_);
   if (exceedFlowCtrl) {
     LOG_W("Order exceed flow ctrl. {}", ordReq->toShortStr());
 
@@ -90,8 +96,8 @@ void TDSrvTaskHandler::handleMsgIdOnOrder(SHMIPCAsyncTaskSPtr& asyncTask) {
         [&](void* shmBuf) { InitMsgBody(shmBuf, *ordReq); },
         MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, ordReq, SyncToRiskMgr::True,
-                               SyncToDB::True);
+    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *ordReq,
+                               SyncToRiskMgr::True, SyncToDB::True);
     return;
   }
 
@@ -116,12 +122,11 @@ void TDSrvTaskHandler::handleMsgIdOnOrder(SHMIPCAsyncTaskSPtr& asyncTask) {
       },
       MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET,
-                             std::make_shared<OrderInfo>(*ordReq),
-                             SyncToRiskMgr::True, SyncToDB::True);
+  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *ordReq, SyncToRiskMgr::True,
+                             SyncToDB::True);
 
+  LATENCY_PROBE("TDSvc.OrderSend", ordReq->orderTime_);
 #ifdef PERF_TEST
-  EXEC_PERF_TEST("Order", ordReq->orderTime_, 100, 10);
   return;
 #endif
 
@@ -137,8 +142,8 @@ void TDSrvTaskHandler::handleMsgIdOnCancelOrder(
   auto ordReq = MakeMsgSPtrByTask<OrderInfo>(asyncTask->task_);
   LOG_I("Recv cancel order {}", ordReq->toShortStr());
 
-  bool exceedFlowCtrl = tdSvc_->getFlowCtrlSvc()->exceedFlowCtrl(
-      GetMsgName(MSG_ID_ON_CANCEL_ORDER));
+  bool exceedFlowCtrl =
+      tdSvc_->getFlowCtrlSvc()->exceedFlowCtrl(taskIdOfOnCancelOrder_);
   if (exceedFlowCtrl) {
     LOG_W("Cancel order exceed flow ctrl. {}", ordReq->toShortStr());
     ordReq->statusCode_ = SCODE_TD_SVC_EXCEED_FLOW_CTRL;
@@ -148,7 +153,7 @@ void TDSrvTaskHandler::handleMsgIdOnCancelOrder(
         MSG_ID_ON_CANCEL_ORDER_RET, sizeof(OrderInfo));
 
     // not sync to db
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_CANCEL_ORDER_RET, ordReq,
+    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_CANCEL_ORDER_RET, *ordReq,
                                SyncToRiskMgr::True, SyncToDB::False);
     return;
   }
@@ -173,8 +178,8 @@ void TDSrvTaskHandler::handleMsgIdOnOrderInRealTDMode(OrderInfoSPtr& ordReq) {
         [&](void* shmBuf) { InitMsgBody(shmBuf, *ordReq); },
         MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, ordReq, SyncToRiskMgr::True,
-                               SyncToDB::True);
+    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *ordReq,
+                               SyncToRiskMgr::True, SyncToDB::True);
     return;
 
   } else {
@@ -196,7 +201,7 @@ void TDSrvTaskHandler::handleMsgIdOnCancelOrderInRealTDMode(
         MSG_ID_ON_CANCEL_ORDER_RET, sizeof(OrderInfo));
 
     // not sync to db
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_CANCEL_ORDER_RET, ordReq,
+    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_CANCEL_ORDER_RET, *ordReq,
                                SyncToRiskMgr::True, SyncToDB::False);
     return;
 
@@ -218,8 +223,8 @@ void TDSrvTaskHandler::handleMsgIdOnOrderInSimedTDMode(OrderInfoSPtr& ordReq) {
         [&](void* shmBuf) { InitMsgBody(shmBuf, *ordReq); },
         MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, ordReq, SyncToRiskMgr::True,
-                               SyncToDB::True);
+    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *ordReq,
+                               SyncToRiskMgr::True, SyncToDB::True);
     return;
   }
 
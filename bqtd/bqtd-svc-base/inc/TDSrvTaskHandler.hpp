@@ -63,6 +63,8 @@ class TDSrvTaskHandler {
 
  private:
   TDSvc* tdSvc_;
+  const std::uint32_t taskIdOfOnOrder_;
+  const std::uint32_t taskIdOfOnCancelOrder_;
 };
 
 }  // namespace bq::td::svc
@@ -19,8 +19,8 @@
 #include "util/SvcBase.hpp"
 
 namespace bq {
-class Scheduler;
-using SchedulerSPtr = std::shared_ptr<Scheduler>;
+class ScheduleTaskExecutor;
+using ScheduleTaskExecutorSPtr = std::shared_ptr<ScheduleTaskExecutor>;
 
 class SignalHandler;
 using SignalHandlerSPtr = std::shared_ptr<SignalHandler>;
@@ -35,10 +35,13 @@ using AssetsMgrSPtr = std::shared_ptr<AssetsMgr>;
 class OrdMgr;
 using OrdMgrSPtr = std::shared_ptr<OrdMgr>;
 
-struct SyncTask;
-using SyncTaskSPtr = std::shared_ptr<SyncTask>;
-using SyncTaskGroup = std::vector<SyncTaskSPtr>;
-using SyncTaskGroupSPtr = std::shared_ptr<SyncTaskGroup>;
+struct OrderInfo;
+
+struct UpdateInfoOfAssetGroup;
+using UpdateInfoOfAssetGroupSPtr = std::shared_ptr<UpdateInfoOfAssetGroup>;
+
+class SyncTaskBuffer;
+using SyncTaskBufferSPtr = std::shared_ptr<SyncTaskBuffer>;
 
 class FlowCtrlSvc;
 using FlowCtrlSvcSPtr = std::shared_ptr<FlowCtrlSvc>;
@@ -198,8 +201,11 @@ class TDSvc : public SvcBase {
     return exceedFlowCtrlHandler_;
   }
 
-  void cacheSyncTaskGroup(MsgId msgId, const std::any& task,
+  void cacheSyncTaskGroup(MsgId msgId, const OrderInfo& orderInfo,
                           SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB);
+  void cacheSyncTaskGroup(
+      MsgId msgId, const UpdateInfoOfAssetGroupSPtr& updateInfoOfAssetGroup,
+      SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB);
   void handleSyncTaskGroup();
 
   ScheduleTaskBundleSPtr& getScheduleTaskBundle() {
@@ -255,11 +261,10 @@ class TDSvc : public SvcBase {
   FlowCtrlSvcSPtr flowCtrlSvc_{nullptr};
   ExceedFlowCtrlHandlerSPtr exceedFlowCtrlHandler_{nullptr};
 
-  SyncTaskGroupSPtr syncTaskGroup_{nullptr};
-  std::ext::spin_mutex mtxSyncTaskGroup_;
+  SyncTaskBufferSPtr syncTaskBuffer_{nullptr};
 
   ScheduleTaskBundleSPtr scheduleTaskBundle_{nullptr};
-  SchedulerSPtr scheduleTaskBundleExecutor_{nullptr};
+  ScheduleTaskExecutorSPtr scheduleTaskBundleExecutor_{nullptr};
 };
 
 }  // namespace bq::td::svc
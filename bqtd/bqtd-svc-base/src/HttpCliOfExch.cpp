@@ -55,7 +55,7 @@ void HttpCliOfExch::handleRspOfOrder(OrderInfoSPtr ordReq, cpr::Response rsp) {
           [&](void* shmBuf) { InitMsgBody(shmBuf, *orderInfoInOrdMgr); },
           MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-      tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, orderInfoInOrdMgr,
+      tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *orderInfoInOrdMgr,
                                  SyncToRiskMgr::True, SyncToDB::True);
     }
 
@@ -84,7 +84,7 @@ void HttpCliOfExch::handleRspOfCancelOrder(OrderInfoSPtr ordReq,
         MSG_ID_ON_CANCEL_ORDER_RET, sizeof(OrderInfo));
 
     // not sync to db
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_CANCEL_ORDER_RET, ordReq,
+    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_CANCEL_ORDER_RET, *ordReq,
                                SyncToRiskMgr::True, SyncToDB::False);
     return;
   }
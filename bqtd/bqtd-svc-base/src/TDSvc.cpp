@@ -35,17 +35,17 @@
 #include "util/FlowCtrlSvc.hpp"
 #include "util/Literal.hpp"
 #include "util/ScheduleTaskBundle.hpp"
-#include "util/Scheduler.hpp"
+#include "util/ScheduleTaskExecutor.hpp"
 #include "util/SignalHandler.hpp"
 #include "util/String.hpp"
+#include "util/SyncTaskBuffer.hpp"
 #include "util/TaskDispatcher.hpp"
 #include "util/TrdSymbolCache.hpp"
 
 namespace bq::td::svc {
 
 int TDSvc::prepareInit() {
-  syncTaskGroup_ = std::make_shared<SyncTaskGroup>();
-  syncTaskGroup_->reserve(1024);
+  syncTaskBuffer_ = std::make_shared<SyncTaskBuffer>();
 
   auto retOfConfInit = Config::get_mutable_instance().init(configFilename_);
   if (retOfConfInit != 0) {
@@ -118,12 +118,13 @@ int TDSvc::doInit() {
   }
 #endif
 
+  // the task handler resolves its task ids of flow ctrl at construction
+  flowCtrlSvc_ = std::make_shared<FlowCtrlSvc>(CONFIG);
   tdSrvTaskHandler_ = std::make_shared<TDSrvTaskHandler>(this);
   initTDSrvTaskDispatcher();
   initSHMCliOfTDSrv();
   initSHMCliOfRiskMgr();
 
-  flowCtrlSvc_ = std::make_shared<FlowCtrlSvc>(CONFIG);
   exceedFlowCtrlHandler_ =
       std::make_shared<ExceedFlowCtrlHandler>([this](auto& asyncTask) {
         getTDSrvTaskDispatcher()->dispatch(asyncTask);
@@ -131,9 +132,8 @@ int TDSvc::doInit() {
 
   scheduleTaskBundle_ = std::make_shared<ScheduleTaskBundle>();
   initScheduleTaskBundle();
-  scheduleTaskBundleExecutor_ = std::make_shared<Scheduler>(
-      appName_, [this]() { ExecScheduleTaskBundle(getScheduleTaskBundle()); },
-      1 * 1000);
+  scheduleTaskBundleExecutor_ = std::make_shared<ScheduleTaskExecutor>(
+      appName_, getScheduleTaskBundle());
 
   return 0;
 }
@@ -340,15 +340,29 @@ void TDSvc::beforeInitScheduleTaskBundle() {
       },
       ExecAtStartup::True, secIntervalOfSyncAssetsSnapshot * 1000));
 
+  // each exec only syncs the unclosed orders which are due
   const auto secAgoTheOrderNeedToBeSynced =
       CONFIG["secAgoTheOrderNeedToBeSynced"].as<std::uint32_t>();
+  SyncParamOfUnclosedOrder syncParamOfUnclosedOrder;
+  syncParamOfUnclosedOrder.usThreshold_ =
+      static_cast<std::uint64_t>(secAgoTheOrderNeedToBeSynced) * 1000 * 1000;
+  syncParamOfUnclosedOrder.usMaxBackoff_ =
+      static_cast<std::uint64_t>(
+          CONFIG["secMaxBackoffOfSyncUnclosedOrderInfo"].as<std::uint32_t>(
+              600)) *
+      1000 * 1000;
+  syncParamOfUnclosedOrder.usMaxJitter_ =
+      syncParamOfUnclosedOrder.usThreshold_ / 10;
+  syncParamOfUnclosedOrder.maxNumOfOrderPerTick_ =
+      CONFIG["maxNumOfUnclosedOrderToSyncPerTick"].as<std::uint32_t>(100);
+  getOrdMgr()->enableSyncOfUnclosedOrder(syncParamOfUnclosedOrder);
+
   const auto secIntervalOfSyncUnclosedOrderInfo =
       CONFIG["secIntervalOfSyncUnclosedOrderInfo"].as<std::uint32_t>();
   getScheduleTaskBundle()->emplace_back(std::make_shared<ScheduleTask>(
       "syncUnclosedOrderInfo",
-      [this, secAgoTheOrderNeedToBeSynced]() {
-        const auto orderInfoGroup =
-            getOrdMgr()->getOrderInfoGroup(secAgoTheOrderNeedToBeSynced);
+      [this]() {
+        const auto orderInfoGroup = getOrdMgr()->getOrderInfoGroupToSync();
         for (const auto& orderInfo : orderInfoGroup) {
           auto asyncTask =
               MakeTDSrvSignal(MSG_ID_SYNC_UNCLOSED_ORDER_INFO, orderInfo);
@@ -386,15 +400,24 @@ void TDSvc::beforeInitScheduleTaskBundle() {
       },
       ExecAtStartup::False, MilliSecInterval(5000)));
 
-  const auto milliSecIntervalOfSyncTask =
-      CONFIG["milliSecIntervalOfSyncTask"].as<std::uint32_t>();
+  // the sync flush runs on its own thread, so it is not delayed by the other
+  // tasks and its interval can be less than 1 ms
+  // the old key in ms is only read when the one in us is not configured
+  const auto nodeOfMicroSecInterval = CONFIG["microSecIntervalOfSyncTask"];
+  const auto microSecIntervalOfSyncTask =
+      nodeOfMicroSecInterval
+          ? nodeOfMicroSecInterval.as<std::uint32_t>()
+          : CONFIG["milliSecIntervalOfSyncTask"].as<std::uint32_t>() * 1000;
   getScheduleTaskBundle()->emplace_back(std::make_shared<ScheduleTask>(
       "syncTask",
       [this]() {
         handleSyncTaskGroup();
         return true;
       },
-      ExecAtStartup::False, milliSecIntervalOfSyncTask));
+      ExecAtStartup::False,
+      std::chrono::microseconds(microSecIntervalOfSyncTask),
+      std::chrono::microseconds(microSecIntervalOfSyncTask),
+      ExecOnDedicatedThread::True));
 }
 
 int TDSvc::doRun() {
@@ -450,44 +473,41 @@ void TDSvc::sendTDGWReg() {
       MSG_ID_ON_TDGW_REG, sizeof(TDGWReg));
 }
 
-void TDSvc::cacheSyncTaskGroup(MsgId msgId, const std::any& task,
+void TDSvc::cacheSyncTaskGroup(MsgId msgId, const OrderInfo& orderInfo,
                                SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB) {
-  {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxSyncTaskGroup_);
-    syncTaskGroup_->emplace_back(
-        std::make_shared<SyncTask>(msgId, task, syncToRiskMgr, syncToDB));
-  }
+  syncTaskBuffer_->cache(msgId, orderInfo, syncToRiskMgr, syncToDB);
 }
 
-void TDSvc::handleSyncTaskGroup() {
-  auto syncTaskGroup = std::make_shared<SyncTaskGroup>();
-  {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxSyncTaskGroup_);
-    syncTaskGroup.swap(syncTaskGroup_);
-  }
+void TDSvc::cacheSyncTaskGroup(
+    MsgId msgId, const UpdateInfoOfAssetGroupSPtr& updateInfoOfAssetGroup,
+    SyncToRiskMgr syncToRiskMgr, SyncToDB syncToDB) {
+  syncTaskBuffer_->cache(msgId, updateInfoOfAssetGroup, syncToRiskMgr,
+                         syncToDB);
+}
 
-  if (syncTaskGroup->size() > 100) {
+void TDSvc::handleSyncTaskGroup() {
+  const auto& syncTaskGroup = syncTaskBuffer_->swap();
+  if (syncTaskGroup.size() > 100) {
     LOG_W("Too many unprocessed task of sync. [num = {}]",
-          syncTaskGroup->size());
+          syncTaskGroup.size());
   }
 
-  for (const auto& rec : *syncTaskGroup) {
+  for (const auto rec : syncTaskGroup) {
     if (rec->syncToRiskMgr_ == SyncToRiskMgr::False) continue;
     if (rec->msgId_ == MSG_ID_ON_ORDER || rec->msgId_ == MSG_ID_ON_ORDER_RET ||
         rec->msgId_ == MSG_ID_ON_CANCEL_ORDER ||
         rec->msgId_ == MSG_ID_ON_CANCEL_ORDER_RET) {
-      const auto orderInfo = std::any_cast<OrderInfoSPtr>(rec->task_);
+      const auto& orderInfo = rec->orderInfo_;
       shmCliOfRiskMgr_->asyncSendMsgWithZeroCopy(
           [&](void* shmBuf) {
-            InitMsgBody(shmBuf, *orderInfo);
+            InitMsgBody(shmBuf, orderInfo);
             LOG_I("Send order info to risk mgr. {}",
                   static_cast<OrderInfo*>(shmBuf)->toShortStr());
           },
           rec->msgId_, sizeof(OrderInfo));
 
     } else if (rec->msgId_ == MSG_ID_SYNC_ASSETS) {
-      const auto updateInfoOfAssetGroup =
-          std::any_cast<UpdateInfoOfAssetGroupSPtr>(rec->task_);
+      const auto& updateInfoOfAssetGroup = rec->updateInfoOfAssetGroup_;
       NotifyAssetInfo(shmCliOfRiskMgr_, getAcctId(), updateInfoOfAssetGroup);
 
     } else {
@@ -496,28 +516,31 @@ void TDSvc::handleSyncTaskGroup() {
     }
   }
 
-  for (const auto& rec : *syncTaskGroup) {
+  for (const auto rec : syncTaskGroup) {
     if (rec->syncToDB_ == SyncToDB::False) continue;
     if (rec->msgId_ == MSG_ID_ON_ORDER || rec->msgId_ == MSG_ID_ON_ORDER_RET ||
         rec->msgId_ == MSG_ID_ON_CANCEL_ORDER ||
         rec->msgId_ == MSG_ID_ON_CANCEL_ORDER_RET) {
-      const auto orderInfo = std::any_cast<OrderInfoSPtr>(rec->task_);
+      const auto& orderInfo = rec->orderInfo_;
       const auto identity = GET_RAND_STR();
-      const auto sql = orderInfo->getSqlOfUSPOrderInfoUpdate();
-      const auto [ret, execRet] = getDBEng()->asyncExec(identity, sql);
+      const auto sql = orderInfo.getSqlOfUSPOrderInfoUpdate();
+      const auto [ret, execRet] = getDBEng()->asyncExec(
+          identity, sql, WriteLog::True, std::to_string(orderInfo.orderId_),
+          db::Coalesce::False);
       if (ret != 0) {
         LOG_W("Sync order info to db failed. [{}]", sql);
       }
 
     } else if (rec->msgId_ == MSG_ID_SYNC_ASSETS) {
-      const auto updateInfoOfAssetGroup =
-          std::any_cast<UpdateInfoOfAssetGroupSPtr>(rec->task_);
+      const auto& updateInfoOfAssetGroup = rec->updateInfoOfAssetGroup_;
 
       for (const auto& assetInfo :
            *updateInfoOfAssetGroup->assetInfoGroupAdd_) {
         const auto identity = GET_RAND_STR();
         const auto sql = assetInfo->getSqlOfInsert();
-        const auto [ret, execRet] = dbEng_->asyncExec(identity, sql);
+        const auto [ret, execRet] = dbEng_->asyncExec(
+            identity, sql, WriteLog::True, assetInfo->getKey(),
+            db::Coalesce::False);
         if (ret != 0) {
           LOG_W("Insert asset info to db failed. [{}]", sql);
         }
@@ -527,7 +550,9 @@ void TDSvc::handleSyncTaskGroup() {
            *updateInfoOfAssetGroup->assetInfoGroupDel_) {
         const auto identity = GET_RAND_STR();
         const auto sql = assetInfo->getSqlOfDelete();
-        const auto [ret, execRet] = dbEng_->asyncExec(identity, sql);
+        const auto [ret, execRet] = dbEng_->asyncExec(
+            identity, sql, WriteLog::True, assetInfo->getKey(),
+            db::Coalesce::False);
         if (ret != 0) {
           LOG_W("Del asset info from db failed. [{}]", sql);
         }
@@ -537,7 +562,9 @@ void TDSvc::handleSyncTaskGroup() {
            *updateInfoOfAssetGroup->assetInfoGroupChg_) {
         const auto identity = GET_RAND_STR();
         const auto sql = assetInfo->getSqlOfUpdate();
-        const auto [ret, execRet] = dbEng_->asyncExec(identity, sql);
+        const auto [ret, execRet] = dbEng_->asyncExec(
+            identity, sql, WriteLog::True, assetInfo->getKey(),
+            db::Coalesce::True);
         if (ret != 0) {
           LOG_W("Update asset info from db failed. [{}]", sql);
         }
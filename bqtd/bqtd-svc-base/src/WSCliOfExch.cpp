@@ -172,7 +172,7 @@ void WSCliOfExch::handleOrder(WSCliAsyncTaskSPtr& asyncTask) {
       },
       MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, orderInfoInOrdMgr,
+  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *orderInfoInOrdMgr,
                              SyncToRiskMgr::True, SyncToDB::True);
 }
 
@@ -195,7 +195,7 @@ void WSCliOfExch::handleSyncUnclosedOrder(WSCliAsyncTaskSPtr& asyncTask) {
       },
       MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, orderInfoInOrdMgr,
+  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *orderInfoInOrdMgr,
                              SyncToRiskMgr::True, SyncToDB::True);
 }
 
@@ -179,7 +179,7 @@ void BQTraderSpi::OnOrderEvent(XTPOrderInfo* orderInfo, XTPRI* errorInfo,
       },
       MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, orderInfoUpdated,
+  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *orderInfoUpdated,
                              SyncToRiskMgr::True, SyncToDB::True);
 }
 
@@ -223,7 +223,7 @@ void BQTraderSpi::OnTradeEvent(XTPTradeReport* tradeInfo, uint64_t sessionId) {
       },
       MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, orderInfoUpdated,
+  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *orderInfoUpdated,
                              SyncToRiskMgr::True, SyncToDB::True);
 }
 
@@ -276,7 +276,7 @@ void BQTraderSpi::OnQueryOrderEx(XTPOrderInfoEx* orderInfo, XTPRI* errorInfo,
       },
       MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, orderInfoUpdated,
+  tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *orderInfoUpdated,
                              SyncToRiskMgr::True, SyncToDB::True);
 }
 
@@ -312,7 +312,7 @@ void BQTraderSpi::OnCancelOrderError(XTPOrderCancelInfo* cancelInfo,
         MSG_ID_ON_CANCEL_ORDER_RET, sizeof(OrderInfo));
 
     // not sync to db
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_CANCEL_ORDER_RET, orderInfo,
+    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_CANCEL_ORDER_RET, *orderInfo,
                                SyncToRiskMgr::True, SyncToDB::False);
     LOG_W("Cancel order failed. [{} - {}] {}", errorInfo->error_id,
           errorInfo->error_msg, orderInfo->toShortStr());
@@ -154,7 +154,7 @@ void TDGatewayOfXTP::doSyncUnclosedOrderInfo(SHMIPCAsyncTaskSPtr& asyncTask) {
         },
         MSG_ID_ON_ORDER_RET, sizeof(OrderInfo));
 
-    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, orderInfoUpdated,
+    tdSvc_->cacheSyncTaskGroup(MSG_ID_ON_ORDER_RET, *orderInfoUpdated,
                                SyncToRiskMgr::True, SyncToDB::True);
   }
 
@@ -39,6 +39,13 @@ class QueryHisMD : public drogon::HttpController<QueryHisMD> {
 
   METHOD_LIST_END
 
+  /*
+   * Responds with the rec set in json with a limit of maxNumOfRecReturned, or
+   * with the columnar rec set without a limit if the req accepts
+   * application/x-bq-columnar, which is encoded in memory at once and sent
+   * after the conn of tdeng is given back. The param columns of the req, such
+   * as columns=exchTs,price,size, selects the columns of the columnar rec set.
+   */
   void queryBetween2Ts(const HttpRequestPtr &req,
                        std::function<void(const HttpResponsePtr &)> &&callback,
                        std::string &&marketCode, std::string &&symbolType,
@@ -63,6 +70,11 @@ class QueryHisMD : public drogon::HttpController<QueryHisMD> {
                        std::string recSet) const;
 
   HttpResponsePtr makeHttpResponse(const std::string &body) const;
+
+  bool acceptColumnarRecSet(const HttpRequestPtr &req) const;
+
+  HttpResponsePtr makeHttpResponseOfColumnarRecSet(
+      const std::string &sql, const std::string &columns) const;
 };
 
 }  // namespace v1
@@ -23,6 +23,7 @@
 #include "tdeng/TDEngUtil.hpp"
 #include "util/BQMDHis.hpp"
 #include "util/BQUtil.hpp"
+#include "util/ColumnarRecSet.hpp"
 #include "util/Datetime.hpp"
 #include "util/Logger.hpp"
 
@@ -95,6 +96,12 @@ void QueryHisMD::queryBetween2Ts(
   const auto sql =
       fmt::format("SELECT * FROM {}.{} where exchTs >= {} AND exchTs < {};",
                   stableName, tableName, tsBegin, tsEnd);
+  if (acceptColumnarRecSet(req)) {
+    callback(
+        makeHttpResponseOfColumnarRecSet(sql, req->getParameter("columns")));
+    return;
+  }
+
   const auto maxNumOfRecReturned =
       CONFIG["maxNumOfRecReturned"].as<std::uint32_t>(10000);
   const auto [statusCode, statusMsg, recNum, recSet] =
@@ -290,3 +297,39 @@ HttpResponsePtr QueryHisMD::makeHttpResponse(const std::string &body) const {
   resp->setBody(body);
   return resp;
 }
+
+bool QueryHisMD::acceptColumnarRecSet(const HttpRequestPtr &req) const {
+  return boost::contains(req->getHeader("accept"),
+                         CONTENT_TYPE_OF_COLUMNAR_REC_SET);
+}
+
+HttpResponsePtr QueryHisMD::makeHttpResponseOfColumnarRecSet(
+    const std::string &sql, const std::string &columns) const {
+  std::vector<std::string> columnNameGroup;
+  if (!columns.empty()) {
+    boost::split(columnNameGroup, columns, boost::is_any_of(","));
+  }
+
+  const auto recSetSource = std::make_shared<tdeng::RecSetSourceOfTDEng>(
+      WebSrv::get_const_instance().getTDEngConnpool(), sql);
+  if (const auto [statusCode, statusMsg] = recSetSource->init();
+      statusCode != 0) {
+    return makeHttpResponse(makeBody(statusCode, statusMsg, ""));
+  }
+
+  const auto recSetStream =
+      std::make_shared<ColumnarRecSetStream>(recSetSource, columnNameGroup);
+  if (const auto statusCode = recSetStream->init(); statusCode != 0) {
+    return makeHttpResponse(makeBody(statusCode, GetStatusMsg(statusCode), ""));
+  }
+
+  // the whole rec set is encoded before the rsp is sent, so the conn of tdeng
+  // is given back before it and a slow client holds neither the conn nor the
+  // io loop while the rsp is written
+  auto resp = HttpResponse::newHttpResponse();
+  resp->setStatusCode(k200OK);
+  resp->setContentTypeCodeAndCustomString(CT_CUSTOM,
+                                          CONTENT_TYPE_OF_COLUMNAR_REC_SET);
+  resp->setBody(recSetStream->readAll());
+  return resp;
+}
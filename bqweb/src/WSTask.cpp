@@ -18,7 +18,7 @@ namespace bq::web {
 TaskFromSrv::TaskFromSrv(bq::web::WSCli* wsCli,
                          const bq::web::ConnMetadataSPtr& connMetadata,
                          const bq::web::MsgSPtr& msg)
-    : localTs_(GetTotalUSSince1970()),
+    : localTs_(GetTotalUSSince1970OfHotPath()),
       wsCli_(wsCli),
       connMetadata_(connMetadata),
       msg_(msg) {}
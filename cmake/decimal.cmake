@@ -0,0 +1,11 @@
+# Selects the Decimal type of all the projects, see bqpub/inc/def/BQDefIF.hpp.
+option(BQ_FIXED_DECIMAL "Use int64 fixed point Decimal." OFF)
+option(BQ_FIXED_DECIMAL_128 "Use int128 fixed point Decimal." OFF)
+if (NOT BQ_DECIMAL_DEFINITIONS_ADDED)
+    set(BQ_DECIMAL_DEFINITIONS_ADDED ON)
+    if (BQ_FIXED_DECIMAL_128)
+        add_definitions(-DBQ_FIXED_DECIMAL_128)
+    elseif (BQ_FIXED_DECIMAL)
+        add_definitions(-DBQ_FIXED_DECIMAL)
+    endif()
+endif()
@@ -9,6 +9,17 @@
  */
 
 #include <benchmark/benchmark.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include "def/Const.hpp"
+#include "util/BinLogger.hpp"
+#include "util/Datetime.hpp"
+#include "util/FlowCtrlSvc.hpp"
+#include "util/IdleObjPool.hpp"
+#include "util/StdExt.hpp"
+#include "util/TaskDispatcher.hpp"
+
+using namespace bq;
 
 class FixtureTest : public benchmark::Fixture {
  public:
@@ -27,4 +38,335 @@ BENCHMARK_REGISTER_F(FixtureTest, test)
     ->Unit(benchmark::kMicrosecond)
     ->Arg(1000);
 
+/*
+ * The path before the arithmetic converter, data_time of xtp is formatted,
+ * split and parsed as iso datetime.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, convertDatetimeToTsByStr)
+(benchmark::State& st) {
+  std::int64_t datetime = 20230120093000000;
+  for (auto _ : st) {
+    const auto dt = fmt::format("{}", datetime);
+    const auto isoDatetime =
+        fmt::format("{}T{}", dt.substr(0, 8), dt.substr(8, dt.size() - 8));
+    benchmark::DoNotOptimize(ConvertISODatetimeToTs(isoDatetime));
+    ++datetime;
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, convertDatetimeToTsByStr);
+
+BENCHMARK_DEFINE_F(FixtureTest, convertDatetimeToTs)(benchmark::State& st) {
+  std::int64_t datetime = 20230120093000000;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(ConvertDatetimeToTs(datetime));
+    ++datetime;
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, convertDatetimeToTs);
+
+BENCHMARK_DEFINE_F(FixtureTest, getTotalUSSince1970ByBoost)
+(benchmark::State& st) {
+  const boost::posix_time::ptime epoch(
+      boost::gregorian::date(1970, boost::gregorian::Jan, 1));
+  for (auto _ : st) {
+    const auto now = boost::posix_time::microsec_clock::universal_time();
+    benchmark::DoNotOptimize((now - epoch).total_microseconds());
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, getTotalUSSince1970ByBoost);
+
+BENCHMARK_DEFINE_F(FixtureTest, getTotalUSSince1970)(benchmark::State& st) {
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(GetTotalUSSince1970());
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, getTotalUSSince1970);
+
+BENCHMARK_DEFINE_F(FixtureTest, getTotalNSSince1970ByTSC)
+(benchmark::State& st) {
+  GetTotalNSSince1970ByTSC();
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(GetTotalNSSince1970ByTSC());
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, getTotalNSSince1970ByTSC);
+
+namespace {
+
+constexpr int NUM_OF_MOCK_CONN = 4;
+
+struct MockConn {
+  explicit MockConn(int no) : no_(no) {}
+  int no_{0};
+  bool idle_{true};
+};
+using MockConnSPtr = std::shared_ptr<MockConn>;
+
+// the connpool before IdleObjPool, scans for an idle conn and sleeps 1ms
+class MockConnpoolByScan {
+ public:
+  MockConnpoolByScan() {
+    for (int no = 0; no < NUM_OF_MOCK_CONN; ++no) {
+      connGroup_.emplace_back(std::make_shared<MockConn>(no));
+    }
+  }
+  MockConnSPtr getIdleConn() {
+    while (true) {
+      {
+        std::lock_guard<std::ext::spin_mutex> lock(mtxConnGroup_);
+        for (const auto& conn : connGroup_) {
+          if (conn->idle_) {
+            conn->idle_ = false;
+            return conn;
+          }
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  void giveBackConn(const MockConnSPtr& conn) {
+    std::lock_guard<std::ext::spin_mutex> lock(mtxConnGroup_);
+    for (const auto& curConn : connGroup_) {
+      if (curConn->no_ == conn->no_) {
+        curConn->idle_ = true;
+      }
+    }
+  }
+
+ private:
+  std::vector<MockConnSPtr> connGroup_;
+  std::ext::spin_mutex mtxConnGroup_;
+};
+
+class MockConnpool {
+ public:
+  MockConnpool() {
+    for (int no = 0; no < NUM_OF_MOCK_CONN; ++no) {
+      idleConnPool_.giveBack(std::make_shared<MockConn>(no));
+    }
+  }
+  MockConnSPtr getIdleConn() { return idleConnPool_.take(); }
+  void giveBackConn(const MockConnSPtr& conn) { idleConnPool_.giveBack(conn); }
+
+ private:
+  IdleObjPool<MockConn> idleConnPool_;
+};
+
+// the time of a sql executed on the conn
+void UseMockConn(const MockConnSPtr& conn) {
+  const auto startTime = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - startTime <
+         std::chrono::microseconds(20)) {
+    benchmark::DoNotOptimize(conn->no_);
+  }
+}
+
+MockConnpoolByScan mockConnpoolByScan;
+MockConnpool mockConnpool;
+
+}  // namespace
+
+/*
+ * Threads more than NUM_OF_MOCK_CONN contend for the conns, each holds a conn
+ * for 20us as if a sql were executed on it.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, getIdleConnByScan)(benchmark::State& st) {
+  for (auto _ : st) {
+    const auto conn = mockConnpoolByScan.getIdleConn();
+    UseMockConn(conn);
+    mockConnpoolByScan.giveBackConn(conn);
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, getIdleConnByScan)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime()
+    ->ThreadRange(1, 16);
+
+BENCHMARK_DEFINE_F(FixtureTest, getIdleConn)(benchmark::State& st) {
+  for (auto _ : st) {
+    const auto conn = mockConnpool.getIdleConn();
+    UseMockConn(conn);
+    mockConnpool.giveBackConn(conn);
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, getIdleConn)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime()
+    ->ThreadRange(1, 16);
+
+/*
+ * Tasks of a bulk are dispatched by their hash to the task specific threads,
+ * an iteration ends when all of them are handled.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, dispatchTask)(benchmark::State& st) {
+  constexpr std::uint64_t NUM_OF_TASK_IN_BULK = 1000;
+  const auto taskDispatcherParam = std::make_shared<TaskDispatcherParam>(
+      "bench", 1, st.range(0), UINT32_MAX, 1, 100, true);
+
+  std::atomic<std::uint64_t> numOfTaskHandled{0};
+  TaskDispatcher<std::uint64_t> taskDispatcher(
+      taskDispatcherParam,
+      [](const auto& task) {
+        return std::make_tuple(
+            0, std::make_shared<AsyncTask<std::uint64_t>>(task));
+      },
+      [](auto& asyncTask, auto taskSpecificThreadPoolSize) {
+        return asyncTask->task_ % taskSpecificThreadPoolSize;
+      },
+      [&](auto& asyncTask) { ++numOfTaskHandled; });
+  taskDispatcher.init();
+  taskDispatcher.start();
+
+  std::uint64_t numOfTaskDispatched = 0;
+  for (auto _ : st) {
+    for (std::uint64_t no = 0; no < NUM_OF_TASK_IN_BULK; ++no) {
+      auto task = numOfTaskDispatched++;
+      taskDispatcher.dispatch(task);
+    }
+    while (numOfTaskHandled != numOfTaskDispatched) {
+      std::this_thread::yield();
+    }
+  }
+
+  taskDispatcher.stop();
+  st.SetItemsProcessed(st.iterations() * NUM_OF_TASK_IN_BULK);
+}
+BENCHMARK_REGISTER_F(FixtureTest, dispatchTask)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime()
+    ->Arg(1)
+    ->Arg(4);
+
+/*
+ * Rule checks of the order reqs of range(0) accts, each acct has a group of
+ * its own as configured in the flow ctrl plugin of tdsrv.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, exceedFlowCtrl)(benchmark::State& st) {
+  YAML::Node node;
+  std::vector<std::string> taskNameGroup;
+  for (std::int64_t acctId = 0; acctId < st.range(0); ++acctId) {
+    taskNameGroup.emplace_back(fmt::format("{}-onOrder", acctId));
+    YAML::Node taskInfo;
+    taskInfo["name"] = taskNameGroup.back();
+    taskInfo["weight"] = 1;
+    YAML::Node flowCtrlRule;
+    flowCtrlRule["taskGroup"].push_back(taskInfo);
+    flowCtrlRule["timeDur"] = 1000;
+    flowCtrlRule["limitNum"] = 100000;
+    node["flowCtrlRule"].push_back(flowCtrlRule);
+  }
+  FlowCtrlSvc flowCtrlSvc(node);
+
+  std::size_t no = 0;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(
+        flowCtrlSvc.exceedFlowCtrl(taskNameGroup[no], WriteLog::False));
+    no = (no + 1) % taskNameGroup.size();
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, exceedFlowCtrl)->Arg(10)->Arg(1000);
+
+/*
+ * Same rule checks as exceedFlowCtrl, by the task ids resolved once instead of
+ * a lookup of the task name per check.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, exceedFlowCtrlByTaskId)
+(benchmark::State& st) {
+  YAML::Node node;
+  std::vector<std::string> taskNameGroup;
+  for (std::int64_t acctId = 0; acctId < st.range(0); ++acctId) {
+    taskNameGroup.emplace_back(fmt::format("{}-onOrder", acctId));
+    YAML::Node taskInfo;
+    taskInfo["name"] = taskNameGroup.back();
+    taskInfo["weight"] = 1;
+    YAML::Node flowCtrlRule;
+    flowCtrlRule["taskGroup"].push_back(taskInfo);
+    flowCtrlRule["timeDur"] = 1000;
+    flowCtrlRule["limitNum"] = 100000;
+    node["flowCtrlRule"].push_back(flowCtrlRule);
+  }
+  FlowCtrlSvc flowCtrlSvc(node);
+  std::vector<std::uint32_t> taskIdGroup;
+  for (const auto& taskName : taskNameGroup) {
+    taskIdGroup.emplace_back(flowCtrlSvc.getTaskId(taskName));
+  }
+
+  std::size_t no = 0;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(
+        flowCtrlSvc.exceedFlowCtrl(taskIdGroup[no], WriteLog::False));
+    no = (no + 1) % taskIdGroup.size();
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, exceedFlowCtrlByTaskId)
+    ->Arg(10)
+    ->Arg(1000);
+
+namespace {
+
+enum class SideOfBench { Bid = 1, Ask = 2 };
+
+// the args of the log statements of an order
+struct OrderOfBench {
+  std::uint64_t orderId_{10001};
+  char symbolCode_[32] = "BTC-USDT";
+  SideOfBench side_{SideOfBench::Bid};
+  double orderPrice_{16541.77};
+  double orderSize_{0.0021};
+};
+
+// logs to a null sink through the thread pool of spdlog, as the loggers do
+void InitLoggerOfBench() {
+  static std::once_flag onceFlag;
+  std::call_once(onceFlag, []() {
+    spdlog::init_thread_pool(8192, 1);
+    auto logger = std::make_shared<spdlog::async_logger>(
+        "bench", std::make_shared<spdlog::sinks::null_sink_mt>(),
+        spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+    spdlog::set_default_logger(logger);
+    VerOfLoggers().fetch_add(1);
+  });
+}
+
+}  // namespace
+
+/*
+ * Cost of a log statement of an order on the hot thread, the args are
+ * formatted before the msg is queued to the thread pool of spdlog.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, logOrder)(benchmark::State& st) {
+  InitLoggerOfBench();
+  const OrderOfBench order;
+  for (auto _ : st) {
+    LOG_I("Recv order. [orderId = {}, symbolCode = {}, side = {}, "
+          "orderPrice = {}, orderSize = {}]",
+          order.orderId_, order.symbolCode_,
+          magic_enum::enum_name(order.side_), order.orderPrice_,
+          order.orderSize_);
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, logOrder);
+
+/*
+ * Cost of the same log statement on the hot thread by bin log, the rings are
+ * flushed out of the timing so that no log is dropped.
+ */
+BENCHMARK_DEFINE_F(FixtureTest, binLogOrder)(benchmark::State& st) {
+  InitLoggerOfBench();
+  const OrderOfBench order;
+  std::size_t no = 0;
+  for (auto _ : st) {
+    BLOG_I("Recv order. [orderId = {}, symbolCode = {}, side = {}, "
+           "orderPrice = {}, orderSize = {}]",
+           order.orderId_, order.symbolCode_, order.side_, order.orderPrice_,
+           order.orderSize_);
+    if (++no % 10000 == 0) {
+      st.PauseTiming();
+      BinLogger::get_mutable_instance().flush();
+      st.ResumeTiming();
+    }
+  }
+}
+BENCHMARK_REGISTER_F(FixtureTest, binLogOrder);
+
 BENCHMARK_MAIN();
@@ -1,2 +1,9 @@
 set(SOLUTION_ROOT_DIR ".." CACHE STRING "Root dir of solution.")
 set(3RDPARTY_PATH ${SOLUTION_ROOT_DIR}/3rdparty)
+
+include(${SOLUTION_ROOT_DIR}/cmake/decimal.cmake)
+
+option(BQ_TSC_CLOCK "Stamp local ts on the hot path with calibrated tsc." OFF)
+if (BQ_TSC_CLOCK)
+    add_definitions(-DBQ_TSC_CLOCK)
+endif()
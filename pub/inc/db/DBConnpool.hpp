@@ -11,6 +11,7 @@
 #pragma once
 
 #include "db/DBEngDef.hpp"
+#include "util/IdleObjPool.hpp"
 #include "util/Pch.hpp"
 #include "util/StdExt.hpp"
 
@@ -22,11 +23,10 @@ struct Conn {
   Conn(const Conn&&) = delete;
   Conn& operator=(const Conn&&) = delete;
 
-  Conn(int no, bool idle, const std::shared_ptr<sql::Connection>& sqlConn)
-      : no_(no), idle_(idle), sqlConn_(sqlConn) {}
+  Conn(int no, const std::shared_ptr<sql::Connection>& sqlConn)
+      : no_(no), sqlConn_(sqlConn) {}
 
   int no_{0};
-  bool idle_{true};
   std::shared_ptr<sql::Connection> sqlConn_{nullptr};
 };
 
@@ -51,9 +51,12 @@ class DBConnpool {
   ConnSPtr getIdleConn() const;
   void giveBackConn(const ConnSPtr& conn);
 
+  std::string getWaitHistStr() const;
+
  private:
   std::vector<ConnSPtr> connGroup_;
   mutable std::ext::spin_mutex mtxConnGroup_;
+  mutable IdleObjPool<Conn> idleConnPool_;
 
   const DBEngParamSPtr dbEngParam_{nullptr};
   const ConnType connType_;
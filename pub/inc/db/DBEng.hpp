@@ -39,9 +39,13 @@ class DBEng {
                                         const std::string& sql,
                                         WriteLog writeLog = WriteLog::True);
 
+  // tasks with the same key of partition reach the db in the order in which
+  // they are passed by one thread, see DBEngAsync
   std::tuple<int, std::string> asyncExec(const std::string& identity,
                                          const std::string& sql,
-                                         WriteLog writeLog = WriteLog::True);
+                                         WriteLog writeLog = WriteLog::True,
+                                         const std::string& keyOfPartition = "",
+                                         Coalesce coalesce = Coalesce::False);
 
  private:
   DBEngParamSPtr dbEngParam_{nullptr};
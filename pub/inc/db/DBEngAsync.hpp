@@ -19,6 +19,14 @@ enum class WriteLog;
 
 namespace bq::db {
 
+/*
+ * Write behind of the async tasks. A task with a key of partition is always
+ * handled by the same thread, so tasks of the same key enqueued by one thread
+ * reach the db in order, and tasks without the key are spread round robin.
+ * Each thread dequeues at most maxNumOfTaskInBatch tasks at a time, drops the
+ * tasks of coalesce superseded in them and execs the rest as a batch, the cb on
+ * exec ret is only called for the tasks executed.
+ */
 class DBEngAsync : public DBEngImpl {
  public:
   DBEngAsync(const DBEngAsync&) = delete;
@@ -34,31 +42,45 @@ class DBEngAsync : public DBEngImpl {
                                                   const std::string& sql,
                                                   WriteLog writeLog) final;
 
+ public:
   std::tuple<int, std::string> asyncExecSql(const std::string& identity,
                                             const std::string& sql,
-                                            WriteLog writeLog);
+                                            WriteLog writeLog,
+                                            const std::string& keyOfPartition,
+                                            Coalesce coalesce);
 
  public:
   void start();
 
  private:
-  void doStart();
+  using TaskQueue = moodycamel::BlockingConcurrentQueue<DBTaskSPtr>;
+  using TaskQueueSPtr = std::shared_ptr<TaskQueue>;
+
+  void doStart(TaskQueue& taskQueue);
 
-  void checkUnprocessedTaskAndAlert(
-      const moodycamel::BlockingConcurrentQueue<DBTaskSPtr>& taskQueue);
+  void checkUnprocessedTaskAndAlert(const TaskQueue& taskQueue);
 
-  void handleTask(DBTaskSPtr& dbTask);
+  void handleTaskGroup(DBTaskGroup& dbTaskGroup);
+
+  virtual std::vector<std::tuple<int, std::string>> execTaskGroup(
+      const DBTaskGroup& dbTaskGroup);
 
  public:
   void stop();
 
  private:
-  bool stopped_{false};
+  std::atomic_bool stopped_{false};
 
-  moodycamel::BlockingConcurrentQueue<DBTaskSPtr> taskQueue_;
+  std::vector<TaskQueueSPtr> taskQueueGroup_;
+  std::atomic<std::uint64_t> noOfTaskWithoutPartition_{0};
   std::vector<std::thread> threadPool_;
 
   CBOnExecRet cbOnExecRet_{nullptr};
 };
 
+// drops the tasks of coalesce superseded by a later one of the same key of
+// partition, the tasks without coalesce of the key are not passed over, the cb
+// on exec ret is not called for the dropped tasks
+void CoalesceTaskGroup(DBTaskGroup& dbTaskGroup);
+
 }  // namespace bq::db
@@ -17,6 +17,12 @@ namespace bq::db {
 
 enum class ConnType { Sync = 1, Async = 2 };
 
+// an async task of coalesce is superseded by the next one of the same key of
+// partition, only for idempotent statements which write the whole rec, such as
+// the update of an asset, not for the usp of order info which inserts the
+// trade info of each fill
+enum class Coalesce { True = 1, False = 2 };
+
 class DBConnpool;
 using DBConnpoolSPtr = std::shared_ptr<DBConnpool>;
 
@@ -43,6 +49,7 @@ using DBEngSPtr = std::shared_ptr<DBEng>;
 
 struct DBTask;
 using DBTaskSPtr = std::shared_ptr<DBTask>;
+using DBTaskGroup = std::vector<DBTaskSPtr>;
 using CBOnExecRet =
     std::function<void(bq::db::DBTaskSPtr& dbTask, const StringSPtr& execRet)>;
 
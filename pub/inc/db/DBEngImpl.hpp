@@ -37,6 +37,8 @@ class DBEngImpl {
                                        const std::string& sql,
                                        WriteLog writeLog);
 
+  std::string getWaitHistStrOfConnpool() const;
+
  private:
   virtual std::tuple<int, std::string> asyncOrSyncExecSql(
       const std::string& identity, const std::string& sql,
@@ -47,7 +49,16 @@ class DBEngImpl {
                                        const std::string& sql,
                                        WriteLog writeLog);
 
+  // execs the sqls of the group in order, the runs of plain sqls between the
+  // calls of usps on one conn in one transaction each, if a run failed its
+  // sqls are execed one by one, so a bad sql does not fail others
+  std::vector<std::tuple<int, std::string>> execSqlGroup(
+      const DBTaskGroup& dbTaskGroup);
+
  private:
+  void execSqlGroupInTrans(const DBTaskGroup& dbTaskGroup,
+                           std::vector<std::tuple<int, std::string>>& ret);
+
   std::string execSqlImpl(const ConnSPtr& conn, const std::string& sql);
 
   std::string handleRecordSet(const std::shared_ptr<sql::ResultSet>& res,
@@ -26,7 +26,8 @@ struct DBEngParam {
              const std::string& dbname, int connPoolSizeOfSyncReq,
              int connPoolSizeOfAsyncReq,
              std::uint32_t numOfUnprocessedTaskAlert,
-             std::uint32_t timeDurOfWaitForTask);
+             std::uint32_t timeDurOfWaitForTask,
+             std::uint32_t maxNumOfTaskInBatch);
   std::string svcName_;
   std::string host_;
   int port_;
@@ -37,6 +38,7 @@ struct DBEngParam {
   int connPoolSizeOfAsyncReq_{1};
   std::uint32_t numOfUnprocessedTaskAlert_{100};
   std::uint32_t timeDurOfWaitForTask_{500};
+  std::uint32_t maxNumOfTaskInBatch_{64};
 };
 
 std::tuple<int, DBEngParamSPtr> MakeDBEngParam(
@@ -18,8 +18,14 @@ namespace bq::db {
 
 struct DBTask {
  public:
-  DBTask(const std::string& identity, const std::string& sql, WriteLog writeLog)
-      : identity_(identity), sql_(sql), writeLog_(writeLog) {}
+  DBTask(const std::string& identity, const std::string& sql, WriteLog writeLog,
+         const std::string& keyOfPartition = "",
+         Coalesce coalesce = Coalesce::False)
+      : identity_(identity),
+        sql_(sql),
+        writeLog_(writeLog),
+        keyOfPartition_(keyOfPartition),
+        coalesce_(coalesce) {}
 
   std::string toStr() {
     const auto ret = fmt::format("identity={}; sql={}", identity_, sql_);
@@ -29,6 +35,8 @@ struct DBTask {
   const std::string identity_;
   const std::string sql_;
   const WriteLog writeLog_;
+  const std::string keyOfPartition_;
+  const Coalesce coalesce_;
 };
 
 struct DBExecRet {
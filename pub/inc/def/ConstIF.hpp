@@ -21,5 +21,6 @@ enum class SyncToDB { True = 1, False = 2 };
 enum class LockFunc { True = 1, False = 2 };
 enum class DeepClone { True = 1, False = 2 };
 enum class ExecAtStartup { True = 1, False = 2 };
+enum class ExecOnDedicatedThread { True = 1, False = 2 };
 
 }  // namespace bq
@@ -37,6 +37,7 @@ const static int SCODE_HIS_MD_INVALID_TS = -4501;
 const static int SCODE_HIS_MD_INVALID_NUM = -4502;
 const static int SCODE_HIS_MD_RECORDS_LESS_THAN_NUM_OF_QURIES = -4503;
 const static int SCODE_HIS_MD_NUM_OF_RECORDS_GREATER_THAN_LIMIT = -4504;
+const static int SCODE_HIS_MD_INVALID_COLUMN = -4505;
 const static int SCODE_HIS_MD_MAKE_INDEX_GROUP_FAILED = -4511;
 const static int SCODE_HIS_MD_GET_EXCH_TS_FAILED = -4512;
 const static int SCODE_HIS_MD_SAVE_INDEX_GROUP_FAILED = -4513;
@@ -48,6 +49,12 @@ const static int SCODE_DB_CAN_NOT_FIND_STG_INST = -5003;
 const static int SCODE_DB_CAN_NOT_FIND_ACCT_INFO = -5004;
 
 const static int SCODE_TDENG_EXEC_SQL_FAILED = -5501;
+const static int SCODE_TDENG_FETCH_REC_FAILED = -5502;
+
+const static int SCODE_SNAPSHOT_NOT_EXISTS = -5601;
+const static int SCODE_SNAPSHOT_INVALID_FILE = -5602;
+const static int SCODE_SNAPSHOT_SAVE_FAILED = -5603;
+const static int SCODE_SNAPSHOT_SAVE_JOURNAL_FAILED = -5604;
 
 const static int SCODE_STG_MUST_HAVE_STG_INST_1 = -6002;
 const static int SCODE_STG_INST_ID_MUST_START_FROM_1 = -6003;
@@ -57,6 +64,7 @@ const static int SCODE_STG_INVALID_SYMBOL_TYPE_IN_DB = -6013;
 const static int SCODE_STG_ENG_INVALID_CONFIG_FILENAME = -6041;
 const static int SCODE_STG_INST_TASK_HANDLER_NOT_INSTALL = -6051;
 const static int SCODE_STG_SEND_HTTP_REQ_TO_QUERY_HIS_MD_FAILED = -6061;
+const static int SCODE_STG_INIT_MARKET_DATA_VIEW_FAILED = -6071;
 
 const static int SCODE_ORD_MGR_ADD_ORDER_INFO_FAILED = -7001;
 const static int SCODE_ORD_MGR_REMOVE_ORDER_INFO_FAILED = -7002;
@@ -74,6 +82,7 @@ const static int SCODE_MD_SVC_SNAPSHOT_NOT_EXISTS = -23001;
 const static int SCODE_MD_SVC_FINAL_UPDATE_ID_TOO_SMALL = -23002;
 const static int SCODE_MD_SVC_FIRST_UPDATE_ID_TOO_LARGE = -23003;
 const static int SCODE_MD_SVC_UPDATE_DATA_DISCONTINUOUS = -23004;
+const static int SCODE_MD_SVC_DECODE_WS_FRAME_FAILED = -23005;
 
 inline std::string GetStatusMsg(int statusCode) {
   if (statusCode == SCODE_SUCCESS) {
@@ -120,6 +129,8 @@ inline std::string GetStatusMsg(int statusCode) {
     return "The number of records is less than the number of queries";
   } else if (statusCode == SCODE_HIS_MD_NUM_OF_RECORDS_GREATER_THAN_LIMIT) {
     return "The number of returned records is greater than the limit";
+  } else if (statusCode == SCODE_HIS_MD_INVALID_COLUMN) {
+    return "Invalid column in query condition";
   } else if (statusCode == SCODE_DB_CAN_NOT_FIND_SYM_CODE) {
     return "Can not find symbolcode";
   } else if (statusCode == SCODE_DB_CAN_NOT_FIND_EXCH_SYM_CODE) {
@@ -130,6 +141,16 @@ inline std::string GetStatusMsg(int statusCode) {
     return "Can not find account info";
   } else if (statusCode == SCODE_TDENG_EXEC_SQL_FAILED) {
     return "Exec tdeng sql failed.";
+  } else if (statusCode == SCODE_TDENG_FETCH_REC_FAILED) {
+    return "Fetch rec of tdeng failed.";
+  } else if (statusCode == SCODE_SNAPSHOT_NOT_EXISTS) {
+    return "Snapshot not exists.";
+  } else if (statusCode == SCODE_SNAPSHOT_INVALID_FILE) {
+    return "Invalid snapshot or journal file.";
+  } else if (statusCode == SCODE_SNAPSHOT_SAVE_FAILED) {
+    return "Save snapshot failed.";
+  } else if (statusCode == SCODE_SNAPSHOT_SAVE_JOURNAL_FAILED) {
+    return "Save journal of snapshot failed.";
   } else if (statusCode == SCODE_STG_MUST_HAVE_STG_INST_1) {
     return "Stg must have stg inst 1";
   } else if (statusCode == SCODE_STG_INST_ID_MUST_START_FROM_1) {
@@ -146,6 +167,8 @@ inline std::string GetStatusMsg(int statusCode) {
     return "StgInstTaskHandler not install";
   } else if (statusCode == SCODE_STG_SEND_HTTP_REQ_TO_QUERY_HIS_MD_FAILED) {
     return "Stg send http request to query his market data failed";
+  } else if (statusCode == SCODE_STG_INIT_MARKET_DATA_VIEW_FAILED) {
+    return "Stg init market data view failed";
   } else if (statusCode == SCODE_ORD_MGR_ADD_ORDER_INFO_FAILED) {
     return "Add orderinfo failed";
   } else if (statusCode == SCODE_ORD_MGR_REMOVE_ORDER_INFO_FAILED) {
@@ -164,6 +187,8 @@ inline std::string GetStatusMsg(int statusCode) {
     return "First update id too large";
   } else if (statusCode == SCODE_MD_SVC_UPDATE_DATA_DISCONTINUOUS) {
     return "Update data discontinuous";
+  } else if (statusCode == SCODE_MD_SVC_DECODE_WS_FRAME_FAILED) {
+    return "Decode ws frame failed";
   } else if (statusCode == SCODE_WEB_SRV_INVALID_BODY_IN_REQ) {
     return "Invalid body in request.";
   } else if (statusCode == SCODE_TD_SRV_RISK_EXCEED_FLOW_CTRL) {
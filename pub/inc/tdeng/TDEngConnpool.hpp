@@ -11,6 +11,7 @@
 #pragma once
 
 #include "tdeng/TDEngParam.hpp"
+#include "util/IdleObjPool.hpp"
 #include "util/Pch.hpp"
 #include "util/StdExt.hpp"
 
@@ -31,10 +32,9 @@ struct Conn {
   Conn& operator=(const Conn&&) = delete;
 
   Conn() = default;
-  Conn(int no, bool idle, TAOS* taos) : no_(no), idle_(idle), taos_(taos) {}
+  Conn(int no, TAOS* taos) : no_(no), taos_(taos) {}
 
   int no_{0};
-  bool idle_{true};
   TAOS* taos_{nullptr};
 };
 using ConnSPtr = std::shared_ptr<Conn>;
@@ -61,9 +61,12 @@ class TDEngConnpool {
   ConnSPtr getIdleConn() const;
   void giveBackConn(const ConnSPtr& conn);
 
+  std::string getWaitHistStr() const;
+
  private:
   std::vector<ConnSPtr> connGroup_;
   mutable std::ext::spin_mutex mtxConnGroup_;
+  mutable IdleObjPool<Conn> idleConnPool_;
 
   const TDEngParamSPtr tdEngParam_{nullptr};
 };
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "util/ColumnarRecSet.hpp"
 #include "util/Pch.hpp"
 
 #ifdef __cplusplus
@@ -25,6 +26,9 @@ namespace bq::tdeng {
 class TDEngConnpool;
 using TDEngConnpoolSPtr = std::shared_ptr<TDEngConnpool>;
 
+struct Conn;
+using ConnSPtr = std::shared_ptr<Conn>;
+
 std::tuple<int, std::uint32_t, std::string> GetJsonDataFromRes(
     TAOS_RES *res, std::uint32_t maxRecNum);
 
@@ -32,4 +36,38 @@ std::tuple<int, std::string, int, std::string> QueryDataFromTDEng(
     const TDEngConnpoolSPtr &tdEngConnpool, const std::string &sql,
     std::uint32_t maxRecNum);
 
+/*
+ * Recs of a query of tdeng fetched one by one without a limit of the rec num.
+ * The conn is held until the source is destroyed.
+ */
+class RecSetSourceOfTDEng : public RecSetSource {
+ public:
+  RecSetSourceOfTDEng(const RecSetSourceOfTDEng &) = delete;
+  RecSetSourceOfTDEng &operator=(const RecSetSourceOfTDEng &) = delete;
+  RecSetSourceOfTDEng(const RecSetSourceOfTDEng &&) = delete;
+  RecSetSourceOfTDEng &operator=(const RecSetSourceOfTDEng &&) = delete;
+
+  RecSetSourceOfTDEng(const TDEngConnpoolSPtr &tdEngConnpool,
+                      const std::string &sql);
+  ~RecSetSourceOfTDEng();
+
+ public:
+  std::tuple<int, std::string> init();
+
+  const std::vector<ColumnInfo> &getColumnInfoGroup() const final {
+    return columnInfoGroup_;
+  }
+
+  std::tuple<int, std::string> fetchRec(void *const *&valueGroup,
+                                        const int *&lenGroup) final;
+
+ private:
+  const TDEngConnpoolSPtr tdEngConnpool_{nullptr};
+  const std::string sql_;
+
+  ConnSPtr conn_{nullptr};
+  TAOS_RES *res_{nullptr};
+  std::vector<ColumnInfo> columnInfoGroup_;
+};
+
 }  // namespace bq::tdeng
@@ -0,0 +1,246 @@
+/*!
+ * \file BinLogger.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "util/Logger.hpp"
+#include "util/Pch.hpp"
+
+/*
+ * Logs to the default logger like LOG_*, but the hot thread only copies the
+ * args into its own ring, they are formatted and passed to the logger by the
+ * background thread of BinLogger.
+ *
+ * The args must be trivially copyable and must not be pointers, char arrays
+ * are copied as strs, enums are formatted by their names, other types need a
+ * fmt::formatter. Use LOG_* for args such as std::string.
+ *
+ * Like LOG_*, a level disabled in the default logger returns before the args
+ * are evaluated, nothing is allocated in the ring or copied.
+ */
+#define BLOG(level, fmtStr, ...)                                        \
+  do {                                                                  \
+    thread_local bq::LoggerOfCallSite loggerOfCallSite_u4c7k0rw;        \
+    if (!bq::GetLogger(loggerOfCallSite_u4c7k0rw, "")                   \
+             ->should_log(level)) {                                     \
+      break;                                                            \
+    }                                                                   \
+    static const bq::BinLogMeta binLogMeta_u4c7k0rw{                    \
+        level,                                                          \
+        spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION},        \
+        fmtStr};                                                        \
+    bq::BinLog(binLogMeta_u4c7k0rw, ##__VA_ARGS__);                     \
+  } while (false)
+
+#define BLOG_T(...) BLOG(spdlog::level::trace, __VA_ARGS__)
+#define BLOG_D(...) BLOG(spdlog::level::debug, __VA_ARGS__)
+#define BLOG_I(...) BLOG(spdlog::level::info, __VA_ARGS__)
+#define BLOG_W(...) BLOG(spdlog::level::warn, __VA_ARGS__)
+#define BLOG_E(...) BLOG(spdlog::level::err, __VA_ARGS__)
+#define BLOG_C(...) BLOG(spdlog::level::critical, __VA_ARGS__)
+
+namespace bq {
+
+struct BinLogMeta {
+  spdlog::level::level_enum level_;
+  spdlog::source_loc loc_;
+  const char* fmtStr_;
+};
+
+template <std::size_t N>
+struct BinLogStr {
+  char data_[N];
+};
+
+namespace detail {
+
+template <typename T>
+struct BinLogArg {
+  using Type = T;
+};
+
+template <std::size_t N>
+struct BinLogArg<char[N]> {
+  using Type = BinLogStr<N>;
+};
+
+template <typename T>
+struct IsBinLogStr : std::false_type {};
+
+template <std::size_t N>
+struct IsBinLogStr<BinLogStr<N>> : std::true_type {};
+
+template <typename T>
+using BinLogArgType =
+    typename BinLogArg<std::remove_cv_t<std::remove_reference_t<T>>>::Type;
+
+template <typename T>
+decltype(auto) ToBinLogArg(const T& value) {
+  if constexpr (IsBinLogStr<BinLogArgType<T>>::value) {
+    BinLogArgType<T> ret;
+    memcpy(ret.data_, value, sizeof(ret.data_));
+    return ret;
+  } else {
+    return (value);
+  }
+}
+
+template <typename T>
+decltype(auto) ToFmtArg(const T& value) {
+  if constexpr (std::is_enum_v<T>) {
+    return magic_enum::enum_name(value);
+  } else if constexpr (IsBinLogStr<T>::value) {
+    return std::string_view(value.data_, strnlen(value.data_, sizeof(T)));
+  } else {
+    return (value);
+  }
+}
+
+template <typename... T>
+std::string FormatBinLogArgImpl(const char* fmtStr, const T&... args) {
+  return fmt::vformat(fmtStr, fmt::make_format_args(args...));
+}
+
+template <typename ArgTuple>
+std::string FormatBinLogArg(const char* fmtStr, const void* argTuple) {
+  return std::apply(
+      [&](const auto&... arg) {
+        return FormatBinLogArgImpl(fmtStr, ToFmtArg(arg)...);
+      },
+      *static_cast<const ArgTuple*>(argTuple));
+}
+
+}  // namespace detail
+
+using FormatBinLogArgFunc = std::string (*)(const char* fmtStr,
+                                            const void* argTuple);
+
+/*
+ * A rec in the ring of a thread, followed by the tuple of the args.
+ */
+struct alignas(16) BinLogRec {
+  const BinLogMeta* meta_;
+  FormatBinLogArgFunc formatBinLogArg_;
+  spdlog::log_clock::time_point logTime_;
+};
+
+/*
+ * Byte ring written by one thread and read by one thread. Recs are 16 bytes
+ * aligned and never wrap, the space left at the end of the ring is skipped.
+ */
+class BinLogRing {
+ public:
+  BinLogRing(const BinLogRing&) = delete;
+  BinLogRing& operator=(const BinLogRing&) = delete;
+  BinLogRing(const BinLogRing&&) = delete;
+  BinLogRing& operator=(const BinLogRing&&) = delete;
+
+  explicit BinLogRing(std::size_t capacity);
+
+ public:
+  // returns nullptr if the ring is full, the rec is readable after commit
+  void* alloc(std::size_t len);
+  void commit() { tail_.store(tailOfAlloc_, std::memory_order_release); }
+
+  // returns nullptr if the ring is empty
+  const void* front();
+  void pop();
+
+  void close() { closed_.store(true, std::memory_order_release); }
+  bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+  std::uint64_t numOfDropped() const {
+    return numOfDropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct alignas(16) Header {
+    std::uint32_t len_;
+    std::uint32_t isPadding_;
+  };
+
+  std::vector<char> buf_;
+  std::uint64_t mask_;
+
+  alignas(64) std::atomic<std::uint64_t> tail_{0};
+  std::uint64_t tailOfAlloc_{0};
+  std::uint64_t headOfProducer_{0};
+  std::atomic<std::uint64_t> numOfDropped_{0};
+
+  alignas(64) std::atomic<std::uint64_t> head_{0};
+  std::uint64_t tailOfConsumer_{0};
+
+  std::atomic_bool closed_{false};
+};
+
+using BinLogRingSPtr = std::shared_ptr<BinLogRing>;
+
+class BinLogger : public boost::serialization::singleton<BinLogger> {
+ public:
+  static constexpr std::size_t CAPACITY_OF_RING = 4 * 1024 * 1024;
+  static constexpr std::uint32_t MS_OF_IDLE = 1;
+
+  BinLogger() = default;
+  ~BinLogger();
+
+ public:
+  // the ring is made at the first call of each thread
+  BinLogRing* getRingOfCurThread();
+
+  // formats and logs the recs already in the rings
+  void flush();
+
+  // must be called before the loggers are destroyed, logs the recs left
+  void stop();
+
+ private:
+  void start();
+  std::size_t consume();
+
+ private:
+  std::vector<BinLogRingSPtr> ringGroup_;
+  std::ext::spin_mutex mtxRingGroup_;
+
+  std::thread threadConsume_;
+  std::atomic_bool stopped_{false};
+  std::mutex mtxThreadConsume_;
+  std::mutex mtxConsume_;
+
+  // only used by the thread which consumes the rings
+  LoggerOfCallSite loggerOfConsumer_;
+  std::uint64_t numOfDroppedLogged_{0};
+};
+
+template <typename... Args>
+void BinLog(const BinLogMeta& meta, const Args&... args) {
+  using ArgTuple = std::tuple<detail::BinLogArgType<Args>...>;
+  static_assert(
+      (std::is_trivially_copyable_v<detail::BinLogArgType<Args>> && ...),
+      "The args of bin log must be trivially copyable.");
+  static_assert((!std::is_pointer_v<detail::BinLogArgType<Args>> && ...),
+                "The args of bin log must not be pointers.");
+  static_assert(alignof(ArgTuple) <= alignof(BinLogRec),
+                "The args of bin log must be at most 16 bytes aligned.");
+
+  thread_local auto ring =
+      BinLogger::get_mutable_instance().getRingOfCurThread();
+  const auto rec = static_cast<BinLogRec*>(
+      ring->alloc(sizeof(BinLogRec) + sizeof(ArgTuple)));
+  if (rec == nullptr) return;
+  rec->meta_ = &meta;
+  rec->formatBinLogArg_ = &detail::FormatBinLogArg<ArgTuple>;
+  rec->logTime_ = spdlog::log_clock::now();
+
+  // never destroyed, the args are trivially copyable
+  new (rec + 1) ArgTuple(detail::ToBinLogArg(args)...);
+  ring->commit();
+}
+
+}  // namespace bq
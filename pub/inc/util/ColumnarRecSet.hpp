@@ -0,0 +1,205 @@
+/*!
+ * \file ColumnarRecSet.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/12/29
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "util/Pch.hpp"
+
+namespace bq {
+
+/*
+ * Binary columnar layout of a rec set, all ints are little endian:
+ *
+ *   header:  "BQCR" | u8 version | u16 numOfColumn |
+ *            numOfColumn * (u8 columnType | u16 lenOfName | name)
+ *   block:   u32 numOfRec (> 0) | numOfColumn * column
+ *   column:  validity bitmap of (numOfRec + 7) / 8 bytes, bit set if not null |
+ *            fixed size values: numOfRec * sizeof(value)
+ *            str values: (numOfRec + 1) * u32 offsets | bytes
+ *   trailer: u32 0 | i32 statusCode | u16 lenOfStatusMsg | statusMsg
+ *
+ * The stream is header, any number of blocks and the trailer, so a rec set of
+ * any size can be sent in chunks and a failure in the middle can be reported.
+ */
+const static std::string MAGIC_OF_COLUMNAR_REC_SET = "BQCR";
+constexpr std::uint8_t VERSION_OF_COLUMNAR_REC_SET = 1;
+const static std::string CONTENT_TYPE_OF_COLUMNAR_REC_SET =
+    "application/x-bq-columnar";
+
+enum class ColumnType : std::uint8_t {
+  Int8 = 1,
+  UInt8 = 2,
+  Int16 = 3,
+  UInt16 = 4,
+  Int32 = 5,
+  UInt32 = 6,
+  Int64 = 7,
+  UInt64 = 8,
+  Float = 9,
+  Double = 10,
+  Bool = 11,
+  Timestamp = 12,
+  Str = 13
+};
+
+// 0 for str
+std::size_t GetSizeOfColumnType(ColumnType columnType);
+
+struct ColumnInfo {
+  std::string name_;
+  ColumnType columnType_;
+};
+
+/*
+ * Recs of a query fetched one by one, such as a result of tdeng.
+ */
+class RecSetSource {
+ public:
+  virtual ~RecSetSource() = default;
+
+  virtual const std::vector<ColumnInfo>& getColumnInfoGroup() const = 0;
+
+  /*
+   * Values of the next rec in the order of the column info group, nullptr for
+   * null, lenGroup holds the len of str values. valueGroup is set to nullptr
+   * after the last rec, a status code other than 0 is returned together with
+   * its msg if the fetch failed.
+   */
+  virtual std::tuple<int, std::string> fetchRec(void* const*& valueGroup,
+                                                const int*& lenGroup) = 0;
+};
+using RecSetSourceSPtr = std::shared_ptr<RecSetSource>;
+
+class ColumnarRecSetEncoder {
+ public:
+  ColumnarRecSetEncoder(const ColumnarRecSetEncoder&) = delete;
+  ColumnarRecSetEncoder& operator=(const ColumnarRecSetEncoder&) = delete;
+  ColumnarRecSetEncoder(const ColumnarRecSetEncoder&&) = delete;
+  ColumnarRecSetEncoder& operator=(const ColumnarRecSetEncoder&&) = delete;
+
+  /*
+   * Only the columns in columnNameGroup are encoded in the order given, all
+   * the columns of the source are encoded if it is empty.
+   */
+  ColumnarRecSetEncoder(const std::vector<ColumnInfo>& columnInfoGroupOfSource,
+                        const std::vector<std::string>& columnNameGroup);
+
+ public:
+  int init();
+
+  void encodeHeader(std::string& out) const;
+
+  void addRec(void* const* valueGroup, const int* lenGroup);
+
+  std::uint32_t getNumOfRec() const { return numOfRec_; }
+
+  // encodes the recs added since the last flush into a block
+  void flushBlock(std::string& out);
+
+  static void EncodeTrailer(std::string& out, int statusCode,
+                            const std::string& statusMsg);
+
+ private:
+  struct Column {
+    std::size_t noInSource_{0};
+    ColumnInfo columnInfo_;
+    std::size_t sizeOfValue_{0};
+    std::string validity_;
+    std::string data_;
+    std::vector<std::uint32_t> offsetGroup_;
+  };
+
+  const std::vector<ColumnInfo> columnInfoGroupOfSource_;
+  const std::vector<std::string> columnNameGroup_;
+
+  std::vector<Column> columnGroup_;
+  std::uint32_t numOfRec_{0};
+};
+
+/*
+ * Reads the stream of a rec set chunk by chunk, a block is encoded each time
+ * the encoded data read before is used up.
+ */
+class ColumnarRecSetStream {
+ public:
+  ColumnarRecSetStream(const ColumnarRecSetStream&) = delete;
+  ColumnarRecSetStream& operator=(const ColumnarRecSetStream&) = delete;
+  ColumnarRecSetStream(const ColumnarRecSetStream&&) = delete;
+  ColumnarRecSetStream& operator=(const ColumnarRecSetStream&&) = delete;
+
+  ColumnarRecSetStream(const RecSetSourceSPtr& recSetSource,
+                       const std::vector<std::string>& columnNameGroup,
+                       std::uint32_t maxNumOfRecEachBlock = 4096);
+
+ public:
+  int init();
+
+  // returns 0 at the end of the stream
+  std::size_t read(char* buf, std::size_t len);
+
+  // the rest of the stream at once, the source is released before it returns
+  std::string readAll();
+
+ private:
+  void encodeNextBlock();
+
+ private:
+  RecSetSourceSPtr recSetSource_{nullptr};
+  ColumnarRecSetEncoder encoder_;
+  const std::uint32_t maxNumOfRecEachBlock_;
+
+  std::string encodedData_;
+  std::size_t offsetOfEncodedData_{0};
+  bool isEnd_{false};
+  int statusCode_{0};
+  std::string statusMsg_;
+};
+using ColumnarRecSetStreamSPtr = std::shared_ptr<ColumnarRecSetStream>;
+
+/*
+ * A decoded rec set, values are read by column no and rec no.
+ */
+struct ColumnarRecSet {
+  struct Column {
+    ColumnInfo columnInfo_;
+    std::vector<bool> validity_;
+    std::string data_;
+    std::vector<std::uint32_t> offsetGroup_{0};
+  };
+
+  template <typename T>
+  T getValue(std::size_t columnNo, std::size_t recNo) const {
+    T ret;
+    memcpy(&ret, columnGroup_[columnNo].data_.data() + recNo * sizeof(T),
+           sizeof(T));
+    return ret;
+  }
+
+  std::string getStr(std::size_t columnNo, std::size_t recNo) const {
+    const auto& column = columnGroup_[columnNo];
+    return column.data_.substr(
+        column.offsetGroup_[recNo],
+        column.offsetGroup_[recNo + 1] - column.offsetGroup_[recNo]);
+  }
+
+  bool isNull(std::size_t columnNo, std::size_t recNo) const {
+    return !columnGroup_[columnNo].validity_[recNo];
+  }
+
+  std::vector<Column> columnGroup_;
+  std::uint32_t numOfRec_{0};
+  int statusCode_{0};
+  std::string statusMsg_;
+};
+
+// returns -1 if the stream is truncated or corrupted
+std::tuple<int, ColumnarRecSet> DecodeColumnarRecSet(const std::string& data);
+
+}  // namespace bq
@@ -19,11 +19,30 @@ std::uint64_t GetTotalUSSince1970();
 std::uint64_t GetTotalMSSince1970();
 std::uint64_t GetTotalSecSince1970();
 
+/*
+ * Read from the tsc which is calibrated against the realtime clock at the
+ * first call and re-anchored to it about every second. Falls back to the
+ * realtime clock without an invariant tsc.
+ */
+std::uint64_t GetTotalNSSince1970ByTSC();
+
+/*
+ * Used to stamp the local ts of market data and orders on the hot path. It is
+ * read from the tsc when pub is built with BQ_TSC_CLOCK, otherwise it is the
+ * same as GetTotalUSSince1970.
+ */
+std::uint64_t GetTotalUSSince1970OfHotPath();
+
 std::string ConvertTsToDBTime(std::uint64_t ts);
 std::string ConvertTsToPtime(std::uint64_t ts);
 std::uint64_t ConvertDBTimeToTS(std::string dbTime);
 std::tuple<int, std::uint64_t> ConvertISODatetimeToTs(
     const std::string& isoDatetime);
+
+/*
+ * Converts datetime in YYYYMMDDhhmmssmmm or YYYYMMDDhhmmss to us since 1970,
+ * the ts of midnight is cached for the last date converted in the thread.
+ */
 std::uint64_t ConvertDatetimeToTs(std::int64_t datetime);
 
 std::string GetDateInStrFmtFromTs(std::uint64_t ts);
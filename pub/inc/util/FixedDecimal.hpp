@@ -0,0 +1,516 @@
+/*!
+ * \file FixedDecimal.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief Scaled integer decimal, a compile time alternative to double for
+ * prices, sizes, fees and pnl. Add, sub and compare are plain integer ops,
+ * mul and div use a wider intermediate and round half away from zero, a
+ * result out of range saturates to +-max instead of wrapping. Div by zero
+ * saturates the same way where double gives +-inf, and 0 / 0 gives 0 where
+ * double gives nan.
+ * FixedDecimal64 holds 8 decimal places within +-9.2e10, use FixedDecimal128
+ * (18 places, same as the db columns) when notional values may exceed that.
+ */
+
+#pragma once
+
+#include "util/Pch.hpp"
+
+namespace bq {
+
+__extension__ using Int128 = __int128;
+__extension__ using UInt128 = unsigned __int128;
+
+enum class RoundMode : std::uint8_t { Nearest = 0, Floor, Ceil, Trunc };
+
+namespace detail {
+
+template <typename Rep>
+struct FixedDecimalTraits;
+
+template <>
+struct FixedDecimalTraits<std::int64_t> {
+  using Unsigned = std::uint64_t;
+  using Wide = Int128;
+  static constexpr int MaxDigits = 19;
+};
+
+template <>
+struct FixedDecimalTraits<Int128> {
+  using Unsigned = UInt128;
+  using Wide = boost::multiprecision::int256_t;
+  static constexpr int MaxDigits = 39;
+};
+
+template <typename Rep>
+constexpr Rep Pow10(int n) {
+  Rep ret = 1;
+  for (int i = 0; i < n; ++i) ret *= 10;
+  return ret;
+}
+
+template <typename T>
+T DivRound(const T& num, const T& den, RoundMode roundMode) {
+  T quot = num / den;
+  const T rem = num - quot * den;
+  if (rem == 0) return quot;
+  const bool neg = (num < 0) != (den < 0);
+  switch (roundMode) {
+    case RoundMode::Nearest: {
+      const T twiceRem = rem < 0 ? rem * -2 : rem * 2;
+      const T absDen = den < 0 ? den * -1 : den;
+      if (twiceRem >= absDen) quot += neg ? -1 : 1;
+    } break;
+    case RoundMode::Floor:
+      if (neg) quot -= 1;
+      break;
+    case RoundMode::Ceil:
+      if (!neg) quot += 1;
+      break;
+    case RoundMode::Trunc:
+      break;
+  }
+  return quot;
+}
+
+}  // namespace detail
+
+template <typename Rep, int Scale>
+class FixedDecimal {
+  using Traits = detail::FixedDecimalTraits<Rep>;
+  using Unsigned = typename Traits::Unsigned;
+  using Wide = typename Traits::Wide;
+
+  template <typename T>
+  using EnableIfArith =
+      std::enable_if_t<std::is_arithmetic_v<T> || std::is_same_v<T, Int128>,
+                       int>;
+
+ public:
+  using RepType = Rep;
+  static constexpr int SCALE = Scale;
+  static constexpr Rep ONE = detail::Pow10<Rep>(Scale);
+  static_assert(Scale > 0 && Scale < Traits::MaxDigits - 1,
+                "Scale out of range of the rep type.");
+
+  constexpr FixedDecimal() = default;
+
+  template <typename T, std::enable_if_t<std::is_integral_v<T> ||
+                                              std::is_same_v<T, Int128>,
+                                          int> = 0>
+  constexpr FixedDecimal(T value) : raw_(static_cast<Rep>(value) * ONE) {}
+
+  template <typename T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+  FixedDecimal(T value) : raw_(FromDouble(static_cast<double>(value))) {}
+
+  static constexpr FixedDecimal FromRaw(Rep raw) {
+    FixedDecimal ret;
+    ret.raw_ = raw;
+    return ret;
+  }
+
+  constexpr Rep raw() const { return raw_; }
+
+  double toDouble() const {
+    const Rep intPart = raw_ / ONE;
+    const Rep fracPart = raw_ % ONE;
+    return static_cast<double>(intPart) +
+           static_cast<double>(fracPart) / static_cast<double>(ONE);
+  }
+
+  // Implicit so that the existing double based apis (json writers, fabs,
+  // db binding) keep working when Decimal is switched to this type.
+  operator double() const { return toDouble(); }
+
+ public:
+  FixedDecimal round(int scale,
+                     RoundMode roundMode = RoundMode::Nearest) const {
+    if (scale >= Scale) return *this;
+    const Rep unit = detail::Pow10<Rep>(Scale - scale);
+    return FromRaw(detail::DivRound<Rep>(raw_, unit, roundMode) * unit);
+  }
+
+  FixedDecimal roundToTick(const FixedDecimal& tick,
+                           RoundMode roundMode = RoundMode::Nearest) const {
+    if (tick.raw_ <= 0) return *this;
+    return FromRaw(detail::DivRound<Rep>(raw_, tick.raw_, roundMode) *
+                   tick.raw_);
+  }
+
+ public:
+  constexpr FixedDecimal operator-() const { return FromRaw(-raw_); }
+  constexpr FixedDecimal operator+() const { return *this; }
+
+  FixedDecimal& operator+=(const FixedDecimal& rhs) {
+    raw_ += rhs.raw_;
+    return *this;
+  }
+  FixedDecimal& operator-=(const FixedDecimal& rhs) {
+    raw_ -= rhs.raw_;
+    return *this;
+  }
+  FixedDecimal& operator*=(const FixedDecimal& rhs) {
+    *this = *this * rhs;
+    return *this;
+  }
+  FixedDecimal& operator/=(const FixedDecimal& rhs) {
+    *this = *this / rhs;
+    return *this;
+  }
+
+  friend constexpr FixedDecimal operator+(const FixedDecimal& lhs,
+                                          const FixedDecimal& rhs) {
+    return FromRaw(lhs.raw_ + rhs.raw_);
+  }
+  friend constexpr FixedDecimal operator-(const FixedDecimal& lhs,
+                                          const FixedDecimal& rhs) {
+    return FromRaw(lhs.raw_ - rhs.raw_);
+  }
+  friend FixedDecimal operator*(const FixedDecimal& lhs,
+                                const FixedDecimal& rhs) {
+    const Wide num = Wide(lhs.raw_) * Wide(rhs.raw_);
+    return FromRaw(
+        Narrow(detail::DivRound<Wide>(num, Wide(ONE), RoundMode::Nearest)));
+  }
+  friend FixedDecimal operator/(const FixedDecimal& lhs,
+                                const FixedDecimal& rhs) {
+    if (rhs.raw_ == 0) {
+      const auto maxOfRep = static_cast<Rep>(MaxMagnitude());
+      if (lhs.raw_ == 0) return FixedDecimal();
+      return FromRaw(lhs.raw_ > 0 ? maxOfRep : -maxOfRep);
+    }
+    const Wide num = Wide(lhs.raw_) * Wide(ONE);
+    return FromRaw(Narrow(
+        detail::DivRound<Wide>(num, Wide(rhs.raw_), RoundMode::Nearest)));
+  }
+
+  friend constexpr bool operator==(const FixedDecimal& lhs,
+                                   const FixedDecimal& rhs) {
+    return lhs.raw_ == rhs.raw_;
+  }
+  friend constexpr bool operator!=(const FixedDecimal& lhs,
+                                   const FixedDecimal& rhs) {
+    return lhs.raw_ != rhs.raw_;
+  }
+  friend constexpr bool operator<(const FixedDecimal& lhs,
+                                  const FixedDecimal& rhs) {
+    return lhs.raw_ < rhs.raw_;
+  }
+  friend constexpr bool operator<=(const FixedDecimal& lhs,
+                                   const FixedDecimal& rhs) {
+    return lhs.raw_ <= rhs.raw_;
+  }
+  friend constexpr bool operator>(const FixedDecimal& lhs,
+                                  const FixedDecimal& rhs) {
+    return lhs.raw_ > rhs.raw_;
+  }
+  friend constexpr bool operator>=(const FixedDecimal& lhs,
+                                   const FixedDecimal& rhs) {
+    return lhs.raw_ >= rhs.raw_;
+  }
+
+  // Mixed operands are matched exactly here, otherwise the implicit
+  // conversion to double would make them ambiguous with the builtins.
+  // Integers scale the raw value directly and stay exact.
+
+#define BQ_FIXED_DECIMAL_MIXED_OP(op)                                      \
+  template <typename T, EnableIfArith<T> = 0>                             \
+  friend auto operator op(const FixedDecimal& lhs, T rhs) {               \
+    return lhs op FixedDecimal(rhs);                                      \
+  }                                                                       \
+  template <typename T, EnableIfArith<T> = 0>                             \
+  friend auto operator op(T lhs, const FixedDecimal& rhs) {               \
+    return FixedDecimal(lhs) op rhs;                                      \
+  }
+
+  BQ_FIXED_DECIMAL_MIXED_OP(+)
+  BQ_FIXED_DECIMAL_MIXED_OP(-)
+  BQ_FIXED_DECIMAL_MIXED_OP(/)
+  BQ_FIXED_DECIMAL_MIXED_OP(==)
+  BQ_FIXED_DECIMAL_MIXED_OP(!=)
+  BQ_FIXED_DECIMAL_MIXED_OP(<)
+  BQ_FIXED_DECIMAL_MIXED_OP(<=)
+  BQ_FIXED_DECIMAL_MIXED_OP(>)
+  BQ_FIXED_DECIMAL_MIXED_OP(>=)
+
+#undef BQ_FIXED_DECIMAL_MIXED_OP
+
+  template <typename T, EnableIfArith<T> = 0>
+  friend FixedDecimal operator*(const FixedDecimal& lhs, T rhs) {
+    if constexpr (std::is_floating_point_v<T>) {
+      return lhs * FixedDecimal(rhs);
+    } else {
+      return FromRaw(Narrow(Wide(lhs.raw_) * Wide(static_cast<Rep>(rhs))));
+    }
+  }
+  template <typename T, EnableIfArith<T> = 0>
+  friend FixedDecimal operator*(T lhs, const FixedDecimal& rhs) {
+    return rhs * lhs;
+  }
+
+  template <typename T, EnableIfArith<T> = 0>
+  FixedDecimal& operator+=(T rhs) {
+    return *this += FixedDecimal(rhs);
+  }
+  template <typename T, EnableIfArith<T> = 0>
+  FixedDecimal& operator-=(T rhs) {
+    return *this -= FixedDecimal(rhs);
+  }
+  template <typename T, EnableIfArith<T> = 0>
+  FixedDecimal& operator*=(T rhs) {
+    return *this = *this * rhs;
+  }
+  template <typename T, EnableIfArith<T> = 0>
+  FixedDecimal& operator/=(T rhs) {
+    return *this /= FixedDecimal(rhs);
+  }
+
+  friend FixedDecimal abs(const FixedDecimal& value) {
+    return value.raw_ < 0 ? -value : value;
+  }
+
+ public:
+  /*
+   * Parse kernel, accepts [+-]digits[.digits][(e|E)[+-]digits]. Digits below
+   * the scale are rounded half away from zero. When consumed is given the
+   * longest valid prefix is parsed, otherwise the whole str must be valid.
+   */
+  static bool Parse(std::string_view str, FixedDecimal& out,
+                    std::size_t* consumed = nullptr) {
+    std::size_t pos = 0;
+    const auto size = str.size();
+
+    bool neg = false;
+    if (pos < size && (str[pos] == '-' || str[pos] == '+')) {
+      neg = str[pos] == '-';
+      ++pos;
+    }
+
+    const auto posOfInt = pos;
+    while (pos < size && IsDigit(str[pos])) ++pos;
+    const auto numOfInt = pos - posOfInt;
+
+    std::size_t posOfFrac = pos;
+    std::size_t numOfFrac = 0;
+    if (pos < size && str[pos] == '.') {
+      posOfFrac = ++pos;
+      while (pos < size && IsDigit(str[pos])) ++pos;
+      numOfFrac = pos - posOfFrac;
+    }
+    if (numOfInt == 0 && numOfFrac == 0) return false;
+
+    int exp = 0;
+    if (pos < size && (str[pos] == 'e' || str[pos] == 'E')) {
+      auto posOfExp = pos + 1;
+      bool negExp = false;
+      if (posOfExp < size && (str[posOfExp] == '-' || str[posOfExp] == '+')) {
+        negExp = str[posOfExp] == '-';
+        ++posOfExp;
+      }
+      if (posOfExp < size && IsDigit(str[posOfExp])) {
+        pos = posOfExp;
+        while (pos < size && IsDigit(str[pos])) {
+          if (exp < 10000) exp = exp * 10 + (str[pos] - '0');
+          ++pos;
+        }
+        if (negExp) exp = -exp;
+      }
+    }
+
+    if (consumed) {
+      *consumed = pos;
+    } else if (pos != size) {
+      return false;
+    }
+
+    // pw is the power of ten of the current digit relative to the raw unit.
+    Unsigned raw = 0;
+    int pw = static_cast<int>(numOfInt) - 1 + Scale + exp;
+    int roundDigit = 0;
+    bool hasLeadingNonZero = false;
+    const auto accumulate = [&](char ch) {
+      const int digit = ch - '0';
+      if (pw >= 0) {
+        if (digit != 0 || hasLeadingNonZero) {
+          hasLeadingNonZero = true;
+          if (raw > (MaxMagnitude() - digit) / 10) return false;
+          raw = raw * 10 + digit;
+        }
+      } else if (pw == -1) {
+        roundDigit = digit;
+      }
+      --pw;
+      return true;
+    };
+    for (std::size_t i = 0; i < numOfInt; ++i) {
+      if (!accumulate(str[posOfInt + i])) return false;
+    }
+    for (std::size_t i = 0; i < numOfFrac; ++i) {
+      if (!accumulate(str[posOfFrac + i])) return false;
+    }
+    for (; pw >= 0; --pw) {
+      if (raw > MaxMagnitude() / 10) return false;
+      raw *= 10;
+    }
+    if (roundDigit >= 5) {
+      if (raw == MaxMagnitude()) return false;
+      ++raw;
+    }
+
+    out.raw_ = neg ? -static_cast<Rep>(raw) : static_cast<Rep>(raw);
+    return true;
+  }
+
+  static std::optional<FixedDecimal> Parse(std::string_view str) {
+    FixedDecimal ret;
+    if (!Parse(str, ret)) return std::nullopt;
+    return ret;
+  }
+
+  /*
+   * Format kernel, writes at most MaxStrLen chars without the terminating
+   * zero and returns the end. A scale of -1 drops the trailing zeros of the
+   * fractional part, otherwise exactly scale digits are written.
+   */
+  static constexpr std::size_t MaxStrLen = Traits::MaxDigits + 3;
+
+  char* toChars(char* buf, int scale = -1) const {
+    const auto value = (scale >= 0 && scale < Scale) ? round(scale) : *this;
+    Unsigned mag = value.raw_ < 0 ? Unsigned(0) - Unsigned(value.raw_)
+                                  : Unsigned(value.raw_);
+
+    char digits[Traits::MaxDigits + 1];
+    int num = 0;
+    do {
+      digits[num++] = static_cast<char>('0' + static_cast<int>(mag % 10));
+      mag /= 10;
+    } while (mag != 0);
+    while (num <= Scale) digits[num++] = '0';
+
+    int numOfFrac = Scale;
+    if (scale < 0) {
+      while (numOfFrac > 0 && digits[Scale - numOfFrac] == '0') --numOfFrac;
+    } else if (scale < Scale) {
+      numOfFrac = scale;
+    }
+
+    char* p = buf;
+    if (value.raw_ < 0) *p++ = '-';
+    for (int i = num - 1; i >= Scale; --i) *p++ = digits[i];
+    if (numOfFrac > 0) {
+      *p++ = '.';
+      for (int i = Scale - 1; i >= Scale - numOfFrac; --i) *p++ = digits[i];
+    }
+    for (int i = Scale; i < scale; ++i) *p++ = '0';
+    return p;
+  }
+
+  std::string toStr(int scale = -1) const {
+    char buf[MaxStrLen + 64];
+    const auto end = toChars(buf, std::min(scale, Scale + 60));
+    return std::string(buf, end);
+  }
+
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const FixedDecimal& value) {
+    return os << value.toStr();
+  }
+
+  friend std::istream& operator>>(std::istream& is, FixedDecimal& value) {
+    std::string str;
+    if (is >> str && !Parse(str, value)) {
+      is.setstate(std::ios::failbit);
+    }
+    return is;
+  }
+
+ private:
+  static constexpr bool IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+  static constexpr Unsigned MaxMagnitude() {
+    return static_cast<Unsigned>(~Unsigned(0) >> 1);
+  }
+
+  static Rep Narrow(const Wide& value) {
+    const auto maxOfRep = static_cast<Rep>(MaxMagnitude());
+    if (value > Wide(maxOfRep)) return maxOfRep;
+    if (value < -Wide(maxOfRep)) return -maxOfRep;
+    return static_cast<Rep>(value);
+  }
+
+  static Rep FromDouble(double value) {
+    const double scaled = value * static_cast<double>(ONE);
+    if (std::fabs(scaled) < 9e18 &&
+        scaled == static_cast<double>(static_cast<std::int64_t>(scaled))) {
+      return static_cast<Rep>(static_cast<std::int64_t>(scaled));
+    }
+    // The shortest repr round-trips, so 0.1 becomes exactly 0.1 instead of
+    // 0.1000000000000000055511151231257827.
+    char buf[64];
+    const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    FixedDecimal ret;
+    if (ec != std::errc() || !Parse(std::string_view(buf, end - buf), ret)) {
+      return 0;
+    }
+    return ret.raw_;
+  }
+
+ private:
+  Rep raw_{0};
+};
+
+/*
+ * Lets CONV(Decimal, str) go through the parse kernel above, boost::convert
+ * hands user types to operator>>.
+ */
+template <typename Rep, int Scale>
+void operator>>(std::string_view in,
+                boost::optional<FixedDecimal<Rep, Scale>>& out) {
+  FixedDecimal<Rep, Scale> value;
+  if (FixedDecimal<Rep, Scale>::Parse(in, value)) out = value;
+}
+
+using FixedDecimal64 = FixedDecimal<std::int64_t, 8>;
+using FixedDecimal128 = FixedDecimal<Int128, 18>;
+
+/*
+ * Number of decimal places of a tick or step size in string format, such as
+ * precOfOrderPrice "0.01" -> 2, "0.00100000" -> 3, "5" -> 0.
+ */
+int GetScaleOfPrec(std::string_view prec);
+
+}  // namespace bq
+
+template <typename Rep, int Scale>
+struct std::numeric_limits<bq::FixedDecimal<Rep, Scale>> {
+  using Type = bq::FixedDecimal<Rep, Scale>;
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_exact = true;
+  static constexpr int digits10 =
+      bq::detail::FixedDecimalTraits<Rep>::MaxDigits - 1;
+  static constexpr Type min() { return Type::FromRaw(1); }
+  static constexpr Type lowest() { return -max(); }
+  static constexpr Type max() {
+    return Type::FromRaw(static_cast<Rep>(
+        ~typename bq::detail::FixedDecimalTraits<Rep>::Unsigned(0) >> 1));
+  }
+  static constexpr Type epsilon() { return Type::FromRaw(1); }
+};
+
+template <typename Rep, int Scale>
+struct fmt::formatter<bq::FixedDecimal<Rep, Scale>>
+    : fmt::formatter<std::string_view> {
+  template <typename FormatContext>
+  auto format(const bq::FixedDecimal<Rep, Scale>& value, FormatContext& ctx)
+      -> decltype(ctx.out()) {
+    char buf[bq::FixedDecimal<Rep, Scale>::MaxStrLen];
+    const auto end = value.toChars(buf);
+    return fmt::formatter<std::string_view>::format(
+        std::string_view(buf, end - buf), ctx);
+  }
+};
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "util/FixedDecimal.hpp"
 #include "util/Pch.hpp"
 
 namespace bq {
@@ -75,4 +76,83 @@ static bool isDefinitelyLessOrEqual(
          isApproximatelyEqual(a, b, tolerance);
 }
 
+// Overloads for the fixed decimal, the compares are exact integer compares
+// and the tolerance defaults to zero.
+template <typename Rep, int Scale>
+static bool isApproximatelyEqual(
+    FixedDecimal<Rep, Scale> a, FixedDecimal<Rep, Scale> b,
+    FixedDecimal<Rep, Scale> tolerance = {}) {
+  return abs(a - b) <= tolerance;
+}
+
+template <typename Rep, int Scale>
+static bool isApproximatelyZero(
+    FixedDecimal<Rep, Scale> a,
+    FixedDecimal<Rep, Scale> tolerance = {}) {
+  return abs(a) <= tolerance;
+}
+
+template <typename Rep, int Scale>
+static bool isDefinitelyLessThan(
+    FixedDecimal<Rep, Scale> a, FixedDecimal<Rep, Scale> b,
+    FixedDecimal<Rep, Scale> tolerance = {}) {
+  return b - a > tolerance;
+}
+
+template <typename Rep, int Scale>
+static bool isDefinitelyGreaterThan(
+    FixedDecimal<Rep, Scale> a, FixedDecimal<Rep, Scale> b,
+    FixedDecimal<Rep, Scale> tolerance = {}) {
+  return a - b > tolerance;
+}
+
+template <typename Rep, int Scale>
+static bool isDefinitelyGreaterOrEqual(
+    FixedDecimal<Rep, Scale> a, FixedDecimal<Rep, Scale> b,
+    FixedDecimal<Rep, Scale> tolerance = {}) {
+  return b - a <= tolerance;
+}
+
+template <typename Rep, int Scale>
+static bool isDefinitelyLessOrEqual(
+    FixedDecimal<Rep, Scale> a, FixedDecimal<Rep, Scale> b,
+    FixedDecimal<Rep, Scale> tolerance = {}) {
+  return a - b <= tolerance;
+}
+
+/*
+ * Sum of decimals used to reconcile fee and pnl. It is a plain integer sum for
+ * the fixed decimal and a Neumaier compensated sum for double.
+ */
+template <typename T>
+class ExactSum {
+ public:
+  ExactSum& operator+=(const T& value) {
+    if constexpr (std::is_floating_point_v<T>) {
+      const T t = sum_ + value;
+      if (std::fabs(sum_) >= std::fabs(value)) {
+        comp_ += (sum_ - t) + value;
+      } else {
+        comp_ += (value - t) + sum_;
+      }
+      sum_ = t;
+    } else {
+      sum_ += value;
+    }
+    return *this;
+  }
+
+  T get() const {
+    if constexpr (std::is_floating_point_v<T>) {
+      return sum_ + comp_;
+    } else {
+      return sum_;
+    }
+  }
+
+ private:
+  T sum_{0};
+  T comp_{0};
+};
+
 }  // namespace bq
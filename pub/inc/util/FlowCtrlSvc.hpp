@@ -19,34 +19,71 @@ namespace bq {
 class FlowCtrlSvc;
 using FlowCtrlSvcSPtr = std::shared_ptr<FlowCtrlSvc>;
 
-template <typename T>
-using FixedSizeQueue = std::queue<T, boost::circular_buffer<T>>;
+// the id of a task name which is not in any group of the flow ctrl rule
+constexpr static std::uint32_t INVALID_TASK_ID_OF_FLOW_CTRL = UINT32_MAX;
 
+/*
+ * Sliding window of a group, the ns of the last limitNum tasks passed are
+ * kept in a ring and a task of weight w takes w of them.
+ */
 struct FlowLimitInfo {
-  FlowLimitInfo(std::uint32_t timeDur, std::int32_t limitNum);
-
-  std::string toStr() const;
-
-  std::uint32_t timeDur_;
-  std::uint32_t limitNum_;
-  FixedSizeQueue<boost::posix_time::ptime> timePointGroupOfTaskHasBeenExec_;
+  std::uint32_t timeDur_{0};
+  std::uint32_t limitNum_{0};
+  std::vector<std::uint64_t> nsGroupOfTaskHasBeenExec_;
+  std::uint32_t posOfFirstTask_{0};
+  std::uint32_t numOfTask_{0};
+  std::ext::spin_mutex mtx_;
 };
-using FlowLimitInfoSPtr = std::shared_ptr<FlowLimitInfo>;
 
+/*
+ * Each group of the flow ctrl rule has one sliding window, which every check
+ * of a task of the group goes through, by task name or by task id, so a group
+ * checked both ways is still limited to limitNum tasks per timeDur.
+ */
 class FlowCtrlSvc {
  public:
   explicit FlowCtrlSvc(const YAML::Node& node);
 
  public:
+  // same as the check by task id, after a lookup of the task name
   bool exceedFlowCtrl(const std::string& taskName,
                       WriteLog writeLog = WriteLog::True);
   void reset();
 
+ public:
+  // resolve the task name once and check the task by its id on the hot path
+  std::uint32_t getTaskId(const std::string& taskName) const;
+
+  /*
+   * Check of the sliding window of the group of the task over the monotonic
+   * ns clock. Once the window is full, the task is passed only if the rate of
+   * the tasks in the window with it is below limitNum per timeDur, so no more
+   * than limitNum tasks of weight 1 are passed within timeDur.
+   */
+  bool exceedFlowCtrl(std::uint32_t taskId,
+                      WriteLog writeLog = WriteLog::True) {
+    return exceedFlowCtrl(taskId, GetNSOfMonotonicClock(), writeLog);
+  }
+  bool exceedFlowCtrl(std::uint32_t taskId, std::uint64_t nsOfNow,
+                      WriteLog writeLog = WriteLog::True);
+
+  static std::uint64_t GetNSOfMonotonicClock() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
  private:
-  std::map<std::string, std::uint32_t> taskName2GroupNo_;
-  std::map<std::string, std::uint32_t> taskName2Weight_;
-  std::map<std::uint32_t, FlowLimitInfoSPtr> groupNo2FlowLimitInfo_;
-  std::ext::spin_mutex mtxFlowCtrl_;
+  std::map<std::string, std::uint32_t> taskName2TaskId_;
+
+  struct TaskInfoOfFlowCtrl {
+    std::string taskName_;
+    std::uint32_t groupNo_;
+    std::uint32_t weight_;
+  };
+  std::vector<TaskInfoOfFlowCtrl> taskId2TaskInfo_;
+  std::unique_ptr<FlowLimitInfo[]> groupNo2FlowLimitInfo_{nullptr};
+  std::uint32_t numOfGroup_{0};
 };
 
 }  // namespace bq
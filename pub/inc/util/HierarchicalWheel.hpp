@@ -0,0 +1,100 @@
+/*!
+ * \file HierarchicalWheel.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "util/Pch.hpp"
+
+namespace bq {
+
+/*
+ * Hierarchical timing wheel, the core of TimerWheel and ScheduleTaskExecutor.
+ * Adding an entry costs O(1) and each tick only visits the entries due in it
+ * however far their deadlines are. Each level has 64 slots, a slot of level n
+ * covers 64^n ticks and is moved down to the lower levels when the wheel
+ * reaches it.
+ *
+ * Entry must have a std::uint64_t expireTick_. Not thread safe, the wheel is
+ * driven by its owner, which hands over the entries added by other threads.
+ */
+template <typename Entry>
+class HierarchicalWheel {
+ public:
+  static constexpr std::uint32_t BITS_OF_SLOT = 6;
+  static constexpr std::uint32_t NUM_OF_SLOT = 1 << BITS_OF_SLOT;
+  static constexpr std::uint64_t MASK_OF_SLOT = NUM_OF_SLOT - 1;
+  static constexpr std::uint32_t NUM_OF_LEVEL = 6;
+
+  HierarchicalWheel(const HierarchicalWheel&) = delete;
+  HierarchicalWheel& operator=(const HierarchicalWheel&) = delete;
+  HierarchicalWheel(const HierarchicalWheel&&) = delete;
+  HierarchicalWheel& operator=(const HierarchicalWheel&&) = delete;
+
+  HierarchicalWheel()
+      : levelGroup_(NUM_OF_LEVEL,
+                    std::vector<std::vector<Entry>>(NUM_OF_SLOT)) {}
+
+ public:
+  // an entry already due is fired by the next tick
+  void add(Entry&& entry) {
+    entry.expireTick_ = std::max(entry.expireTick_, curTick_ + 1);
+    addToLevel(std::move(entry));
+  }
+
+  // moves on 1 tick and passes each entry due to fire, which may add entries
+  template <typename Fire>
+  void tick(Fire&& fire) {
+    ++curTick_;
+
+    // move the slots of the higher levels reached by this tick down
+    for (std::uint32_t level = 1; level < NUM_OF_LEVEL; ++level) {
+      const auto bitsOfLevel = BITS_OF_SLOT * level;
+      if ((curTick_ & ((1ULL << bitsOfLevel) - 1)) != 0) break;
+      auto& slot = levelGroup_[level][(curTick_ >> bitsOfLevel) & MASK_OF_SLOT];
+      std::vector<Entry> entryGroup;
+      entryGroup.swap(slot);
+      for (auto& entry : entryGroup) {
+        addToLevel(std::move(entry));
+      }
+    }
+
+    entryGroupToFire_.swap(levelGroup_[0][curTick_ & MASK_OF_SLOT]);
+    for (auto& entry : entryGroupToFire_) {
+      if (entry.expireTick_ > curTick_) {
+        addToLevel(std::move(entry));
+      } else {
+        fire(entry);
+      }
+    }
+    entryGroupToFire_.clear();
+  }
+
+  std::uint64_t getCurTick() const { return curTick_; }
+
+ private:
+  void addToLevel(Entry&& entry) {
+    const auto tickNum = entry.expireTick_ - curTick_;
+    std::uint32_t level = 0;
+    while (level + 1 < NUM_OF_LEVEL &&
+           tickNum >= (1ULL << (BITS_OF_SLOT * (level + 1)))) {
+      ++level;
+    }
+    const auto slotNo =
+        (entry.expireTick_ >> (BITS_OF_SLOT * level)) & MASK_OF_SLOT;
+    levelGroup_[level][slotNo].emplace_back(std::move(entry));
+  }
+
+ private:
+  std::vector<std::vector<std::vector<Entry>>> levelGroup_;
+  std::vector<Entry> entryGroupToFire_;
+  std::uint64_t curTick_{0};
+};
+
+}  // namespace bq
@@ -0,0 +1,102 @@
+/*!
+ * \file IdleObjPool.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "util/Pch.hpp"
+
+namespace bq {
+
+/*
+ * Histogram of the time spent waiting for an idle object, bucket 0 counts the
+ * acquisitions which found an idle object at once, bucket n counts the waits
+ * shorter than 2^n us, the last bucket counts the rest.
+ */
+class WaitHist {
+ public:
+  static constexpr std::size_t NUM_OF_BUCKET = 24;
+
+  void addNoWait() { bucketGroup_[0].fetch_add(1, std::memory_order_relaxed); }
+
+  void addWait(std::uint64_t microSecOfWait) {
+    std::size_t no = 1;
+    while (no < NUM_OF_BUCKET - 1 && (1ULL << no) <= microSecOfWait) ++no;
+    bucketGroup_[no].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  std::uint64_t getNum(std::size_t no) const {
+    return bucketGroup_[no].load(std::memory_order_relaxed);
+  }
+
+  std::string toStr() const {
+    std::string ret = fmt::format("noWait: {}", getNum(0));
+    for (std::size_t no = 1; no < NUM_OF_BUCKET; ++no) {
+      const auto num = getNum(no);
+      if (num == 0) continue;
+      if (no == NUM_OF_BUCKET - 1) {
+        ret.append(fmt::format(", >={}us: {}", 1ULL << (no - 1), num));
+      } else {
+        ret.append(fmt::format(", <{}us: {}", 1ULL << no, num));
+      }
+    }
+    return ret;
+  }
+
+ private:
+  std::array<std::atomic<std::uint64_t>, NUM_OF_BUCKET> bucketGroup_{};
+};
+
+/*
+ * Pool of idle objects such as db connections. Idle objects are kept in a lock
+ * free queue, an acquirer with no idle object to take blocks on the semaphore
+ * of the queue and each object given back wakes exactly one of the waiters.
+ */
+template <typename Obj>
+class IdleObjPool {
+  using ObjSPtr = std::shared_ptr<Obj>;
+
+ public:
+  IdleObjPool(const IdleObjPool&) = delete;
+  IdleObjPool& operator=(const IdleObjPool&) = delete;
+  IdleObjPool(const IdleObjPool&&) = delete;
+  IdleObjPool& operator=(const IdleObjPool&&) = delete;
+
+  explicit IdleObjPool(std::size_t capacity = 64) : idleObjGroup_(capacity) {}
+
+ public:
+  void giveBack(const ObjSPtr& obj) { idleObjGroup_.enqueue(obj); }
+
+  ObjSPtr take() {
+    ObjSPtr obj;
+    if (idleObjGroup_.try_dequeue(obj)) {
+      waitHist_.addNoWait();
+      return obj;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    idleObjGroup_.wait_dequeue(obj);
+    const auto microSecOfWait =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime)
+            .count();
+    waitHist_.addWait(microSecOfWait);
+    return obj;
+  }
+
+  std::size_t getNumOfIdleObj() const { return idleObjGroup_.size_approx(); }
+
+  const WaitHist& getWaitHist() const { return waitHist_; }
+
+ private:
+  moodycamel::BlockingConcurrentQueue<ObjSPtr> idleObjGroup_;
+  WaitHist waitHist_;
+};
+
+}  // namespace bq
@@ -0,0 +1,150 @@
+/*!
+ * \file LatencyHist.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "util/Datetime.hpp"
+#include "util/Pch.hpp"
+#include "util/StdExt.hpp"
+
+/*
+ * Records the us elapsed since startTs into the histogram of the probe owned
+ * by the current thread, the histogram is registered at the first call of
+ * each thread, after that no lock is taken and no memory is allocated.
+ */
+#define LATENCY_PROBE(probeName, startTs)                                     \
+  do {                                                                        \
+    thread_local auto latencyHist_f7ob25ln =                                  \
+        bq::LatencyProbeMgr::get_mutable_instance()                           \
+            .getLatencyHistOfCurThread(probeName);                            \
+    latencyHist_f7ob25ln->recordSince(static_cast<std::uint64_t>(startTs));   \
+  } while (false)
+
+namespace bq {
+
+/*
+ * Log linear histogram of latencies in us with a relative error less than
+ * 1/32. Values less than 64 have a bucket of their own, every power of 2 above
+ * is divided into 32 sub buckets, values of 2^41us and above fall into the
+ * last bucket. It is written by one thread and can be read by any thread.
+ */
+class LatencyHist {
+ public:
+  static constexpr std::uint32_t BITS_OF_SUB_BUCKET = 5;
+  static constexpr std::uint64_t NUM_OF_SUB_BUCKET = 1ULL
+                                                     << BITS_OF_SUB_BUCKET;
+  static constexpr std::uint32_t MAX_EXPONENT = 40;
+  static constexpr std::size_t NUM_OF_BUCKET =
+      NUM_OF_SUB_BUCKET * (MAX_EXPONENT - BITS_OF_SUB_BUCKET + 2);
+
+  static std::size_t GetBucketNo(std::uint64_t value) {
+    if (value < 2 * NUM_OF_SUB_BUCKET) return value;
+    const std::uint32_t exponent = 63 - __builtin_clzll(value);
+    if (exponent > MAX_EXPONENT) return NUM_OF_BUCKET - 1;
+    const auto subBucketNo =
+        (value >> (exponent - BITS_OF_SUB_BUCKET)) - NUM_OF_SUB_BUCKET;
+    return 2 * NUM_OF_SUB_BUCKET +
+           (exponent - BITS_OF_SUB_BUCKET - 1) * NUM_OF_SUB_BUCKET +
+           subBucketNo;
+  }
+
+  static std::uint64_t GetMaxValueOfBucket(std::size_t bucketNo) {
+    if (bucketNo < 2 * NUM_OF_SUB_BUCKET) return bucketNo;
+    const auto no = bucketNo - 2 * NUM_OF_SUB_BUCKET;
+    const auto exponent = no / NUM_OF_SUB_BUCKET + BITS_OF_SUB_BUCKET + 1;
+    const auto subBucketNo = no % NUM_OF_SUB_BUCKET;
+    return ((NUM_OF_SUB_BUCKET + subBucketNo + 1)
+            << (exponent - BITS_OF_SUB_BUCKET)) -
+           1;
+  }
+
+ public:
+  // only the owner thread writes, so no atomic rmw is needed
+  void record(std::uint64_t value) {
+    inc(bucketGroup_[GetBucketNo(value)], 1);
+    inc(num_, 1);
+    inc(sum_, value);
+    if (value > max_.load(std::memory_order_relaxed)) {
+      max_.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  // a start ts later than now comes from clocks of different hosts
+  void recordSince(std::uint64_t startTs) {
+    const auto now = GetTotalUSSince1970OfHotPath();
+    record(now > startTs ? now - startTs : 0);
+  }
+
+  std::uint64_t getNum(std::size_t bucketNo) const {
+    return bucketGroup_[bucketNo].load(std::memory_order_relaxed);
+  }
+  std::uint64_t getNum() const { return num_.load(std::memory_order_relaxed); }
+  std::uint64_t getSum() const { return sum_.load(std::memory_order_relaxed); }
+  std::uint64_t getMax() const { return max_.load(std::memory_order_relaxed); }
+
+ private:
+  static void inc(std::atomic<std::uint64_t>& value, std::uint64_t delta) {
+    value.store(value.load(std::memory_order_relaxed) + delta,
+                std::memory_order_relaxed);
+  }
+
+ private:
+  std::array<std::atomic<std::uint64_t>, NUM_OF_BUCKET> bucketGroup_{};
+  std::atomic<std::uint64_t> num_{0};
+  std::atomic<std::uint64_t> sum_{0};
+  std::atomic<std::uint64_t> max_{0};
+};
+
+/*
+ * Histograms of the threads of a probe merged by the reader.
+ */
+struct LatencyStat {
+  LatencyStat() : bucketGroup_(LatencyHist::NUM_OF_BUCKET, 0) {}
+
+  void merge(const LatencyHist& latencyHist);
+
+  // stat of the samples recorded after prevStat was taken
+  LatencyStat getIncrement(const LatencyStat& prevStat) const;
+
+  std::uint64_t getValueAtPercentile(double percentile) const;
+
+  std::string toStr() const;
+
+  std::vector<std::uint64_t> bucketGroup_;
+  std::uint64_t num_{0};
+  std::uint64_t sum_{0};
+  std::uint64_t max_{0};
+};
+
+class LatencyProbeMgr
+    : public boost::serialization::singleton<LatencyProbeMgr> {
+ public:
+  /*
+   * Called once for each thread of each probe. The histograms live as long as
+   * the process, as the threads recording into them do.
+   */
+  LatencyHist* getLatencyHistOfCurThread(const std::string& probeName);
+
+  LatencyStat getStat(const std::string& probeName) const;
+
+  // logs p50/p99/p999/max of each probe since the last call
+  void logStat();
+
+ private:
+  struct Probe {
+    std::vector<std::unique_ptr<LatencyHist>> latencyHistGroup_;
+    LatencyStat statOfLastLog_;
+  };
+
+  std::map<std::string, Probe> probeName2Probe_;
+  mutable std::ext::spin_mutex mtxProbeName2Probe_;
+};
+
+}  // namespace bq
@@ -32,48 +32,83 @@ std::shared_ptr<spdlog::async_logger> makeLogger(
     const std::string& configFilename);
 std::shared_ptr<spdlog::async_logger> makeLogger(const YAML::Node& config);
 
+// bumped each time the loggers are inited
+inline std::atomic<std::uint64_t>& VerOfLoggers() {
+  static std::atomic<std::uint64_t> verOfLoggers{1};
+  return verOfLoggers;
+}
+
+/*
+ * The logger cached by a log statement in each thread, it is looked up again
+ * only after the loggers are inited again, so the registry of spdlog which
+ * takes a mutex is not queried by every log.
+ */
+struct LoggerOfCallSite {
+  std::uint64_t verOfLoggers_{0};
+  std::shared_ptr<spdlog::logger> logger_{nullptr};
+};
+
+inline spdlog::logger* GetLogger(LoggerOfCallSite& loggerOfCallSite,
+                                 std::string_view loggerName) {
+  const auto verOfLoggers = VerOfLoggers().load(std::memory_order_acquire);
+  if (loggerOfCallSite.verOfLoggers_ != verOfLoggers) {
+    auto logger = spdlog::get(std::string(loggerName));
+    if (logger == nullptr) logger = spdlog::default_logger();
+    loggerOfCallSite.logger_ = std::move(logger);
+    loggerOfCallSite.verOfLoggers_ = verOfLoggers;
+  }
+  return loggerOfCallSite.logger_.get();
+}
+
 }  // namespace bq
 
-#define SPDL_T(logger_name, ...)                              \
-  {                                                           \
-    auto logger = spdlog::get((logger_name));                 \
-    if (logger == nullptr) logger = spdlog::default_logger(); \
-    SPDLOG_LOGGER_TRACE(logger, __VA_ARGS__);                 \
+// the logger_name of a log statement must not change between calls
+#define SPDL_T(logger_name, ...)                                 \
+  {                                                              \
+    thread_local bq::LoggerOfCallSite loggerOfCallSite_q8v1m3ze; \
+    const auto logger =                                          \
+        bq::GetLogger(loggerOfCallSite_q8v1m3ze, (logger_name)); \
+    SPDLOG_LOGGER_TRACE(logger, __VA_ARGS__);                    \
   }
 
-#define SPDL_D(logger_name, ...)                              \
-  {                                                           \
-    auto logger = spdlog::get((logger_name));                 \
-    if (logger == nullptr) logger = spdlog::default_logger(); \
-    SPDLOG_LOGGER_DEBUG(logger, __VA_ARGS__);                 \
+#define SPDL_D(logger_name, ...)                                 \
+  {                                                              \
+    thread_local bq::LoggerOfCallSite loggerOfCallSite_q8v1m3ze; \
+    const auto logger =                                          \
+        bq::GetLogger(loggerOfCallSite_q8v1m3ze, (logger_name)); \
+    SPDLOG_LOGGER_DEBUG(logger, __VA_ARGS__);                    \
   }
 
-#define SPDL_I(logger_name, ...)                              \
-  {                                                           \
-    auto logger = spdlog::get((logger_name));                 \
-    if (logger == nullptr) logger = spdlog::default_logger(); \
-    SPDLOG_LOGGER_INFO(logger, __VA_ARGS__);                  \
+#define SPDL_I(logger_name, ...)                                 \
+  {                                                              \
+    thread_local bq::LoggerOfCallSite loggerOfCallSite_q8v1m3ze; \
+    const auto logger =                                          \
+        bq::GetLogger(loggerOfCallSite_q8v1m3ze, (logger_name)); \
+    SPDLOG_LOGGER_INFO(logger, __VA_ARGS__);                     \
   }
 
-#define SPDL_W(logger_name, ...)                              \
-  {                                                           \
-    auto logger = spdlog::get((logger_name));                 \
-    if (logger == nullptr) logger = spdlog::default_logger(); \
-    SPDLOG_LOGGER_WARN(logger, __VA_ARGS__);                  \
+#define SPDL_W(logger_name, ...)                                 \
+  {                                                              \
+    thread_local bq::LoggerOfCallSite loggerOfCallSite_q8v1m3ze; \
+    const auto logger =                                          \
+        bq::GetLogger(loggerOfCallSite_q8v1m3ze, (logger_name)); \
+    SPDLOG_LOGGER_WARN(logger, __VA_ARGS__);                     \
   }
 
-#define SPDL_E(logger_name, ...)                              \
-  {                                                           \
-    auto logger = spdlog::get((logger_name));                 \
-    if (logger == nullptr) logger = spdlog::default_logger(); \
-    SPDLOG_LOGGER_ERROR(logger, __VA_ARGS__);                 \
+#define SPDL_E(logger_name, ...)                                 \
+  {                                                              \
+    thread_local bq::LoggerOfCallSite loggerOfCallSite_q8v1m3ze; \
+    const auto logger =                                          \
+        bq::GetLogger(loggerOfCallSite_q8v1m3ze, (logger_name)); \
+    SPDLOG_LOGGER_ERROR(logger, __VA_ARGS__);                    \
   }
 
-#define SPDL_C(logger_name, ...)                              \
-  {                                                           \
-    auto logger = spdlog::get((logger_name));                 \
-    if (logger == nullptr) logger = spdlog::default_logger(); \
-    SPDLOG_LOGGER_CRITICAL(logger, __VA_ARGS__);              \
+#define SPDL_C(logger_name, ...)                                 \
+  {                                                              \
+    thread_local bq::LoggerOfCallSite loggerOfCallSite_q8v1m3ze; \
+    const auto logger =                                          \
+        bq::GetLogger(loggerOfCallSite_q8v1m3ze, (logger_name)); \
+    SPDLOG_LOGGER_CRITICAL(logger, __VA_ARGS__);                 \
   }
 
 #define LOG_T(...) SPDL_T("", __VA_ARGS__)
@@ -11,6 +11,7 @@
 #pragma once
 
 #include <any>
+#include <atomic>
 #include <charconv>
 #include <chrono>
 #include <condition_variable>
@@ -19,25 +19,46 @@ namespace bq {
 using ScheduleTaskHandler = std::function<bool()>;
 
 struct ScheduleTask {
+  // interval in ms, without a budget
   ScheduleTask(const std::string& scheduleTaskName,
                const ScheduleTaskHandler& scheduleTaskHandler,
                ExecAtStartup execAtStartup, std::uint32_t interval,
                std::uint64_t maxExecTimes = UINT64_MAX,
                WriteLog writeLog = WriteLog::True);
 
+  /*
+   * An exec longer than the budget is counted as an overrun, 0 means no
+   * budget. Tasks on a dedicated thread are not delayed by the others and
+   * their tick follows their interval, so they can run in less than 1 ms.
+   */
+  ScheduleTask(const std::string& scheduleTaskName,
+               const ScheduleTaskHandler& scheduleTaskHandler,
+               ExecAtStartup execAtStartup, std::chrono::microseconds interval,
+               std::chrono::microseconds budget,
+               ExecOnDedicatedThread execOnDedicatedThread =
+                   ExecOnDedicatedThread::False,
+               std::uint64_t maxExecTimes = UINT64_MAX,
+               WriteLog writeLog = WriteLog::True);
+
   const std::string scheduleTaskName_;
   const ScheduleTaskHandler scheduleTaskHandler_;
   const ExecAtStartup execAtStartup_{ExecAtStartup::False};
-  const std::uint32_t interval_{1};
-  std::uint64_t lastExecTime_{GetTotalSecSince1970()};
+  const std::uint64_t usInterval_{1000};
+  const std::uint64_t usBudget_{0};
+  const ExecOnDedicatedThread execOnDedicatedThread_{
+      ExecOnDedicatedThread::False};
   std::uint64_t execTimes_{0};
   const std::uint64_t maxExecTimes_{UINT64_MAX};
   const WriteLog writeLog_{WriteLog::True};
+
+  // updated by the thread of the executor after each exec
+  std::uint64_t numOfOverrun_{0};
+  std::uint64_t usMaxExecTime_{0};
+  std::uint64_t usTotalExecTime_{0};
 };
 
 using ScheduleTaskSPtr = std::shared_ptr<ScheduleTask>;
 using ScheduleTaskBundle = std::vector<ScheduleTaskSPtr>;
 using ScheduleTaskBundleSPtr = std::shared_ptr<ScheduleTaskBundle>;
-void ExecScheduleTaskBundle(ScheduleTaskBundleSPtr& scheduleTaskBundle);
 
 }  // namespace bq
@@ -0,0 +1,113 @@
+/*!
+ * \file ScheduleTaskExecutor.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "util/HierarchicalWheel.hpp"
+#include "util/Pch.hpp"
+#include "util/StdExt.hpp"
+
+namespace bq {
+
+struct ScheduleTask;
+using ScheduleTaskSPtr = std::shared_ptr<ScheduleTask>;
+using ScheduleTaskBundle = std::vector<ScheduleTaskSPtr>;
+using ScheduleTaskBundleSPtr = std::shared_ptr<ScheduleTaskBundle>;
+
+class ScheduleTaskExecutor;
+using ScheduleTaskExecutorSPtr = std::shared_ptr<ScheduleTaskExecutor>;
+
+// returns the cur time in us, only the diff between 2 calls is used
+using ScheduleClock = std::function<std::uint64_t()>;
+
+/*
+ * Execs the schedule tasks on a HierarchicalWheel, so each tick only visits
+ * the tasks due in that tick however long their intervals are.
+ *
+ * The time of each exec is measured by the clock and added to the metrics of
+ * the task, an exec longer than the budget of the task is logged as an
+ * overrun. A task that overruns its interval skips the missed execs instead
+ * of running them back to back.
+ *
+ * Tasks with ExecOnDedicatedThread::True run on their own wheel and thread so
+ * a slow task in the bundle never delays them.
+ *
+ * Without start() the executor can be driven by calling advance() directly,
+ * which together with a fake clock makes the timing of the tasks testable.
+ */
+class ScheduleTaskExecutor {
+  struct Entry {
+    std::uint64_t expireTick_{0};
+    ScheduleTaskSPtr scheduleTask_{nullptr};
+  };
+
+ public:
+  static constexpr std::uint32_t DEFAULT_US_OF_TICK = 1000;
+
+  ScheduleTaskExecutor(const ScheduleTaskExecutor&) = delete;
+  ScheduleTaskExecutor& operator=(const ScheduleTaskExecutor&) = delete;
+  ScheduleTaskExecutor(const ScheduleTaskExecutor&&) = delete;
+  ScheduleTaskExecutor& operator=(const ScheduleTaskExecutor&&) = delete;
+
+  ScheduleTaskExecutor(const std::string& moduleName,
+                       const ScheduleTaskBundleSPtr& scheduleTaskBundle,
+                       std::uint32_t usOfTick = DEFAULT_US_OF_TICK,
+                       const ScheduleClock& clock = nullptr);
+  ~ScheduleTaskExecutor();
+
+ public:
+  int start();
+  int stop();
+
+ public:
+  // thread safe, the task is scheduled by the next advance
+  void addScheduleTask(const ScheduleTaskSPtr& scheduleTask);
+
+  // execs the tasks due by the cur time of the clock, including the tasks on
+  // dedicated threads, only call it when the executor is not started
+  void advance();
+
+  std::uint64_t getCurTick() const { return wheel_.getCurTick(); }
+
+ private:
+  std::vector<ScheduleTaskExecutorSPtr> getDedicatedExecutorGroup();
+
+  void advanceWheel();
+  void exec(Entry& entry);
+
+  std::uint64_t getTickOfNow() const;
+  std::uint64_t getTickNumOfInterval(const ScheduleTaskSPtr& scheduleTask);
+
+  void logMetrics(const ScheduleTaskSPtr& scheduleTask) const;
+
+  void run();
+
+ private:
+  const std::string moduleName_;
+  const std::uint32_t usOfTick_;
+  const ScheduleClock clock_;
+  const std::uint64_t usOfStart_;
+
+  HierarchicalWheel<Entry> wheel_;
+
+  std::vector<ScheduleTaskSPtr> scheduleTaskGroupToAdd_;
+  std::ext::spin_mutex mtxScheduleTaskGroupToAdd_;
+
+  // only touched by the thread of the wheel, used to log the metrics at stop
+  std::vector<ScheduleTaskSPtr> scheduleTaskGroup_;
+
+  std::vector<ScheduleTaskExecutorSPtr> dedicatedExecutorGroup_;
+  std::mutex mtxDedicatedExecutorGroup_;
+
+  std::atomic_bool stopped_{true};
+  std::unique_ptr<std::thread> thread_{nullptr};
+};
+
+}  // namespace bq
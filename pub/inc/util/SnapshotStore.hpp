@@ -0,0 +1,361 @@
+/*!
+ * \file SnapshotStore.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/12/29
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "def/StatusCode.hpp"
+#include "util/Logger.hpp"
+#include "util/Pch.hpp"
+#include "util/Scheduler.hpp"
+#include "util/StdExt.hpp"
+
+namespace bq {
+
+enum class OpOfJournal : std::uint8_t { Upsert = 1, Remove = 2 };
+
+/*
+ * Binary snapshot of the recs of a mgr, such as the order infos of OrdMgr,
+ * plus an append only journal of the changes made after it, so that the mgr
+ * can be restored at restart without querying the db. Changes are buffered
+ * by the thread making them and written to the journal by the thread of the
+ * store, a new snapshot is taken once the journal grows large enough.
+ *
+ * Files under rootPath:
+ *   <name>.snapshot      header | numOfRec * rec, replaced by rename
+ *   <name>.journal.<no>  (op | rec)*, the journals from the no saved in the
+ *                        header of the snapshot on are replayed in order
+ *
+ * Recs are saved as raw bytes, a snapshot written by a build with another
+ * layout of Rec is rejected by the size of rec saved in its header. Files are
+ * flushed but not synced, they survive a crash of the process, not of the os.
+ */
+template <typename Rec>
+class SnapshotStore {
+  static_assert(std::is_trivially_copyable_v<Rec>);
+
+  constexpr static std::uint32_t MAGIC_OF_SNAPSHOT = 0x53535142;  // "BQSS"
+  constexpr static std::uint32_t VERSION_OF_SNAPSHOT = 1;
+
+  struct HeaderOfSnapshot {
+    std::uint32_t magic_{MAGIC_OF_SNAPSHOT};
+    std::uint32_t version_{VERSION_OF_SNAPSHOT};
+    std::uint64_t sizeOfRec_{sizeof(Rec)};
+    std::uint64_t noOfJournal_{0};
+    std::uint64_t numOfRec_{0};
+  };
+
+  struct RecOfJournal {
+    OpOfJournal op_;
+    Rec rec_;
+  };
+
+ public:
+  using GetRecGroupCallback = std::function<std::vector<Rec>()>;
+  using ApplyRecCallback = std::function<void(OpOfJournal, const Rec&)>;
+
+  SnapshotStore(const SnapshotStore&) = delete;
+  SnapshotStore& operator=(const SnapshotStore&) = delete;
+  SnapshotStore(const SnapshotStore&&) = delete;
+  SnapshotStore& operator=(const SnapshotStore&&) = delete;
+
+  SnapshotStore(const std::string& rootPath, const std::string& name,
+                const GetRecGroupCallback& getRecGroupCallback,
+                std::uint32_t milliSecIntervalOfFlush = 10,
+                std::uint64_t numOfRecOfJournalToTakeSnapshot = 100000)
+      : rootPath_(rootPath),
+        name_(name),
+        getRecGroupCallback_(getRecGroupCallback),
+        milliSecIntervalOfFlush_(milliSecIntervalOfFlush),
+        numOfRecOfJournalToTakeSnapshot_(numOfRecOfJournalToTakeSnapshot) {}
+
+  ~SnapshotStore() { stop(); }
+
+ public:
+  /*
+   * Applies the recs of the snapshot as upserts and then the recs of the
+   * journals after it in order. A rec cut off at the end of a journal by a
+   * crash is ignored.
+   */
+  int load(const ApplyRecCallback& applyRecCallback) {
+    std::lock_guard<std::mutex> guard(mtxFile_);
+
+    const auto noGroupOfJournal = getNoGroupOfJournal();
+    if (!noGroupOfJournal.empty()) {
+      noOfJournal_ = std::max(noOfJournal_, noGroupOfJournal.back());
+    }
+
+    const auto filenameOfSnapshot = getFilenameOfSnapshot();
+    if (!boost::filesystem::exists(filenameOfSnapshot)) {
+      return SCODE_SNAPSHOT_NOT_EXISTS;
+    }
+
+    std::ifstream in(filenameOfSnapshot, std::ios::binary);
+    HeaderOfSnapshot header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || header.magic_ != MAGIC_OF_SNAPSHOT ||
+        header.version_ != VERSION_OF_SNAPSHOT ||
+        header.sizeOfRec_ != sizeof(Rec)) {
+      LOG_W("Load snapshot {} failed because of invalid header.",
+            filenameOfSnapshot);
+      return SCODE_SNAPSHOT_INVALID_FILE;
+    }
+
+    std::vector<Rec> recGroup(header.numOfRec_);
+    in.read(reinterpret_cast<char*>(recGroup.data()),
+            recGroup.size() * sizeof(Rec));
+    if (!in) {
+      LOG_W("Load snapshot {} failed because of the file is truncated.",
+            filenameOfSnapshot);
+      return SCODE_SNAPSHOT_INVALID_FILE;
+    }
+    for (const auto& rec : recGroup) {
+      applyRecCallback(OpOfJournal::Upsert, rec);
+    }
+
+    std::uint64_t numOfRecOfJournal = 0;
+    for (const auto noOfJournal : noGroupOfJournal) {
+      if (noOfJournal < header.noOfJournal_) continue;
+      std::ifstream inOfJournal(getFilenameOfJournal(noOfJournal),
+                                std::ios::binary);
+      RecOfJournal recOfJournal;
+      while (inOfJournal.read(reinterpret_cast<char*>(&recOfJournal),
+                              sizeof(recOfJournal))) {
+        applyRecCallback(recOfJournal.op_, recOfJournal.rec_);
+        ++numOfRecOfJournal;
+      }
+    }
+
+    LOG_I("Load snapshot {} success. [numOfRec = {}; numOfRecOfJournal = {}]",
+          filenameOfSnapshot, recGroup.size(), numOfRecOfJournal);
+    return 0;
+  }
+
+  // takes a snapshot at once, then flushes the journal every interval
+  int start() {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(rootPath_, ec);
+    if (const auto ret = takeSnapshot(); ret != 0) {
+      return ret;
+    }
+
+    scheduler_ = std::make_shared<Scheduler>(
+        name_,
+        [this]() {
+          flush();
+          if (numOfRecOfJournalSinceSnapshot_ >=
+              numOfRecOfJournalToTakeSnapshot_) {
+            takeSnapshot();
+          }
+        },
+        milliSecIntervalOfFlush_);
+    return scheduler_->start();
+  }
+
+  void stop() {
+    if (scheduler_) {
+      scheduler_->stop();
+      scheduler_.reset();
+    }
+    flush();
+  }
+
+  void append(OpOfJournal op, const Rec& rec) {
+    std::lock_guard<std::ext::spin_mutex> guard(mtxRecGroupOfJournal_);
+    recGroupOfJournal_.emplace_back(RecOfJournal{op, rec});
+  }
+
+  int flush() {
+    std::lock_guard<std::mutex> guard(mtxFile_);
+    return flushJournal();
+  }
+
+  /*
+   * Switches to a new journal before getting the recs, so every change not
+   * in the snapshot is in the new journal or in the ones after it.
+   */
+  int takeSnapshot() {
+    std::lock_guard<std::mutex> guard(mtxFile_);
+    if (const auto ret = flushJournal(); ret != 0) {
+      return ret;
+    }
+    ofsOfJournal_.close();
+    ++noOfJournal_;
+
+    HeaderOfSnapshot header;
+    header.noOfJournal_ = noOfJournal_;
+    const auto recGroup = getRecGroupCallback_();
+    header.numOfRec_ = recGroup.size();
+
+    const auto filenameOfSnapshot = getFilenameOfSnapshot();
+    const auto filenameOfTmp = filenameOfSnapshot + ".tmp";
+    {
+      std::ofstream out(filenameOfTmp, std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out.write(reinterpret_cast<const char*>(recGroup.data()),
+                recGroup.size() * sizeof(Rec));
+      out.flush();
+      if (!out) {
+        LOG_W("Save snapshot {} failed.", filenameOfTmp);
+        return SCODE_SNAPSHOT_SAVE_FAILED;
+      }
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(filenameOfTmp, filenameOfSnapshot, ec);
+    if (ec) {
+      LOG_W("Save snapshot {} failed. [{}]", filenameOfSnapshot, ec.message());
+      return SCODE_SNAPSHOT_SAVE_FAILED;
+    }
+
+    for (const auto noOfJournal : getNoGroupOfJournal()) {
+      if (noOfJournal >= noOfJournal_) continue;
+      boost::filesystem::remove(getFilenameOfJournal(noOfJournal), ec);
+    }
+    numOfRecOfJournalSinceSnapshot_ = 0;
+
+    LOG_D("Save snapshot {} success. [numOfRec = {}]", filenameOfSnapshot,
+          recGroup.size());
+    return 0;
+  }
+
+ private:
+  /*
+   * On a failure the recs are put back in front of the ones appended since,
+   * and the journal is cut back to the end of the last rec written in full,
+   * so a torn rec never sits in front of the recs appended after it.
+   */
+  int flushJournal() {
+    std::vector<RecOfJournal> recGroupOfJournal;
+    {
+      std::lock_guard<std::ext::spin_mutex> guard(mtxRecGroupOfJournal_);
+      std::swap(recGroupOfJournal, recGroupOfJournal_);
+    }
+    if (recGroupOfJournal.empty()) return 0;
+
+    const auto filenameOfJournal = getFilenameOfJournal(noOfJournal_);
+    if (!ofsOfJournal_.is_open()) {
+      openJournal(filenameOfJournal);
+    }
+    const auto sizeOfRecGroup = recGroupOfJournal.size() * sizeof(RecOfJournal);
+    ofsOfJournal_.write(
+        reinterpret_cast<const char*>(recGroupOfJournal.data()),
+        sizeOfRecGroup);
+    ofsOfJournal_.flush();
+    if (!ofsOfJournal_) {
+      LOG_W("Save journal {} failed. [num = {}]", filenameOfJournal,
+            recGroupOfJournal.size());
+      ofsOfJournal_.close();
+      boost::system::error_code ec;
+      boost::filesystem::resize_file(filenameOfJournal, offsetOfJournal_, ec);
+      {
+        std::lock_guard<std::ext::spin_mutex> guard(mtxRecGroupOfJournal_);
+        recGroupOfJournal.insert(std::end(recGroupOfJournal),
+                                 std::begin(recGroupOfJournal_),
+                                 std::end(recGroupOfJournal_));
+        std::swap(recGroupOfJournal, recGroupOfJournal_);
+      }
+      return SCODE_SNAPSHOT_SAVE_JOURNAL_FAILED;
+    }
+    offsetOfJournal_ += sizeOfRecGroup;
+    numOfRecOfJournalSinceSnapshot_ += recGroupOfJournal.size();
+    return 0;
+  }
+
+  // a rec torn by a crash or a failed write is cut off before appending
+  void openJournal(const std::string& filenameOfJournal) {
+    boost::system::error_code ec;
+    const auto sizeOfFile = boost::filesystem::file_size(filenameOfJournal, ec);
+    offsetOfJournal_ =
+        ec ? 0 : sizeOfFile - sizeOfFile % sizeof(RecOfJournal);
+    if (!ec && offsetOfJournal_ != sizeOfFile) {
+      boost::filesystem::resize_file(filenameOfJournal, offsetOfJournal_, ec);
+    }
+    ofsOfJournal_.clear();
+    ofsOfJournal_.open(filenameOfJournal, std::ios::binary | std::ios::app);
+  }
+
+  std::string getFilenameOfSnapshot() const {
+    return (boost::filesystem::path(rootPath_) / (name_ + ".snapshot"))
+        .string();
+  }
+
+  std::string getFilenameOfJournal(std::uint64_t noOfJournal) const {
+    return (boost::filesystem::path(rootPath_) /
+            fmt::format("{}.journal.{}", name_, noOfJournal))
+        .string();
+  }
+
+  std::vector<std::uint64_t> getNoGroupOfJournal() const {
+    std::vector<std::uint64_t> ret;
+    boost::system::error_code ec;
+    if (!boost::filesystem::is_directory(rootPath_, ec)) return ret;
+
+    const auto prefix = name_ + ".journal.";
+    for (const auto& entry :
+         boost::filesystem::directory_iterator(rootPath_, ec)) {
+      const auto filename = entry.path().filename().string();
+      if (!boost::starts_with(filename, prefix)) continue;
+      const auto noInStrFmt = filename.substr(prefix.size());
+      if (noInStrFmt.empty() ||
+          !std::all_of(std::begin(noInStrFmt), std::end(noInStrFmt),
+                       [](char ch) { return std::isdigit(ch); })) {
+        continue;
+      }
+      ret.emplace_back(std::stoull(noInStrFmt));
+    }
+    std::sort(std::begin(ret), std::end(ret));
+    return ret;
+  }
+
+ private:
+  const std::string rootPath_;
+  const std::string name_;
+  const GetRecGroupCallback getRecGroupCallback_;
+  const std::uint32_t milliSecIntervalOfFlush_;
+  const std::uint64_t numOfRecOfJournalToTakeSnapshot_;
+
+  std::vector<RecOfJournal> recGroupOfJournal_;
+  std::ext::spin_mutex mtxRecGroupOfJournal_;
+
+  std::mutex mtxFile_;
+  std::ofstream ofsOfJournal_;
+  std::uint64_t offsetOfJournal_{0};
+  std::uint64_t noOfJournal_{0};
+  std::atomic<std::uint64_t> numOfRecOfJournalSinceSnapshot_{0};
+
+  SchedulerSPtr scheduler_{nullptr};
+};
+
+template <typename Rec>
+using SnapshotStoreSPtr = std::shared_ptr<SnapshotStore<Rec>>;
+
+/*
+ * Makes the store of the mgr named name as configured under snapshotStore of
+ * the node, returns nullptr if it is not enabled.
+ */
+template <typename Rec>
+SnapshotStoreSPtr<Rec> MakeSnapshotStore(
+    const YAML::Node& node, const std::string& name,
+    const typename SnapshotStore<Rec>::GetRecGroupCallback&
+        getRecGroupCallback) {
+  const auto nodeOfSnapshotStore = node["snapshotStore"];
+  if (name.empty() || !nodeOfSnapshotStore ||
+      !nodeOfSnapshotStore["enable"].as<bool>(false)) {
+    return nullptr;
+  }
+  return std::make_shared<SnapshotStore<Rec>>(
+      nodeOfSnapshotStore["rootPath"].as<std::string>("data/snapshot"), name,
+      getRecGroupCallback,
+      nodeOfSnapshotStore["milliSecIntervalOfFlush"].as<std::uint32_t>(10),
+      nodeOfSnapshotStore["numOfRecOfJournalToTakeSnapshot"]
+          .as<std::uint64_t>(100000));
+}
+
+}  // namespace bq
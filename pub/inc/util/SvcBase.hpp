@@ -23,6 +23,9 @@ enum class InstallSignalHandler { True = 1, False = 2 };
 class SignalHandler;
 using SignalHandlerSPtr = std::shared_ptr<SignalHandler>;
 
+class Scheduler;
+using SchedulerSPtr = std::shared_ptr<Scheduler>;
+
 class SvcBase {
  public:
   SvcBase(const SvcBase&) = delete;
@@ -68,6 +71,10 @@ class SvcBase {
  private:
   InstallSignalHandler installSignalHandler{InstallSignalHandler::True};
   SignalHandlerSPtr signalHandler_{nullptr};
+
+  // logs the latency stat of the probes installed by LATENCY_PROBE
+  SchedulerSPtr schedulerOfLatencyStat_{nullptr};
+  inline const static std::uint32_t MILLI_SEC_INTERVAL_OF_LATENCY_STAT{60000};
 };
 
 }  // namespace bq
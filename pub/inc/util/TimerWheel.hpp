@@ -0,0 +1,74 @@
+/*!
+ * \file TimerWheel.hpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#pragma once
+
+#include "util/HierarchicalWheel.hpp"
+#include "util/Pch.hpp"
+
+namespace bq {
+
+class TimerWheel;
+using TimerWheelSPtr = std::shared_ptr<TimerWheel>;
+
+/*
+ * Timers on a HierarchicalWheel, adding a timer costs O(1) and each tick only
+ * visits the timers due in it. Timers are added from any thread through a
+ * lock free queue and fired on the thread of the wheel in the order of their
+ * deadline. The queue keeps no order across producers, so timers with the
+ * same deadline fire in no particular order, callers must not rely on it.
+ *
+ * Without start() the wheel can be driven by calling advance() directly.
+ */
+class TimerWheel {
+  using Callback = std::function<void()>;
+
+  struct Timer {
+    std::uint64_t expireTick_{0};
+    Callback callback_{nullptr};
+  };
+
+ public:
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+  TimerWheel(const TimerWheel&&) = delete;
+  TimerWheel& operator=(const TimerWheel&&) = delete;
+
+  explicit TimerWheel(const std::string& moduleName,
+                      std::uint32_t milliSecOfTick = 1);
+  ~TimerWheel();
+
+ public:
+  void start();
+  void stop();
+
+ public:
+  void addTimer(std::uint32_t milliSecDelay, const Callback& callback);
+
+  void advance();
+  std::uint64_t getCurTick() const { return wheel_.getCurTick(); }
+
+ private:
+  void run();
+
+ private:
+  const std::string moduleName_;
+  const std::uint32_t milliSecOfTick_;
+
+  HierarchicalWheel<Timer> wheel_;
+  std::atomic<std::uint64_t> tickOfAdd_{0};
+
+  moodycamel::ConcurrentQueue<Timer> timerGroupToAdd_;
+
+  std::atomic_bool stopped_{true};
+  std::unique_ptr<std::thread> thread_{nullptr};
+};
+
+}  // namespace bq
@@ -27,10 +27,12 @@ int DBConnpool::init() {
     for (int no = 0; no < connPoolSize; ++no) {
       auto connProperties = makeConnProperties(dbEngParam_);
       std::shared_ptr<sql::Connection> sqlConn(driver->connect(connProperties));
+      const auto conn = std::make_shared<Conn>(no, sqlConn);
       {
         std::lock_guard<std::ext::spin_mutex> lock(mtxConnGroup_);
-        connGroup_.emplace_back(std::make_shared<Conn>(no, true, sqlConn));
+        connGroup_.emplace_back(conn);
       }
+      idleConnPool_.giveBack(conn);
     }
   } catch (const std::exception& e) {
     LOG_E("Init failed. [{}]", e.what());
@@ -56,28 +58,14 @@ std::uint32_t DBConnpool::getSize() const {
   return connGroup_.size();
 }
 
-ConnSPtr DBConnpool::getIdleConn() const {
-  while (true) {
-    {
-      std::lock_guard<std::ext::spin_mutex> lock(mtxConnGroup_);
-      for (const auto& conn : connGroup_) {
-        if (conn->idle_) {
-          conn->idle_ = false;
-          return conn;
-        }
-      }
-    }
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-  }
-}
+ConnSPtr DBConnpool::getIdleConn() const { return idleConnPool_.take(); }
 
 void DBConnpool::giveBackConn(const ConnSPtr& conn) {
-  std::lock_guard<std::ext::spin_mutex> lock(mtxConnGroup_);
-  for (const auto& curConn : connGroup_) {
-    if (curConn->no_ == conn->no_) {
-      curConn->idle_ = true;
-    }
-  }
+  idleConnPool_.giveBack(conn);
+}
+
+std::string DBConnpool::getWaitHistStr() const {
+  return idleConnPool_.getWaitHist().toStr();
 }
 
 }  // namespace bq::db
@@ -49,6 +49,10 @@ void DBEng::start() {
 void DBEng::stop() {
   LOG_D("[{}] Begin to stop db engine.", dbEngParam_->svcName_);
   dbEngAsync_->stop();
+  LOG_I("[{}] Wait hist of sync connpool. [{}]", dbEngParam_->svcName_,
+        dbEngSync_->getWaitHistStrOfConnpool());
+  LOG_I("[{}] Wait hist of async connpool. [{}]", dbEngParam_->svcName_,
+        dbEngAsync_->getWaitHistStrOfConnpool());
 }
 
 std::tuple<int, std::string> DBEng::syncExec(const std::string& identity,
@@ -59,8 +63,11 @@ std::tuple<int, std::string> DBEng::syncExec(const std::string& identity,
 
 std::tuple<int, std::string> DBEng::asyncExec(const std::string& identity,
                                               const std::string& sql,
-                                              WriteLog writeLog) {
-  return dbEngAsync_->execUSP(identity, sql, writeLog);
+                                              WriteLog writeLog,
+                                              const std::string& keyOfPartition,
+                                              Coalesce coalesce) {
+  return dbEngAsync_->asyncExecSql(identity, sql, writeLog, keyOfPartition,
+                                   coalesce);
 }
 
 }  // namespace bq::db
@@ -22,55 +22,75 @@ namespace bq::db {
 
 DBEngAsync::DBEngAsync(const DBEngParamSPtr& dbEngParam,
                        const CBOnExecRet& cbOnExecRet)
-    : DBEngImpl(dbEngParam, ConnType::Async), cbOnExecRet_(cbOnExecRet) {}
+    : DBEngImpl(dbEngParam, ConnType::Async), cbOnExecRet_(cbOnExecRet) {
+  const auto numOfTaskQueue =
+      std::max(1, dbEngParam_->connPoolSizeOfAsyncReq_);
+  for (int i = 0; i < numOfTaskQueue; ++i) {
+    taskQueueGroup_.emplace_back(std::make_shared<TaskQueue>());
+  }
+}
 
 std::tuple<int, std::string> DBEngAsync::asyncOrSyncExecSql(
     const std::string& identity, const std::string& sql, WriteLog writeLog) {
-  return asyncExecSql(identity, sql, writeLog);
+  return asyncExecSql(identity, sql, writeLog, "", Coalesce::False);
 }
 
 std::tuple<int, std::string> DBEngAsync::asyncExecSql(
-    const std::string& identity, const std::string& sql, WriteLog writeLog) {
-  const auto dbTask = std::make_shared<bq::db::DBTask>(identity, sql, writeLog);
-  taskQueue_.enqueue(dbTask);
+    const std::string& identity, const std::string& sql, WriteLog writeLog,
+    const std::string& keyOfPartition, Coalesce coalesce) {
+  const auto dbTask = std::make_shared<bq::db::DBTask>(
+      identity, sql, writeLog, keyOfPartition, coalesce);
+  const auto no = keyOfPartition.empty()
+                      ? noOfTaskWithoutPartition_.fetch_add(1)
+                      : std::hash<std::string>{}(keyOfPartition);
+  taskQueueGroup_[no % taskQueueGroup_.size()]->enqueue(dbTask);
   return {0, ""};
 }
 
 void DBEngAsync::start() {
-  for (std::uint32_t i = 0; i < connPool_->getSize(); ++i) {
-    threadPool_.emplace_back(std::thread([this]() { doStart(); }));
+  for (auto& taskQueue : taskQueueGroup_) {
+    threadPool_.emplace_back(
+        std::thread([this, taskQueue]() { doStart(*taskQueue); }));
   }
 }
 
-void DBEngAsync::doStart() {
-  while (stopped_ == false || taskQueue_.size_approx() != 0) {
-    checkUnprocessedTaskAndAlert(taskQueue_);
-    bq::db::DBTaskSPtr dbTask;
-    if (taskQueue_.wait_dequeue_timed(
-            dbTask,
-            std::chrono::milliseconds(dbEngParam_->timeDurOfWaitForTask_))) {
-      handleTask(dbTask);
-    } else {
-      continue;
-    }
+void DBEngAsync::doStart(TaskQueue& taskQueue) {
+  const auto maxNumOfTaskInBatch = dbEngParam_->maxNumOfTaskInBatch_;
+  DBTaskGroup dbTaskGroup;
+  while (stopped_ == false || taskQueue.size_approx() != 0) {
+    checkUnprocessedTaskAndAlert(taskQueue);
+    dbTaskGroup.resize(maxNumOfTaskInBatch);
+    const auto num = taskQueue.wait_dequeue_bulk_timed(
+        std::begin(dbTaskGroup), maxNumOfTaskInBatch,
+        std::chrono::milliseconds(dbEngParam_->timeDurOfWaitForTask_));
+    if (num == 0) continue;
+    dbTaskGroup.resize(num);
+    handleTaskGroup(dbTaskGroup);
   }
 }
 
-void DBEngAsync::checkUnprocessedTaskAndAlert(
-    const moodycamel::BlockingConcurrentQueue<DBTaskSPtr>& taskQueue) {
+void DBEngAsync::checkUnprocessedTaskAndAlert(const TaskQueue& taskQueue) {
   if (taskQueue.size_approx() > 0 &&
       taskQueue.size_approx() % dbEngParam_->numOfUnprocessedTaskAlert_ == 0) {
     LOG_W("[{}] Too many unprocessed task. [num = {}].", dbEngParam_->svcName_,
-          taskQueue_.size_approx());
+          taskQueue.size_approx());
   }
 }
 
-void DBEngAsync::handleTask(DBTaskSPtr& dbTask) {
-  const auto [retOfExec, ret] =
-      execSql(dbTask->identity_, dbTask->sql_, dbTask->writeLog_);
-  const auto jsonFmtOfRet =
-      std::make_shared<std::string>(fmt::format("{}{}{}", "{", ret, "}"));
-  if (cbOnExecRet_) cbOnExecRet_(dbTask, jsonFmtOfRet);
+void DBEngAsync::handleTaskGroup(DBTaskGroup& dbTaskGroup) {
+  CoalesceTaskGroup(dbTaskGroup);
+  const auto execRetGroup = execTaskGroup(dbTaskGroup);
+  for (std::size_t i = 0; i < dbTaskGroup.size(); ++i) {
+    const auto& [retOfExec, ret] = execRetGroup[i];
+    const auto jsonFmtOfRet =
+        std::make_shared<std::string>(fmt::format("{}{}{}", "{", ret, "}"));
+    if (cbOnExecRet_) cbOnExecRet_(dbTaskGroup[i], jsonFmtOfRet);
+  }
+}
+
+std::vector<std::tuple<int, std::string>> DBEngAsync::execTaskGroup(
+    const DBTaskGroup& dbTaskGroup) {
+  return execSqlGroup(dbTaskGroup);
 }
 
 void DBEngAsync::stop() {
@@ -82,4 +102,27 @@ void DBEngAsync::stop() {
   }
 }
 
+void CoalesceTaskGroup(DBTaskGroup& dbTaskGroup) {
+  // keys of partition of which a later task of coalesce has been kept
+  std::set<std::string> keyOfPartitionGroupSuperseded;
+  DBTaskGroup ret;
+  ret.reserve(dbTaskGroup.size());
+  for (auto iter = std::rbegin(dbTaskGroup); iter != std::rend(dbTaskGroup);
+       ++iter) {
+    const auto& dbTask = *iter;
+    if (dbTask->keyOfPartition_.empty()) {
+      ret.emplace_back(dbTask);
+    } else if (dbTask->coalesce_ == Coalesce::False) {
+      keyOfPartitionGroupSuperseded.erase(dbTask->keyOfPartition_);
+      ret.emplace_back(dbTask);
+    } else {
+      const auto [_, isTheLast] =
+          keyOfPartitionGroupSuperseded.emplace(dbTask->keyOfPartition_);
+      if (isTheLast) ret.emplace_back(dbTask);
+    }
+  }
+  std::reverse(std::begin(ret), std::end(ret));
+  dbTaskGroup.swap(ret);
+}
+
 }  // namespace bq::db
@@ -12,6 +12,7 @@
 
 #include "db/DBConnpool.hpp"
 #include "db/DBEngDef.hpp"
+#include "db/DBTask.hpp"
 #include "def/Const.hpp"
 #include "util/Logger.hpp"
 #include "util/Pch.hpp"
@@ -26,6 +27,10 @@ DBEngImpl::DBEngImpl(const DBEngParamSPtr& dbEngParam, ConnType connType)
 
 int DBEngImpl::init() { return connPool_->init(); }
 
+std::string DBEngImpl::getWaitHistStrOfConnpool() const {
+  return connPool_->getWaitHistStr();
+}
+
 std::tuple<int, std::string> DBEngImpl::execUSP(const std::string& identity,
                                                 const std::string& sql,
                                                 WriteLog writeLog) {
@@ -66,6 +71,86 @@ std::tuple<int, std::string> DBEngImpl::execSql(const std::string& identity,
   return {0, jsonFmtOfRet};
 }
 
+namespace {
+
+// a usp runs its own transaction, whose commit also commits the outer one
+bool IsCallOfUSP(const std::string& sql) {
+  const auto pos = sql.find_first_not_of(" \t\r\n");
+  return pos != std::string::npos &&
+         strncasecmp(sql.c_str() + pos, "call", 4) == 0;
+}
+
+}  // namespace
+
+std::vector<std::tuple<int, std::string>> DBEngImpl::execSqlGroup(
+    const DBTaskGroup& dbTaskGroup) {
+  std::vector<std::tuple<int, std::string>> ret;
+  DBTaskGroup dbTaskGroupOfTrans;
+  for (const auto& dbTask : dbTaskGroup) {
+    if (!IsCallOfUSP(dbTask->sql_)) {
+      dbTaskGroupOfTrans.emplace_back(dbTask);
+      continue;
+    }
+    execSqlGroupInTrans(dbTaskGroupOfTrans, ret);
+    dbTaskGroupOfTrans.clear();
+    ret.emplace_back(
+        execSql(dbTask->identity_, dbTask->sql_, dbTask->writeLog_));
+  }
+  execSqlGroupInTrans(dbTaskGroupOfTrans, ret);
+  return ret;
+}
+
+void DBEngImpl::execSqlGroupInTrans(
+    const DBTaskGroup& dbTaskGroup,
+    std::vector<std::tuple<int, std::string>>& ret) {
+  if (dbTaskGroup.empty()) return;
+  if (dbTaskGroup.size() == 1) {
+    const auto& dbTask = dbTaskGroup.front();
+    ret.emplace_back(
+        execSql(dbTask->identity_, dbTask->sql_, dbTask->writeLog_));
+    return;
+  }
+
+  const auto numOfRetBefore = ret.size();
+  auto conn = connPool_->getIdleConn();
+  try {
+    conn->sqlConn_->setAutoCommit(false);
+    for (const auto& dbTask : dbTaskGroup) {
+      const auto jsonFmtOfRet = execSqlImpl(conn, dbTask->sql_);
+      ret.emplace_back(0,
+                       getJsonFmtOfStatus(0, "Success") + "," + jsonFmtOfRet);
+      if (dbTask->writeLog_ == WriteLog::True) {
+        LOG_D("Exec sql success. [conn no = {}, identity = {}, sql = {}]",
+              conn->no_, dbTask->identity_, dbTask->sql_);
+      }
+    }
+    conn->sqlConn_->commit();
+    conn->sqlConn_->setAutoCommit(true);
+  } catch (const std::exception& e) {
+    try {
+      conn->sqlConn_->rollback();
+      conn->sqlConn_->setAutoCommit(true);
+    } catch (const std::exception& eOfRollback) {
+      LOG_E("Rollback sql group exception. [conn no = {}, exception = {}]",
+            conn->no_, eOfRollback.what());
+    }
+    connPool_->giveBackConn(conn);
+    LOG_W(
+        "Exec sql group exception, exec them one by one. "
+        "[conn no = {}, num = {}, exception = {}]",
+        conn->no_, dbTaskGroup.size(), e.what());
+    // no usp is in the transaction, so the rollback undid all of it
+    ret.resize(numOfRetBefore);
+    for (const auto& dbTask : dbTaskGroup) {
+      ret.emplace_back(
+          execSql(dbTask->identity_, dbTask->sql_, dbTask->writeLog_));
+    }
+    return;
+  }
+
+  connPool_->giveBackConn(conn);
+}
+
 std::string DBEngImpl::execSqlImpl(const ConnSPtr& conn,
                                    const std::string& sql) {
   std::shared_ptr<sql::PreparedStatement> pstmt;
@@ -20,7 +20,8 @@ DBEngParam::DBEngParam(const std::string& svcName, const std::string& host,
                        const std::string& password, const std::string& dbname,
                        int connPoolSizeOfSyncReq, int connPoolSizeOfAsyncReq,
                        std::uint32_t numOfUnprocessedTaskAlert,
-                       std::uint32_t timeDurOfWaitForTask)
+                       std::uint32_t timeDurOfWaitForTask,
+                       std::uint32_t maxNumOfTaskInBatch)
     : svcName_(svcName),
       host_(host),
       port_(port),
@@ -30,7 +31,8 @@ DBEngParam::DBEngParam(const std::string& svcName, const std::string& host,
       connPoolSizeOfSyncReq_(connPoolSizeOfSyncReq),
       connPoolSizeOfAsyncReq_(connPoolSizeOfAsyncReq),
       numOfUnprocessedTaskAlert_(numOfUnprocessedTaskAlert),
-      timeDurOfWaitForTask_(timeDurOfWaitForTask) {}
+      timeDurOfWaitForTask_(timeDurOfWaitForTask),
+      maxNumOfTaskInBatch_(maxNumOfTaskInBatch) {}
 
 std::tuple<int, DBEngParamSPtr> MakeDBEngParam(
     const std::string& dbEngParamInStrFmt) {
@@ -85,6 +87,13 @@ std::tuple<int, DBEngParamSPtr> MakeDBEngParam(
     fieldValue = dbEngParamTable[fieldName];
     ret->timeDurOfWaitForTask_ = CONV(std::uint32_t, fieldValue);
 
+    fieldName = "maxnumoftaskinbatch";
+    fieldValue = dbEngParamTable[fieldName];
+    ret->maxNumOfTaskInBatch_ = CONV(std::uint32_t, fieldValue);
+    if (ret->maxNumOfTaskInBatch_ == 0) {
+      throw std::invalid_argument("max num of task in batch is 0");
+    }
+
   } catch (const std::exception& e) {
     LOG_E("Make db engine param failed because of invalid field info of {}. {}",
           fieldName, e.what());
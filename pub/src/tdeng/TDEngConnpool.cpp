@@ -40,12 +40,14 @@ int TDEngConnpool::init() {
       std::lock_guard<std::ext::spin_mutex> lock(mtxConnGroup_);
       connGroup_.emplace_back(conn);
     }
+    idleConnPool_.giveBack(conn);
   }
 
   return 0;
 }
 
 void TDEngConnpool::uninit() {
+  LOG_I("Wait hist of tdeng connpool. [{}]", getWaitHistStr());
   for (int no = 0; no < tdEngParam_->connPoolSize_; ++no) {
     {
       std::lock_guard<std::ext::spin_mutex> lock(mtxConnGroup_);
@@ -62,29 +64,14 @@ std::uint32_t TDEngConnpool::getSize() const {
   }
 }
 
-ConnSPtr TDEngConnpool::getIdleConn() const {
-  while (true) {
-    {
-      std::lock_guard<std::ext::spin_mutex> lock(mtxConnGroup_);
-      for (const auto& conn : connGroup_) {
-        if (conn->idle_) {
-          conn->idle_ = false;
-          return conn;
-        }
-      }
-    }
-    LOG_I("Wait for idle connection. ");
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-  }
-}
+ConnSPtr TDEngConnpool::getIdleConn() const { return idleConnPool_.take(); }
 
 void TDEngConnpool::giveBackConn(const ConnSPtr& conn) {
-  std::lock_guard<std::ext::spin_mutex> lock(mtxConnGroup_);
-  for (const auto& curConn : connGroup_) {
-    if (curConn->no_ == conn->no_) {
-      curConn->idle_ = true;
-    }
-  }
+  idleConnPool_.giveBack(conn);
+}
+
+std::string TDEngConnpool::getWaitHistStr() const {
+  return idleConnPool_.getWaitHist().toStr();
 }
 
 }  // namespace bq::tdeng
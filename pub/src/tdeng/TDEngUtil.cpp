@@ -171,4 +171,92 @@ std::tuple<int, std::string, int, std::string> QueryDataFromTDEng(
   return {statusCode, statusMsg, recNum, recSet};
 }
 
+namespace {
+
+ColumnType GetColumnTypeByTypeOfTDEng(int type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return ColumnType::Int8;
+    case TSDB_DATA_TYPE_UTINYINT:
+      return ColumnType::UInt8;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return ColumnType::Int16;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return ColumnType::UInt16;
+    case TSDB_DATA_TYPE_INT:
+      return ColumnType::Int32;
+    case TSDB_DATA_TYPE_UINT:
+      return ColumnType::UInt32;
+    case TSDB_DATA_TYPE_BIGINT:
+      return ColumnType::Int64;
+    case TSDB_DATA_TYPE_UBIGINT:
+      return ColumnType::UInt64;
+    case TSDB_DATA_TYPE_FLOAT:
+      return ColumnType::Float;
+    case TSDB_DATA_TYPE_DOUBLE:
+      return ColumnType::Double;
+    case TSDB_DATA_TYPE_BOOL:
+      return ColumnType::Bool;
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return ColumnType::Timestamp;
+    default:
+      return ColumnType::Str;
+  }
+}
+
+}  // namespace
+
+RecSetSourceOfTDEng::RecSetSourceOfTDEng(const TDEngConnpoolSPtr &tdEngConnpool,
+                                         const std::string &sql)
+    : tdEngConnpool_(tdEngConnpool), sql_(sql) {}
+
+RecSetSourceOfTDEng::~RecSetSourceOfTDEng() {
+  if (res_ != nullptr) {
+    taos_free_result(res_);
+  }
+  if (conn_ != nullptr) {
+    tdEngConnpool_->giveBackConn(conn_);
+  }
+}
+
+std::tuple<int, std::string> RecSetSourceOfTDEng::init() {
+  conn_ = tdEngConnpool_->getIdleConn();
+  res_ = taos_query(conn_->taos_, sql_.c_str());
+  const auto errorCode = taos_errno(res_);
+  if (errorCode != 0) {
+    const auto statusMsg = fmt::format("Exec sql of tdeng failed. [{} - {}]",
+                                       errorCode, taos_errstr(res_));
+    LOG_W(statusMsg);
+    return {SCODE_TDENG_EXEC_SQL_FAILED, statusMsg};
+  }
+
+  const auto fields = taos_fetch_fields(res_);
+  const auto fieldsNum = taos_num_fields(res_);
+  for (auto i = 0; i < fieldsNum; ++i) {
+    columnInfoGroup_.emplace_back(
+        ColumnInfo{fields[i].name, GetColumnTypeByTypeOfTDEng(fields[i].type)});
+  }
+  return {0, ""};
+}
+
+std::tuple<int, std::string> RecSetSourceOfTDEng::fetchRec(
+    void *const *&valueGroup, const int *&lenGroup) {
+  const auto row = taos_fetch_row(res_);
+  if (row == nullptr) {
+    // a null row is also returned when the fetch fails
+    const auto errorCode = taos_errno(res_);
+    if (errorCode != 0) {
+      const auto statusMsg = fmt::format(
+          "Fetch rec of tdeng failed. [{} - {}]", errorCode, taos_errstr(res_));
+      LOG_W(statusMsg);
+      return {SCODE_TDENG_FETCH_REC_FAILED, statusMsg};
+    }
+    valueGroup = nullptr;
+    return {0, ""};
+  }
+  valueGroup = row;
+  lenGroup = taos_fetch_lengths(res_);
+  return {0, ""};
+}
+
 }  // namespace bq::tdeng
@@ -0,0 +1,176 @@
+/*!
+ * \file BinLogger.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "util/BinLogger.hpp"
+
+namespace bq {
+
+BinLogRing::BinLogRing(std::size_t capacity) {
+  std::size_t capacityOfPow2 = 64;
+  while (capacityOfPow2 < capacity) capacityOfPow2 <<= 1;
+  buf_.resize(capacityOfPow2);
+  mask_ = capacityOfPow2 - 1;
+}
+
+void* BinLogRing::alloc(std::size_t len) {
+  const std::uint64_t lenOfRec = (sizeof(Header) + len + 15) & ~15ULL;
+  const auto capacity = buf_.size();
+  if (lenOfRec > capacity / 2) {
+    numOfDropped_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  const auto offset = tailOfAlloc_ & mask_;
+  const auto lenOfPadding =
+      offset + lenOfRec > capacity ? capacity - offset : 0;
+  const auto newTail = tailOfAlloc_ + lenOfPadding + lenOfRec;
+  if (newTail - headOfProducer_ > capacity) {
+    headOfProducer_ = head_.load(std::memory_order_acquire);
+    if (newTail - headOfProducer_ > capacity) {
+      numOfDropped_.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+  }
+
+  if (lenOfPadding != 0) {
+    const auto padding = reinterpret_cast<Header*>(buf_.data() + offset);
+    padding->len_ = lenOfPadding;
+    padding->isPadding_ = 1;
+  }
+
+  const auto header = reinterpret_cast<Header*>(
+      buf_.data() + ((tailOfAlloc_ + lenOfPadding) & mask_));
+  header->len_ = lenOfRec;
+  header->isPadding_ = 0;
+  tailOfAlloc_ = newTail;
+  return header + 1;
+}
+
+const void* BinLogRing::front() {
+  while (true) {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head == tailOfConsumer_) {
+      tailOfConsumer_ = tail_.load(std::memory_order_acquire);
+      if (head == tailOfConsumer_) return nullptr;
+    }
+    const auto header =
+        reinterpret_cast<const Header*>(buf_.data() + (head & mask_));
+    if (header->isPadding_ == 0) return header + 1;
+    head_.store(head + header->len_, std::memory_order_release);
+  }
+}
+
+void BinLogRing::pop() {
+  const auto head = head_.load(std::memory_order_relaxed);
+  const auto header =
+      reinterpret_cast<const Header*>(buf_.data() + (head & mask_));
+  head_.store(head + header->len_, std::memory_order_release);
+}
+
+namespace {
+
+// closes the ring of a thread when the thread exits
+struct RingOfCurThread {
+  ~RingOfCurThread() {
+    if (ring_) ring_->close();
+  }
+  BinLogRingSPtr ring_{nullptr};
+};
+
+}  // namespace
+
+BinLogger::~BinLogger() { stop(); }
+
+void BinLogger::stop() {
+  std::lock_guard<std::mutex> guard(mtxThreadConsume_);
+  stopped_ = true;
+  if (threadConsume_.joinable()) {
+    threadConsume_.join();
+  }
+}
+
+BinLogRing* BinLogger::getRingOfCurThread() {
+  thread_local RingOfCurThread ringOfCurThread;
+  if (ringOfCurThread.ring_ == nullptr) {
+    ringOfCurThread.ring_ = std::make_shared<BinLogRing>(CAPACITY_OF_RING);
+    {
+      std::lock_guard<std::ext::spin_mutex> guard(mtxRingGroup_);
+      ringGroup_.emplace_back(ringOfCurThread.ring_);
+    }
+    std::lock_guard<std::mutex> guard(mtxThreadConsume_);
+    if (!threadConsume_.joinable() && !stopped_) start();
+  }
+  return ringOfCurThread.ring_.get();
+}
+
+void BinLogger::flush() { consume(); }
+
+void BinLogger::start() {
+  threadConsume_ = std::thread([this]() {
+    while (!stopped_) {
+      if (consume() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(MS_OF_IDLE));
+      }
+    }
+    consume();
+  });
+}
+
+std::size_t BinLogger::consume() {
+  std::lock_guard<std::mutex> guardOfConsume(mtxConsume_);
+
+  std::vector<BinLogRingSPtr> ringGroup;
+  {
+    std::lock_guard<std::ext::spin_mutex> guard(mtxRingGroup_);
+    ringGroup = ringGroup_;
+  }
+
+  const auto logger = GetLogger(loggerOfConsumer_, "");
+  std::size_t numOfRec = 0;
+  std::uint64_t numOfDropped = 0;
+  std::uint64_t numOfDroppedOfClosedRing = 0;
+  for (const auto& ring : ringGroup) {
+    // the ring is closed before the last rec of its thread is seen
+    const auto closed = ring->closed();
+    while (const auto front = ring->front()) {
+      const auto rec = static_cast<const BinLogRec*>(front);
+      try {
+        const auto msg = rec->formatBinLogArg_(rec->meta_->fmtStr_, rec + 1);
+        logger->log(rec->logTime_, rec->meta_->loc_, rec->meta_->level_, msg);
+      } catch (const std::exception& e) {
+        std::cerr << fmt::format("Log bin log {} failed. [{}]",
+                                 rec->meta_->fmtStr_, e.what())
+                  << std::endl;
+      }
+      ring->pop();
+      ++numOfRec;
+    }
+    numOfDropped += ring->numOfDropped();
+
+    if (closed) {
+      std::lock_guard<std::ext::spin_mutex> guard(mtxRingGroup_);
+      ringGroup_.erase(std::remove(std::begin(ringGroup_),
+                                   std::end(ringGroup_), ring),
+                       std::end(ringGroup_));
+      numOfDroppedOfClosedRing += ring->numOfDropped();
+    }
+  }
+
+  if (numOfDropped > numOfDroppedLogged_) {
+    logger->warn("Drop {} bin logs because of the ring is full.",
+                 numOfDropped - numOfDroppedLogged_);
+    numOfDroppedLogged_ = numOfDropped;
+  }
+  numOfDroppedLogged_ -= numOfDroppedOfClosedRing;
+
+  return numOfRec;
+}
+
+}  // namespace bq
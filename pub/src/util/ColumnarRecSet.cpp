@@ -0,0 +1,316 @@
+/*!
+ * \file ColumnarRecSet.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/12/29
+ *
+ * \brief
+ */
+
+#include "util/ColumnarRecSet.hpp"
+
+#include "def/StatusCode.hpp"
+#include "util/Logger.hpp"
+
+namespace bq {
+
+namespace {
+
+template <typename T>
+void Append(std::string& out, T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool Read(const std::string& data, std::size_t& offset, T& value) {
+  if (offset + sizeof(value) > data.size()) return false;
+  memcpy(&value, data.data() + offset, sizeof(value));
+  offset += sizeof(value);
+  return true;
+}
+
+bool Read(const std::string& data, std::size_t& offset, std::size_t len,
+          std::string& value) {
+  if (offset + len > data.size()) return false;
+  value.assign(data.data() + offset, len);
+  offset += len;
+  return true;
+}
+
+}  // namespace
+
+std::size_t GetSizeOfColumnType(ColumnType columnType) {
+  switch (columnType) {
+    case ColumnType::Int8:
+    case ColumnType::UInt8:
+    case ColumnType::Bool:
+      return 1;
+    case ColumnType::Int16:
+    case ColumnType::UInt16:
+      return 2;
+    case ColumnType::Int32:
+    case ColumnType::UInt32:
+    case ColumnType::Float:
+      return 4;
+    case ColumnType::Int64:
+    case ColumnType::UInt64:
+    case ColumnType::Double:
+    case ColumnType::Timestamp:
+      return 8;
+    case ColumnType::Str:
+      return 0;
+  }
+  return 0;
+}
+
+ColumnarRecSetEncoder::ColumnarRecSetEncoder(
+    const std::vector<ColumnInfo>& columnInfoGroupOfSource,
+    const std::vector<std::string>& columnNameGroup)
+    : columnInfoGroupOfSource_(columnInfoGroupOfSource),
+      columnNameGroup_(columnNameGroup) {}
+
+int ColumnarRecSetEncoder::init() {
+  const auto addColumn = [this](std::size_t noInSource) {
+    Column column;
+    column.noInSource_ = noInSource;
+    column.columnInfo_ = columnInfoGroupOfSource_[noInSource];
+    column.sizeOfValue_ = GetSizeOfColumnType(column.columnInfo_.columnType_);
+    column.offsetGroup_.emplace_back(0);
+    columnGroup_.emplace_back(std::move(column));
+  };
+
+  if (columnNameGroup_.empty()) {
+    for (std::size_t no = 0; no < columnInfoGroupOfSource_.size(); ++no) {
+      addColumn(no);
+    }
+    return 0;
+  }
+
+  for (const auto& columnName : columnNameGroup_) {
+    const auto iter = std::find_if(
+        std::begin(columnInfoGroupOfSource_),
+        std::end(columnInfoGroupOfSource_),
+        [&](const auto& columnInfo) { return columnInfo.name_ == columnName; });
+    if (iter == std::end(columnInfoGroupOfSource_)) {
+      LOG_W("Init columnar rec set encoder failed because of column {} not "
+            "exists.",
+            columnName);
+      return SCODE_HIS_MD_INVALID_COLUMN;
+    }
+    addColumn(std::distance(std::begin(columnInfoGroupOfSource_), iter));
+  }
+  return 0;
+}
+
+void ColumnarRecSetEncoder::encodeHeader(std::string& out) const {
+  out.append(MAGIC_OF_COLUMNAR_REC_SET);
+  Append(out, VERSION_OF_COLUMNAR_REC_SET);
+  Append(out, static_cast<std::uint16_t>(columnGroup_.size()));
+  for (const auto& column : columnGroup_) {
+    Append(out, static_cast<std::uint8_t>(column.columnInfo_.columnType_));
+    Append(out, static_cast<std::uint16_t>(column.columnInfo_.name_.size()));
+    out.append(column.columnInfo_.name_);
+  }
+}
+
+void ColumnarRecSetEncoder::addRec(void* const* valueGroup,
+                                   const int* lenGroup) {
+  const auto bitNo = numOfRec_ % 8;
+  for (auto& column : columnGroup_) {
+    if (bitNo == 0) column.validity_.push_back(0);
+    const auto value = valueGroup[column.noInSource_];
+    if (value != nullptr) {
+      column.validity_.back() |= static_cast<char>(1 << bitNo);
+    }
+
+    if (column.sizeOfValue_ != 0) {
+      if (value != nullptr) {
+        column.data_.append(static_cast<const char*>(value),
+                            column.sizeOfValue_);
+      } else {
+        column.data_.append(column.sizeOfValue_, '\0');
+      }
+    } else {
+      if (value != nullptr) {
+        column.data_.append(static_cast<const char*>(value),
+                            lenGroup[column.noInSource_]);
+      }
+      column.offsetGroup_.emplace_back(column.data_.size());
+    }
+  }
+  ++numOfRec_;
+}
+
+void ColumnarRecSetEncoder::flushBlock(std::string& out) {
+  if (numOfRec_ == 0) return;
+  Append(out, numOfRec_);
+  for (auto& column : columnGroup_) {
+    out.append(column.validity_);
+    if (column.sizeOfValue_ == 0) {
+      out.append(reinterpret_cast<const char*>(column.offsetGroup_.data()),
+                 column.offsetGroup_.size() * sizeof(std::uint32_t));
+      column.offsetGroup_.resize(1);
+    }
+    out.append(column.data_);
+    column.validity_.clear();
+    column.data_.clear();
+  }
+  numOfRec_ = 0;
+}
+
+void ColumnarRecSetEncoder::EncodeTrailer(std::string& out, int statusCode,
+                                          const std::string& statusMsg) {
+  Append(out, static_cast<std::uint32_t>(0));
+  Append(out, static_cast<std::int32_t>(statusCode));
+  Append(out, static_cast<std::uint16_t>(statusMsg.size()));
+  out.append(statusMsg);
+}
+
+ColumnarRecSetStream::ColumnarRecSetStream(
+    const RecSetSourceSPtr& recSetSource,
+    const std::vector<std::string>& columnNameGroup,
+    std::uint32_t maxNumOfRecEachBlock)
+    : recSetSource_(recSetSource),
+      encoder_(recSetSource->getColumnInfoGroup(), columnNameGroup),
+      maxNumOfRecEachBlock_(maxNumOfRecEachBlock) {}
+
+int ColumnarRecSetStream::init() {
+  if (const auto ret = encoder_.init(); ret != 0) {
+    return ret;
+  }
+  encoder_.encodeHeader(encodedData_);
+  return 0;
+}
+
+std::size_t ColumnarRecSetStream::read(char* buf, std::size_t len) {
+  std::size_t ret = 0;
+  while (ret < len) {
+    if (offsetOfEncodedData_ == encodedData_.size()) {
+      if (isEnd_) break;
+      encodedData_.clear();
+      offsetOfEncodedData_ = 0;
+      encodeNextBlock();
+    }
+    const auto lenOfCopy =
+        std::min(len - ret, encodedData_.size() - offsetOfEncodedData_);
+    memcpy(buf + ret, encodedData_.data() + offsetOfEncodedData_, lenOfCopy);
+    offsetOfEncodedData_ += lenOfCopy;
+    ret += lenOfCopy;
+  }
+  return ret;
+}
+
+std::string ColumnarRecSetStream::readAll() {
+  std::string ret;
+  while (true) {
+    if (offsetOfEncodedData_ == encodedData_.size()) {
+      if (isEnd_) break;
+      encodedData_.clear();
+      offsetOfEncodedData_ = 0;
+      encodeNextBlock();
+    }
+    ret.append(encodedData_, offsetOfEncodedData_);
+    offsetOfEncodedData_ = encodedData_.size();
+  }
+  return ret;
+}
+
+void ColumnarRecSetStream::encodeNextBlock() {
+  void* const* valueGroup = nullptr;
+  const int* lenGroup = nullptr;
+  while (encoder_.getNumOfRec() < maxNumOfRecEachBlock_) {
+    valueGroup = nullptr;
+    std::tie(statusCode_, statusMsg_) =
+        recSetSource_->fetchRec(valueGroup, lenGroup);
+    if (statusCode_ != 0 || valueGroup == nullptr) {
+      isEnd_ = true;
+      break;
+    }
+    encoder_.addRec(valueGroup, lenGroup);
+  }
+  encoder_.flushBlock(encodedData_);
+  if (isEnd_) {
+    // the recs fetched before a failure are kept, the trailer tells the reader
+    // that the rec set is incomplete
+    if (statusCode_ == 0) {
+      statusMsg_ = GetStatusMsg(SCODE_SUCCESS);
+    }
+    ColumnarRecSetEncoder::EncodeTrailer(encodedData_, statusCode_,
+                                         statusMsg_);
+    recSetSource_.reset();
+  }
+}
+
+std::tuple<int, ColumnarRecSet> DecodeColumnarRecSet(const std::string& data) {
+  ColumnarRecSet ret;
+  std::size_t offset = 0;
+
+  std::string magic;
+  std::uint8_t version = 0;
+  std::uint16_t numOfColumn = 0;
+  if (!Read(data, offset, MAGIC_OF_COLUMNAR_REC_SET.size(), magic) ||
+      magic != MAGIC_OF_COLUMNAR_REC_SET || !Read(data, offset, version) ||
+      version != VERSION_OF_COLUMNAR_REC_SET ||
+      !Read(data, offset, numOfColumn)) {
+    return {-1, ret};
+  }
+
+  for (std::uint16_t no = 0; no < numOfColumn; ++no) {
+    ColumnarRecSet::Column column;
+    std::uint8_t columnType = 0;
+    std::uint16_t lenOfName = 0;
+    if (!Read(data, offset, columnType) || !Read(data, offset, lenOfName) ||
+        !Read(data, offset, lenOfName, column.columnInfo_.name_)) {
+      return {-1, ret};
+    }
+    column.columnInfo_.columnType_ = static_cast<ColumnType>(columnType);
+    ret.columnGroup_.emplace_back(std::move(column));
+  }
+
+  while (true) {
+    std::uint32_t numOfRec = 0;
+    if (!Read(data, offset, numOfRec)) return {-1, ret};
+    if (numOfRec == 0) break;
+
+    for (auto& column : ret.columnGroup_) {
+      std::string validity;
+      if (!Read(data, offset, (numOfRec + 7) / 8, validity)) return {-1, ret};
+      for (std::uint32_t recNo = 0; recNo < numOfRec; ++recNo) {
+        column.validity_.emplace_back((validity[recNo / 8] >> (recNo % 8)) & 1);
+      }
+
+      std::string value;
+      const auto sizeOfValue =
+          GetSizeOfColumnType(column.columnInfo_.columnType_);
+      if (sizeOfValue != 0) {
+        if (!Read(data, offset, numOfRec * sizeOfValue, value)) {
+          return {-1, ret};
+        }
+      } else {
+        std::vector<std::uint32_t> offsetGroup(numOfRec + 1);
+        for (auto& offsetOfStr : offsetGroup) {
+          if (!Read(data, offset, offsetOfStr)) return {-1, ret};
+        }
+        if (!Read(data, offset, offsetGroup.back(), value)) return {-1, ret};
+        const auto base = column.data_.size();
+        for (std::uint32_t recNo = 1; recNo <= numOfRec; ++recNo) {
+          column.offsetGroup_.emplace_back(base + offsetGroup[recNo]);
+        }
+      }
+      column.data_.append(value);
+    }
+    ret.numOfRec_ += numOfRec;
+  }
+
+  std::int32_t statusCode = 0;
+  std::uint16_t lenOfStatusMsg = 0;
+  if (!Read(data, offset, statusCode) || !Read(data, offset, lenOfStatusMsg) ||
+      !Read(data, offset, lenOfStatusMsg, ret.statusMsg_)) {
+    return {-1, ret};
+  }
+  ret.statusCode_ = statusCode;
+  return {0, ret};
+}
+
+}  // namespace bq
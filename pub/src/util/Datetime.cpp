@@ -10,11 +10,114 @@
 
 #include "util/Datetime.hpp"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 #include "util/Logger.hpp"
 #include "util/StdExt.hpp"
 
 namespace bq {
 
+namespace {
+
+/*
+ * Days since 1970-01-01 of the proleptic gregorian date, see
+ * http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+ */
+constexpr std::int64_t DaysFromCivil(std::int64_t y, std::uint32_t m,
+                                     std::uint32_t d) {
+  y -= m <= 2;
+  const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const auto yoe = static_cast<std::uint32_t>(y - era * 400);
+  const std::uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  const std::uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+static_assert(DaysFromCivil(1970, 1, 1) == 0);
+static_assert(DaysFromCivil(2000, 3, 1) == 11017);
+
+class TSCClock {
+ public:
+  TSCClock(const TSCClock&) = delete;
+  TSCClock& operator=(const TSCClock&) = delete;
+  TSCClock(const TSCClock&&) = delete;
+  TSCClock& operator=(const TSCClock&&) = delete;
+
+  TSCClock() { calibrate(); }
+
+  std::uint64_t getTotalNSSince1970() const {
+    if (nsPerTickInQ32_ == 0) return GetTotalNSSince1970();
+
+    thread_local std::uint64_t tscOfAnchor = 0;
+    thread_local std::uint64_t nsOfAnchor = 0;
+    thread_local std::uint64_t lastNS = 0;
+
+    const auto tsc = ReadTSC();
+    if (tsc - tscOfAnchor >= ticksBetweenAnchor_) {
+      tscOfAnchor = tsc;
+      nsOfAnchor = GetTotalNSSince1970();
+    }
+    auto ret = nsOfAnchor + static_cast<std::uint64_t>(
+                                (static_cast<unsigned __int128>(
+                                     tsc - tscOfAnchor) *
+                                 nsPerTickInQ32_) >>
+                                32);
+    // re-anchoring must not make the clock go backwards
+    if (ret < lastNS) ret = lastNS;
+    lastNS = ret;
+    return ret;
+  }
+
+ private:
+  static std::uint64_t ReadTSC() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+  }
+
+  static bool IsInvariantTSC() {
+#if defined(__x86_64__) || defined(__i386__)
+    std::ifstream ifs("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(ifs, line)) {
+      if (boost::algorithm::starts_with(line, "flags")) {
+        return line.find(" constant_tsc") != std::string::npos &&
+               line.find(" nonstop_tsc") != std::string::npos;
+      }
+    }
+#endif
+    return false;
+  }
+
+  void calibrate() {
+    if (!IsInvariantTSC()) {
+      LOG_I("Invariant tsc not found, use realtime clock instead.");
+      return;
+    }
+
+    const auto nsStart = GetTotalNSSince1970();
+    const auto tscStart = ReadTSC();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const auto nsEnd = GetTotalNSSince1970();
+    const auto tscEnd = ReadTSC();
+    if (tscEnd <= tscStart || nsEnd <= nsStart) return;
+
+    nsPerTickInQ32_ = ((nsEnd - nsStart) << 32) / (tscEnd - tscStart);
+    ticksBetweenAnchor_ = (tscEnd - tscStart) * 20;
+    LOG_I("Calibrate tsc finished. [ticks per us = {:.3f}]",
+          (tscEnd - tscStart) * 1000.0 / (nsEnd - nsStart));
+  }
+
+ private:
+  std::uint64_t nsPerTickInQ32_{0};
+  std::uint64_t ticksBetweenAnchor_{0};
+};
+
+}  // namespace
+
 std::uint64_t GetTotalNSSince1970() {
   struct timespec time_start = {0, 0};
   clock_gettime(CLOCK_REALTIME, &time_start);
@@ -23,11 +126,10 @@ std::uint64_t GetTotalNSSince1970() {
 }
 
 std::uint64_t GetTotalUSSince1970() {
-  boost::posix_time::ptime epoch(
-      boost::gregorian::date(1970, boost::gregorian::Jan, 1));
-  const auto now = boost::posix_time::microsec_clock::universal_time();
-  const auto time_duration = now - epoch;
-  return time_duration.total_microseconds();
+  struct timespec time_start = {0, 0};
+  clock_gettime(CLOCK_REALTIME, &time_start);
+  std::uint64_t ret = time_start.tv_sec * 1000000 + time_start.tv_nsec / 1000;
+  return ret;
 }
 
 std::uint64_t GetTotalMSSince1970() {
@@ -40,6 +142,19 @@ std::uint64_t GetTotalSecSince1970() {
   return ret;
 }
 
+std::uint64_t GetTotalNSSince1970ByTSC() {
+  static const TSCClock tscClock;
+  return tscClock.getTotalNSSince1970();
+}
+
+std::uint64_t GetTotalUSSince1970OfHotPath() {
+#ifdef BQ_TSC_CLOCK
+  return GetTotalNSSince1970ByTSC() / 1000;
+#else
+  return GetTotalUSSince1970();
+#endif
+}
+
 std::string ConvertTsToDBTime(std::uint64_t ts) {
   const auto t = boost::posix_time::from_time_t(ts / 1000000);
   const auto us = ts % 1000000;
@@ -80,12 +195,25 @@ std::tuple<int, std::uint64_t> ConvertISODatetimeToTs(
 }
 
 std::uint64_t ConvertDatetimeToTs(std::int64_t datetime) {
-  const auto dt = fmt::format("{}", datetime);
-  const auto l = dt.substr(0, 8);
-  const auto r = dt.substr(8, dt.size() - 8);
-  const auto isoDatetime = fmt::format("{}T{}", l, r);
-  const auto [statusCode, ret] = ConvertISODatetimeToTs(isoDatetime);
-  return ret;
+  std::int64_t ms = 0;
+  if (datetime >= 10000000000000000) {
+    ms = datetime % 1000;
+    datetime /= 1000;
+  }
+  const auto date = datetime / 1000000;
+  const auto timeOfDay = datetime % 1000000;
+
+  thread_local std::int64_t dateInCache = 0;
+  thread_local std::int64_t tsOfMidnightInCache = 0;
+  if (date != dateInCache) {
+    const auto days = DaysFromCivil(date / 10000, date / 100 % 100, date % 100);
+    tsOfMidnightInCache = days * 86400 * 1000000;
+    dateInCache = date;
+  }
+
+  const auto secOfDay = timeOfDay / 10000 * 3600 +
+                        timeOfDay / 100 % 100 * 60 + timeOfDay % 100;
+  return tsOfMidnightInCache + secOfDay * 1000000 + ms * 1000;
 }
 
 std::string GetDateInStrFmtFromTs(std::uint64_t ts) {
@@ -0,0 +1,38 @@
+/*!
+ * \file FixedDecimal.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "util/FixedDecimal.hpp"
+
+namespace bq {
+
+int GetScaleOfPrec(std::string_view prec) {
+  int exp = 0;
+  const auto posOfExp = prec.find_first_of("eE");
+  if (posOfExp != std::string_view::npos) {
+    const auto strOfExp = prec.substr(posOfExp + 1);
+    const auto offset = !strOfExp.empty() && strOfExp[0] == '+' ? 1 : 0;
+    std::from_chars(strOfExp.data() + offset,
+                    strOfExp.data() + strOfExp.size(), exp);
+    prec = prec.substr(0, posOfExp);
+  }
+
+  int ret = 0;
+  const auto posOfDot = prec.find('.');
+  if (posOfDot != std::string_view::npos) {
+    const auto posOfLastNonZero = prec.find_last_not_of('0');
+    if (posOfLastNonZero != std::string_view::npos &&
+        posOfLastNonZero > posOfDot) {
+      ret = static_cast<int>(posOfLastNonZero - posOfDot);
+    }
+  }
+  return std::max(ret - exp, 0);
+}
+
+}  // namespace bq
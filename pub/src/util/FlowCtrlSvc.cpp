@@ -10,137 +10,130 @@
 
 #include "util/FlowCtrlSvc.hpp"
 
-#include "util/Float.hpp"
 #include "util/Logger.hpp"
 
 namespace bq {
 
-FlowLimitInfo::FlowLimitInfo(std::uint32_t timeDur, std::int32_t limitNum)
-    : timeDur_(timeDur),
-      limitNum_(limitNum),
-      timePointGroupOfTaskHasBeenExec_(
-          boost::circular_buffer<boost::posix_time::ptime>(limitNum_)) {}
-
-std::string FlowLimitInfo::toStr() const {
-  return fmt::format("timeDur={}; limitNum={}", timeDur_, limitNum_);
-}
-
 FlowCtrlSvc::FlowCtrlSvc(const YAML::Node& node) {
+  std::vector<std::tuple<std::uint32_t, std::uint32_t>> flowLimitInfoGroup;
   const auto& flowCtrlRule = node["flowCtrlRule"];
-  std::size_t groupNo = 0;
+  std::uint32_t groupNo = 0;
   for (auto iter = flowCtrlRule.begin(); iter != flowCtrlRule.end();
        ++iter, ++groupNo) {
     const auto taskGroup = (*iter)["taskGroup"];
     for (auto iter = taskGroup.begin(); iter != taskGroup.end(); ++iter) {
       const auto taskName = (*iter)["name"].as<std::string>();
       const auto taskWeight = (*iter)["weight"].as<std::uint32_t>();
-      taskName2GroupNo_.emplace(taskName, groupNo);
-      taskName2Weight_.emplace(taskName, taskWeight);
+      const auto taskId = static_cast<std::uint32_t>(taskId2TaskInfo_.size());
+      if (taskName2TaskId_.emplace(taskName, taskId).second) {
+        taskId2TaskInfo_.emplace_back(
+            TaskInfoOfFlowCtrl{taskName, groupNo, taskWeight});
+      }
       LOG_D("Add task info. groupNo={}; taskName={}; taskWeight={}", groupNo,
             taskName, taskWeight);
     }
     const auto timeDur = (*iter)["timeDur"].as<std::uint32_t>();
     const auto limitNum = (*iter)["limitNum"].as<std::uint32_t>();
-    const auto flowLimitInfo =
-        std::make_shared<FlowLimitInfo>(timeDur, limitNum);
-    groupNo2FlowLimitInfo_.emplace(groupNo, flowLimitInfo);
-    LOG_D("Add flow limit info. groupNo={}; {}", groupNo,
-          flowLimitInfo->toStr());
+    flowLimitInfoGroup.emplace_back(timeDur, limitNum);
+    LOG_D("Add flow limit info. groupNo={}; timeDur={}; limitNum={}", groupNo,
+          timeDur, limitNum);
+  }
+
+  numOfGroup_ = groupNo;
+  groupNo2FlowLimitInfo_ = std::make_unique<FlowLimitInfo[]>(numOfGroup_);
+  for (groupNo = 0; groupNo < numOfGroup_; ++groupNo) {
+    const auto [timeDur, limitNum] = flowLimitInfoGroup[groupNo];
+    auto& flowLimitInfo = groupNo2FlowLimitInfo_[groupNo];
+    flowLimitInfo.timeDur_ = timeDur;
+    flowLimitInfo.limitNum_ = limitNum;
+    flowLimitInfo.nsGroupOfTaskHasBeenExec_.resize(limitNum, 0);
   }
 }
 
 bool FlowCtrlSvc::exceedFlowCtrl(const std::string& taskName,
                                  WriteLog writeLog) {
-  auto getGroupNo =
-      [this](const std::string& taskName) -> std::optional<std::uint32_t> {
-    const auto iter = taskName2GroupNo_.find(taskName);
-    if (iter != taskName2GroupNo_.end()) {
-      return std::make_optional<std::uint32_t>(iter->second);
-    }
-    return std::nullopt;
-  };
-
-  auto getTaskWeight = [this](const std::string& taskName) -> std::uint32_t {
-    const auto iter = taskName2Weight_.find(taskName);
-    if (iter != taskName2Weight_.end()) {
-      return iter->second;
-    }
-    return 0;
-  };
+  return exceedFlowCtrl(getTaskId(taskName), writeLog);
+}
 
-  {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxFlowCtrl_);
-    const auto groupNoOpt = getGroupNo(taskName);
-    if (groupNoOpt == std::nullopt) {
-      return false;
-    }
-    const auto groupNo = groupNoOpt.value();
+void FlowCtrlSvc::reset() {
+  for (std::uint32_t groupNo = 0; groupNo < numOfGroup_; ++groupNo) {
+    auto& flowLimitInfo = groupNo2FlowLimitInfo_[groupNo];
+    std::lock_guard<std::ext::spin_mutex> guard(flowLimitInfo.mtx_);
+    flowLimitInfo.posOfFirstTask_ = 0;
+    flowLimitInfo.numOfTask_ = 0;
+  }
+}
 
-    const auto taskWeight = getTaskWeight(taskName);
-    if (taskWeight == 0) {
-      return false;
-    }
+std::uint32_t FlowCtrlSvc::getTaskId(const std::string& taskName) const {
+  const auto iter = taskName2TaskId_.find(taskName);
+  if (iter == std::end(taskName2TaskId_)) {
+    return INVALID_TASK_ID_OF_FLOW_CTRL;
+  }
+  return iter->second;
+}
 
-    const auto iter = groupNo2FlowLimitInfo_.find(groupNo);
-    auto& flowLimitInfo = iter->second;
+bool FlowCtrlSvc::exceedFlowCtrl(std::uint32_t taskId, std::uint64_t nsOfNow,
+                                 WriteLog writeLog) {
+  if (taskId >= taskId2TaskInfo_.size()) {
+    return false;
+  }
+  const auto& taskInfo = taskId2TaskInfo_[taskId];
+  if (taskInfo.weight_ == 0) {
+    return false;
+  }
 
-    const auto now = boost::posix_time::microsec_clock::universal_time();
-    const auto numOfTask =
-        flowLimitInfo->timePointGroupOfTaskHasBeenExec_.size();
-    if (numOfTask + taskWeight < flowLimitInfo->limitNum_) {
-      for (std::uint32_t i = 0; i < taskWeight; ++i) {
-        flowLimitInfo->timePointGroupOfTaskHasBeenExec_.push(now);
+  auto& flowLimitInfo = groupNo2FlowLimitInfo_[taskInfo.groupNo_];
+  auto& nsGroup = flowLimitInfo.nsGroupOfTaskHasBeenExec_;
+  auto& posOfFirstTask = flowLimitInfo.posOfFirstTask_;
+  auto& numOfTask = flowLimitInfo.numOfTask_;
+  const auto limitNum = flowLimitInfo.limitNum_;
+
+  // the ring keeps the last limitNum tasks, the first one is dropped if full
+  const auto pushTask = [&]() {
+    for (std::uint32_t i = 0; i < taskInfo.weight_; ++i) {
+      if (numOfTask < limitNum) {
+        nsGroup[(posOfFirstTask + numOfTask) % limitNum] = nsOfNow;
+        ++numOfTask;
+      } else {
+        nsGroup[posOfFirstTask] = nsOfNow;
+        posOfFirstTask = (posOfFirstTask + 1) % limitNum;
       }
-      return false;
-    }
-
-    const auto td =
-        now - flowLimitInfo->timePointGroupOfTaskHasBeenExec_.front();
-    if (td.total_milliseconds() == 0) {
-      return true;
     }
+  };
 
-    const auto timeDurBetweenFirstTaskAndNow =
-        static_cast<double>(td.total_milliseconds());
-    const auto taskNumPerMSIfExec =
-        (numOfTask + taskWeight) / timeDurBetweenFirstTaskAndNow;
-
-    const auto timeDurOfLimit = static_cast<double>(flowLimitInfo->timeDur_);
-    const auto taskNumLimitPerMS = flowLimitInfo->limitNum_ / timeDurOfLimit;
-
-    if (isDefinitelyGreaterOrEqual(taskNumPerMSIfExec, taskNumLimitPerMS)) {
-      if (writeLog == WriteLog::True) {
-        LOG_W(
-            "Exceed flow ctrl. "
-            "timeDur={}; limitNum={}; "
-            "timeDurBetweenFirstTaskAndNow={}; taskNumIfExec={}; "
-            "taskNumPerMSIfExec={} >= taskNumLimitPerMS={}",
-            flowLimitInfo->timeDur_, flowLimitInfo->limitNum_,
-            timeDurBetweenFirstTaskAndNow, (numOfTask + taskWeight),
-            taskNumPerMSIfExec, taskNumLimitPerMS);
-      }
-      return true;
-    } else {
-      for (std::uint32_t i = 0; i < taskWeight; ++i) {
-        flowLimitInfo->timePointGroupOfTaskHasBeenExec_.push(now);
-      }
-      return false;
-    }
+  std::lock_guard<std::ext::spin_mutex> guard(flowLimitInfo.mtx_);
+  const auto numOfTaskIfExec = numOfTask + taskInfo.weight_;
+  if (numOfTaskIfExec < limitNum) {
+    pushTask();
+    return false;
   }
 
-  return false;
-}
+  // a task heavier than the whole limit meets an empty window and is never
+  // passed
+  std::uint64_t msOfTimeDurSinceFirstTask = 0;
+  if (numOfTask != 0 && nsOfNow > nsGroup[posOfFirstTask]) {
+    msOfTimeDurSinceFirstTask =
+        (nsOfNow - nsGroup[posOfFirstTask]) / 1000 / 1000;
+  }
 
-void FlowCtrlSvc::reset() {
-  {
-    std::lock_guard<std::ext::spin_mutex> guard(mtxFlowCtrl_);
-    for (const auto& rec : groupNo2FlowLimitInfo_) {
-      auto& flowLimitInfo = rec.second;
-      while (!flowLimitInfo->timePointGroupOfTaskHasBeenExec_.empty()) {
-        flowLimitInfo->timePointGroupOfTaskHasBeenExec_.pop();
-      }
+  // the rate of the tasks in the window if the task is passed against the
+  // rate of the limit, compared exactly by the cross products
+  if (msOfTimeDurSinceFirstTask == 0 ||
+      static_cast<std::uint64_t>(numOfTaskIfExec) * flowLimitInfo.timeDur_ >=
+          static_cast<std::uint64_t>(limitNum) * msOfTimeDurSinceFirstTask) {
+    if (writeLog == WriteLog::True) {
+      LOG_W(
+          "Exceed flow ctrl. "
+          "taskName={}; groupNo={}; timeDur={}; limitNum={}; "
+          "timeDurSinceFirstTask={}; taskNumIfExec={}",
+          taskInfo.taskName_, taskInfo.groupNo_, flowLimitInfo.timeDur_,
+          limitNum, msOfTimeDurSinceFirstTask, numOfTaskIfExec);
     }
+    return true;
   }
+
+  pushTask();
+  return false;
 }
 
 }  // namespace bq
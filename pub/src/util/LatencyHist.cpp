@@ -0,0 +1,103 @@
+/*!
+ * \file LatencyHist.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "util/LatencyHist.hpp"
+
+#include "util/Logger.hpp"
+
+namespace bq {
+
+void LatencyStat::merge(const LatencyHist& latencyHist) {
+  for (std::size_t no = 0; no < LatencyHist::NUM_OF_BUCKET; ++no) {
+    bucketGroup_[no] += latencyHist.getNum(no);
+  }
+  num_ += latencyHist.getNum();
+  sum_ += latencyHist.getSum();
+  max_ = std::max(max_, latencyHist.getMax());
+}
+
+LatencyStat LatencyStat::getIncrement(const LatencyStat& prevStat) const {
+  LatencyStat ret;
+  std::size_t maxBucketNo = 0;
+  for (std::size_t no = 0; no < LatencyHist::NUM_OF_BUCKET; ++no) {
+    ret.bucketGroup_[no] = bucketGroup_[no] - prevStat.bucketGroup_[no];
+    if (ret.bucketGroup_[no] != 0) maxBucketNo = no;
+  }
+  ret.num_ = num_ - prevStat.num_;
+  ret.sum_ = sum_ - prevStat.sum_;
+  // the max of the increment is only known to the precision of its bucket
+  ret.max_ = ret.num_ == 0 ? 0
+                           : std::min(max_, LatencyHist::GetMaxValueOfBucket(
+                                                maxBucketNo));
+  return ret;
+}
+
+std::uint64_t LatencyStat::getValueAtPercentile(double percentile) const {
+  if (num_ == 0) return 0;
+  const auto numOfTarget = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(std::ceil(percentile / 100 * num_)));
+  std::uint64_t numOfSum = 0;
+  for (std::size_t no = 0; no < LatencyHist::NUM_OF_BUCKET; ++no) {
+    numOfSum += bucketGroup_[no];
+    if (numOfSum >= numOfTarget) {
+      return std::min(max_, LatencyHist::GetMaxValueOfBucket(no));
+    }
+  }
+  return max_;
+}
+
+std::string LatencyStat::toStr() const {
+  return fmt::format(
+      "num: {}; avg: {:.3f}; p50: {}; p99: {}; p999: {}; max: {}", num_,
+      num_ == 0 ? 0.0 : static_cast<double>(sum_) / num_,
+      getValueAtPercentile(50), getValueAtPercentile(99),
+      getValueAtPercentile(99.9), max_);
+}
+
+LatencyHist* LatencyProbeMgr::getLatencyHistOfCurThread(
+    const std::string& probeName) {
+  auto latencyHist = std::make_unique<LatencyHist>();
+  const auto ret = latencyHist.get();
+  {
+    std::lock_guard<std::ext::spin_mutex> guard(mtxProbeName2Probe_);
+    probeName2Probe_[probeName].latencyHistGroup_.emplace_back(
+        std::move(latencyHist));
+  }
+  return ret;
+}
+
+LatencyStat LatencyProbeMgr::getStat(const std::string& probeName) const {
+  LatencyStat ret;
+  std::lock_guard<std::ext::spin_mutex> guard(mtxProbeName2Probe_);
+  const auto iter = probeName2Probe_.find(probeName);
+  if (iter == std::end(probeName2Probe_)) {
+    return ret;
+  }
+  for (const auto& latencyHist : iter->second.latencyHistGroup_) {
+    ret.merge(*latencyHist);
+  }
+  return ret;
+}
+
+void LatencyProbeMgr::logStat() {
+  std::lock_guard<std::ext::spin_mutex> guard(mtxProbeName2Probe_);
+  for (auto& [probeName, probe] : probeName2Probe_) {
+    LatencyStat stat;
+    for (const auto& latencyHist : probe.latencyHistGroup_) {
+      stat.merge(*latencyHist);
+    }
+    const auto statOfIncrement = stat.getIncrement(probe.statOfLastLog_);
+    probe.statOfLastLog_ = std::move(stat);
+    if (statOfIncrement.num_ == 0) continue;
+    LOG_I("[Latency] {} us {}", probeName, statOfIncrement.toStr());
+  }
+}
+
+}  // namespace bq
@@ -94,6 +94,7 @@ int InitLogger(const YAML::Node& config) {
         config["logger"]["defaultLoggerName"].as<std::string>();
     const auto defaultLogger = spdlog::get(defaultLoggerName);
     spdlog::set_default_logger(defaultLogger);
+    VerOfLoggers().fetch_add(1, std::memory_order_release);
 
   } catch (const std::exception& e) {
     std::cerr << fmt::format("Init logger by config failed. [{}]", e.what())
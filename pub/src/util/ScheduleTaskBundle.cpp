@@ -10,8 +10,6 @@
 
 #include "util/ScheduleTaskBundle.hpp"
 
-#include "util/Logger.hpp"
-
 namespace bq {
 
 ScheduleTask::ScheduleTask(const std::string& scheduleTaskName,
@@ -21,35 +19,24 @@ ScheduleTask::ScheduleTask(const std::string& scheduleTaskName,
     : scheduleTaskName_(scheduleTaskName),
       scheduleTaskHandler_(scheduleTaskHandler),
       execAtStartup_(execAtStartup),
-      interval_(interval),
+      usInterval_(static_cast<std::uint64_t>(interval) * 1000),
       maxExecTimes_(maxExecTimes),
-      writeLog_(writeLog) {
-  if (execAtStartup_ != ExecAtStartup::True) {
-    lastExecTime_ = GetTotalMSSince1970();
-  } else {
-    lastExecTime_ = 0;
-  }
-}
+      writeLog_(writeLog) {}
 
-void ExecScheduleTaskBundle(ScheduleTaskBundleSPtr& scheduleTaskBundle) {
-  if (!scheduleTaskBundle) return;
-  for (auto& scheduleTask : *scheduleTaskBundle) {
-    if (scheduleTask->execTimes_ >= scheduleTask->maxExecTimes_) {
-      continue;
-    }
-    const auto now = GetTotalMSSince1970();
-    const auto timeDurAfterLastExec = now - scheduleTask->lastExecTime_;
-    if (timeDurAfterLastExec >= scheduleTask->interval_) {
-      if (scheduleTask->writeLog_ == WriteLog::True) {
-        LOG_D("Begin to exec scheduler task {}. [exec times = {}]",
-              scheduleTask->scheduleTaskName_, scheduleTask->execTimes_ + 1);
-      }
-      scheduleTask->lastExecTime_ = now;
-      if (scheduleTask->scheduleTaskHandler_() == true) {
-        ++scheduleTask->execTimes_;
-      }
-    }
-  }
-}
+ScheduleTask::ScheduleTask(const std::string& scheduleTaskName,
+                           const ScheduleTaskHandler& scheduleTaskHandler,
+                           ExecAtStartup execAtStartup,
+                           std::chrono::microseconds interval,
+                           std::chrono::microseconds budget,
+                           ExecOnDedicatedThread execOnDedicatedThread,
+                           std::uint64_t maxExecTimes, WriteLog writeLog)
+    : scheduleTaskName_(scheduleTaskName),
+      scheduleTaskHandler_(scheduleTaskHandler),
+      execAtStartup_(execAtStartup),
+      usInterval_(std::max<std::int64_t>(interval.count(), 1)),
+      usBudget_(std::max<std::int64_t>(budget.count(), 0)),
+      execOnDedicatedThread_(execOnDedicatedThread),
+      maxExecTimes_(maxExecTimes),
+      writeLog_(writeLog) {}
 
 }  // namespace bq
@@ -0,0 +1,206 @@
+/*!
+ * \file ScheduleTaskExecutor.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "util/ScheduleTaskExecutor.hpp"
+
+#include "util/Logger.hpp"
+#include "util/ScheduleTaskBundle.hpp"
+
+namespace bq {
+
+namespace {
+
+std::uint64_t GetUSOfSteadyClock() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+ScheduleTaskExecutor::ScheduleTaskExecutor(
+    const std::string& moduleName,
+    const ScheduleTaskBundleSPtr& scheduleTaskBundle, std::uint32_t usOfTick,
+    const ScheduleClock& clock)
+    : moduleName_(moduleName),
+      usOfTick_(std::max(usOfTick, 1U)),
+      clock_(clock ? clock : GetUSOfSteadyClock),
+      usOfStart_(clock_()) {
+  if (scheduleTaskBundle) {
+    for (const auto& scheduleTask : *scheduleTaskBundle) {
+      addScheduleTask(scheduleTask);
+    }
+  }
+}
+
+ScheduleTaskExecutor::~ScheduleTaskExecutor() { stop(); }
+
+int ScheduleTaskExecutor::start() {
+  if (stopped_.exchange(false) == false) return 0;
+  thread_ = std::make_unique<std::thread>([this]() { run(); });
+  for (const auto& dedicatedExecutor : getDedicatedExecutorGroup()) {
+    dedicatedExecutor->start();
+  }
+  LOG_D("[{}] Start schedule task executor. [usOfTick = {}]", moduleName_,
+        usOfTick_);
+  return 0;
+}
+
+int ScheduleTaskExecutor::stop() {
+  if (stopped_.exchange(true) == true) return 0;
+  if (thread_ && thread_->joinable()) {
+    thread_->join();
+  }
+  thread_.reset();
+  for (const auto& dedicatedExecutor : getDedicatedExecutorGroup()) {
+    dedicatedExecutor->stop();
+  }
+  for (const auto& scheduleTask : scheduleTaskGroup_) {
+    logMetrics(scheduleTask);
+  }
+  LOG_D("[{}] Stop schedule task executor.", moduleName_);
+  return 0;
+}
+
+void ScheduleTaskExecutor::addScheduleTask(
+    const ScheduleTaskSPtr& scheduleTask) {
+  if (scheduleTask->execOnDedicatedThread_ == ExecOnDedicatedThread::False) {
+    std::lock_guard<std::ext::spin_mutex> guard(mtxScheduleTaskGroupToAdd_);
+    scheduleTaskGroupToAdd_.emplace_back(scheduleTask);
+    return;
+  }
+
+  // the tick of a dedicated thread follows the interval of its task
+  const auto usOfTick = static_cast<std::uint32_t>(
+      std::min<std::uint64_t>(scheduleTask->usInterval_, usOfTick_));
+  const auto dedicatedExecutor = std::make_shared<ScheduleTaskExecutor>(
+      fmt::format("{}/{}", moduleName_, scheduleTask->scheduleTaskName_),
+      nullptr, usOfTick, clock_);
+  dedicatedExecutor->scheduleTaskGroupToAdd_.emplace_back(scheduleTask);
+
+  std::lock_guard<std::mutex> guard(mtxDedicatedExecutorGroup_);
+  dedicatedExecutorGroup_.emplace_back(dedicatedExecutor);
+  if (!stopped_) dedicatedExecutor->start();
+}
+
+void ScheduleTaskExecutor::advance() {
+  advanceWheel();
+  for (const auto& dedicatedExecutor : getDedicatedExecutorGroup()) {
+    dedicatedExecutor->advance();
+  }
+}
+
+std::vector<ScheduleTaskExecutorSPtr>
+ScheduleTaskExecutor::getDedicatedExecutorGroup() {
+  std::lock_guard<std::mutex> guard(mtxDedicatedExecutorGroup_);
+  return dedicatedExecutorGroup_;
+}
+
+void ScheduleTaskExecutor::advanceWheel() {
+  const auto tickOfNow = getTickOfNow();
+
+  std::vector<ScheduleTaskSPtr> scheduleTaskGroupToAdd;
+  {
+    std::lock_guard<std::ext::spin_mutex> guard(mtxScheduleTaskGroupToAdd_);
+    scheduleTaskGroupToAdd.swap(scheduleTaskGroupToAdd_);
+  }
+  for (const auto& scheduleTask : scheduleTaskGroupToAdd) {
+    if (scheduleTask->execTimes_ >= scheduleTask->maxExecTimes_) continue;
+    scheduleTaskGroup_.emplace_back(scheduleTask);
+    // tasks exec at startup are fired by the next tick
+    const auto expireTick =
+        scheduleTask->execAtStartup_ == ExecAtStartup::True
+            ? tickOfNow
+            : tickOfNow + getTickNumOfInterval(scheduleTask);
+    wheel_.add(Entry{expireTick, scheduleTask});
+  }
+
+  while (wheel_.getCurTick() < tickOfNow) {
+    wheel_.tick([this](Entry& entry) { exec(entry); });
+  }
+}
+
+void ScheduleTaskExecutor::exec(Entry& entry) {
+  const auto& scheduleTask = entry.scheduleTask_;
+  if (scheduleTask->writeLog_ == WriteLog::True) {
+    LOG_D("[{}] Begin to exec schedule task {}. [exec times = {}]",
+          moduleName_, scheduleTask->scheduleTaskName_,
+          scheduleTask->execTimes_ + 1);
+  }
+
+  const auto usOfBegin = clock_();
+  if (scheduleTask->scheduleTaskHandler_() == true) {
+    ++scheduleTask->execTimes_;
+  }
+  const auto usOfEnd = clock_();
+  const auto usOfExec = usOfEnd > usOfBegin ? usOfEnd - usOfBegin : 0;
+
+  scheduleTask->usTotalExecTime_ += usOfExec;
+  scheduleTask->usMaxExecTime_ =
+      std::max(scheduleTask->usMaxExecTime_, usOfExec);
+  if (scheduleTask->usBudget_ != 0 && usOfExec > scheduleTask->usBudget_) {
+    ++scheduleTask->numOfOverrun_;
+    LOG_W(
+        "[{}] Exec schedule task {} overrun. "
+        "[us of exec = {}, us of budget = {}, num of overrun = {}]",
+        moduleName_, scheduleTask->scheduleTaskName_, usOfExec,
+        scheduleTask->usBudget_, scheduleTask->numOfOverrun_);
+  }
+
+  if (scheduleTask->execTimes_ >= scheduleTask->maxExecTimes_) {
+    LOG_I("[{}] Schedule task {} finished. [exec times = {}]", moduleName_,
+          scheduleTask->scheduleTaskName_, scheduleTask->execTimes_);
+    std::ext::erase_if(scheduleTaskGroup_,
+                       [&](const auto& rec) { return rec == scheduleTask; });
+    return;
+  }
+
+  // skip the execs missed by a slow exec
+  const auto tickNumOfInterval = getTickNumOfInterval(scheduleTask);
+  const auto tickOfNow = std::max(getTickOfNow(), wheel_.getCurTick());
+  auto expireTick = entry.expireTick_ + tickNumOfInterval;
+  if (expireTick < tickOfNow) {
+    const auto numOfMissed = (tickOfNow - expireTick - 1) / tickNumOfInterval;
+    expireTick += (numOfMissed + 1) * tickNumOfInterval;
+  }
+  wheel_.add(Entry{expireTick, scheduleTask});
+}
+
+std::uint64_t ScheduleTaskExecutor::getTickOfNow() const {
+  const auto usOfNow = clock_();
+  return usOfNow > usOfStart_ ? (usOfNow - usOfStart_) / usOfTick_ : 0;
+}
+
+std::uint64_t ScheduleTaskExecutor::getTickNumOfInterval(
+    const ScheduleTaskSPtr& scheduleTask) {
+  const auto tickNum = (scheduleTask->usInterval_ + usOfTick_ - 1) / usOfTick_;
+  return std::max<std::uint64_t>(tickNum, 1);
+}
+
+void ScheduleTaskExecutor::logMetrics(
+    const ScheduleTaskSPtr& scheduleTask) const {
+  const auto execTimes = std::max<std::uint64_t>(scheduleTask->execTimes_, 1);
+  LOG_I(
+      "[{}] Metrics of schedule task {}. [exec times = {}, "
+      "avg us of exec = {}, max us of exec = {}, num of overrun = {}]",
+      moduleName_, scheduleTask->scheduleTaskName_, scheduleTask->execTimes_,
+      scheduleTask->usTotalExecTime_ / execTimes, scheduleTask->usMaxExecTime_,
+      scheduleTask->numOfOverrun_);
+}
+
+void ScheduleTaskExecutor::run() {
+  const auto tick = std::chrono::microseconds(usOfTick_);
+  while (!stopped_) {
+    advanceWheel();
+    std::this_thread::sleep_for(tick);
+  }
+}
+
+}  // namespace bq
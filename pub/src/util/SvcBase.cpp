@@ -11,8 +11,12 @@
 #include "util/SvcBase.hpp"
 
 #include "db/DBE.hpp"
+#include "util/BinLogger.hpp"
+#include "util/Datetime.hpp"
+#include "util/LatencyHist.hpp"
 #include "util/Logger.hpp"
 #include "util/Random.hpp"
+#include "util/Scheduler.hpp"
 #include "util/SignalHandler.hpp"
 
 namespace bq {
@@ -35,6 +39,8 @@ int SvcBase::init(const std::string& configFilename,
     configFilename_ = configFilename;
     RandomStr::get_mutable_instance().init();
     RandomInt::get_mutable_instance().init();
+    // calibrate the tsc clock before any ts is stamped on the hot path
+    GetTotalUSSince1970OfHotPath();
   }
 
   if (signalHandler_ == nullptr &&
@@ -78,6 +84,15 @@ int SvcBase::run() {
     return ret;
   }
 
+  schedulerOfLatencyStat_ = std::make_shared<Scheduler>(
+      "LATENCY_STAT",
+      []() { LatencyProbeMgr::get_mutable_instance().logStat(); },
+      MILLI_SEC_INTERVAL_OF_LATENCY_STAT);
+  if (auto ret = schedulerOfLatencyStat_->start(); ret != 0) {
+    LOG_E("Run svc failed.");
+    return ret;
+  }
+
   if (auto ret = afterRun(); ret != 0) {
     LOG_E("Run svc failed.");
     return ret;
@@ -93,9 +108,14 @@ int SvcBase::afterRun() {
 }
 
 void SvcBase::exit(const boost::system::error_code* ec, int signalNum) {
+  if (schedulerOfLatencyStat_) {
+    schedulerOfLatencyStat_->stop();
+    LatencyProbeMgr::get_mutable_instance().logStat();
+  }
   beforeExit(ec, signalNum);
   doExit(ec, signalNum);
   afterExit(ec, signalNum);
+  BinLogger::get_mutable_instance().stop();
 }
 
 }  // namespace bq
@@ -0,0 +1,72 @@
+/*!
+ * \file TimerWheel.cpp
+ * \project BetterQuant
+ *
+ * \author byrnexu
+ * \date 2022/09/08
+ *
+ * \brief
+ */
+
+#include "util/TimerWheel.hpp"
+
+#include "util/Logger.hpp"
+
+namespace bq {
+
+TimerWheel::TimerWheel(const std::string& moduleName,
+                       std::uint32_t milliSecOfTick)
+    : moduleName_(moduleName), milliSecOfTick_(std::max(milliSecOfTick, 1U)) {}
+
+TimerWheel::~TimerWheel() { stop(); }
+
+void TimerWheel::start() {
+  if (stopped_.exchange(false) == false) return;
+  thread_ = std::make_unique<std::thread>([this]() { run(); });
+  LOG_D("[{}] Start timer wheel. [milliSecOfTick = {}]", moduleName_,
+        milliSecOfTick_);
+}
+
+void TimerWheel::stop() {
+  stopped_ = true;
+  if (thread_ && thread_->joinable()) {
+    thread_->join();
+  }
+  thread_.reset();
+}
+
+void TimerWheel::addTimer(std::uint32_t milliSecDelay,
+                          const Callback& callback) {
+  const auto tickNum = (milliSecDelay + milliSecOfTick_ - 1) / milliSecOfTick_;
+  timerGroupToAdd_.enqueue(
+      Timer{tickOfAdd_.load() + std::max<std::uint64_t>(tickNum, 1), callback});
+}
+
+void TimerWheel::advance() {
+  // timers already due are fired by this tick
+  Timer timer;
+  while (timerGroupToAdd_.try_dequeue(timer)) {
+    wheel_.add(std::move(timer));
+  }
+
+  // timers added by the callbacks are due from this tick on
+  tickOfAdd_ = wheel_.getCurTick() + 1;
+  wheel_.tick([](Timer& timerToFire) { timerToFire.callback_(); });
+}
+
+void TimerWheel::run() {
+  const auto startTime = std::chrono::steady_clock::now();
+  const auto tick = std::chrono::milliseconds(milliSecOfTick_);
+  while (!stopped_) {
+    const auto elapsedTicks =
+        static_cast<std::uint64_t>((std::chrono::steady_clock::now() -
+                                    startTime) /
+                                   tick);
+    while (wheel_.getCurTick() < elapsedTicks) {
+      advance();
+    }
+    std::this_thread::sleep_for(tick);
+  }
+}
+
+}  // namespace bq
@@ -10,11 +10,32 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <spdlog/sinks/ostream_sink.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
+#include <csignal>
 #include <string>
 
+#include "db/DBEngAsync.hpp"
+#include "db/DBEngParam.hpp"
+#include "db/DBTask.hpp"
+#include "util/BinLogger.hpp"
+#include "def/StatusCode.hpp"
+#include "util/ColumnarRecSet.hpp"
+#include "util/Datetime.hpp"
 #include "util/File.hpp"
+#include "util/FlowCtrlSvc.hpp"
+#include "util/FixedDecimal.hpp"
+#include "util/Float.hpp"
+#include "util/IdleObjPool.hpp"
+#include "util/LatencyHist.hpp"
+#include "util/Literal.hpp"
+#include "util/ScheduleTaskBundle.hpp"
+#include "util/ScheduleTaskExecutor.hpp"
+#include "util/SnapshotStore.hpp"
 #include "util/String.hpp"
+#include "util/TimerWheel.hpp"
 
 using namespace bq;
 
@@ -61,6 +82,925 @@ TEST(test, testFile) {
   EXPECT_TRUE(lg[1] == "bbb");
 }
 
+TEST(test, testFixedDecimal) {
+  using Dec = FixedDecimal64;
+
+  EXPECT_TRUE(Dec::Parse("0.1").value().raw() == 10000000);
+  EXPECT_TRUE(Dec::Parse("-1.234567895").value().toStr() == "-1.2345679");
+  EXPECT_TRUE(Dec::Parse("1e-5").value().toStr() == "0.00001");
+  EXPECT_FALSE(Dec::Parse("1.2.3").has_value());
+  EXPECT_FALSE(Dec::Parse("").has_value());
+  EXPECT_FALSE(Dec::Parse("999999999999").has_value());
+  EXPECT_TRUE(CONV(Dec, "20000.12").toStr() == "20000.12");
+
+  const Dec a = 0.1;
+  const Dec b = 0.2;
+  EXPECT_TRUE(a + b == Dec(0.3));
+  EXPECT_TRUE((a * b).toStr() == "0.02");
+  EXPECT_TRUE((Dec(2) / Dec(3)).toStr() == "0.66666667");
+  EXPECT_TRUE((Dec(-2) / Dec(3)).toStr() == "-0.66666667");
+  EXPECT_TRUE(-1.0 * a == -a);
+  EXPECT_TRUE(fmt::format("{}", Dec(-0.5)) == "-0.5");
+  EXPECT_TRUE(Dec(5).toStr(3) == "5.000");
+  EXPECT_TRUE(Dec(1.15).roundToTick(0.1).toStr() == "1.2");
+  EXPECT_TRUE(Dec(-1.15).roundToTick(0.1, RoundMode::Floor).toStr() == "-1.2");
+
+  // saturates instead of wrapping
+  const auto maxOfDec = std::numeric_limits<Dec>::max();
+  EXPECT_TRUE(Dec(20000) * Dec(1000) * Dec(20000) == maxOfDec);
+  EXPECT_TRUE(Dec(-20000) * Dec(1000) * Dec(20000) == -maxOfDec);
+  EXPECT_TRUE(Dec(90000000000) / Dec(0.1) == maxOfDec);
+  EXPECT_TRUE(Dec(20000000) * 20000 == maxOfDec);
+
+  // div by zero saturates as double gives +-inf, 0 / 0 gives 0
+  EXPECT_TRUE(Dec(1.5) / Dec(0) == maxOfDec);
+  EXPECT_TRUE(Dec(-1.5) / 0 == -maxOfDec);
+  EXPECT_TRUE(Dec(0) / Dec(0) == Dec(0));
+  Dec avgPrice = 100;
+  avgPrice /= Dec(0);
+  EXPECT_TRUE(avgPrice == maxOfDec);
+  EXPECT_TRUE(FixedDecimal128(1) / 0.0 ==
+              std::numeric_limits<FixedDecimal128>::max());
+
+  EXPECT_TRUE(isApproximatelyZero(a + b - 0.3));
+  EXPECT_TRUE(isDefinitelyGreaterThan(b, a));
+  EXPECT_FALSE(isDefinitelyLessThan(a, a));
+
+  using Dec128 = FixedDecimal128;
+  const auto c = Dec128::Parse("123456789012.123456789012345678").value();
+  EXPECT_TRUE(c.toStr() == "123456789012.123456789012345678");
+  EXPECT_TRUE((Dec128(1) / Dec128(3)).toStr() == "0.333333333333333333");
+
+  EXPECT_TRUE(GetScaleOfPrec("0.01") == 2);
+  EXPECT_TRUE(GetScaleOfPrec("0.00100000") == 3);
+  EXPECT_TRUE(GetScaleOfPrec("1e-05") == 5);
+  EXPECT_TRUE(GetScaleOfPrec("5") == 0);
+}
+
+TEST(test, testExactSum) {
+  ExactSum<double> sumOfDouble;
+  ExactSum<FixedDecimal64> sumOfDec;
+  for (int i = 0; i < 10; ++i) {
+    sumOfDouble += 0.1;
+    sumOfDec += 0.1;
+  }
+  EXPECT_TRUE(sumOfDouble.get() == 1.0);
+  EXPECT_TRUE(sumOfDec.get() == 1);
+}
+
+TEST(test, testConvertDatetimeToTs) {
+  EXPECT_TRUE(ConvertDatetimeToTs(19700101000000000) == 0);
+  EXPECT_TRUE(ConvertDatetimeToTs(20230120093000123) == 1674207000123000);
+  EXPECT_TRUE(ConvertDatetimeToTs(20230120093000) == 1674207000000000);
+  EXPECT_TRUE(ConvertDatetimeToTs(20240229235959999) == 1709251199999000);
+  EXPECT_TRUE(ConvertDatetimeToTs(20230120150000000) == 1674226800000000);
+  for (const auto datetime : {"20221231T235959", "20230301T000000"}) {
+    const auto [statusCode, ts] = ConvertISODatetimeToTs(datetime);
+    EXPECT_TRUE(statusCode == 0);
+    EXPECT_TRUE(ConvertDatetimeToTs(std::stoll(
+                    boost::algorithm::erase_all_copy(std::string(datetime),
+                                                     "T"))) == ts);
+  }
+}
+
+TEST(test, testGetTotalNSSince1970ByTSC) {
+  const auto nsOfSys = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+  const std::int64_t us = GetTotalUSSince1970();
+  EXPECT_TRUE(std::llabs(us - nsOfSys / 1000) < 10000);
+
+  std::uint64_t last = 0;
+  for (int i = 0; i < 1000; ++i) {
+    const auto nsOfTSC = GetTotalNSSince1970ByTSC();
+    EXPECT_TRUE(nsOfTSC >= last);
+    last = nsOfTSC;
+  }
+  const std::int64_t usOfTSC = GetTotalNSSince1970ByTSC() / 1000;
+  const std::int64_t usOfSys = GetTotalUSSince1970();
+  EXPECT_TRUE(std::llabs(usOfTSC - usOfSys) < 10000);
+}
+
+TEST(test, testTimerWheel) {
+  TimerWheel timerWheel("test", 1);
+  std::vector<int> firedGroup;
+  timerWheel.addTimer(100, [&]() { firedGroup.emplace_back(100); });
+  timerWheel.addTimer(3, [&]() { firedGroup.emplace_back(3); });
+  timerWheel.addTimer(0, [&]() { firedGroup.emplace_back(0); });
+  timerWheel.addTimer(3, [&]() {
+    firedGroup.emplace_back(4);
+    timerWheel.addTimer(1, [&]() { firedGroup.emplace_back(5); });
+  });
+
+  timerWheel.advance();
+  EXPECT_TRUE(firedGroup == std::vector<int>({0}));
+  for (int i = 0; i < 2; ++i) timerWheel.advance();
+  EXPECT_TRUE(firedGroup == std::vector<int>({0, 3, 4}));
+  timerWheel.advance();
+  EXPECT_TRUE(firedGroup == std::vector<int>({0, 3, 4, 5}));
+  // 100 ticks is moved down from the 2nd level of the wheel
+  for (int i = 0; i < 95; ++i) timerWheel.advance();
+  EXPECT_TRUE(firedGroup.size() == 4);
+  timerWheel.advance();
+  EXPECT_TRUE(firedGroup == std::vector<int>({0, 3, 4, 5, 100}));
+
+  std::atomic_int num{0};
+  timerWheel.start();
+  for (int i = 0; i < 10; ++i) {
+    timerWheel.addTimer(i, [&]() { ++num; });
+  }
+  for (int i = 0; i < 1000 && num != 10; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  timerWheel.stop();
+  EXPECT_TRUE(num == 10);
+}
+
+TEST(test, testScheduleTaskExecutor) {
+  std::uint64_t usOfNow = 0;
+  const auto clock = [&]() { return usOfNow; };
+
+  std::uint64_t numOfA = 0, numOfB = 0, numOfC = 0, numOfD = 0;
+  auto scheduleTaskBundle = std::make_shared<ScheduleTaskBundle>();
+  scheduleTaskBundle->emplace_back(std::make_shared<ScheduleTask>(
+      "a", [&]() { return ++numOfA; }, ExecAtStartup::True,
+      MilliSecInterval(1)));
+  scheduleTaskBundle->emplace_back(std::make_shared<ScheduleTask>(
+      "b", [&]() { return ++numOfB; }, ExecAtStartup::False,
+      std::chrono::microseconds(300), std::chrono::microseconds(0)));
+  scheduleTaskBundle->emplace_back(std::make_shared<ScheduleTask>(
+      "c", [&]() { return ++numOfC; }, ExecAtStartup::False,
+      MilliSecInterval(10 * 1000), 2));
+  // finer than the tick of the bundle
+  scheduleTaskBundle->emplace_back(std::make_shared<ScheduleTask>(
+      "d", [&]() { return ++numOfD; }, ExecAtStartup::False,
+      std::chrono::microseconds(50), std::chrono::microseconds(0),
+      ExecOnDedicatedThread::True));
+
+  ScheduleTaskExecutor executor("test", scheduleTaskBundle, 100, clock);
+  for (int i = 0; i < 1000; ++i) {
+    usOfNow += 100;
+    executor.advance();
+  }
+  EXPECT_TRUE(executor.getCurTick() == 1000);
+  EXPECT_TRUE(numOfA == 100);
+  EXPECT_TRUE(numOfB == 333);
+  EXPECT_TRUE(numOfD == 1998);
+  EXPECT_TRUE(numOfC == 0);
+
+  // c is moved down through the levels of the wheel, the clock jumps 1s
+  for (int i = 0; i < 25; ++i) {
+    usOfNow += 1000 * 1000;
+    executor.advance();
+  }
+  EXPECT_TRUE(numOfC == 2);
+  // a runs once for each jump of the clock, the execs it missed are skipped
+  EXPECT_TRUE(numOfA == 125);
+
+  // the budget of e is overrun once and the 2 missed execs are skipped
+  usOfNow = 0;
+  bool overrun = true;
+  const auto e = std::make_shared<ScheduleTask>(
+      "e",
+      [&]() {
+        if (std::exchange(overrun, false)) usOfNow += 2500;
+        return true;
+      },
+      ExecAtStartup::False, std::chrono::microseconds(1000),
+      std::chrono::microseconds(100));
+  ScheduleTaskExecutor executorOfE("test", nullptr, 100, clock);
+  executorOfE.addScheduleTask(e);
+  executorOfE.advance();
+  usOfNow = 1000;
+  executorOfE.advance();
+  EXPECT_TRUE(e->execTimes_ == 1);
+  EXPECT_TRUE(e->numOfOverrun_ == 1);
+  EXPECT_TRUE(e->usMaxExecTime_ == 2500);
+  usOfNow = 3900;
+  executorOfE.advance();
+  EXPECT_TRUE(e->execTimes_ == 1);
+  usOfNow = 4000;
+  executorOfE.advance();
+  EXPECT_TRUE(e->execTimes_ == 2);
+  EXPECT_TRUE(e->numOfOverrun_ == 1);
+
+  std::atomic_int num{0};
+  ScheduleTaskExecutor executorOfSteadyClock("test", nullptr, 100);
+  executorOfSteadyClock.addScheduleTask(std::make_shared<ScheduleTask>(
+      "f", [&]() { return ++num; }, ExecAtStartup::True,
+      std::chrono::microseconds(200), std::chrono::microseconds(0),
+      ExecOnDedicatedThread::True, 10));
+  executorOfSteadyClock.start();
+  for (int i = 0; i < 1000 && num != 10; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  executorOfSteadyClock.stop();
+  EXPECT_TRUE(num == 10);
+}
+
+namespace {
+
+// the sliding window of the flow ctrl svc before the check by task id, kept
+// to check that the new one passes and rejects the same tasks
+class SlidingWindowOfBaseline {
+ public:
+  SlidingWindowOfBaseline(std::uint32_t timeDur, std::uint32_t limitNum)
+      : timeDur_(timeDur),
+        limitNum_(limitNum),
+        timePointGroupOfTaskHasBeenExec_(
+            boost::circular_buffer<boost::posix_time::ptime>(limitNum)) {}
+
+  bool exceedFlowCtrl(std::uint32_t taskWeight, boost::posix_time::ptime now) {
+    const auto numOfTask = timePointGroupOfTaskHasBeenExec_.size();
+    if (numOfTask + taskWeight < limitNum_) {
+      for (std::uint32_t i = 0; i < taskWeight; ++i) {
+        timePointGroupOfTaskHasBeenExec_.push(now);
+      }
+      return false;
+    }
+
+    const auto td = now - timePointGroupOfTaskHasBeenExec_.front();
+    if (td.total_milliseconds() == 0) {
+      return true;
+    }
+
+    const auto taskNumPerMSIfExec =
+        (numOfTask + taskWeight) / static_cast<double>(td.total_milliseconds());
+    const auto taskNumLimitPerMS = limitNum_ / static_cast<double>(timeDur_);
+    if (isDefinitelyGreaterOrEqual(taskNumPerMSIfExec, taskNumLimitPerMS)) {
+      return true;
+    }
+    for (std::uint32_t i = 0; i < taskWeight; ++i) {
+      timePointGroupOfTaskHasBeenExec_.push(now);
+    }
+    return false;
+  }
+
+  void reset() {
+    while (!timePointGroupOfTaskHasBeenExec_.empty()) {
+      timePointGroupOfTaskHasBeenExec_.pop();
+    }
+  }
+
+ private:
+  std::uint32_t timeDur_;
+  std::uint32_t limitNum_;
+  std::queue<boost::posix_time::ptime,
+             boost::circular_buffer<boost::posix_time::ptime>>
+      timePointGroupOfTaskHasBeenExec_;
+};
+
+}  // namespace
+
+TEST(test, testFlowCtrlSvc) {
+  // group 0 is order and cancel, 10 tasks per 1000 ms, group 1 is query, 3
+  // tasks per 100 ms
+  YAML::Node node;
+  for (const auto& [taskName, weight] :
+       std::vector<std::pair<std::string, int>>{{"order", 1}, {"cancel", 2}}) {
+    YAML::Node taskInfo;
+    taskInfo["name"] = taskName;
+    taskInfo["weight"] = weight;
+    node["flowCtrlRule"][0]["taskGroup"].push_back(taskInfo);
+  }
+  node["flowCtrlRule"][0]["timeDur"] = 1000;
+  node["flowCtrlRule"][0]["limitNum"] = 10;
+  YAML::Node taskInfoOfQuery;
+  taskInfoOfQuery["name"] = "query";
+  taskInfoOfQuery["weight"] = 1;
+  node["flowCtrlRule"][1]["taskGroup"].push_back(taskInfoOfQuery);
+  node["flowCtrlRule"][1]["timeDur"] = 100;
+  node["flowCtrlRule"][1]["limitNum"] = 3;
+
+  // checks by name and by id share the window of the group
+  FlowCtrlSvc flowCtrlSvcOfMixedCheck(node);
+  const auto taskIdOfMixedCheck = flowCtrlSvcOfMixedCheck.getTaskId("order");
+  std::uint32_t numOfPassedByMixedCheck = 0;
+  for (int i = 0; i < 20; ++i) {
+    if (!flowCtrlSvcOfMixedCheck.exceedFlowCtrl("order", WriteLog::False)) {
+      ++numOfPassedByMixedCheck;
+    }
+    if (!flowCtrlSvcOfMixedCheck.exceedFlowCtrl(taskIdOfMixedCheck,
+                                                WriteLog::False)) {
+      ++numOfPassedByMixedCheck;
+    }
+  }
+  EXPECT_TRUE(numOfPassedByMixedCheck == 9);
+
+  FlowCtrlSvc flowCtrlSvc(node);
+  EXPECT_TRUE(flowCtrlSvc.getTaskId("trade") == INVALID_TASK_ID_OF_FLOW_CTRL);
+  EXPECT_FALSE(flowCtrlSvc.exceedFlowCtrl(INVALID_TASK_ID_OF_FLOW_CTRL, 0));
+
+  // the same tasks at the same time points go through the svc and the
+  // baseline, which must pass and reject exactly the same ones
+  SlidingWindowOfBaseline baselineOfOrder(1000, 10);
+  SlidingWindowOfBaseline baselineOfQuery(100, 3);
+  const std::vector<std::string> taskNameGroup{"order", "cancel", "query"};
+  const std::vector<std::uint32_t> taskWeightGroup{1, 2, 1};
+  const std::vector<SlidingWindowOfBaseline*> baselineGroup{
+      &baselineOfOrder, &baselineOfOrder, &baselineOfQuery};
+  std::vector<std::uint32_t> taskIdGroup;
+  for (const auto& taskName : taskNameGroup) {
+    taskIdGroup.emplace_back(flowCtrlSvc.getTaskId(taskName));
+  }
+
+  const auto epoch =
+      boost::posix_time::ptime(boost::gregorian::date(2022, 9, 8));
+  std::uint64_t usOfNow = 1000 * 1000;
+  std::uint32_t numOfDiff = 0;
+  const auto check = [&](std::size_t no) {
+    const auto ret = flowCtrlSvc.exceedFlowCtrl(
+        taskIdGroup[no], usOfNow * 1000, WriteLog::False);
+    const auto retOfBaseline = baselineGroup[no]->exceedFlowCtrl(
+        taskWeightGroup[no], epoch + boost::posix_time::microseconds(usOfNow));
+    if (ret != retOfBaseline) ++numOfDiff;
+    return ret;
+  };
+  const auto passBurst = [&](std::size_t no, int numOfTask) {
+    std::uint32_t ret = 0;
+    for (int i = 0; i < numOfTask; ++i) {
+      if (!check(no)) ++ret;
+    }
+    return ret;
+  };
+
+  EXPECT_TRUE(passBurst(0, 20) == 9);
+  EXPECT_TRUE(passBurst(2, 5) == 2);
+
+  // bursts just before, at and just after the end of the window
+  const auto usOfFirstBurst = usOfNow;
+  for (const auto usOfOffset : {999000, 999999, 1000000, 1000001, 1001000,
+                                1100000, 1101000, 2000000, 2101000}) {
+    usOfNow = usOfFirstBurst + usOfOffset;
+    passBurst(0, 5);
+    passBurst(1, 3);
+    passBurst(2, 4);
+  }
+  EXPECT_TRUE(numOfDiff == 0);
+
+  // tasks at the limit and above it
+  for (const auto usOfGap : {100000, 101000, 50000, 33000}) {
+    for (int i = 0; i < 100; ++i) {
+      usOfNow += usOfGap;
+      check(0);
+      check(2);
+    }
+  }
+  EXPECT_TRUE(numOfDiff == 0);
+
+  // random tasks, the window of the group of order and cancel passes no more
+  // than limitNum tasks within any 1000 ms, but a cancel of weight 2 may be
+  // passed with limitNum - 1 tasks in the window as by the baseline
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<std::uint64_t> distOfGap(0, 200 * 1000);
+  std::uniform_int_distribution<std::size_t> distOfNo(0, 2);
+  std::deque<std::uint64_t> usGroupOfPassedTask;
+  for (int i = 0; i < 100000; ++i) {
+    usOfNow += distOfGap(gen);
+    const auto no = distOfNo(gen);
+    if (check(no) || no == 2) continue;
+    for (std::uint32_t weight = 0; weight < taskWeightGroup[no]; ++weight) {
+      usGroupOfPassedTask.emplace_back(usOfNow);
+    }
+    while (usGroupOfPassedTask.front() + 1000 * 1000 <= usOfNow) {
+      usGroupOfPassedTask.pop_front();
+    }
+    EXPECT_TRUE(usGroupOfPassedTask.size() <= 10 + 2 - 1);
+  }
+  EXPECT_TRUE(numOfDiff == 0);
+
+  flowCtrlSvc.reset();
+  baselineOfOrder.reset();
+  baselineOfQuery.reset();
+  EXPECT_TRUE(passBurst(0, 20) == 9);
+  EXPECT_TRUE(numOfDiff == 0);
+}
+
+TEST(test, testIdleObjPool) {
+  IdleObjPool<int> idleObjPool;
+  idleObjPool.giveBack(std::make_shared<int>(1));
+  idleObjPool.giveBack(std::make_shared<int>(2));
+  const auto obj1 = idleObjPool.take();
+  const auto obj2 = idleObjPool.take();
+  EXPECT_TRUE(*obj1 + *obj2 == 3);
+  EXPECT_TRUE(idleObjPool.getNumOfIdleObj() == 0);
+  EXPECT_TRUE(idleObjPool.getWaitHist().getNum(0) == 2);
+
+  std::atomic_int no{0};
+  std::thread waiter([&]() { no = *idleObjPool.take(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_TRUE(no == 0);
+  idleObjPool.giveBack(obj2);
+  waiter.join();
+  EXPECT_TRUE(no == *obj2);
+
+  std::uint64_t numOfWait = 0;
+  for (std::size_t i = 1; i < WaitHist::NUM_OF_BUCKET; ++i) {
+    numOfWait += idleObjPool.getWaitHist().getNum(i);
+  }
+  EXPECT_TRUE(numOfWait == 1);
+}
+
+TEST(test, testLatencyHist) {
+  for (std::uint64_t value : {0ULL, 1ULL, 63ULL, 64ULL, 65ULL, 1000ULL,
+                              123456789ULL, (1ULL << 41) - 1}) {
+    const auto bucketNo = LatencyHist::GetBucketNo(value);
+    EXPECT_TRUE(bucketNo < LatencyHist::NUM_OF_BUCKET);
+    EXPECT_TRUE(LatencyHist::GetMaxValueOfBucket(bucketNo) >= value);
+    EXPECT_TRUE(LatencyHist::GetMaxValueOfBucket(bucketNo) - value <=
+                value / LatencyHist::NUM_OF_SUB_BUCKET);
+  }
+  EXPECT_TRUE(LatencyHist::GetBucketNo(UINT64_MAX) ==
+              LatencyHist::NUM_OF_BUCKET - 1);
+
+  LatencyHist latencyHist;
+  for (std::uint64_t value = 1; value <= 10000; ++value) {
+    latencyHist.record(value);
+  }
+  LatencyStat stat;
+  stat.merge(latencyHist);
+  EXPECT_TRUE(stat.num_ == 10000);
+  EXPECT_TRUE(stat.max_ == 10000);
+  const auto p50 = stat.getValueAtPercentile(50);
+  const auto p99 = stat.getValueAtPercentile(99);
+  EXPECT_TRUE(p50 >= 5000 && p50 <= 5000 + 5000 / 32);
+  EXPECT_TRUE(p99 >= 9900 && p99 <= 9900 + 9900 / 32);
+  EXPECT_TRUE(stat.getValueAtPercentile(100) == 10000);
+
+  latencyHist.record(20);
+  LatencyStat statOfNext;
+  statOfNext.merge(latencyHist);
+  const auto statOfIncrement = statOfNext.getIncrement(stat);
+  EXPECT_TRUE(statOfIncrement.num_ == 1);
+  EXPECT_TRUE(statOfIncrement.max_ == 20);
+  EXPECT_TRUE(statOfIncrement.getValueAtPercentile(99.9) == 20);
+
+  std::vector<std::thread> threadGroup;
+  for (int i = 0; i < 4; ++i) {
+    threadGroup.emplace_back([]() {
+      for (int j = 0; j < 1000; ++j) {
+        LATENCY_PROBE("testLatencyHist", GetTotalUSSince1970OfHotPath());
+      }
+    });
+  }
+  for (auto& thread : threadGroup) thread.join();
+  EXPECT_TRUE(
+      LatencyProbeMgr::get_mutable_instance().getStat("testLatencyHist").num_ ==
+      4000);
+}
+
+namespace {
+
+class StubRecSetSource : public RecSetSource {
+ public:
+  // the fetch of rec no recNoOfFailure fails
+  explicit StubRecSetSource(std::uint64_t numOfRec,
+                            std::uint64_t recNoOfFailure = UINT64_MAX)
+      : numOfRec_(numOfRec), recNoOfFailure_(recNoOfFailure) {}
+
+  const std::vector<ColumnInfo>& getColumnInfoGroup() const final {
+    return columnInfoGroup_;
+  }
+
+  std::tuple<int, std::string> fetchRec(void* const*& valueGroup,
+                                        const int*& lenGroup) final {
+    if (recNo_ == recNoOfFailure_) {
+      return {SCODE_TDENG_FETCH_REC_FAILED, "Fetch rec failed."};
+    }
+    if (recNo_ == numOfRec_) {
+      valueGroup = nullptr;
+      return {0, ""};
+    }
+    exchTs_ = 1669338658437000 + recNo_;
+    price_ = 16500 + recNo_ * 0.5;
+    side_ = recNo_ % 2 == 0 ? "Bid" : "Ask";
+    valueGroup_[0] = &exchTs_;
+    valueGroup_[1] = recNo_ % 3 == 0 ? nullptr : &price_;
+    valueGroup_[2] = side_.data();
+    lenGroup_[2] = side_.size();
+    valueGroup = valueGroup_;
+    lenGroup = lenGroup_;
+    ++recNo_;
+    return {0, ""};
+  }
+
+ private:
+  const std::vector<ColumnInfo> columnInfoGroup_{
+      {"exchTs", ColumnType::Timestamp},
+      {"price", ColumnType::Double},
+      {"side", ColumnType::Str}};
+  const std::uint64_t numOfRec_;
+  const std::uint64_t recNoOfFailure_;
+  std::uint64_t recNo_{0};
+
+  std::uint64_t exchTs_{0};
+  double price_{0};
+  std::string side_;
+  void* valueGroup_[3]{nullptr};
+  int lenGroup_[3]{0};
+};
+
+std::string ReadAll(ColumnarRecSetStream& recSetStream) {
+  std::string ret;
+  char buf[7];
+  while (const auto len = recSetStream.read(buf, sizeof(buf))) {
+    ret.append(buf, len);
+  }
+  return ret;
+}
+
+}  // namespace
+
+TEST(test, testColumnarRecSet) {
+  {
+    ColumnarRecSetStream recSetStream(std::make_shared<StubRecSetSource>(1000),
+                                      {}, 64);
+    EXPECT_TRUE(recSetStream.init() == 0);
+    const auto [statusCode, recSet] =
+        DecodeColumnarRecSet(ReadAll(recSetStream));
+    EXPECT_TRUE(statusCode == 0);
+    EXPECT_TRUE(recSet.statusCode_ == SCODE_SUCCESS);
+    EXPECT_TRUE(recSet.numOfRec_ == 1000);
+    EXPECT_TRUE(recSet.columnGroup_.size() == 3);
+    EXPECT_TRUE(recSet.getValue<std::uint64_t>(0, 999) == 1669338658437999);
+    EXPECT_TRUE(recSet.isNull(1, 999));
+    EXPECT_TRUE(!recSet.isNull(1, 998));
+    EXPECT_TRUE(recSet.getValue<double>(1, 998) == 16999);
+    EXPECT_TRUE(recSet.getStr(2, 998) == "Bid");
+    EXPECT_TRUE(recSet.getStr(2, 999) == "Ask");
+  }
+
+  {
+    ColumnarRecSetStream recSetStream(std::make_shared<StubRecSetSource>(100),
+                                      {"side", "exchTs"});
+    EXPECT_TRUE(recSetStream.init() == 0);
+    const auto [statusCode, recSet] =
+        DecodeColumnarRecSet(ReadAll(recSetStream));
+    EXPECT_TRUE(statusCode == 0);
+    EXPECT_TRUE(recSet.columnGroup_.size() == 2);
+    EXPECT_TRUE(recSet.columnGroup_[0].columnInfo_.name_ == "side");
+    EXPECT_TRUE(recSet.getStr(0, 1) == "Ask");
+    EXPECT_TRUE(recSet.getValue<std::uint64_t>(1, 1) == 1669338658437001);
+  }
+
+  {
+    ColumnarRecSetStream recSetStream(std::make_shared<StubRecSetSource>(0),
+                                      {});
+    EXPECT_TRUE(recSetStream.init() == 0);
+    const auto [statusCode, recSet] =
+        DecodeColumnarRecSet(ReadAll(recSetStream));
+    EXPECT_TRUE(statusCode == 0);
+    EXPECT_TRUE(recSet.numOfRec_ == 0);
+  }
+
+  {
+    ColumnarRecSetStream recSetStream(
+        std::make_shared<StubRecSetSource>(1000, 100), {}, 64);
+    EXPECT_TRUE(recSetStream.init() == 0);
+    const auto [statusCode, recSet] =
+        DecodeColumnarRecSet(ReadAll(recSetStream));
+    EXPECT_TRUE(statusCode == 0);
+    EXPECT_TRUE(recSet.statusCode_ == SCODE_TDENG_FETCH_REC_FAILED);
+    EXPECT_TRUE(recSet.statusMsg_ == "Fetch rec failed.");
+    EXPECT_TRUE(recSet.numOfRec_ == 100);
+  }
+
+  {
+    // read at once the same as chunk by chunk, the source is released then
+    ColumnarRecSetStream recSetStream(std::make_shared<StubRecSetSource>(1000),
+                                      {}, 64);
+    auto recSetSource = std::make_shared<StubRecSetSource>(1000);
+    const std::weak_ptr<StubRecSetSource> recSetSourceReadAll = recSetSource;
+    ColumnarRecSetStream recSetStreamReadAll(recSetSource, {}, 64);
+    recSetSource.reset();
+    EXPECT_TRUE(recSetStream.init() == 0);
+    EXPECT_TRUE(recSetStreamReadAll.init() == 0);
+    const auto recSetReadAll = recSetStreamReadAll.readAll();
+    EXPECT_TRUE(recSetSourceReadAll.expired());
+    EXPECT_TRUE(recSetReadAll == ReadAll(recSetStream));
+    EXPECT_TRUE(recSetStreamReadAll.readAll().empty());
+  }
+
+  ColumnarRecSetStream recSetStream(std::make_shared<StubRecSetSource>(1),
+                                    {"volume"});
+  EXPECT_TRUE(recSetStream.init() == SCODE_HIS_MD_INVALID_COLUMN);
+}
+
+namespace {
+
+struct RecOfSnapshotStore {
+  std::uint64_t id_{0};
+  std::uint64_t value_{0};
+  char name_[16]{};
+};
+
+using Id2RecOfSnapshotStore = std::map<std::uint64_t, RecOfSnapshotStore>;
+
+void ApplyRecOfSnapshotStore(Id2RecOfSnapshotStore& id2Rec, OpOfJournal op,
+                             const RecOfSnapshotStore& rec) {
+  if (op == OpOfJournal::Upsert) {
+    id2Rec[rec.id_] = rec;
+  } else {
+    id2Rec.erase(rec.id_);
+  }
+}
+
+// the change made by the process each time, it is the same in every process
+std::tuple<OpOfJournal, RecOfSnapshotStore> MakeChgOfSnapshotStore(
+    std::uint64_t no) {
+  RecOfSnapshotStore rec;
+  rec.id_ = no % 97;
+  rec.value_ = no;
+  snprintf(rec.name_, sizeof(rec.name_), "rec-%lu", no);
+  const auto op = no % 7 == 0 ? OpOfJournal::Remove : OpOfJournal::Upsert;
+  return {op, rec};
+}
+
+}  // namespace
+
+TEST(test, testSnapshotStore) {
+  const std::string rootPath = "testSnapshotStore";
+  boost::filesystem::remove_all(rootPath);
+
+  std::mutex mtxId2Rec;
+  const auto makeSnapshotStore = [&](Id2RecOfSnapshotStore& id2Rec) {
+    return std::make_shared<SnapshotStore<RecOfSnapshotStore>>(
+        rootPath, "test",
+        [&]() {
+          std::lock_guard<std::mutex> guard(mtxId2Rec);
+          std::vector<RecOfSnapshotStore> ret;
+          for (const auto& [id, rec] : id2Rec) ret.emplace_back(rec);
+          return ret;
+        },
+        1, 1000);
+  };
+
+  // chg, snapshot and journal in a child killed without any cleanup
+  const auto pid = fork();
+  if (pid == 0) {
+    Id2RecOfSnapshotStore id2Rec;
+    auto snapshotStore = makeSnapshotStore(id2Rec);
+    snapshotStore->start();
+    for (std::uint64_t no = 0; no < 5000; ++no) {
+      const auto [op, rec] = MakeChgOfSnapshotStore(no);
+      {
+        std::lock_guard<std::mutex> guard(mtxId2Rec);
+        ApplyRecOfSnapshotStore(id2Rec, op, rec);
+        snapshotStore->append(op, rec);
+      }
+      if (no == 2500) snapshotStore->takeSnapshot();
+    }
+    snapshotStore->flush();
+    raise(SIGKILL);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  EXPECT_TRUE(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+
+  Id2RecOfSnapshotStore id2RecExpected;
+  for (std::uint64_t no = 0; no < 5000; ++no) {
+    const auto [op, rec] = MakeChgOfSnapshotStore(no);
+    ApplyRecOfSnapshotStore(id2RecExpected, op, rec);
+  }
+
+  // a rec cut off by a crash while it is written to the journal
+  for (const auto& entry : boost::filesystem::directory_iterator(rootPath)) {
+    if (entry.path().string().find(".journal.") != std::string::npos) {
+      AppendStrToFile(entry.path().string(), "cut");
+    }
+  }
+
+  Id2RecOfSnapshotStore id2Rec;
+  auto snapshotStore = makeSnapshotStore(id2Rec);
+  const auto ret = snapshotStore->load(
+      [&](OpOfJournal op, const RecOfSnapshotStore& rec) {
+        ApplyRecOfSnapshotStore(id2Rec, op, rec);
+      });
+  EXPECT_TRUE(ret == 0);
+  EXPECT_TRUE(id2Rec.size() == id2RecExpected.size());
+  for (const auto& [id, rec] : id2RecExpected) {
+    const auto iter = id2Rec.find(id);
+    EXPECT_TRUE(iter != std::end(id2Rec) &&
+                memcmp(&iter->second, &rec, sizeof(rec)) == 0);
+  }
+
+  // a rec appended to the journal with the cut rec is not shifted by it
+  const auto [op, rec] = MakeChgOfSnapshotStore(5001);
+  ApplyRecOfSnapshotStore(id2Rec, op, rec);
+  ApplyRecOfSnapshotStore(id2RecExpected, op, rec);
+  snapshotStore->append(op, rec);
+  EXPECT_TRUE(snapshotStore->flush() == 0);
+  Id2RecOfSnapshotStore id2RecAfterCut;
+  EXPECT_TRUE(makeSnapshotStore(id2RecAfterCut)
+                  ->load([&](OpOfJournal op, const RecOfSnapshotStore& rec) {
+                    ApplyRecOfSnapshotStore(id2RecAfterCut, op, rec);
+                  }) == 0);
+  EXPECT_TRUE(id2RecAfterCut.size() == id2RecExpected.size());
+  EXPECT_TRUE(id2RecAfterCut[rec.id_].value_ == 5001);
+
+  // restart again from the snapshot taken at start
+  snapshotStore->start();
+  snapshotStore->stop();
+  Id2RecOfSnapshotStore id2RecOfRestart;
+  EXPECT_TRUE(makeSnapshotStore(id2RecOfRestart)
+                  ->load([&](OpOfJournal op, const RecOfSnapshotStore& rec) {
+                    ApplyRecOfSnapshotStore(id2RecOfRestart, op, rec);
+                  }) == 0);
+  EXPECT_TRUE(id2RecOfRestart.size() == id2RecExpected.size());
+
+  boost::filesystem::remove_all(rootPath);
+}
+
+namespace {
+
+// records the sqls of each batch instead of execing them on a db
+class FakeDBEngAsync : public db::DBEngAsync {
+ public:
+  using db::DBEngAsync::DBEngAsync;
+
+  std::vector<std::string> getSqlGroup() {
+    std::lock_guard<std::mutex> guard(mtx_);
+    return sqlGroup_;
+  }
+
+  std::vector<std::size_t> getBatchSizeGroup() {
+    std::lock_guard<std::mutex> guard(mtx_);
+    return batchSizeGroup_;
+  }
+
+ private:
+  std::vector<std::tuple<int, std::string>> execTaskGroup(
+      const db::DBTaskGroup& dbTaskGroup) final {
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+    std::lock_guard<std::mutex> guard(mtx_);
+    for (const auto& dbTask : dbTaskGroup) sqlGroup_.emplace_back(dbTask->sql_);
+    batchSizeGroup_.emplace_back(dbTaskGroup.size());
+    return std::vector<std::tuple<int, std::string>>(
+        dbTaskGroup.size(), std::make_tuple(0, std::string()));
+  }
+
+  std::mutex mtx_;
+  std::vector<std::string> sqlGroup_;
+  std::vector<std::size_t> batchSizeGroup_;
+};
+
+}  // namespace
+
+TEST(test, testCoalesceTaskGroup) {
+  db::DBTaskGroup dbTaskGroup;
+  const auto add = [&](const std::string& key, db::Coalesce coalesce) {
+    const auto sql = fmt::format("{}", dbTaskGroup.size());
+    dbTaskGroup.emplace_back(
+        std::make_shared<db::DBTask>("", sql, WriteLog::False, key, coalesce));
+  };
+  add("a", db::Coalesce::False);  // 0 insert
+  add("a", db::Coalesce::True);   // 1 superseded by 3
+  add("b", db::Coalesce::True);   // 2
+  add("a", db::Coalesce::True);   // 3
+  add("", db::Coalesce::True);    // 4 no key of partition
+  add("a", db::Coalesce::False);  // 5 delete
+  add("a", db::Coalesce::True);   // 6
+  db::CoalesceTaskGroup(dbTaskGroup);
+
+  std::string sqlGroup;
+  for (const auto& dbTask : dbTaskGroup) sqlGroup.append(dbTask->sql_);
+  EXPECT_TRUE(sqlGroup == "023456");
+}
+
+TEST(test, testDBEngAsync) {
+  auto dbEngParam = std::make_shared<db::DBEngParam>();
+  dbEngParam->connPoolSizeOfAsyncReq_ = 4;
+  dbEngParam->maxNumOfTaskInBatch_ = 16;
+  dbEngParam->timeDurOfWaitForTask_ = 10;
+  dbEngParam->numOfUnprocessedTaskAlert_ = 100000;
+  const auto dbEng = std::make_shared<FakeDBEngAsync>(dbEngParam, nullptr);
+  dbEng->start();
+
+  // each order is updated in full many times and each asset is inserted,
+  // updated and deleted
+  const std::uint32_t numOfOrder = 100;
+  const std::uint32_t numOfUpdate = 20;
+  std::uint32_t numOfTask = 0;
+  for (std::uint32_t no = 0; no < numOfUpdate; ++no) {
+    for (std::uint32_t orderId = 0; orderId < numOfOrder; ++orderId) {
+      const auto key = fmt::format("order-{}", orderId);
+      dbEng->asyncExecSql("", fmt::format("{}:{}", key, no), WriteLog::False,
+                          key, db::Coalesce::True);
+      ++numOfTask;
+    }
+  }
+  for (std::uint32_t assetNo = 0; assetNo < numOfOrder; ++assetNo) {
+    const auto key = fmt::format("asset-{}", assetNo);
+    dbEng->asyncExecSql("", fmt::format("{}:insert", key), WriteLog::False,
+                        key, db::Coalesce::False);
+    for (std::uint32_t no = 0; no < numOfUpdate; ++no) {
+      dbEng->asyncExecSql("", fmt::format("{}:{}", key, no), WriteLog::False,
+                          key, db::Coalesce::True);
+    }
+    dbEng->asyncExecSql("", fmt::format("{}:delete", key), WriteLog::False,
+                        key, db::Coalesce::False);
+    numOfTask += numOfUpdate + 2;
+  }
+  dbEng->stop();
+
+  // the sqls of each key are execed in order and the last one is never dropped
+  std::map<std::string, std::vector<std::string>> key2SqlGroup;
+  for (const auto& sql : dbEng->getSqlGroup()) {
+    const auto pos = sql.find(':');
+    key2SqlGroup[sql.substr(0, pos)].emplace_back(sql.substr(pos + 1));
+  }
+  EXPECT_TRUE(key2SqlGroup.size() == numOfOrder * 2);
+  for (const auto& [key, sqlGroup] : key2SqlGroup) {
+    std::vector<std::uint32_t> noGroup;
+    for (const auto& sql : sqlGroup) {
+      if (sql != "insert" && sql != "delete") {
+        noGroup.emplace_back(CONV(std::uint32_t, sql));
+      }
+    }
+    EXPECT_TRUE(std::is_sorted(std::begin(noGroup), std::end(noGroup)));
+    EXPECT_TRUE(!noGroup.empty() && noGroup.back() == numOfUpdate - 1);
+    if (boost::starts_with(key, "asset")) {
+      EXPECT_TRUE(sqlGroup.front() == "insert" && sqlGroup.back() == "delete");
+    }
+  }
+
+  // tasks are batched and superseded ones are dropped
+  const auto batchSizeGroup = dbEng->getBatchSizeGroup();
+  const auto numOfTaskExeced = dbEng->getSqlGroup().size();
+  const auto maxBatchSize =
+      *std::max_element(std::begin(batchSizeGroup), std::end(batchSizeGroup));
+  EXPECT_TRUE(maxBatchSize > 1 && maxBatchSize <= 16);
+  EXPECT_TRUE(numOfTaskExeced < numOfTask);
+  EXPECT_TRUE(batchSizeGroup.size() < numOfTaskExeced);
+}
+
+TEST(test, testBinLogRing) {
+  BinLogRing ring(256);
+  EXPECT_TRUE(ring.front() == nullptr);
+
+  // recs of 16 + 32 bytes, the 6th one does not fit at the end of the ring
+  for (std::uint64_t round = 0; round < 100; ++round) {
+    for (std::uint64_t no = 0; no < 5; ++no) {
+      const auto rec = static_cast<std::uint64_t*>(ring.alloc(24));
+      EXPECT_TRUE(rec != nullptr);
+      *rec = round * 5 + no;
+      ring.commit();
+    }
+    EXPECT_TRUE(ring.alloc(24) == nullptr);
+    for (std::uint64_t no = 0; no < 5; ++no) {
+      const auto rec = static_cast<const std::uint64_t*>(ring.front());
+      EXPECT_TRUE(rec != nullptr && *rec == round * 5 + no);
+      ring.pop();
+    }
+    EXPECT_TRUE(ring.front() == nullptr);
+  }
+  EXPECT_TRUE(ring.numOfDropped() == 100);
+  EXPECT_TRUE(ring.alloc(256) == nullptr);
+}
+
+enum class SideOfTest { Bid = 1, Ask = 2 };
+
+TEST(test, testBinLogger) {
+  std::ostringstream oss;
+  auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss);
+  sink->set_pattern("%v");
+  const auto defaultLogger = spdlog::default_logger();
+  spdlog::set_default_logger(std::make_shared<spdlog::logger>("test", sink));
+  VerOfLoggers().fetch_add(1);
+
+  char symbolCode[32] = "BTC-USDT";
+  symbolCode[16] = 'X';
+  std::vector<std::thread> threadGroup;
+  for (int threadNo = 0; threadNo < 4; ++threadNo) {
+    threadGroup.emplace_back([&, threadNo]() {
+      for (int no = 0; no < 1000; ++no) {
+        BLOG_I("{}-{} {} {} {}", threadNo, no, symbolCode, SideOfTest::Ask,
+               1.5);
+      }
+    });
+  }
+  for (auto& thread : threadGroup) thread.join();
+  BLOG_W("Bin log without args.");
+  BinLogger::get_mutable_instance().flush();
+
+  // a disabled level returns before the args are evaluated
+  spdlog::default_logger()->set_level(spdlog::level::warn);
+  int numOfEval = 0;
+  BLOG_I("Bin log of disabled level {}.", ++numOfEval);
+  EXPECT_TRUE(numOfEval == 0);
+  BinLogger::get_mutable_instance().flush();
+
+  spdlog::set_default_logger(defaultLogger);
+  VerOfLoggers().fetch_add(1);
+
+  const auto logs = oss.str();
+  EXPECT_TRUE(std::count(std::begin(logs), std::end(logs), '\n') == 4001);
+  EXPECT_TRUE(logs.find("3-999 BTC-USDT Ask 1.5\n") != std::string::npos);
+  EXPECT_TRUE(logs.find("1-100 ") < logs.find("1-101 "));
+  EXPECT_TRUE(logs.find("Bin log without args.") != std::string::npos);
+  EXPECT_TRUE(logs.find("disabled level") == std::string::npos);
+}
+
 int main(int argc, char** argv) {
   testing::AddGlobalTestEnvironment(new global_event);
   testing::InitGoogleTest(&argc, argv);